@@ -0,0 +1,28 @@
+/**
+ * @file gb.h
+ * @brief API for creating and destroying gameboy emulator instances.
+ *
+ * Every piece of emulator state is owned by a gb_t context, so any number of independent
+ * instances can be run in one process, each on its own thread.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#ifndef INCLUDE_GB_H_
+#define INCLUDE_GB_H_
+
+#include <stdint.h>
+
+/* Clock cycles (4.194304 MHz T-states) in one M-cycle and in one full frame */
+#define GB_CYCLES_PER_M_CYCLE 4
+#define GB_CYCLES_PER_FRAME   70224
+
+typedef struct gb gb_t;
+
+gb_t *gb_create(void);
+void gb_destroy(gb_t *gb);
+uint32_t gb_run_cycles(gb_t *gb, uint32_t cycles);
+uint32_t gb_run_frame(gb_t *gb);
+
+#endif /* INCLUDE_GB_H_ */
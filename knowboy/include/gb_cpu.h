@@ -9,7 +9,27 @@
 #ifndef INCLUDE_GB_CPU_H_
 #define INCLUDE_GB_CPU_H_
 
-void gb_cpu_init(void);
-void gb_cpu_step(void);
+#include "gb.h"
+
+/* CPU cores */
+typedef enum {
+	// runs a whole instruction per dispatch, the default
+	GB_CPU_MODE_INSTRUCTION,
+	// runs one M-cycle per step, used while a debugger is attached
+	GB_CPU_MODE_M_CYCLE,
+	// like the instruction core, hot code is translated to native code on x86-64 hosts
+	GB_CPU_MODE_JIT,
+	// like the JIT mode, every native code run is repeated by the instruction core and compared
+	GB_CPU_MODE_JIT_CHECK,
+} gb_cpu_mode_t;
+
+void gb_cpu_init(gb_t *gb);
+void gb_cpu_set_mode(gb_t *gb, gb_cpu_mode_t mode);
+void gb_cpu_step(gb_t *gb);
+void gb_cpu_execute(gb_t *gb);
+void gb_cpu_execute_block(gb_t *gb, uint64_t end);
+void gb_cpu_sync(gb_t *gb);
+uint64_t gb_cpu_get_idle_cycles(const gb_t *gb);
+uint32_t gb_cpu_get_jit_mismatches(const gb_t *gb);
 
 #endif /* INCLUDE_GB_CPU_H_ */
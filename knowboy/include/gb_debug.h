@@ -9,17 +9,22 @@
 #ifndef INCLUDE_GB_DEBUG_H_
 #define INCLUDE_GB_DEBUG_H_
 
+#include "gb.h"
+
 #include <stdbool.h>
 #include <stdint.h>
 
 #define QUEUE_MSG_LEN 50ul
 
+/* Number of instructions shown by the disassemble command */
+#define DISASSEMBLE_INSTRUCTIONS 8
+
 typedef bool (*gb_debug_check_msg_queue_t)(void *, char *);
 typedef void (*gb_debug_flush_t)(void);
 
-void gb_debug_init(gb_debug_check_msg_queue_t check_msg_queue, gb_debug_flush_t flush,
+void gb_debug_init(gb_t *gb, gb_debug_check_msg_queue_t check_msg_queue, gb_debug_flush_t flush,
 		   void *queue_ctx);
-void gb_debug_check_msg_queue(void);
-bool gb_debug_step(void);
+void gb_debug_check_msg_queue(gb_t *gb);
+bool gb_debug_step(gb_t *gb);
 
 #endif /* INCLUDE_GB_DEBUG_H_ */
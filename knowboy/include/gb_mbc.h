@@ -9,12 +9,14 @@
 #ifndef INCLUDE_GB_MBC_H_
 #define INCLUDE_GB_MBC_H_
 
+#include "gb.h"
+
 #include <stdint.h>
 
-void gbc_mbc_init(void);
-void gb_mbc_set_cartridge_info(uint8_t code, uint8_t rom_size, uint8_t ram_size);
-uint8_t gb_mbc_read_rom_bank(uint16_t address);
-void gb_mbc_write_register(uint16_t address, uint8_t data);
-uint8_t gb_mbc_read_ram_bank(uint16_t address);
-void gb_mbc_write_ram_bank(uint16_t address, uint8_t data);
+void gbc_mbc_init(gb_t *gb);
+void gb_mbc_set_cartridge_info(gb_t *gb, uint8_t code, uint8_t rom_size, uint8_t ram_size);
+uint8_t gb_mbc_read_rom_bank(gb_t *gb, uint16_t address);
+void gb_mbc_write_register(gb_t *gb, uint16_t address, uint8_t data);
+uint8_t gb_mbc_read_ram_bank(gb_t *gb, uint16_t address);
+void gb_mbc_write_ram_bank(gb_t *gb, uint16_t address, uint8_t data);
 #endif /* INCLUDE_GB_MBC_H_ */
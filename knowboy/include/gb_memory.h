@@ -9,6 +9,8 @@
 #ifndef INCLUDE_GB_MEMORY_H_
 #define INCLUDE_GB_MEMORY_H_
 
+#include "gb.h"
+
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -27,6 +29,7 @@
 #define ECHORAM_BASE  0xE000
 #define OAM_BASE      0xFE00
 #define IO_BASE	      0xFF00
+#define HRAM_BASE     0xFF80
 
 // Drawing Related Register Addresses
 #define JOY_ADDR  0xFF00
@@ -289,19 +292,19 @@ typedef struct {
 	registers_t reg;
 } memory_t;
 
-typedef uint8_t (*gb_memory_controls_t)(uint8_t *, uint8_t *);
+typedef uint8_t (*gb_memory_controls_t)(void *, uint8_t *, uint8_t *);
 
 /* Public function prototypes -----------------------------------------------*/
-void gb_memory_set_control_function(gb_memory_controls_t controls);
-const uint8_t *gb_memory_get_rom_pointer(void);
-void gb_memory_load(const void *data, uint32_t size);
-void gb_memory_write(uint16_t address, uint8_t data);
-void gb_memory_write_short(uint16_t address, uint16_t data);
-uint8_t gb_memory_read(uint16_t address);
-uint16_t gb_memory_read_short(uint16_t address);
-void gb_memory_inc_timers(uint8_t duration);
-void gb_memory_set_bit(uint16_t address, uint8_t bit);
-void gb_memory_reset_bit(uint16_t address, uint8_t bit);
-void gb_memory_init(const uint8_t *boot_rom, const uint8_t *game_rom, bool boot_skip);
+void gb_memory_set_control_function(gb_t *gb, gb_memory_controls_t controls, void *controls_ctx);
+const uint8_t *gb_memory_get_rom_pointer(gb_t *gb);
+void gb_memory_load(gb_t *gb, const void *data, uint32_t size);
+void gb_memory_write(gb_t *gb, uint16_t address, uint8_t data);
+void gb_memory_write_short(gb_t *gb, uint16_t address, uint16_t data);
+uint8_t gb_memory_read(gb_t *gb, uint16_t address);
+uint16_t gb_memory_read_short(gb_t *gb, uint16_t address);
+void gb_memory_set_bit(gb_t *gb, uint16_t address, uint8_t bit);
+void gb_memory_reset_bit(gb_t *gb, uint16_t address, uint8_t bit);
+void gb_memory_init(gb_t *gb, const uint8_t *boot_rom, const uint8_t *game_rom, bool boot_skip);
+void gb_memory_map_cartridge(gb_t *gb);
 
 #endif /* INCLUDE_GB_MEMORY_H_ */
@@ -9,15 +9,42 @@
 #ifndef INCLUDE_GB_PPU_H_
 #define INCLUDE_GB_PPU_H_
 
+#include "gb.h"
+
+#include <stdint.h>
+
 #define GAMEBOY_SCREEN_WIDTH  160
 #define GAMEBOY_SCREEN_HEIGHT 144
 
-typedef void (*gb_ppu_display_frame_buffer_t)(uint32_t *);
+/* Frame formats the PPU draws */
+typedef enum {
+	// one ARGB8888 color per pixel, handed to the display function, the default
+	GB_PPU_OUTPUT_ARGB8888,
+	// one shade per pixel, 0 being the lightest and 3 the darkest
+	GB_PPU_OUTPUT_INDEXED,
+	// 4 shades per byte, the leftmost pixel in the 2 most significant bits
+	GB_PPU_OUTPUT_INDEXED_PACKED,
+} gb_ppu_output_t;
+
+// render skip that renders no frames except the ones asked for with gb_ppu_render_next_frame()
+#define GB_PPU_RENDER_SKIP_ALL UINT32_MAX
+
+typedef void (*gb_ppu_display_frame_buffer_t)(void *, uint32_t *);
 
-void gb_ppu_set_display_frame_buffer(gb_ppu_display_frame_buffer_t display_frame_buffer);
-void gb_ppu_step(void);
-void gb_ppu_init(void);
-uint8_t gb_ppu_memory_read(uint16_t address);
-void gb_ppu_memory_write(uint16_t address, uint8_t data);
+void gb_ppu_set_display_frame_buffer(gb_t *gb, gb_ppu_display_frame_buffer_t display_frame_buffer,
+				     void *display_ctx);
+const uint32_t *gb_ppu_get_frame(const gb_t *gb);
+void gb_ppu_set_output(gb_t *gb, gb_ppu_output_t output);
+void gb_ppu_set_render_skip(gb_t *gb, uint32_t frames);
+void gb_ppu_render_next_frame(gb_t *gb);
+const uint8_t *gb_ppu_get_indexed_frame(const gb_t *gb);
+void gb_ppu_expand_argb8888(const gb_t *gb, uint32_t *pixels);
+void gb_ppu_expand_rgb565(const gb_t *gb, uint16_t *pixels);
+void gb_ppu_init(gb_t *gb);
+void gb_ppu_sync(gb_t *gb);
+uint64_t gb_ppu_next_change(gb_t *gb);
+void gb_ppu_invalidate_tiles(gb_t *gb);
+uint8_t gb_ppu_memory_read(gb_t *gb, uint16_t address);
+void gb_ppu_memory_write(gb_t *gb, uint16_t address, uint8_t data);
 
 #endif /* INCLUDE_GB_PPU_H_ */
@@ -0,0 +1,146 @@
+/**
+ * @file gb.c
+ * @brief Gameboy emulator context lifetime.
+ *
+ * This file creates and destroys the gb_t context that holds the state of a single emulated
+ * gameboy.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#include "gb.h"
+#include "gb_apu.h"
+#include "gb_cpu.h"
+#include "gb_debug.h"
+#include "gb_jit.h"
+#include "gb_mbc.h"
+#include "gb_ppu.h"
+#include "gb_priv.h"
+#include "gb_sched.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * @brief Runs the emulator for up to cycles clock cycles.
+ * @details The CPU runs a basic block from the block cache at a time, or one M-cycle at a time
+ * in the M-cycle mode, the PPU and the timers only run when one of their scheduled events is due
+ * or when the CPU accesses them, the APU only when the CPU accesses it. These and the CPU flags
+ * are brought up to date before returning so the frame buffer, the audio buffer and the registers
+ * can be inspected.
+ * Outside of the M-cycle mode, VBlank is only noticed at the end of a block. When a debugger is
+ * attached, the M-cycle mode is used and the debugger is consulted before every M-cycle, the run
+ * stops early as soon as it reports that emulation is halted on a breakpoint.
+ * @param cycles clock cycle budget
+ * @param stop_at_vblank also stop once the PPU enters VBlank
+ * @return number of clock cycles that were run
+ */
+static uint32_t gb_run(gb_t *gb, uint32_t cycles, bool stop_at_vblank)
+{
+	bool debugger_attached = gb->debug.check_queue != NULL;
+	uint64_t start = gb->sched.now;
+	uint64_t end = start + cycles;
+
+	gb->ppu.vblank = false;
+	if (gb->cpu.mode != GB_CPU_MODE_M_CYCLE && !debugger_attached) {
+		while (gb->sched.now < end) {
+			gb_cpu_execute_block(gb, end);
+
+			if (stop_at_vblank && gb->ppu.vblank) {
+				break;
+			}
+		}
+	} else {
+		while (gb->sched.now < end) {
+			if (debugger_attached) {
+				gb_ppu_sync(gb);
+				gb_apu_sync(gb);
+				if (gb_debug_step(gb)) {
+					break;
+				}
+			}
+
+			gb_cpu_step(gb);
+			gb_sched_advance(gb, GB_CYCLES_PER_M_CYCLE);
+
+			if (stop_at_vblank && gb->ppu.vblank) {
+				break;
+			}
+		}
+	}
+
+	gb_cpu_sync(gb);
+	gb_ppu_sync(gb);
+	gb_apu_sync(gb);
+
+	return gb->sched.now - start;
+}
+
+/**
+ * @brief Allocates a new emulator context and puts the CPU, PPU and MBC in their power on state.
+ * @details The memory map still has to be loaded with gb_memory_init() and the audio buffers have
+ * to be handed over with gb_apu_init() before the emulator can be stepped.
+ * @return new emulator context, NULL if the allocation failed
+ */
+gb_t *gb_create(void)
+{
+	gb_t *gb = calloc(1, sizeof(*gb));
+	if (gb == NULL) {
+		return NULL;
+	}
+
+	gb_sched_init(gb);
+	gb_cpu_init(gb);
+	gb_jit_init(gb);
+	gb_ppu_init(gb);
+	gbc_mbc_init(gb);
+
+	return gb;
+}
+
+/**
+ * @brief Frees an emulator context and the cartridge RAM owned by it.
+ * @param gb emulator context, may be NULL
+ * @return Nothing
+ */
+void gb_destroy(gb_t *gb)
+{
+	if (gb == NULL) {
+		return;
+	}
+
+	gb_jit_destroy(gb);
+	free(gb->mbc.bank_ram);
+	free(gb);
+}
+
+/**
+ * @brief Runs the emulator for a number of clock cycles.
+ * @details The budget is rounded up to whole M-cycles, or to whole instructions unless the CPU
+ * is in the M-cycle mode. Fewer cycles are run if an attached debugger stops on a breakpoint.
+ * The APU mixes one stereo sample every 95 clock cycles into the audio buffer handed to
+ * gb_apu_init(), which is only drained by the frontend between runs. The budget should
+ * therefore be at most 95 * buf_size / 2 clock cycles, about 1.5 million for a buffer of 32768
+ * entries, the samples of a longer run that do not fit into the buffer are dropped.
+ * @param gb emulator context
+ * @param cycles number of clock cycles (T-states) to run
+ * @return number of clock cycles that were run
+ */
+uint32_t gb_run_cycles(gb_t *gb, uint32_t cycles)
+{
+	return gb_run(gb, cycles, false);
+}
+
+/**
+ * @brief Runs the emulator until the PPU enters VBlank.
+ * @details While the LCD is off no VBlank happens, so the run also ends after the clock cycles
+ * of one full frame. The frame buffer handed to the display function is complete when this
+ * returns after reaching VBlank, unless the frame was skipped, see gb_ppu_set_render_skip().
+ * @param gb emulator context
+ * @return number of clock cycles that were run
+ */
+uint32_t gb_run_frame(gb_t *gb)
+{
+	return gb_run(gb, GB_CYCLES_PER_FRAME, true);
+}
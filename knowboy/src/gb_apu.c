@@ -11,17 +11,11 @@
 #include "gb_apu.h"
 #include "gb_common.h"
 #include "gb_memory.h"
+#include "gb_priv.h"
 #include "logging.h"
 
 #include <string.h>
 
-// Audio buffers
-static uint16_t *gb_apu_buf = NULL;
-static uint16_t *gb_apu_buf_pos = NULL;
-
-// Gameboy memory struct
-extern memory_t mem;
-
 static const uint8_t duties[4][8] = {
 	{0, 0, 0, 0, 0, 0, 0, 1}, // 00
 	{1, 0, 0, 0, 0, 0, 0, 1}, // 01
@@ -29,654 +23,642 @@ static const uint8_t duties[4][8] = {
 	{0, 1, 1, 1, 1, 1, 1, 0}  // 11
 };
 
-// 4.194 MHZ --> 44100 HZ Conversion (4.194 / 0.0441 = 95)
-static uint8_t audio_freq_convert_factor = 95;
-
-// Frame Sequence Step 0 - 7 (Incremented every 8192 T States)
-static uint8_t frame_sequence_step = 0;
-
-// Frame Sequence TState (Incremented every T State up to 8192)
-static uint16_t frame_sequence_cycle = 0;
-
-// NR10
-static uint8_t ch1_sweep_pace = 0;
-static uint8_t ch1_sweep_dir = 0;
-static int16_t ch1_sweep_step = 0;
-static uint8_t ch1_sweep_enable = 0;
-static uint8_t ch1_sweep_timer = 0;
-static uint32_t ch1_sweep_shadow = 0;
-static int16_t ch1_sweep_negate = 0;
-
-// NR11
-static uint8_t ch1_wave_duty = 0;
-static uint8_t ch1_length_counter = 0;
-static uint8_t ch1_duty_pos = 0;
-
-// NR12
-static uint8_t ch1_init_vol = 0;
-static uint8_t ch1_envelope_dir = 0;
-static uint8_t ch1_envelope_pace = 0;
-static bool ch1_dac_on = false;
-static uint16_t ch1_volume = 0;
-static uint8_t ch1_envelope = 0;
-
-// NR13
-static uint16_t ch1_freq = 0;
-static int32_t ch1_timer = 0;
-
-// NR14
-static uint8_t ch1_len_enable = 0;
-
-// NR21
-static uint8_t ch2_wave_duty = 0;
-static uint8_t ch2_length_counter = 0;
-static uint8_t ch2_duty_pos = 0;
-
-// NR22
-static uint8_t ch2_init_vol = 0;
-static uint8_t ch2_envelope_dir = 0;
-static uint8_t ch2_envelope_pace = 0;
-static bool ch2_dac_on = false;
-static uint16_t ch2_volume = 0;
-static uint8_t ch2_envelope = 0;
-
-// NR23
-static uint16_t ch2_freq = 0;
-static int32_t ch2_timer = 0;
-
-// NR24
-static uint8_t ch2_len_enable = 0;
-
-// NR30
-static bool ch3_dac_on = false;
-
-// NR31
-static uint16_t ch3_length_counter = 0;
-static uint8_t ch3_wave_pos = 0;
-
-// NR32
-static uint8_t ch3_output_lvl = 0;
-static uint16_t ch3_volume = 0;
-static uint8_t ch3_envelope = 0;
-
-// NR33
-static uint16_t ch3_freq = 0;
-static int32_t ch3_timer = 0;
-static bool ch3_wave_avail = false;
-
-// NR34
-static uint8_t ch3_len_enable = 0;
-
-// NR41
-static uint8_t ch4_length_counter = 0;
-
-// NR42
-static uint8_t ch4_init_vol = 0;
-static uint8_t ch4_envelope_dir = 0;
-static uint8_t ch4_envelope_pace = 0;
-static bool ch4_dac_on = false;
-static uint16_t ch4_volume = 0;
-static uint8_t ch4_envelope = 0;
-
-// NR43
-static uint8_t ch4_clock_shift = 0;
-static uint8_t ch4_lfsr_width = 0;
-static uint8_t ch4_clock_div = 0;
-static int32_t ch4_timer = 0;
 static const uint8_t ch4_divisor[8] = {8, 16, 32, 48, 64, 80, 96, 112};
-static uint16_t ch4_lfsr = 0;
 
-// NR44
-static uint8_t ch4_len_enable = 0;
+// Clock cycles between frame sequencer steps (512 Hz)
+#define FRAME_SEQUENCER_PERIOD 8192
 
-static void gb_apu_step_ch1(void)
+static uint32_t gb_apu_run_timer(int32_t *timer, int32_t period, uint32_t cycles);
+static void gb_apu_run_timers(gb_t *gb, uint32_t cycles);
+static void gb_apu_mix(gb_t *gb);
+
+static void gb_apu_step_ch1(gb_t *gb)
 {
 
 	// length
-	if (frame_sequence_step % 2 == 0 && ch1_len_enable && ch1_length_counter) {
-		ch1_length_counter--;
-		if (ch1_length_counter <= 0) {
-			mem.map[NR52_ADDR] &= ~CH1_ON;
+	if (gb->apu.frame_sequence_step % 2 == 0 && gb->apu.ch1_len_enable &&
+	    gb->apu.ch1_length_counter) {
+		gb->apu.ch1_length_counter--;
+		if (gb->apu.ch1_length_counter <= 0) {
+			gb->mem.map[NR52_ADDR] &= ~CH1_ON;
 		}
 	}
 
 	//  handle sweep (frequency sweep)
-	if (frame_sequence_step == 2 || frame_sequence_step == 6) {
+	if (gb->apu.frame_sequence_step == 2 || gb->apu.frame_sequence_step == 6) {
 
-		if (ch1_sweep_timer > 0)
-			--ch1_sweep_timer;
+		if (gb->apu.ch1_sweep_timer > 0)
+			--gb->apu.ch1_sweep_timer;
 
-		if (ch1_sweep_timer == 0) {
+		if (gb->apu.ch1_sweep_timer == 0) {
 
-			ch1_sweep_timer = ch1_sweep_pace;
+			gb->apu.ch1_sweep_timer = gb->apu.ch1_sweep_pace;
 
-			if (ch1_sweep_pace == 0)
-				ch1_sweep_timer = 8;
+			if (gb->apu.ch1_sweep_pace == 0)
+				gb->apu.ch1_sweep_timer = 8;
 
-			if (ch1_sweep_enable && ch1_sweep_pace) {
+			if (gb->apu.ch1_sweep_enable && gb->apu.ch1_sweep_pace) {
 
-				ch1_sweep_negate = ch1_sweep_dir ? -1 : 1;
+				gb->apu.ch1_sweep_negate = gb->apu.ch1_sweep_dir ? -1 : 1;
 
 				uint32_t newfreq =
-					ch1_sweep_shadow +
-					((ch1_sweep_shadow >> ch1_sweep_step) * ch1_sweep_negate);
-
-				if (newfreq < 2048 && ch1_sweep_step) {
-					ch1_sweep_shadow = newfreq;
-					ch1_freq = newfreq;
-					mem.map[NR13_ADDR] = ch1_sweep_shadow & 0xff;
-					mem.map[NR14_ADDR] = (mem.map[NR14_ADDR] & ~0x07) |
-							     ((ch1_sweep_shadow >> 8) & 0x07);
-
-					if ((ch1_sweep_shadow +
-					     ((ch1_sweep_shadow >> ch1_sweep_step) *
-					      ch1_sweep_negate)) > 2047) {
-						ch1_sweep_enable = 0;
-						mem.map[NR52_ADDR] &= ~CH1_ON;
+					gb->apu.ch1_sweep_shadow +
+					((gb->apu.ch1_sweep_shadow >> gb->apu.ch1_sweep_step) *
+					 gb->apu.ch1_sweep_negate);
+
+				if (newfreq < 2048 && gb->apu.ch1_sweep_step) {
+					gb->apu.ch1_sweep_shadow = newfreq;
+					gb->apu.ch1_freq = newfreq;
+					gb->mem.map[NR13_ADDR] = gb->apu.ch1_sweep_shadow & 0xff;
+					gb->mem.map[NR14_ADDR] =
+						(gb->mem.map[NR14_ADDR] & ~0x07) |
+						((gb->apu.ch1_sweep_shadow >> 8) & 0x07);
+
+					if ((gb->apu.ch1_sweep_shadow +
+					     ((gb->apu.ch1_sweep_shadow >> gb->apu.ch1_sweep_step) *
+					      gb->apu.ch1_sweep_negate)) > 2047) {
+						gb->apu.ch1_sweep_enable = 0;
+						gb->mem.map[NR52_ADDR] &= ~CH1_ON;
 					}
 				}
 
 				if ((newfreq > 2047) ||
-				    ((ch1_sweep_shadow + ((ch1_sweep_shadow >> ch1_sweep_step) *
-							  ch1_sweep_negate)) > 2047)) {
-					ch1_sweep_enable = 0;
-					mem.map[NR52_ADDR] &= ~CH1_ON;
+				    ((gb->apu.ch1_sweep_shadow +
+				      ((gb->apu.ch1_sweep_shadow >> gb->apu.ch1_sweep_step) *
+				       gb->apu.ch1_sweep_negate)) > 2047)) {
+					gb->apu.ch1_sweep_enable = 0;
+					gb->mem.map[NR52_ADDR] &= ~CH1_ON;
 				}
 			}
 		}
 	}
 
 	//  handle envelope (volume envelope)
-	if (frame_sequence_step == 7 && ch1_dac_on && ch1_envelope_pace) {
-		--ch1_envelope;
+	if (gb->apu.frame_sequence_step == 7 && gb->apu.ch1_dac_on && gb->apu.ch1_envelope_pace) {
+		--gb->apu.ch1_envelope;
 
-		if (ch1_envelope <= 0) {
-			ch1_envelope = ch1_envelope_pace;
+		if (gb->apu.ch1_envelope <= 0) {
+			gb->apu.ch1_envelope = gb->apu.ch1_envelope_pace;
 
-			int8_t vol = ch1_volume + (ch1_envelope_dir ? 1 : -1);
+			int8_t vol = gb->apu.ch1_volume + (gb->apu.ch1_envelope_dir ? 1 : -1);
 
 			if (vol >= 0x0 && vol <= 0xF) {
-				ch1_volume = vol;
+				gb->apu.ch1_volume = vol;
 			}
 		}
 	}
 }
 
-static void gb_apu_step_ch2(void)
+static void gb_apu_step_ch2(gb_t *gb)
 {
 	// length
-	if (frame_sequence_step % 2 == 0 && ch2_len_enable && ch2_length_counter) {
-		ch2_length_counter--;
-		if (ch2_length_counter <= 0) {
-			mem.map[NR52_ADDR] &= ~CH2_ON;
+	if (gb->apu.frame_sequence_step % 2 == 0 && gb->apu.ch2_len_enable &&
+	    gb->apu.ch2_length_counter) {
+		gb->apu.ch2_length_counter--;
+		if (gb->apu.ch2_length_counter <= 0) {
+			gb->mem.map[NR52_ADDR] &= ~CH2_ON;
 		}
 	}
 
 	// envelope
-	if (frame_sequence_step == 7 && ch2_dac_on && ch2_envelope_pace) {
-		ch2_envelope--;
+	if (gb->apu.frame_sequence_step == 7 && gb->apu.ch2_dac_on && gb->apu.ch2_envelope_pace) {
+		gb->apu.ch2_envelope--;
 
-		if (ch2_envelope <= 0) {
+		if (gb->apu.ch2_envelope <= 0) {
 
-			ch2_envelope = ch2_envelope_pace;
+			gb->apu.ch2_envelope = gb->apu.ch2_envelope_pace;
 
 			// get louder or quieter
-			int8_t vol = ch2_volume + ((ch2_envelope_dir) ? 1 : -1);
+			int8_t vol = gb->apu.ch2_volume + ((gb->apu.ch2_envelope_dir) ? 1 : -1);
 
 			if (vol >= 0x0 && vol <= 0xF) {
-				ch2_volume = vol;
+				gb->apu.ch2_volume = vol;
 			}
 		}
 	}
 }
 
-static void gb_apu_step_ch3(void)
+static void gb_apu_step_ch3(gb_t *gb)
 {
 
 	//  handle length
-	if (frame_sequence_step % 2 == 0 && ch3_len_enable && ch3_length_counter) {
-		ch3_length_counter--;
-		if (ch3_length_counter == 0) {
-			mem.map[NR52_ADDR] &= ~CH3_ON;
+	if (gb->apu.frame_sequence_step % 2 == 0 && gb->apu.ch3_len_enable &&
+	    gb->apu.ch3_length_counter) {
+		gb->apu.ch3_length_counter--;
+		if (gb->apu.ch3_length_counter == 0) {
+			gb->mem.map[NR52_ADDR] &= ~CH3_ON;
 		}
 	}
 }
 
-static void gb_apu_step_ch4(void)
+static void gb_apu_step_ch4(gb_t *gb)
 {
 
 	//  handle length
-	if (frame_sequence_step % 2 == 0 && ch4_len_enable && ch4_length_counter) {
-		ch4_length_counter--;
-		if (ch4_length_counter == 0) {
-			mem.map[NR52_ADDR] &= ~CH4_ON;
+	if (gb->apu.frame_sequence_step % 2 == 0 && gb->apu.ch4_len_enable &&
+	    gb->apu.ch4_length_counter) {
+		gb->apu.ch4_length_counter--;
+		if (gb->apu.ch4_length_counter == 0) {
+			gb->mem.map[NR52_ADDR] &= ~CH4_ON;
 		}
 	}
 
 	//  handle envelope (volume envelope)
-	if (frame_sequence_step == 7 && ch4_envelope_pace) {
-		--ch4_envelope;
+	if (gb->apu.frame_sequence_step == 7 && gb->apu.ch4_envelope_pace) {
+		--gb->apu.ch4_envelope;
 
-		if (ch4_envelope <= 0) {
+		if (gb->apu.ch4_envelope <= 0) {
 
-			ch4_envelope = ch4_envelope_pace;
+			gb->apu.ch4_envelope = gb->apu.ch4_envelope_pace;
 
-			int8_t vol = ch4_volume + ((ch4_envelope_dir) ? 1 : -1);
+			int8_t vol = gb->apu.ch4_volume + ((gb->apu.ch4_envelope_dir) ? 1 : -1);
 
 			if (vol >= 0x0 && vol <= 0xF)
-				ch4_volume = vol;
+				gb->apu.ch4_volume = vol;
 		}
 	}
 }
 
-void gb_apu_init(uint16_t *buf, uint16_t *buf_pos, uint16_t buf_size)
+/**
+ * @brief Hands the audio buffer of the frontend to the APU
+ * @details One stereo sample is mixed into the buffer every 95 clock cycles, left then right,
+ * and buf_pos is moved on past it. The frontend drains the buffer and resets buf_pos to 0 after
+ * each run, samples that no longer fit into the buffer are dropped.
+ * @param buf audio buffer
+ * @param buf_pos position of the next sample in buf
+ * @param buf_size number of entries in buf
+ * @return Nothing
+ */
+void gb_apu_init(gb_t *gb, uint16_t *buf, uint16_t *buf_pos, uint16_t buf_size)
 {
-	gb_apu_buf = buf;
-	gb_apu_buf_pos = buf_pos;
-	memset(gb_apu_buf, 0x00, buf_size);
+	gb->apu.buf = buf;
+	gb->apu.buf_pos = buf_pos;
+	gb->apu.buf_size = buf_size;
+	gb->apu.audio_freq_convert_factor = 95;
+	memset(gb->apu.buf, 0x00, buf_size * sizeof(*buf));
+	gb->apu.cycle = gb->sched.now;
 }
 
-void gb_apu_step(void)
+/**
+ * @brief Brings the channels, the frame sequencer and the mixer up to the current M-cycle
+ * @details The APU does not run on every M-cycle, it only records the clock cycle it has been
+ * run up to and catches up in one go whenever an APU register is read or written and when the
+ * frontend drains the audio buffer at the end of gb_run_cycles() and gb_run_frame(). Between two
+ * frame sequencer steps or samples nothing but the channel timers change, so the elapsed span is
+ * run one sample at a time and the timers are advanced in closed form.
+ * @return Nothing
+ */
+void gb_apu_sync(gb_t *gb)
 {
-	uint8_t current_cylces = 4;
+	while (gb->apu.cycle < gb->sched.now) {
+		// the frame sequencer steps on the last clock cycle of every period since power on
+		uint64_t frame_sequencer = gb->apu.cycle | (FRAME_SEQUENCER_PERIOD - 1);
+		uint64_t sample = gb->apu.cycle + gb->apu.audio_freq_convert_factor - 1;
+		uint64_t next = (sample < frame_sequencer) ? sample : frame_sequencer;
+
+		if (next >= gb->sched.now) {
+			uint32_t cycles = gb->sched.now - gb->apu.cycle;
+
+			gb_apu_run_timers(gb, cycles);
+			gb->apu.audio_freq_convert_factor -= cycles;
+			gb->apu.cycle = gb->sched.now;
+			return;
+		}
 
-	while (current_cylces--) {
+		// the frame sequencer and the mixer run after the timers of their clock cycle
+		gb_apu_run_timers(gb, next + 1 - gb->apu.cycle);
+		gb->apu.audio_freq_convert_factor -= next + 1 - gb->apu.cycle;
+		gb->apu.cycle = next + 1;
 
-		ch1_timer--;
-		if (ch1_timer <= 0x00) {
-			ch1_timer = (2048 - ch1_freq) * 4;
-			ch1_duty_pos++;
-			ch1_duty_pos %= 8;
-		}
+		if (next == frame_sequencer) {
+			gb->apu.frame_sequence_step++;
+			gb->apu.frame_sequence_step %= 8;
 
-		ch2_timer--;
-		if (ch2_timer <= 0x00) {
-			ch2_timer = (2048 - ch2_freq) * 4;
-			ch2_duty_pos++;
-			ch2_duty_pos %= 8;
+			gb_apu_step_ch1(gb);
+			gb_apu_step_ch2(gb);
+			gb_apu_step_ch3(gb);
+			gb_apu_step_ch4(gb);
 		}
 
-		ch3_timer--;
-		if (ch3_timer <= 0x00) {
-			ch3_timer = (2048 - ch3_freq) * 2;
-			ch3_wave_pos++;
-			ch3_wave_pos %= 32;
-			ch3_wave_avail = true;
+		if (next == sample) {
+			gb->apu.audio_freq_convert_factor = 95;
+			gb_apu_mix(gb);
 		}
+	}
+}
 
-		ch4_timer--;
-		if (ch4_timer <= 0x00) {
-			ch4_timer = ch4_divisor[ch4_clock_div] << ch4_clock_shift;
-
-			//  handle lfsr
-			uint8_t xor_res = (ch4_lfsr & 0x1) ^ ((ch4_lfsr & 0x2) >> 1);
-			ch4_lfsr >>= 1;
-			ch4_lfsr |= (xor_res << 14);
-			if (ch4_lfsr_width) {
-				ch4_lfsr |= (xor_res << 6);
-				ch4_lfsr &= 0x7F;
-			}
-		}
+/**
+ * @brief Runs a channel timer for a number of clock cycles
+ * @details The timer counts down once per clock cycle and is reloaded with period when it
+ * reaches 0.
+ * @param timer channel timer
+ * @param period reload value of the timer
+ * @param cycles number of clock cycles, at least 1
+ * @return number of times the timer was reloaded
+ */
+static uint32_t gb_apu_run_timer(int32_t *timer, int32_t period, uint32_t cycles)
+{
+	// clock cycles up to and including the next reload
+	uint32_t remaining = (*timer > 0) ? *timer : 1;
 
-		// FS Step
-		frame_sequence_cycle++;
-		if (frame_sequence_cycle == 8192) {
-			frame_sequence_cycle = 0;
+	if (cycles < remaining) {
+		*timer -= cycles;
+		return 0;
+	}
 
-			frame_sequence_step++;
-			frame_sequence_step %= 8;
+	cycles -= remaining;
+	*timer = period - cycles % period;
+	return 1 + cycles / period;
+}
 
-			gb_apu_step_ch1();
-			gb_apu_step_ch2();
-			gb_apu_step_ch3();
-			gb_apu_step_ch4();
-		}
+/**
+ * @brief Runs the timers of all four channels for a number of clock cycles
+ * @param cycles number of clock cycles, at least 1
+ * @return Nothing
+ */
+static void gb_apu_run_timers(gb_t *gb, uint32_t cycles)
+{
+	uint32_t steps;
 
-		// 95
-		if (!--audio_freq_convert_factor) {
-			audio_freq_convert_factor = 95;
+	steps = gb_apu_run_timer(&gb->apu.ch1_timer, (2048 - gb->apu.ch1_freq) * 4, cycles);
+	gb->apu.ch1_duty_pos = (gb->apu.ch1_duty_pos + steps) % 8;
 
-			gb_apu_buf[*gb_apu_buf_pos] = 0;
-			gb_apu_buf[*gb_apu_buf_pos + 1] = 0;
+	steps = gb_apu_run_timer(&gb->apu.ch2_timer, (2048 - gb->apu.ch2_freq) * 4, cycles);
+	gb->apu.ch2_duty_pos = (gb->apu.ch2_duty_pos + steps) % 8;
 
-			if (mem.map[NR52_ADDR] & AUDIO_ON) {
+	steps = gb_apu_run_timer(&gb->apu.ch3_timer, (2048 - gb->apu.ch3_freq) * 2, cycles);
+	if (steps) {
+		gb->apu.ch3_wave_pos = (gb->apu.ch3_wave_pos + steps) % 32;
+		gb->apu.ch3_wave_avail = true;
+	}
 
-				// ch1
-				if (mem.map[NR52_ADDR] & CH1_ON) {
+	int32_t ch4_period = ch4_divisor[gb->apu.ch4_clock_div] << gb->apu.ch4_clock_shift;
 
-					if (mem.map[NR51_ADDR] & CH1_LEFT) {
-						gb_apu_buf[*gb_apu_buf_pos] =
-							((duties[ch1_wave_duty][ch1_duty_pos] == 1)
-								 ? ch1_volume
-								 : 0);
-					}
+	steps = gb_apu_run_timer(&gb->apu.ch4_timer, ch4_period, cycles);
+	for (; steps > 0; steps--) {
+		//  handle lfsr
+		uint8_t xor_res = (gb->apu.ch4_lfsr & 0x1) ^ ((gb->apu.ch4_lfsr & 0x2) >> 1);
+		gb->apu.ch4_lfsr >>= 1;
+		gb->apu.ch4_lfsr |= (xor_res << 14);
+		if (gb->apu.ch4_lfsr_width) {
+			gb->apu.ch4_lfsr |= (xor_res << 6);
+			gb->apu.ch4_lfsr &= 0x7F;
+		}
+	}
+}
 
-					if ((mem.map[NR51_ADDR] & CH1_RIGHT)) {
-						gb_apu_buf[*gb_apu_buf_pos + 1] =
-							((duties[ch1_wave_duty][ch1_duty_pos] == 1)
-								 ? ch1_volume
-								 : 0);
-					}
-				}
+/**
+ * @brief Mixes the channels into one stereo sample of the audio buffer
+ * @return Nothing
+ */
+static void gb_apu_mix(gb_t *gb)
+{
+	if (*gb->apu.buf_pos + 2 > gb->apu.buf_size) {
+		// the buffer is full, the frontend has not drained it
+		return;
+	}
 
-				// ch2
-				if (mem.map[NR52_ADDR] & CH2_ON) {
+	gb->apu.buf[*gb->apu.buf_pos] = 0;
+	gb->apu.buf[*gb->apu.buf_pos + 1] = 0;
 
-					if (mem.map[NR51_ADDR] & CH2_LEFT) {
-						gb_apu_buf[*gb_apu_buf_pos] +=
-							((duties[ch2_wave_duty][ch2_duty_pos] == 1)
-								 ? ch2_volume
-								 : 0);
-					}
-					if (mem.map[NR51_ADDR] & CH2_RIGHT) {
-						gb_apu_buf[*gb_apu_buf_pos + 1] +=
-							((duties[ch2_wave_duty][ch2_duty_pos] == 1)
-								 ? ch2_volume
-								 : 0);
-					}
-				}
+	if (gb->mem.map[NR52_ADDR] & AUDIO_ON) {
 
-				// ch3
-				if ((mem.map[NR52_ADDR] & CH3_ON)) {
+		// ch1
+		if (gb->mem.map[NR52_ADDR] & CH1_ON) {
 
-					uint8_t wave = mem.map[WPRAM_BASE + (ch3_wave_pos / 2)];
+			if (gb->mem.map[NR51_ADDR] & CH1_LEFT) {
+				gb->apu.buf[*gb->apu.buf_pos] =
+					((duties[gb->apu.ch1_wave_duty][gb->apu.ch1_duty_pos] == 1)
+						 ? gb->apu.ch1_volume
+						 : 0);
+			}
 
-					if (ch3_wave_pos % 2) {
-						wave = wave & 0xf;
-					} else {
-						wave = wave >> 4;
-					}
+			if ((gb->mem.map[NR51_ADDR] & CH1_RIGHT)) {
+				gb->apu.buf[*gb->apu.buf_pos + 1] =
+					((duties[gb->apu.ch1_wave_duty][gb->apu.ch1_duty_pos] == 1)
+						 ? gb->apu.ch1_volume
+						 : 0);
+			}
+		}
 
-					if (ch3_output_lvl)
-						wave = wave >> (ch3_output_lvl - 1);
-					else
-						wave = wave >> 4;
+		// ch2
+		if (gb->mem.map[NR52_ADDR] & CH2_ON) {
 
-					if (mem.map[NR51_ADDR] & CH3_LEFT) {
-						gb_apu_buf[*gb_apu_buf_pos] += wave;
-					}
+			if (gb->mem.map[NR51_ADDR] & CH2_LEFT) {
+				gb->apu.buf[*gb->apu.buf_pos] +=
+					((duties[gb->apu.ch2_wave_duty][gb->apu.ch2_duty_pos] == 1)
+						 ? gb->apu.ch2_volume
+						 : 0);
+			}
+			if (gb->mem.map[NR51_ADDR] & CH2_RIGHT) {
+				gb->apu.buf[*gb->apu.buf_pos + 1] +=
+					((duties[gb->apu.ch2_wave_duty][gb->apu.ch2_duty_pos] == 1)
+						 ? gb->apu.ch2_volume
+						 : 0);
+			}
+		}
 
-					if (mem.map[NR51_ADDR] & CH3_RIGHT) {
-						gb_apu_buf[*gb_apu_buf_pos + 1] += wave;
-					}
-				}
+		// ch3
+		if ((gb->mem.map[NR52_ADDR] & CH3_ON)) {
 
-				// ch4
-				if ((mem.map[NR52_ADDR] & CH4_ON)) {
+			uint8_t wave = gb->mem.map[WPRAM_BASE + (gb->apu.ch3_wave_pos / 2)];
 
-					if (mem.map[NR51_ADDR] & CH4_LEFT) {
-						gb_apu_buf[*gb_apu_buf_pos] +=
-							((ch4_lfsr & 0x1) ? ch4_volume : 0);
-					}
-					if (mem.map[NR51_ADDR] & CH4_RIGHT) {
-						gb_apu_buf[*gb_apu_buf_pos + 1] +=
-							((ch4_lfsr & 0x1) ? ch4_volume : 0);
-					}
-				}
+			if (gb->apu.ch3_wave_pos % 2) {
+				wave = wave & 0xf;
+			} else {
+				wave = wave >> 4;
+			}
 
-				gb_apu_buf[*gb_apu_buf_pos] <<=
-					((mem.map[NR50_ADDR] & VOL_LEFT) >> VOL_LEFT_OFFSET);
+			if (gb->apu.ch3_output_lvl)
+				wave = wave >> (gb->apu.ch3_output_lvl - 1);
+			else
+				wave = wave >> 4;
 
-				gb_apu_buf[*gb_apu_buf_pos + 1] <<=
-					((mem.map[NR50_ADDR] & VOL_RIGHT) >> VOL_RIGHT_OFFSET);
+			if (gb->mem.map[NR51_ADDR] & CH3_LEFT) {
+				gb->apu.buf[*gb->apu.buf_pos] += wave;
+			}
+
+			if (gb->mem.map[NR51_ADDR] & CH3_RIGHT) {
+				gb->apu.buf[*gb->apu.buf_pos + 1] += wave;
 			}
-			*gb_apu_buf_pos += 2;
 		}
+
+		// ch4
+		if ((gb->mem.map[NR52_ADDR] & CH4_ON)) {
+
+			if (gb->mem.map[NR51_ADDR] & CH4_LEFT) {
+				gb->apu.buf[*gb->apu.buf_pos] +=
+					((gb->apu.ch4_lfsr & 0x1) ? gb->apu.ch4_volume : 0);
+			}
+			if (gb->mem.map[NR51_ADDR] & CH4_RIGHT) {
+				gb->apu.buf[*gb->apu.buf_pos + 1] +=
+					((gb->apu.ch4_lfsr & 0x1) ? gb->apu.ch4_volume : 0);
+			}
+		}
+
+		gb->apu.buf[*gb->apu.buf_pos] <<=
+			((gb->mem.map[NR50_ADDR] & VOL_LEFT) >> VOL_LEFT_OFFSET);
+
+		gb->apu.buf[*gb->apu.buf_pos + 1] <<=
+			((gb->mem.map[NR50_ADDR] & VOL_RIGHT) >> VOL_RIGHT_OFFSET);
 	}
+	*gb->apu.buf_pos += 2;
 }
 
-static void gb_apu_set_dac_ch1(uint8_t dac_mask)
+static void gb_apu_set_dac_ch1(gb_t *gb, uint8_t dac_mask)
 {
-	ch1_dac_on = (dac_mask != 0) ? true : false;
-	if (!ch1_dac_on) {
-		mem.map[NR52_ADDR] &= ~CH1_ON;
+	gb->apu.ch1_dac_on = (dac_mask != 0) ? true : false;
+	if (!gb->apu.ch1_dac_on) {
+		gb->mem.map[NR52_ADDR] &= ~CH1_ON;
 	}
 }
 
-static void gb_apu_set_dac_ch2(uint8_t dac_mask)
+static void gb_apu_set_dac_ch2(gb_t *gb, uint8_t dac_mask)
 {
-	ch2_dac_on = (dac_mask != 0) ? true : false;
-	if (!ch2_dac_on) {
-		mem.map[NR52_ADDR] &= ~CH2_ON;
+	gb->apu.ch2_dac_on = (dac_mask != 0) ? true : false;
+	if (!gb->apu.ch2_dac_on) {
+		gb->mem.map[NR52_ADDR] &= ~CH2_ON;
 	}
 }
 
-static void gb_apu_set_dac_ch3(uint8_t dac_mask)
+static void gb_apu_set_dac_ch3(gb_t *gb, uint8_t dac_mask)
 {
-	ch3_dac_on = (dac_mask != 0) ? true : false;
-	if (!ch3_dac_on) {
-		mem.map[NR52_ADDR] &= ~CH3_ON;
+	gb->apu.ch3_dac_on = (dac_mask != 0) ? true : false;
+	if (!gb->apu.ch3_dac_on) {
+		gb->mem.map[NR52_ADDR] &= ~CH3_ON;
 	}
 }
 
-static void gb_apu_set_dac_ch4(uint8_t dac_mask)
+static void gb_apu_set_dac_ch4(gb_t *gb, uint8_t dac_mask)
 {
-	ch4_dac_on = (dac_mask != 0) ? true : false;
-	if (!ch4_dac_on) {
-		mem.map[NR52_ADDR] &= ~CH4_ON;
+	gb->apu.ch4_dac_on = (dac_mask != 0) ? true : false;
+	if (!gb->apu.ch4_dac_on) {
+		gb->mem.map[NR52_ADDR] &= ~CH4_ON;
 	}
 }
 
-static void gb_apu_update_ch1_counter(void)
+static void gb_apu_update_ch1_counter(gb_t *gb)
 {
-	if (ch1_length_counter != 0 && frame_sequence_step % 2 == 0) {
-		ch1_length_counter--;
+	if (gb->apu.ch1_length_counter != 0 && gb->apu.frame_sequence_step % 2 == 0) {
+		gb->apu.ch1_length_counter--;
 	}
 
-	if (ch1_length_counter == 0) {
-		mem.map[NR52_ADDR] &= ~CH1_ON;
+	if (gb->apu.ch1_length_counter == 0) {
+		gb->mem.map[NR52_ADDR] &= ~CH1_ON;
 	}
 }
 
-static void gb_apu_update_ch2_counter(void)
+static void gb_apu_update_ch2_counter(gb_t *gb)
 {
-	if (ch2_length_counter != 0 && frame_sequence_step % 2 == 0) {
-		ch2_length_counter--;
+	if (gb->apu.ch2_length_counter != 0 && gb->apu.frame_sequence_step % 2 == 0) {
+		gb->apu.ch2_length_counter--;
 	}
 
-	if (ch2_length_counter == 0) {
-		mem.map[NR52_ADDR] &= ~CH2_ON;
+	if (gb->apu.ch2_length_counter == 0) {
+		gb->mem.map[NR52_ADDR] &= ~CH2_ON;
 	}
 }
 
-static void gb_apu_update_ch3_counter(void)
+static void gb_apu_update_ch3_counter(gb_t *gb)
 {
-	if (ch3_length_counter != 0 && frame_sequence_step % 2 == 0) {
-		ch3_length_counter--;
+	if (gb->apu.ch3_length_counter != 0 && gb->apu.frame_sequence_step % 2 == 0) {
+		gb->apu.ch3_length_counter--;
 	}
 
-	if (ch3_length_counter == 0) {
-		mem.map[NR52_ADDR] &= ~CH3_ON;
+	if (gb->apu.ch3_length_counter == 0) {
+		gb->mem.map[NR52_ADDR] &= ~CH3_ON;
 	}
 }
 
-static void gb_apu_update_ch4_counter(void)
+static void gb_apu_update_ch4_counter(gb_t *gb)
 {
-	if (ch4_length_counter != 0 && frame_sequence_step % 2 == 0) {
-		ch4_length_counter--;
+	if (gb->apu.ch4_length_counter != 0 && gb->apu.frame_sequence_step % 2 == 0) {
+		gb->apu.ch4_length_counter--;
 	}
 
-	if (ch4_length_counter == 0) {
-		mem.map[NR52_ADDR] &= ~CH4_ON;
+	if (gb->apu.ch4_length_counter == 0) {
+		gb->mem.map[NR52_ADDR] &= ~CH4_ON;
 	}
 }
 
-static void gb_apu_trigger_ch1(void)
+static void gb_apu_trigger_ch1(gb_t *gb)
 {
-	if (ch1_dac_on) {
-		mem.map[NR52_ADDR] |= CH1_ON;
+	if (gb->apu.ch1_dac_on) {
+		gb->mem.map[NR52_ADDR] |= CH1_ON;
 	}
 
-	if (ch1_length_counter == 0) {
-		ch1_length_counter = 64;
-		if (ch1_len_enable && frame_sequence_step % 2 == 0) {
-			ch1_length_counter--;
+	if (gb->apu.ch1_length_counter == 0) {
+		gb->apu.ch1_length_counter = 64;
+		if (gb->apu.ch1_len_enable && gb->apu.frame_sequence_step % 2 == 0) {
+			gb->apu.ch1_length_counter--;
 		}
 	}
 
-	ch1_timer = (2048 - ch1_freq) * 4;
-	ch1_sweep_shadow = ch1_freq;
-	ch1_envelope = ch1_envelope_pace;
-	ch1_volume = ch1_init_vol;
+	gb->apu.ch1_timer = (2048 - gb->apu.ch1_freq) * 4;
+	gb->apu.ch1_sweep_shadow = gb->apu.ch1_freq;
+	gb->apu.ch1_envelope = gb->apu.ch1_envelope_pace;
+	gb->apu.ch1_volume = gb->apu.ch1_init_vol;
 
-	ch1_sweep_timer = ch1_sweep_pace;
+	gb->apu.ch1_sweep_timer = gb->apu.ch1_sweep_pace;
 
-	if (ch1_sweep_pace == 0)
-		ch1_sweep_timer = 8;
+	if (gb->apu.ch1_sweep_pace == 0)
+		gb->apu.ch1_sweep_timer = 8;
 
-	ch1_sweep_negate = 1;
+	gb->apu.ch1_sweep_negate = 1;
 
-	if (ch1_sweep_pace || ch1_sweep_step)
-		ch1_sweep_enable = 1;
+	if (gb->apu.ch1_sweep_pace || gb->apu.ch1_sweep_step)
+		gb->apu.ch1_sweep_enable = 1;
 	else
-		ch1_sweep_enable = 0;
+		gb->apu.ch1_sweep_enable = 0;
 
-	if (ch1_sweep_step) {
+	if (gb->apu.ch1_sweep_step) {
 
-		ch1_sweep_negate = (ch1_sweep_dir) ? -1 : 1;
+		gb->apu.ch1_sweep_negate = (gb->apu.ch1_sweep_dir) ? -1 : 1;
 
-		uint32_t newfreq = ch1_sweep_shadow +
-				   ((ch1_sweep_shadow >> ch1_sweep_step) * ch1_sweep_negate);
+		uint32_t newfreq = gb->apu.ch1_sweep_shadow +
+				   ((gb->apu.ch1_sweep_shadow >> gb->apu.ch1_sweep_step) *
+				    gb->apu.ch1_sweep_negate);
 
 		if (newfreq > 2047) {
-			mem.map[NR52_ADDR] &= ~CH1_ON;
-			ch1_sweep_enable = 0;
+			gb->mem.map[NR52_ADDR] &= ~CH1_ON;
+			gb->apu.ch1_sweep_enable = 0;
 		}
 	}
 }
 
-static void gb_apu_trigger_ch2(void)
+static void gb_apu_trigger_ch2(gb_t *gb)
 {
-	if (ch2_dac_on) {
-		mem.map[NR52_ADDR] |= CH2_ON;
+	if (gb->apu.ch2_dac_on) {
+		gb->mem.map[NR52_ADDR] |= CH2_ON;
 	}
 
-	if (ch2_length_counter == 0) {
-		ch2_length_counter = 64;
-		if (ch2_len_enable && frame_sequence_step % 2 == 0) {
-			ch2_length_counter--;
+	if (gb->apu.ch2_length_counter == 0) {
+		gb->apu.ch2_length_counter = 64;
+		if (gb->apu.ch2_len_enable && gb->apu.frame_sequence_step % 2 == 0) {
+			gb->apu.ch2_length_counter--;
 		}
 	}
 
-	ch2_timer = (2048 - ch2_freq) * 4;
-	ch2_envelope = ch2_envelope_pace;
-	ch2_volume = ch2_init_vol;
+	gb->apu.ch2_timer = (2048 - gb->apu.ch2_freq) * 4;
+	gb->apu.ch2_envelope = gb->apu.ch2_envelope_pace;
+	gb->apu.ch2_volume = gb->apu.ch2_init_vol;
 }
 
-static void gb_apu_trigger_ch3(void)
+static void gb_apu_trigger_ch3(gb_t *gb)
 {
-	if (ch3_dac_on) {
-		mem.map[NR52_ADDR] |= CH3_ON;
+	if (gb->apu.ch3_dac_on) {
+		gb->mem.map[NR52_ADDR] |= CH3_ON;
 	}
 
-	if (ch3_length_counter == 0) {
-		ch3_length_counter = 256;
-		if (ch3_len_enable && frame_sequence_step % 2 == 0) {
-			ch3_length_counter--;
+	if (gb->apu.ch3_length_counter == 0) {
+		gb->apu.ch3_length_counter = 256;
+		if (gb->apu.ch3_len_enable && gb->apu.frame_sequence_step % 2 == 0) {
+			gb->apu.ch3_length_counter--;
 		}
 	}
 
-	if (ch3_timer == 4 && ch3_wave_avail) {
-		if ((ch3_wave_pos >> 1) <= 0x3) {
-			mem.map[WPRAM_BASE + 0x0] = mem.map[WPRAM_BASE + (ch3_wave_pos >> 1)];
-		} else if ((ch3_wave_pos >> 1) <= 0x7) {
-			mem.map[WPRAM_BASE + 0x0] = mem.map[WPRAM_BASE + 0x4];
-			mem.map[WPRAM_BASE + 0x1] = mem.map[WPRAM_BASE + 0x5];
-			mem.map[WPRAM_BASE + 0x2] = mem.map[WPRAM_BASE + 0x6];
-			mem.map[WPRAM_BASE + 0x3] = mem.map[WPRAM_BASE + 0x7];
-		} else if ((ch3_wave_pos >> 1) <= 0xB) {
-			mem.map[WPRAM_BASE + 0x0] = mem.map[WPRAM_BASE + 0x8];
-			mem.map[WPRAM_BASE + 0x1] = mem.map[WPRAM_BASE + 0x9];
-			mem.map[WPRAM_BASE + 0x2] = mem.map[WPRAM_BASE + 0xA];
-			mem.map[WPRAM_BASE + 0x3] = mem.map[WPRAM_BASE + 0xB];
-		} else if ((ch3_wave_pos >> 1) <= 0xF) {
-			mem.map[WPRAM_BASE + 0x0] = mem.map[WPRAM_BASE + 0xC];
-			mem.map[WPRAM_BASE + 0x1] = mem.map[WPRAM_BASE + 0xD];
-			mem.map[WPRAM_BASE + 0x2] = mem.map[WPRAM_BASE + 0xE];
-			mem.map[WPRAM_BASE + 0x3] = mem.map[WPRAM_BASE + 0xF];
+	if (gb->apu.ch3_timer == 4 && gb->apu.ch3_wave_avail) {
+		if ((gb->apu.ch3_wave_pos >> 1) <= 0x3) {
+			gb->mem.map[WPRAM_BASE + 0x0] =
+				gb->mem.map[WPRAM_BASE + (gb->apu.ch3_wave_pos >> 1)];
+		} else if ((gb->apu.ch3_wave_pos >> 1) <= 0x7) {
+			gb->mem.map[WPRAM_BASE + 0x0] = gb->mem.map[WPRAM_BASE + 0x4];
+			gb->mem.map[WPRAM_BASE + 0x1] = gb->mem.map[WPRAM_BASE + 0x5];
+			gb->mem.map[WPRAM_BASE + 0x2] = gb->mem.map[WPRAM_BASE + 0x6];
+			gb->mem.map[WPRAM_BASE + 0x3] = gb->mem.map[WPRAM_BASE + 0x7];
+		} else if ((gb->apu.ch3_wave_pos >> 1) <= 0xB) {
+			gb->mem.map[WPRAM_BASE + 0x0] = gb->mem.map[WPRAM_BASE + 0x8];
+			gb->mem.map[WPRAM_BASE + 0x1] = gb->mem.map[WPRAM_BASE + 0x9];
+			gb->mem.map[WPRAM_BASE + 0x2] = gb->mem.map[WPRAM_BASE + 0xA];
+			gb->mem.map[WPRAM_BASE + 0x3] = gb->mem.map[WPRAM_BASE + 0xB];
+		} else if ((gb->apu.ch3_wave_pos >> 1) <= 0xF) {
+			gb->mem.map[WPRAM_BASE + 0x0] = gb->mem.map[WPRAM_BASE + 0xC];
+			gb->mem.map[WPRAM_BASE + 0x1] = gb->mem.map[WPRAM_BASE + 0xD];
+			gb->mem.map[WPRAM_BASE + 0x2] = gb->mem.map[WPRAM_BASE + 0xE];
+			gb->mem.map[WPRAM_BASE + 0x3] = gb->mem.map[WPRAM_BASE + 0xF];
 		}
 	}
 
-	ch3_timer = (2048 - ch3_freq) * 2;
-	ch3_timer += 4;
-	ch3_wave_pos = 0;
-	ch3_wave_avail = false;
+	gb->apu.ch3_timer = (2048 - gb->apu.ch3_freq) * 2;
+	gb->apu.ch3_timer += 4;
+	gb->apu.ch3_wave_pos = 0;
+	gb->apu.ch3_wave_avail = false;
 }
 
-static void gb_apu_trigger_ch4(void)
+static void gb_apu_trigger_ch4(gb_t *gb)
 {
-	if (ch4_dac_on) {
-		mem.map[NR52_ADDR] |= CH4_ON;
+	if (gb->apu.ch4_dac_on) {
+		gb->mem.map[NR52_ADDR] |= CH4_ON;
 	}
 
-	if (ch4_length_counter == 0) {
-		ch4_length_counter = 64;
-		if (ch4_len_enable && frame_sequence_step % 2 == 0) {
-			ch4_length_counter--;
+	if (gb->apu.ch4_length_counter == 0) {
+		gb->apu.ch4_length_counter = 64;
+		if (gb->apu.ch4_len_enable && gb->apu.frame_sequence_step % 2 == 0) {
+			gb->apu.ch4_length_counter--;
 		}
 	}
 
-	ch4_timer = ch4_divisor[ch4_clock_div] << ch4_clock_shift;
-	ch4_lfsr = 0x7fff;
-	ch4_envelope = ch4_envelope_pace;
-	ch4_volume = ch4_init_vol;
+	gb->apu.ch4_timer = ch4_divisor[gb->apu.ch4_clock_div] << gb->apu.ch4_clock_shift;
+	gb->apu.ch4_lfsr = 0x7fff;
+	gb->apu.ch4_envelope = gb->apu.ch4_envelope_pace;
+	gb->apu.ch4_volume = gb->apu.ch4_init_vol;
 }
 
-void gb_apu_reset(void)
+static void gb_apu_reset(gb_t *gb)
 {
-	ch1_sweep_pace = 0;
-	ch1_sweep_dir = 0;
-	ch1_sweep_step = 0;
-	ch1_sweep_enable = 0;
-	ch1_sweep_timer = 0;
-	ch1_sweep_shadow = 0;
-	ch1_sweep_negate = 0;
-	ch1_wave_duty = 0;
-	ch1_duty_pos = 0;
-	ch1_init_vol = 0;
-	ch1_envelope_dir = 0;
-	ch1_envelope_pace = 0;
-	ch1_dac_on = false;
-	ch1_volume = 0;
-	ch1_envelope = 0;
-	ch1_freq = 0;
-	ch1_timer = 0;
-	ch1_len_enable = 0;
-
-	ch2_wave_duty = 0;
-	ch2_duty_pos = 0;
-	ch2_init_vol = 0;
-	ch2_envelope_dir = 0;
-	ch2_envelope_pace = 0;
-	ch2_dac_on = false;
-	ch2_volume = 0;
-	ch2_envelope = 0;
-	ch2_freq = 0;
-	ch2_timer = 0;
-	ch2_len_enable = 0;
-
-	ch3_dac_on = false;
-	ch3_wave_pos = 0;
-	ch3_output_lvl = 0;
-	ch3_volume = 0;
-	ch3_envelope = 0;
-	ch3_freq = 0;
-	ch3_timer = 0;
-	ch3_wave_avail = false;
-	ch3_len_enable = 0;
-
-	ch4_init_vol = 0;
-	ch4_envelope_dir = 0;
-	ch4_envelope_pace = 0;
-	ch4_dac_on = false;
-	ch4_volume = 0;
-	ch4_envelope = 0;
-	ch4_clock_shift = 0;
-	ch4_lfsr_width = 0;
-	ch4_clock_div = 0;
-	ch4_timer = 0;
-	ch4_lfsr = 0;
-	ch4_len_enable = 0;
+	gb->apu.ch1_sweep_pace = 0;
+	gb->apu.ch1_sweep_dir = 0;
+	gb->apu.ch1_sweep_step = 0;
+	gb->apu.ch1_sweep_enable = 0;
+	gb->apu.ch1_sweep_timer = 0;
+	gb->apu.ch1_sweep_shadow = 0;
+	gb->apu.ch1_sweep_negate = 0;
+	gb->apu.ch1_wave_duty = 0;
+	gb->apu.ch1_duty_pos = 0;
+	gb->apu.ch1_init_vol = 0;
+	gb->apu.ch1_envelope_dir = 0;
+	gb->apu.ch1_envelope_pace = 0;
+	gb->apu.ch1_dac_on = false;
+	gb->apu.ch1_volume = 0;
+	gb->apu.ch1_envelope = 0;
+	gb->apu.ch1_freq = 0;
+	gb->apu.ch1_timer = 0;
+	gb->apu.ch1_len_enable = 0;
+
+	gb->apu.ch2_wave_duty = 0;
+	gb->apu.ch2_duty_pos = 0;
+	gb->apu.ch2_init_vol = 0;
+	gb->apu.ch2_envelope_dir = 0;
+	gb->apu.ch2_envelope_pace = 0;
+	gb->apu.ch2_dac_on = false;
+	gb->apu.ch2_volume = 0;
+	gb->apu.ch2_envelope = 0;
+	gb->apu.ch2_freq = 0;
+	gb->apu.ch2_timer = 0;
+	gb->apu.ch2_len_enable = 0;
+
+	gb->apu.ch3_dac_on = false;
+	gb->apu.ch3_wave_pos = 0;
+	gb->apu.ch3_output_lvl = 0;
+	gb->apu.ch3_volume = 0;
+	gb->apu.ch3_envelope = 0;
+	gb->apu.ch3_freq = 0;
+	gb->apu.ch3_timer = 0;
+	gb->apu.ch3_wave_avail = false;
+	gb->apu.ch3_len_enable = 0;
+
+	gb->apu.ch4_init_vol = 0;
+	gb->apu.ch4_envelope_dir = 0;
+	gb->apu.ch4_envelope_pace = 0;
+	gb->apu.ch4_dac_on = false;
+	gb->apu.ch4_volume = 0;
+	gb->apu.ch4_envelope = 0;
+	gb->apu.ch4_clock_shift = 0;
+	gb->apu.ch4_lfsr_width = 0;
+	gb->apu.ch4_clock_div = 0;
+	gb->apu.ch4_timer = 0;
+	gb->apu.ch4_lfsr = 0;
+	gb->apu.ch4_len_enable = 0;
 
 	// ch1_length_counter = 0;
 	// ch2_length_counter = 0;
@@ -684,55 +666,57 @@ void gb_apu_reset(void)
 	// ch4_length_counter = 0;
 }
 
-uint8_t gb_apu_memory_read(uint16_t address)
+uint8_t gb_apu_memory_read(gb_t *gb, uint16_t address)
 {
+	gb_apu_sync(gb);
+
 	switch (address) {
 	case NR10_ADDR:
-		return 0x80 | mem.map[address];
+		return 0x80 | gb->mem.map[address];
 	case NR11_ADDR:
-		return 0x3F | mem.map[address];
+		return 0x3F | gb->mem.map[address];
 	case NR12_ADDR:
-		return 0x00 | mem.map[address];
+		return 0x00 | gb->mem.map[address];
 	case NR13_ADDR:
-		return 0xFF | mem.map[address];
+		return 0xFF | gb->mem.map[address];
 	case NR14_ADDR:
-		return 0xBF | mem.map[address];
+		return 0xBF | gb->mem.map[address];
 	case NR20_ADDR:
-		return 0xFF | mem.map[address];
+		return 0xFF | gb->mem.map[address];
 	case NR21_ADDR:
-		return 0x3F | mem.map[address];
+		return 0x3F | gb->mem.map[address];
 	case NR22_ADDR:
-		return 0x00 | mem.map[address];
+		return 0x00 | gb->mem.map[address];
 	case NR23_ADDR:
-		return 0xFF | mem.map[address];
+		return 0xFF | gb->mem.map[address];
 	case NR24_ADDR:
-		return 0xBF | mem.map[address];
+		return 0xBF | gb->mem.map[address];
 	case NR30_ADDR:
-		return 0x7F | mem.map[address];
+		return 0x7F | gb->mem.map[address];
 	case NR31_ADDR:
-		return 0xFF | mem.map[address];
+		return 0xFF | gb->mem.map[address];
 	case NR32_ADDR:
-		return 0x9F | mem.map[address];
+		return 0x9F | gb->mem.map[address];
 	case NR33_ADDR:
-		return 0xFF | mem.map[address];
+		return 0xFF | gb->mem.map[address];
 	case NR34_ADDR:
-		return 0xBF | mem.map[address];
+		return 0xBF | gb->mem.map[address];
 	case NR40_ADDR:
-		return 0xFF | mem.map[address];
+		return 0xFF | gb->mem.map[address];
 	case NR41_ADDR:
-		return 0xFF | mem.map[address];
+		return 0xFF | gb->mem.map[address];
 	case NR42_ADDR:
-		return 0x00 | mem.map[address];
+		return 0x00 | gb->mem.map[address];
 	case NR43_ADDR:
-		return 0x00 | mem.map[address];
+		return 0x00 | gb->mem.map[address];
 	case NR44_ADDR:
-		return 0xBF | mem.map[address];
+		return 0xBF | gb->mem.map[address];
 	case NR50_ADDR:
-		return 0x00 | mem.map[address];
+		return 0x00 | gb->mem.map[address];
 	case NR51_ADDR:
-		return 0x00 | mem.map[address];
+		return 0x00 | gb->mem.map[address];
 	case NR52_ADDR:
-		return 0x70 | mem.map[address];
+		return 0x70 | gb->mem.map[address];
 	case 0XFF27:
 	case 0XFF28:
 	case 0XFF29:
@@ -742,7 +726,7 @@ uint8_t gb_apu_memory_read(uint16_t address)
 	case 0XFF2D:
 	case 0XFF2E:
 	case 0XFF2F:
-		return 0xFF | mem.map[address];
+		return 0xFF | gb->mem.map[address];
 	case WPRAM_BASE + 0x0:
 	case WPRAM_BASE + 0x1:
 	case WPRAM_BASE + 0x2:
@@ -759,191 +743,215 @@ uint8_t gb_apu_memory_read(uint16_t address)
 	case WPRAM_BASE + 0xD:
 	case WPRAM_BASE + 0xE:
 	case WPRAM_BASE + 0xF:
-		if ((mem.map[NR52_ADDR] & CH3_ON)) {
-			if (ch3_timer == 2 && ch3_wave_avail) {
-				return mem.map[WPRAM_BASE + (ch3_wave_pos >> 1)];
+		if ((gb->mem.map[NR52_ADDR] & CH3_ON)) {
+			if (gb->apu.ch3_timer == 2 && gb->apu.ch3_wave_avail) {
+				return gb->mem.map[WPRAM_BASE + (gb->apu.ch3_wave_pos >> 1)];
 			} else {
 				return 0xFF;
 			}
 
 		} else {
-			return 0x00 | mem.map[address];
+			return 0x00 | gb->mem.map[address];
 		}
 	default:
-		return mem.map[address];
+		return gb->mem.map[address];
 	}
 }
 
-void gb_apu_memory_write(uint16_t address, uint8_t data)
+void gb_apu_memory_write(gb_t *gb, uint16_t address, uint8_t data)
 {
+	gb_apu_sync(gb);
+
 	if (address >= NR10_ADDR && address < WPRAM_BASE) {
-		bool apu_power = CHK_BIT(mem.map[NR52_ADDR], AUDIO_ON_OFFSET);
+		bool apu_power = CHK_BIT(gb->mem.map[NR52_ADDR], AUDIO_ON_OFFSET);
 
 		switch (address) {
 
 		case NR10_ADDR:
-			ch1_sweep_pace = (data & CH1_SWEEP_PACE) >> CH1_SWEEP_PACE_OFFSET;
-			ch1_sweep_dir = (data & CH1_SWEEP_DIR) >> CH1_SWEEP_DIR_OFFSET;
-			ch1_sweep_step = (data & CH1_SWEEP_STEP) >> CH1_SWEEP_STEP_OFFSET;
+			gb->apu.ch1_sweep_pace = (data & CH1_SWEEP_PACE) >> CH1_SWEEP_PACE_OFFSET;
+			gb->apu.ch1_sweep_dir = (data & CH1_SWEEP_DIR) >> CH1_SWEEP_DIR_OFFSET;
+			gb->apu.ch1_sweep_step = (data & CH1_SWEEP_STEP) >> CH1_SWEEP_STEP_OFFSET;
 			if (apu_power) {
-				if (ch1_sweep_negate == -1 && !ch1_sweep_dir) {
-					mem.map[NR52_ADDR] &= ~CH1_ON;
+				if (gb->apu.ch1_sweep_negate == -1 && !gb->apu.ch1_sweep_dir) {
+					gb->mem.map[NR52_ADDR] &= ~CH1_ON;
 				}
-				mem.map[address] = data;
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR11_ADDR:
-			ch1_wave_duty = (data & CH1_WAVE_DUTY) >> CH1_WAVE_DUTY_OFFSET;
-			ch1_length_counter = 64 - (data & CH1_INITIAL_LEN_TIMER);
-			mem.map[address] = (apu_power) ? data : data & CH1_INITIAL_LEN_TIMER;
+			gb->apu.ch1_wave_duty = (data & CH1_WAVE_DUTY) >> CH1_WAVE_DUTY_OFFSET;
+			gb->apu.ch1_length_counter = 64 - (data & CH1_INITIAL_LEN_TIMER);
+			gb->mem.map[address] = (apu_power) ? data : data & CH1_INITIAL_LEN_TIMER;
 			return;
 
 		case NR12_ADDR:
 			if (apu_power) {
-				ch1_init_vol = (data & CH1_INITIAL_VOL) >> CH1_INITIAL_VOL_OFFSET;
-				ch1_envelope_dir = (data & CH1_ENV_DIR) >> CH1_ENV_DIR_OFFSET;
-				ch1_envelope_pace = (data & CH1_ENV_PACE) >> CH1_ENV_PACE_OFFSET;
-				gb_apu_set_dac_ch1(data & (CH1_ENV_DIR + CH1_INITIAL_VOL));
-				mem.map[address] = data;
+				gb->apu.ch1_init_vol =
+					(data & CH1_INITIAL_VOL) >> CH1_INITIAL_VOL_OFFSET;
+				gb->apu.ch1_envelope_dir =
+					(data & CH1_ENV_DIR) >> CH1_ENV_DIR_OFFSET;
+				gb->apu.ch1_envelope_pace =
+					(data & CH1_ENV_PACE) >> CH1_ENV_PACE_OFFSET;
+				gb_apu_set_dac_ch1(gb, data & (CH1_ENV_DIR + CH1_INITIAL_VOL));
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR13_ADDR:
 			if (apu_power) {
-				ch1_freq = (ch1_freq & ~0x00FF) | (data & CH1_PERIOD_LOW);
-				mem.map[address] = data;
+				gb->apu.ch1_freq =
+					(gb->apu.ch1_freq & ~0x00FF) | (data & CH1_PERIOD_LOW);
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR14_ADDR:
 			if (apu_power) {
-				bool ch1_len_on = !ch1_len_enable && (data & CH1_LEN_EN);
-				ch1_len_enable = (data & CH1_LEN_EN) >> CH1_LEN_EN_OFFSET;
-				ch1_freq = (ch1_freq & ~0xFF00) | ((data & CH1_PERIOD_HIGH) << 8);
+				bool ch1_len_on =
+					!gb->apu.ch1_len_enable && (data & CH1_LEN_EN);
+				gb->apu.ch1_len_enable = (data & CH1_LEN_EN) >> CH1_LEN_EN_OFFSET;
+				gb->apu.ch1_freq = (gb->apu.ch1_freq & ~0xFF00) |
+						   ((data & CH1_PERIOD_HIGH) << 8);
 				if (ch1_len_on) {
-					gb_apu_update_ch1_counter();
+					gb_apu_update_ch1_counter(gb);
 				}
 				if (CHK_BIT(data, 7)) {
-					gb_apu_trigger_ch1();
+					gb_apu_trigger_ch1(gb);
 				}
-				mem.map[address] = data;
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR21_ADDR:
-			ch2_wave_duty = (data & CH2_WAVE_DUTY) >> CH2_WAVE_DUTY_OFFSET;
-			ch2_length_counter = 64 - (data & CH2_INITIAL_LEN_TIMER);
-			mem.map[address] = (apu_power) ? data : data & CH2_INITIAL_LEN_TIMER;
+			gb->apu.ch2_wave_duty = (data & CH2_WAVE_DUTY) >> CH2_WAVE_DUTY_OFFSET;
+			gb->apu.ch2_length_counter = 64 - (data & CH2_INITIAL_LEN_TIMER);
+			gb->mem.map[address] = (apu_power) ? data : data & CH2_INITIAL_LEN_TIMER;
 			return;
 
 		case NR22_ADDR:
 			if (apu_power) {
-				ch2_init_vol = (data & CH2_INITIAL_VOL) >> CH2_INITIAL_VOL_OFFSET;
-				ch2_envelope_dir = (data & CH2_ENV_DIR) >> CH2_ENV_DIR_OFFSET;
-				ch2_envelope_pace = (data & CH2_ENV_PACE) >> CH2_ENV_PACE_OFFSET;
-				gb_apu_set_dac_ch2(data & (CH2_ENV_DIR + CH2_INITIAL_VOL));
-				mem.map[address] = data;
+				gb->apu.ch2_init_vol =
+					(data & CH2_INITIAL_VOL) >> CH2_INITIAL_VOL_OFFSET;
+				gb->apu.ch2_envelope_dir =
+					(data & CH2_ENV_DIR) >> CH2_ENV_DIR_OFFSET;
+				gb->apu.ch2_envelope_pace =
+					(data & CH2_ENV_PACE) >> CH2_ENV_PACE_OFFSET;
+				gb_apu_set_dac_ch2(gb, data & (CH2_ENV_DIR + CH2_INITIAL_VOL));
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR23_ADDR:
 			if (apu_power) {
-				ch2_freq = (ch2_freq & ~0x00FF) | (data & CH2_PERIOD_LOW);
-				mem.map[address] = data;
+				gb->apu.ch2_freq =
+					(gb->apu.ch2_freq & ~0x00FF) | (data & CH2_PERIOD_LOW);
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR24_ADDR:
 			if (apu_power) {
-				bool ch2_len_on = !ch2_len_enable && (data & CH2_LEN_EN);
-				ch2_len_enable = (data & CH2_LEN_EN) >> CH2_LEN_EN_OFFSET;
-				ch2_freq = (ch2_freq & ~0xFF00) | ((data & CH2_PERIOD_HIGH) << 8);
+				bool ch2_len_on =
+					!gb->apu.ch2_len_enable && (data & CH2_LEN_EN);
+				gb->apu.ch2_len_enable = (data & CH2_LEN_EN) >> CH2_LEN_EN_OFFSET;
+				gb->apu.ch2_freq = (gb->apu.ch2_freq & ~0xFF00) |
+						   ((data & CH2_PERIOD_HIGH) << 8);
 				if (ch2_len_on) {
-					gb_apu_update_ch2_counter();
+					gb_apu_update_ch2_counter(gb);
 				}
 				if (CHK_BIT(data, 7)) {
-					gb_apu_trigger_ch2();
+					gb_apu_trigger_ch2(gb);
 				}
-				mem.map[address] = data;
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR30_ADDR:
 			if (apu_power) {
-				gb_apu_set_dac_ch3(data & CH3_DAC_ON);
-				mem.map[address] = data;
+				gb_apu_set_dac_ch3(gb, data & CH3_DAC_ON);
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR31_ADDR:
-			ch3_length_counter = 256 - (data & CH3_INITIAL_LEN_TIMER);
-			mem.map[address] = data;
+			gb->apu.ch3_length_counter = 256 - (data & CH3_INITIAL_LEN_TIMER);
+			gb->mem.map[address] = data;
 			return;
 
 		case NR32_ADDR:
 			if (apu_power) {
-				ch3_output_lvl = (data & CH3_OUTPUT_LVL) >> CH3_OUTPUT_LVL_OFFSET;
-				mem.map[address] = data;
+				gb->apu.ch3_output_lvl =
+					(data & CH3_OUTPUT_LVL) >> CH3_OUTPUT_LVL_OFFSET;
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR33_ADDR:
 			if (apu_power) {
-				ch3_freq = (ch3_freq & ~0x00FF) | (data & CH3_PERIOD_LOW);
-				mem.map[address] = data;
+				gb->apu.ch3_freq =
+					(gb->apu.ch3_freq & ~0x00FF) | (data & CH3_PERIOD_LOW);
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR34_ADDR:
 			if (apu_power) {
-				bool ch3_len_on = !ch3_len_enable && (data & CH3_LEN_EN);
-				ch3_len_enable = (data & CH3_LEN_EN) >> CH3_LEN_EN_OFFSET;
-				ch3_freq = (ch3_freq & ~0xFF00) | ((data & CH3_PERIOD_HIGH) << 8);
+				bool ch3_len_on =
+					!gb->apu.ch3_len_enable && (data & CH3_LEN_EN);
+				gb->apu.ch3_len_enable = (data & CH3_LEN_EN) >> CH3_LEN_EN_OFFSET;
+				gb->apu.ch3_freq = (gb->apu.ch3_freq & ~0xFF00) |
+						   ((data & CH3_PERIOD_HIGH) << 8);
 				if (ch3_len_on) {
-					gb_apu_update_ch3_counter();
+					gb_apu_update_ch3_counter(gb);
 				}
 				if (CHK_BIT(data, 7)) {
-					gb_apu_trigger_ch3();
+					gb_apu_trigger_ch3(gb);
 				}
-				mem.map[address] = data;
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR41_ADDR:
-			ch4_length_counter = 64 - (data & CH4_INITIAL_LEN_TIMER);
-			mem.map[address] = data;
+			gb->apu.ch4_length_counter = 64 - (data & CH4_INITIAL_LEN_TIMER);
+			gb->mem.map[address] = data;
 			return;
 
 		case NR42_ADDR:
 			if (apu_power) {
-				ch4_init_vol = (data & CH4_INITIAL_VOL) >> CH4_INITIAL_VOL_OFFSET;
-				ch4_envelope_dir = (data & CH4_ENV_DIR) >> CH4_ENV_DIR_OFFSET;
-				ch4_envelope_pace = (data & CH4_ENV_PACE) >> CH4_ENV_PACE_OFFSET;
-				gb_apu_set_dac_ch4(data & (CH4_ENV_DIR + CH4_INITIAL_VOL));
-				mem.map[address] = data;
+				gb->apu.ch4_init_vol =
+					(data & CH4_INITIAL_VOL) >> CH4_INITIAL_VOL_OFFSET;
+				gb->apu.ch4_envelope_dir =
+					(data & CH4_ENV_DIR) >> CH4_ENV_DIR_OFFSET;
+				gb->apu.ch4_envelope_pace =
+					(data & CH4_ENV_PACE) >> CH4_ENV_PACE_OFFSET;
+				gb_apu_set_dac_ch4(gb, data & (CH4_ENV_DIR + CH4_INITIAL_VOL));
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR43_ADDR:
 			if (apu_power) {
-				ch4_clock_shift = (data & CH4_CLK_SHIFT) >> CH4_CLK_SHIFT_OFFSET;
-				ch4_lfsr_width = (data & CH4_LFSR_WIDTH) >> CH4_LFSR_WIDTH_OFFSET;
-				ch4_clock_div = (data & CH4_CLK_DIV) >> CH4_CLK_DIV_OFFSET;
-				mem.map[address] = data;
+				gb->apu.ch4_clock_shift =
+					(data & CH4_CLK_SHIFT) >> CH4_CLK_SHIFT_OFFSET;
+				gb->apu.ch4_lfsr_width =
+					(data & CH4_LFSR_WIDTH) >> CH4_LFSR_WIDTH_OFFSET;
+				gb->apu.ch4_clock_div = (data & CH4_CLK_DIV) >> CH4_CLK_DIV_OFFSET;
+				gb->mem.map[address] = data;
 			}
 			return;
 
 		case NR44_ADDR:
 			if (apu_power) {
-				bool ch4_len_on = !ch4_len_enable && (data & CH4_LEN_EN);
-				ch4_len_enable = (data & CH4_LEN_EN) >> CH4_LEN_EN_OFFSET;
-				mem.map[address] = data;
+				bool ch4_len_on =
+					!gb->apu.ch4_len_enable && (data & CH4_LEN_EN);
+				gb->apu.ch4_len_enable = (data & CH4_LEN_EN) >> CH4_LEN_EN_OFFSET;
+				gb->mem.map[address] = data;
 				if (ch4_len_on) {
-					gb_apu_update_ch4_counter();
+					gb_apu_update_ch4_counter(gb);
 				}
 				if (CHK_BIT(data, 7)) {
-					gb_apu_trigger_ch4();
+					gb_apu_trigger_ch4(gb);
 				}
 			}
 			return;
@@ -952,32 +960,32 @@ void gb_apu_memory_write(uint16_t address, uint8_t data)
 			bool apu_power_on = CHK_BIT(data, AUDIO_ON_OFFSET) && !apu_power;
 			bool apu_power_off = !CHK_BIT(data, AUDIO_ON_OFFSET) && apu_power;
 			if (apu_power_on) {
-				frame_sequence_step = 7;
-				mem.map[address] |= AUDIO_ON;
+				gb->apu.frame_sequence_step = 7;
+				gb->mem.map[address] |= AUDIO_ON;
 			} else if (apu_power_off) {
-				memset(&mem.map[NR10_ADDR], 0x00, (NR52_ADDR - NR10_ADDR) + 1);
-				gb_apu_reset();
+				memset(&gb->mem.map[NR10_ADDR], 0x00, (NR52_ADDR - NR10_ADDR) + 1);
+				gb_apu_reset(gb);
 			}
 			return;
 
 		default:
 			if (apu_power) {
-				mem.map[address] = data;
+				gb->mem.map[address] = data;
 			}
 			return;
 		}
 
 	} else if (address >= WPRAM_BASE && address < LCDC_ADDR) {
-		if ((mem.map[NR52_ADDR] & CH3_ON)) {
-			if (ch3_timer == 2 && ch3_wave_avail) {
-				mem.map[WPRAM_BASE + (ch3_wave_pos >> 1)] = data;
+		if ((gb->mem.map[NR52_ADDR] & CH3_ON)) {
+			if (gb->apu.ch3_timer == 2 && gb->apu.ch3_wave_avail) {
+				gb->mem.map[WPRAM_BASE + (gb->apu.ch3_wave_pos >> 1)] = data;
 				return;
 			} else {
 				return;
 			}
 
 		} else {
-			mem.map[address] = data;
+			gb->mem.map[address] = data;
 			return;
 		}
 	}
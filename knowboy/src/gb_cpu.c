@@ -8,4161 +8,3161 @@
  * @date 2021-03-28
  */
 
+#include "gb_cpu_bulk.h"
+#include "gb_cpu_cache.h"
 #include "gb_cpu_priv.h"
+#include "gb_jit.h"
 #include "gb_memory.h"
+#include "gb_ppu.h"
+#include "gb_priv.h"
+#include "gb_sched.h"
 #include "logging.h"
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
-/* Private variables ---------------------------------------------------------*/
-static uint8_t stopped = 0;
-static uint8_t halted = 0;
-static uint8_t interrupt_master_enable = 0;
-static uint8_t one_cycle_interrupt_delay = 0;
-static uint8_t op_remaining = 0;
-static int interupt_dur = 0;
-static uint8_t opcode = 0;
-static uint8_t current_cycle = 0;
-static bool dont_update_pc = false;
-extern memory_t mem;
-
-/* Game Boy CPU instruction set */
-gb_instr_t instructions[256] = {{gb_cpu_NOP, {1, 1, 1}},
-				{gb_cpu_LOAD_BC_d16, {3, 3, 1}},
-				{gb_cpu_LOAD_BC_A, {1, 2, 1}},
-				{gb_cpu_INC_BC, {1, 2, 1}},
-				{gb_cpu_INC_B, {1, 1, 1}},
-				{gb_cpu_DEC_B, {1, 1, 1}},
-				{gb_cpu_LOAD_B_d8, {2, 2, 1}},
-				{gb_cpu_RLCA, {1, 1, 1}},
-				{gb_cpu_LOAD_a16_SP, {3, 5, 1}},
-				{gb_cpu_ADD_HL_BC, {1, 2, 1}},
-				{gb_cpu_LOAD_A_BC, {1, 2, 1}},
-				{gb_cpu_DEC_BC, {1, 2, 1}},
-				{gb_cpu_INC_C, {1, 1, 1}},
-				{gb_cpu_DEC_C, {1, 1, 1}},
-				{gb_cpu_LOAD_C_d8, {2, 2, 1}},
-				{gb_cpu_RRCA, {1, 1, 1}},
-				{gb_cpu_STOP, {2, 1, 1}},
-				{gb_cpu_LOAD_DE_d16, {3, 3, 1}},
-				{gb_cpu_LOAD_DE_A, {1, 2, 1}},
-				{gb_cpu_INC_DE, {1, 2, 1}},
-				{gb_cpu_INC_D, {1, 1, 1}},
-				{gb_cpu_DEC_D, {1, 1, 1}},
-				{gb_cpu_LOAD_D_d8, {2, 2, 1}},
-				{gb_cpu_RLA, {1, 1, 1}},
-				{gb_cpu_JR_r8, {2, 3, 3}},
-				{gb_cpu_ADD_HL_DE, {1, 2, 1}},
-				{gb_cpu_LOAD_A_DE, {1, 2, 1}},
-				{gb_cpu_DEC_DE, {1, 2, 1}},
-				{gb_cpu_INC_E, {1, 1, 1}},
-				{gb_cpu_DEC_E, {1, 1, 1}},
-				{gb_cpu_LOAD_E_d8, {2, 2, 1}},
-				{gb_cpu_RRA, {1, 1, 1}},
-				{gb_cpu_JR_NZ_r8, {2, CUSTOM_TIMING, 1}},
-				{gb_cpu_LOAD_HL_d16, {3, 3, 1}},
-				{gb_cpu_LOAD_HLI_A, {1, 2, 1}},
-				{gb_cpu_INC_HL, {1, 2, 1}},
-				{gb_cpu_INC_H, {1, 1, 1}},
-				{gb_cpu_DEC_H, {1, 1, 1}},
-				{gb_cpu_LOAD_H_d8, {2, 2, 1}},
-				{gb_cpu_DAA, {1, 1, 1}},
-				{gb_cpu_JR_Z_r8, {2, CUSTOM_TIMING, 1}},
-				{gb_cpu_ADD_HL_HL, {1, 2, 1}},
-				{gb_cpu_LOAD_A_HLI, {1, 2, 1}},
-				{gb_cpu_DEC_HL, {1, 2, 1}},
-				{gb_cpu_INC_L, {1, 1, 1}},
-				{gb_cpu_DEC_L, {1, 1, 1}},
-				{gb_cpu_LOAD_L_d8, {2, 2, 1}},
-				{gb_cpu_CPL, {1, 1, 1}},
-				{gb_cpu_JR_NC_r8, {2, CUSTOM_TIMING, 1}},
-				{gb_cpu_LOAD_SP_d16, {3, 3, 1}},
-				{gb_cpu_LOAD_HLD_A, {1, 2, 1}},
-				{gb_cpu_INC_SP, {1, 2, 1}},
-				{gb_cpu_INC_HL_ADDR, {1, 3, CUSTOM_TIMING}},
-				{gb_cpu_DEC_HL_ADDR, {1, 3, CUSTOM_TIMING}},
-				{gb_cpu_LOAD_HL_d8, {2, 3, 2}},
-				{gb_cpu_SCF, {1, 1, 1}},
-				{gb_cpu_JR_C_r8, {2, CUSTOM_TIMING, 1}},
-				{gb_cpu_ADD_HL_SP, {1, 2, 1}},
-				{gb_cpu_LOAD_A_HLD, {1, 2, 1}},
-				{gb_cpu_DEC_SP, {1, 2, 1}},
-				{gb_cpu_INC_A, {1, 1, 1}},
-				{gb_cpu_DEC_A, {1, 1, 1}},
-				{gb_cpu_LOAD_A_d8, {2, 2, 1}},
-				{gb_cpu_CCF, {1, 1, 1}},
-				{gb_cpu_LOAD_B_B, {1, 1, 1}},
-				{gb_cpu_LOAD_B_C, {1, 1, 1}},
-				{gb_cpu_LOAD_B_D, {1, 1, 1}},
-				{gb_cpu_LOAD_B_E, {1, 1, 1}},
-				{gb_cpu_LOAD_B_H, {1, 1, 1}},
-				{gb_cpu_LOAD_B_L, {1, 1, 1}},
-				{gb_cpu_LOAD_B_HL, {1, 2, 1}},
-				{gb_cpu_LOAD_B_A, {1, 1, 1}},
-				{gb_cpu_LOAD_C_B, {1, 1, 1}},
-				{gb_cpu_LOAD_C_C, {1, 1, 1}},
-				{gb_cpu_LOAD_C_D, {1, 1, 1}},
-				{gb_cpu_LOAD_C_E, {1, 1, 1}},
-				{gb_cpu_LOAD_C_H, {1, 1, 1}},
-				{gb_cpu_LOAD_C_L, {1, 1, 1}},
-				{gb_cpu_LOAD_C_HL, {1, 2, 1}},
-				{gb_cpu_LOAD_C_A, {1, 1, 1}},
-				{gb_cpu_LOAD_D_B, {1, 1, 1}},
-				{gb_cpu_LOAD_D_C, {1, 1, 1}},
-				{gb_cpu_LOAD_D_D, {1, 1, 1}},
-				{gb_cpu_LOAD_D_E, {1, 1, 1}},
-				{gb_cpu_LOAD_D_H, {1, 1, 1}},
-				{gb_cpu_LOAD_D_L, {1, 1, 1}},
-				{gb_cpu_LOAD_D_HL, {1, 2, 1}},
-				{gb_cpu_LOAD_D_A, {1, 1, 1}},
-				{gb_cpu_LOAD_E_B, {1, 1, 1}},
-				{gb_cpu_LOAD_E_C, {1, 1, 1}},
-				{gb_cpu_LOAD_E_D, {1, 1, 1}},
-				{gb_cpu_LOAD_E_E, {1, 1, 1}},
-				{gb_cpu_LOAD_E_H, {1, 1, 1}},
-				{gb_cpu_LOAD_E_L, {1, 1, 1}},
-				{gb_cpu_LOAD_E_HL, {1, 2, 1}},
-				{gb_cpu_LOAD_E_A, {1, 1, 1}},
-				{gb_cpu_LOAD_H_B, {1, 1, 1}},
-				{gb_cpu_LOAD_H_C, {1, 1, 1}},
-				{gb_cpu_LOAD_H_D, {1, 1, 1}},
-				{gb_cpu_LOAD_H_E, {1, 1, 1}},
-				{gb_cpu_LOAD_H_H, {1, 1, 1}},
-				{gb_cpu_LOAD_H_L, {1, 1, 1}},
-				{gb_cpu_LOAD_H_HL, {1, 2, 1}},
-				{gb_cpu_LOAD_H_A, {1, 1, 1}},
-				{gb_cpu_LOAD_L_B, {1, 1, 1}},
-				{gb_cpu_LOAD_L_C, {1, 1, 1}},
-				{gb_cpu_LOAD_L_D, {1, 1, 1}},
-				{gb_cpu_LOAD_L_E, {1, 1, 1}},
-				{gb_cpu_LOAD_L_H, {1, 1, 1}},
-				{gb_cpu_LOAD_L_L, {1, 1, 1}},
-				{gb_cpu_LOAD_L_HL, {1, 2, 1}},
-				{gb_cpu_LOAD_L_A, {1, 1, 1}},
-				{gb_cpu_LOAD_HL_B, {1, 2, 1}},
-				{gb_cpu_LOAD_HL_C, {1, 2, 1}},
-				{gb_cpu_LOAD_HL_D, {1, 2, 1}},
-				{gb_cpu_LOAD_HL_E, {1, 2, 1}},
-				{gb_cpu_LOAD_HL_H, {1, 2, 1}},
-				{gb_cpu_LOAD_HL_L, {1, 2, 1}},
-				{gb_cpu_HALT, {1, 1, 1}},
-				{gb_cpu_LOAD_HL_A, {1, 2, 1}},
-				{gb_cpu_LOAD_A_B, {1, 1, 1}},
-				{gb_cpu_LOAD_A_C, {1, 1, 1}},
-				{gb_cpu_LOAD_A_D, {1, 1, 1}},
-				{gb_cpu_LOAD_A_E, {1, 1, 1}},
-				{gb_cpu_LOAD_A_H, {1, 1, 1}},
-				{gb_cpu_LOAD_A_L, {1, 1, 1}},
-				{gb_cpu_LOAD_A_HL, {1, 2, 1}},
-				{gb_cpu_LOAD_A_A, {1, 1, 1}},
-				{gb_cpu_ADD_A_B, {1, 1, 1}},
-				{gb_cpu_ADD_A_C, {1, 1, 1}},
-				{gb_cpu_ADD_A_D, {1, 1, 1}},
-				{gb_cpu_ADD_A_E, {1, 1, 1}},
-				{gb_cpu_ADD_A_H, {1, 1, 1}},
-				{gb_cpu_ADD_A_L, {1, 1, 1}},
-				{gb_cpu_ADD_A_HL, {1, 2, 1}},
-				{gb_cpu_ADD_A_A, {1, 1, 1}},
-				{gb_cpu_ADC_A_B, {1, 1, 1}},
-				{gb_cpu_ADC_A_C, {1, 1, 1}},
-				{gb_cpu_ADC_A_D, {1, 1, 1}},
-				{gb_cpu_ADC_A_E, {1, 1, 1}},
-				{gb_cpu_ADC_A_H, {1, 1, 1}},
-				{gb_cpu_ADC_A_L, {1, 1, 1}},
-				{gb_cpu_ADC_A_HL, {1, 2, 1}},
-				{gb_cpu_ADC_A_A, {1, 1, 1}},
-				{gb_cpu_SUB_B, {1, 1, 1}},
-				{gb_cpu_SUB_C, {1, 1, 1}},
-				{gb_cpu_SUB_D, {1, 1, 1}},
-				{gb_cpu_SUB_E, {1, 1, 1}},
-				{gb_cpu_SUB_H, {1, 1, 1}},
-				{gb_cpu_SUB_L, {1, 1, 1}},
-				{gb_cpu_SUB_HL, {1, 2, 1}},
-				{gb_cpu_SUB_A, {1, 1, 1}},
-				{gb_cpu_SBC_A_B, {1, 1, 1}},
-				{gb_cpu_SBC_A_C, {1, 1, 1}},
-				{gb_cpu_SBC_A_D, {1, 1, 1}},
-				{gb_cpu_SBC_A_E, {1, 1, 1}},
-				{gb_cpu_SBC_A_H, {1, 1, 1}},
-				{gb_cpu_SBC_A_L, {1, 1, 1}},
-				{gb_cpu_SBC_A_HL, {1, 2, 1}},
-				{gb_cpu_SBC_A_A, {1, 1, 1}},
-				{gb_cpu_AND_B, {1, 1, 1}},
-				{gb_cpu_AND_C, {1, 1, 1}},
-				{gb_cpu_AND_D, {1, 1, 1}},
-				{gb_cpu_AND_E, {1, 1, 1}},
-				{gb_cpu_AND_H, {1, 1, 1}},
-				{gb_cpu_AND_L, {1, 1, 1}},
-				{gb_cpu_AND_HL, {1, 2, 1}},
-				{gb_cpu_AND_A, {1, 1, 1}},
-				{gb_cpu_XOR_B, {1, 1, 1}},
-				{gb_cpu_XOR_C, {1, 1, 1}},
-				{gb_cpu_XOR_D, {1, 1, 1}},
-				{gb_cpu_XOR_E, {1, 1, 1}},
-				{gb_cpu_XOR_H, {1, 1, 1}},
-				{gb_cpu_XOR_L, {1, 1, 1}},
-				{gb_cpu_XOR_HL, {1, 2, 1}},
-				{gb_cpu_XOR_A, {1, 1, 1}},
-				{gb_cpu_OR_B, {1, 1, 1}},
-				{gb_cpu_OR_C, {1, 1, 1}},
-				{gb_cpu_OR_D, {1, 1, 1}},
-				{gb_cpu_OR_E, {1, 1, 1}},
-				{gb_cpu_OR_H, {1, 1, 1}},
-				{gb_cpu_OR_L, {1, 1, 1}},
-				{gb_cpu_OR_HL, {1, 2, 1}},
-				{gb_cpu_OR_A, {1, 1, 1}},
-				{gb_cpu_CP_B, {1, 1, 1}},
-				{gb_cpu_CP_C, {1, 1, 1}},
-				{gb_cpu_CP_D, {1, 1, 1}},
-				{gb_cpu_CP_E, {1, 1, 1}},
-				{gb_cpu_CP_H, {1, 1, 1}},
-				{gb_cpu_CP_L, {1, 1, 1}},
-				{gb_cpu_CP_HL, {1, 2, 1}},
-				{gb_cpu_CP_A, {1, 1, 1}},
-				{gb_cpu_RET_NZ, {1, CUSTOM_TIMING, 1}},
-				{gb_cpu_POP_BC, {1, 3, 1}},
-				{gb_cpu_JP_NZ_a16, {3, CUSTOM_TIMING, 1}},
-				{gb_cpu_JP_a16, {3, 4, 4}},
-				{gb_cpu_CALL_NZ_a16, {3, CUSTOM_TIMING, 1}},
-				{gb_cpu_PUSH_BC, {1, 4, 1}},
-				{gb_cpu_ADD_A_d8, {2, 2, 1}},
-				{gb_cpu_RST_00H, {1, 4, 1}},
-				{gb_cpu_RET_Z, {1, CUSTOM_TIMING, 1}},
-				{gb_cpu_RET, {1, 4, 1}},
-				{gb_cpu_JP_Z_a16, {3, CUSTOM_TIMING, 1}},
-				{gb_cpu_PREFIX, {1, 1, CUSTOM_TIMING}},
-				{gb_cpu_CALL_Z_a16, {3, CUSTOM_TIMING, 1}},
-				{gb_cpu_CALL_a16, {3, 6, 1}},
-				{gb_cpu_ADC_A_d8, {2, 2, 1}},
-				{gb_cpu_RST_08H, {1, 4, 1}},
-				{gb_cpu_RET_NC, {1, CUSTOM_TIMING, 1}},
-				{gb_cpu_POP_DE, {1, 3, 1}},
-				{gb_cpu_JP_NC_a16, {3, CUSTOM_TIMING, 1}},
-				{NULL, {0, 0, 0}},
-				{gb_cpu_CALL_NC_a16, {3, CUSTOM_TIMING, 1}},
-				{gb_cpu_PUSH_DE, {1, 4, 1}},
-				{gb_cpu_SUB_d8, {2, 2, 1}},
-				{gb_cpu_RST_10H, {1, 4, 1}},
-				{gb_cpu_RET_C, {1, CUSTOM_TIMING, 1}},
-				{gb_cpu_RETI, {1, 4, 1}},
-				{gb_cpu_JP_C_a16, {3, CUSTOM_TIMING, 1}},
-				{NULL, {0, 0, 0}},
-				{gb_cpu_CALL_C_a16, {3, CUSTOM_TIMING, 1}},
-				{NULL, {0, 0, 0}},
-				{gb_cpu_SBC_A_d8, {2, 2, 1}},
-				{gb_cpu_RST_18H, {1, 4, 1}},
-				{gb_cpu_LOAD_a8_A, {2, 3, 2}},
-				{gb_cpu_POP_HL, {1, 3, 1}},
-				{gb_cpu_LOAD_fC_A, {1, 2, 1}},
-				{NULL, {0, 0, 0}},
-				{NULL, {0, 0, 0}},
-				{gb_cpu_PUSH_HL, {1, 4, 1}},
-				{gb_cpu_AND_d8, {2, 2, 1}},
-				{gb_cpu_RST20H, {1, 4, 1}},
-				{gb_cpu_ADD_SP_r8, {2, 4, 1}},
-				{gb_cpu_JP_HL, {1, 1, 1}},
-				{gb_cpu_LOAD_a16_A, {3, 4, 3}},
-				{NULL, {0, 0, 0}},
-				{NULL, {0, 0, 0}},
-				{NULL, {0, 0, 0}},
-				{gb_cpu_XOR_d8, {2, 2, 1}},
-				{gb_cpu_RST_28H, {1, 4, 1}},
-				{gb_cpu_LOAD_A_a8, {2, 3, 2}},
-				{gb_cpu_POP_AF, {1, 3, 1}},
-				{gb_cpu_LOAD_A_fC, {1, 2, 1}},
-				{gb_cpu_DI, {1, 1, 1}},
-				{NULL, {0, 0, 0}},
-				{gb_cpu_PUSH_AF, {1, 4, 1}},
-				{gb_cpu_OR_d8, {2, 2, 1}},
-				{gb_cpu_RST_30H, {1, 4, 1}},
-				{gb_cpu_LOAD_HL_SP_r8, {2, 3, 1}},
-				{gb_cpu_LOAD_SP_HL, {1, 2, 1}},
-				{gb_cpu_LOAD_A_a16, {3, 4, 3}},
-				{gb_cpu_EI, {1, 1, 1}},
-				{NULL, {0, 0, 0}},
-				{NULL, {0, 0, 0}},
-				{gb_cpu_CP_d8, {2, 2, 1}},
-				{gb_cpu_RST_38H, {1, 4, 1}}};
-
-gb_instr_t prefix_instructions[256] = {{gb_cpu_RLC_B, {2, 2, 1}},
-				       {gb_cpu_RLC_C, {2, 2, 1}},
-				       {gb_cpu_RLC_D, {2, 2, 1}},
-				       {gb_cpu_RLC_E, {2, 2, 1}},
-				       {gb_cpu_RLC_H, {2, 2, 1}},
-				       {gb_cpu_RLC_L, {2, 2, 1}},
-				       {gb_cpu_RLC_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RLC_A, {2, 2, 1}},
-				       {gb_cpu_RRC_B, {2, 2, 1}},
-				       {gb_cpu_RRC_C, {2, 2, 1}},
-				       {gb_cpu_RRC_D, {2, 2, 1}},
-				       {gb_cpu_RRC_E, {2, 2, 1}},
-				       {gb_cpu_RRC_H, {2, 2, 1}},
-				       {gb_cpu_RRC_L, {2, 2, 1}},
-				       {gb_cpu_RRC_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RRC_A, {2, 2, 1}},
-				       {gb_cpu_RL_B, {2, 2, 1}},
-				       {gb_cpu_RL_C, {2, 2, 1}},
-				       {gb_cpu_RL_D, {2, 2, 1}},
-				       {gb_cpu_RL_E, {2, 2, 1}},
-				       {gb_cpu_RL_H, {2, 2, 1}},
-				       {gb_cpu_RL_L, {2, 2, 1}},
-				       {gb_cpu_RL_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RL_A, {2, 2, 1}},
-				       {gb_cpu_RR_B, {2, 2, 1}},
-				       {gb_cpu_RR_C, {2, 2, 1}},
-				       {gb_cpu_RR_D, {2, 2, 1}},
-				       {gb_cpu_RR_E, {2, 2, 1}},
-				       {gb_cpu_RR_H, {2, 2, 1}},
-				       {gb_cpu_RR_L, {2, 2, 1}},
-				       {gb_cpu_RR_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RR_A, {2, 2, 1}},
-				       {gb_cpu_SLA_B, {2, 2, 1}},
-				       {gb_cpu_SLA_C, {2, 2, 1}},
-				       {gb_cpu_SLA_D, {2, 2, 1}},
-				       {gb_cpu_SLA_E, {2, 2, 1}},
-				       {gb_cpu_SLA_H, {2, 2, 1}},
-				       {gb_cpu_SLA_L, {2, 2, 1}},
-				       {gb_cpu_SLA_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SLA_A, {2, 2, 1}},
-				       {gb_cpu_SRA_B, {2, 2, 1}},
-				       {gb_cpu_SRA_C, {2, 2, 1}},
-				       {gb_cpu_SRA_D, {2, 2, 1}},
-				       {gb_cpu_SRA_E, {2, 2, 1}},
-				       {gb_cpu_SRA_H, {2, 2, 1}},
-				       {gb_cpu_SRA_L, {2, 2, 1}},
-				       {gb_cpu_SRA_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SRA_A, {2, 2, 1}},
-				       {gb_cpu_SWAP_B, {2, 2, 1}},
-				       {gb_cpu_SWAP_C, {2, 2, 1}},
-				       {gb_cpu_SWAP_D, {2, 2, 1}},
-				       {gb_cpu_SWAP_E, {2, 2, 1}},
-				       {gb_cpu_SWAP_H, {2, 2, 1}},
-				       {gb_cpu_SWAP_L, {2, 2, 1}},
-				       {gb_cpu_SWAP_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SWAP_A, {2, 2, 1}},
-				       {gb_cpu_SRL_B, {2, 2, 1}},
-				       {gb_cpu_SRL_C, {2, 2, 1}},
-				       {gb_cpu_SRL_D, {2, 2, 1}},
-				       {gb_cpu_SRL_E, {2, 2, 1}},
-				       {gb_cpu_SRL_H, {2, 2, 1}},
-				       {gb_cpu_SRL_L, {2, 2, 1}},
-				       {gb_cpu_SRL_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SRL_A, {2, 2, 1}},
-				       {gb_cpu_BIT_0_B, {2, 2, 1}},
-				       {gb_cpu_BIT_0_C, {2, 2, 1}},
-				       {gb_cpu_BIT_0_D, {2, 2, 1}},
-				       {gb_cpu_BIT_0_E, {2, 2, 1}},
-				       {gb_cpu_BIT_0_H, {2, 2, 1}},
-				       {gb_cpu_BIT_0_L, {2, 2, 1}},
-				       {gb_cpu_BIT_0_HL, {2, 3, 2}},
-				       {gb_cpu_BIT_0_A, {2, 2, 1}},
-				       {gb_cpu_BIT_1_B, {2, 2, 1}},
-				       {gb_cpu_BIT_1_C, {2, 2, 1}},
-				       {gb_cpu_BIT_1_D, {2, 2, 1}},
-				       {gb_cpu_BIT_1_E, {2, 2, 1}},
-				       {gb_cpu_BIT_1_H, {2, 2, 1}},
-				       {gb_cpu_BIT_1_L, {2, 2, 1}},
-				       {gb_cpu_BIT_1_HL, {2, 3, 2}},
-				       {gb_cpu_BIT_1_A, {2, 2, 1}},
-				       {gb_cpu_BIT_2_B, {2, 2, 1}},
-				       {gb_cpu_BIT_2_C, {2, 2, 1}},
-				       {gb_cpu_BIT_2_D, {2, 2, 1}},
-				       {gb_cpu_BIT_2_E, {2, 2, 1}},
-				       {gb_cpu_BIT_2_H, {2, 2, 1}},
-				       {gb_cpu_BIT_2_L, {2, 2, 1}},
-				       {gb_cpu_BIT_2_HL, {2, 3, 2}},
-				       {gb_cpu_BIT_2_A, {2, 2, 1}},
-				       {gb_cpu_BIT_3_B, {2, 2, 1}},
-				       {gb_cpu_BIT_3_C, {2, 2, 1}},
-				       {gb_cpu_BIT_3_D, {2, 2, 1}},
-				       {gb_cpu_BIT_3_E, {2, 2, 1}},
-				       {gb_cpu_BIT_3_H, {2, 2, 1}},
-				       {gb_cpu_BIT_3_L, {2, 2, 1}},
-				       {gb_cpu_BIT_3_HL, {2, 3, 2}},
-				       {gb_cpu_BIT_3_A, {2, 2, 1}},
-				       {gb_cpu_BIT_4_B, {2, 2, 1}},
-				       {gb_cpu_BIT_4_C, {2, 2, 1}},
-				       {gb_cpu_BIT_4_D, {2, 2, 1}},
-				       {gb_cpu_BIT_4_E, {2, 2, 1}},
-				       {gb_cpu_BIT_4_H, {2, 2, 1}},
-				       {gb_cpu_BIT_4_L, {2, 2, 1}},
-				       {gb_cpu_BIT_4_HL, {2, 3, 2}},
-				       {gb_cpu_BIT_4_A, {2, 2, 1}},
-				       {gb_cpu_BIT_5_B, {2, 2, 1}},
-				       {gb_cpu_BIT_5_C, {2, 2, 1}},
-				       {gb_cpu_BIT_5_D, {2, 2, 1}},
-				       {gb_cpu_BIT_5_E, {2, 2, 1}},
-				       {gb_cpu_BIT_5_H, {2, 2, 1}},
-				       {gb_cpu_BIT_5_L, {2, 2, 1}},
-				       {gb_cpu_BIT_5_HL, {2, 3, 2}},
-				       {gb_cpu_BIT_5_A, {2, 2, 1}},
-				       {gb_cpu_BIT_6_B, {2, 2, 1}},
-				       {gb_cpu_BIT_6_C, {2, 2, 1}},
-				       {gb_cpu_BIT_6_D, {2, 2, 1}},
-				       {gb_cpu_BIT_6_E, {2, 2, 1}},
-				       {gb_cpu_BIT_6_H, {2, 2, 1}},
-				       {gb_cpu_BIT_6_L, {2, 2, 1}},
-				       {gb_cpu_BIT_6_HL, {2, 3, 2}},
-				       {gb_cpu_BIT_6_A, {2, 2, 1}},
-				       {gb_cpu_BIT_7_B, {2, 2, 1}},
-				       {gb_cpu_BIT_7_C, {2, 2, 1}},
-				       {gb_cpu_BIT_7_D, {2, 2, 1}},
-				       {gb_cpu_BIT_7_E, {2, 2, 1}},
-				       {gb_cpu_BIT_7_H, {2, 2, 1}},
-				       {gb_cpu_BIT_7_L, {2, 2, 1}},
-				       {gb_cpu_BIT_7_HL, {2, 3, 2}},
-				       {gb_cpu_BIT_7_A, {2, 2, 1}},
-				       {gb_cpu_RES_0_B, {2, 2, 1}},
-				       {gb_cpu_RES_0_C, {2, 2, 1}},
-				       {gb_cpu_RES_0_D, {2, 2, 1}},
-				       {gb_cpu_RES_0_E, {2, 2, 1}},
-				       {gb_cpu_RES_0_H, {2, 2, 1}},
-				       {gb_cpu_RES_0_L, {2, 2, 1}},
-				       {gb_cpu_RES_0_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RES_0_A, {2, 2, 1}},
-				       {gb_cpu_RES_1_B, {2, 2, 1}},
-				       {gb_cpu_RES_1_C, {2, 2, 1}},
-				       {gb_cpu_RES_1_D, {2, 2, 1}},
-				       {gb_cpu_RES_1_E, {2, 2, 1}},
-				       {gb_cpu_RES_1_H, {2, 2, 1}},
-				       {gb_cpu_RES_1_L, {2, 2, 1}},
-				       {gb_cpu_RES_1_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RES_1_A, {2, 2, 1}},
-				       {gb_cpu_RES_2_B, {2, 2, 1}},
-				       {gb_cpu_RES_2_C, {2, 2, 1}},
-				       {gb_cpu_RES_2_D, {2, 2, 1}},
-				       {gb_cpu_RES_2_E, {2, 2, 1}},
-				       {gb_cpu_RES_2_H, {2, 2, 1}},
-				       {gb_cpu_RES_2_L, {2, 2, 1}},
-				       {gb_cpu_RES_2_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RES_2_A, {2, 2, 1}},
-				       {gb_cpu_RES_3_B, {2, 2, 1}},
-				       {gb_cpu_RES_3_C, {2, 2, 1}},
-				       {gb_cpu_RES_3_D, {2, 2, 1}},
-				       {gb_cpu_RES_3_E, {2, 2, 1}},
-				       {gb_cpu_RES_3_H, {2, 2, 1}},
-				       {gb_cpu_RES_3_L, {2, 2, 1}},
-				       {gb_cpu_RES_3_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RES_3_A, {2, 2, 1}},
-				       {gb_cpu_RES_4_B, {2, 2, 1}},
-				       {gb_cpu_RES_4_C, {2, 2, 1}},
-				       {gb_cpu_RES_4_D, {2, 2, 1}},
-				       {gb_cpu_RES_4_E, {2, 2, 1}},
-				       {gb_cpu_RES_4_H, {2, 2, 1}},
-				       {gb_cpu_RES_4_L, {2, 2, 1}},
-				       {gb_cpu_RES_4_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RES_4_A, {2, 2, 1}},
-				       {gb_cpu_RES_5_B, {2, 2, 1}},
-				       {gb_cpu_RES_5_C, {2, 2, 1}},
-				       {gb_cpu_RES_5_D, {2, 2, 1}},
-				       {gb_cpu_RES_5_E, {2, 2, 1}},
-				       {gb_cpu_RES_5_H, {2, 2, 1}},
-				       {gb_cpu_RES_5_L, {2, 2, 1}},
-				       {gb_cpu_RES_5_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RES_5_A, {2, 2, 1}},
-				       {gb_cpu_RES_6_B, {2, 2, 1}},
-				       {gb_cpu_RES_6_C, {2, 2, 1}},
-				       {gb_cpu_RES_6_D, {2, 2, 1}},
-				       {gb_cpu_RES_6_E, {2, 2, 1}},
-				       {gb_cpu_RES_6_H, {2, 2, 1}},
-				       {gb_cpu_RES_6_L, {2, 2, 1}},
-				       {gb_cpu_RES_6_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RES_6_A, {2, 2, 1}},
-				       {gb_cpu_RES_7_B, {2, 2, 1}},
-				       {gb_cpu_RES_7_C, {2, 2, 1}},
-				       {gb_cpu_RES_7_D, {2, 2, 1}},
-				       {gb_cpu_RES_7_E, {2, 2, 1}},
-				       {gb_cpu_RES_7_H, {2, 2, 1}},
-				       {gb_cpu_RES_7_L, {2, 2, 1}},
-				       {gb_cpu_RES_7_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_RES_7_A, {2, 2, 1}},
-				       {gb_cpu_SET_0_B, {2, 2, 1}},
-				       {gb_cpu_SET_0_C, {2, 2, 1}},
-				       {gb_cpu_SET_0_D, {2, 2, 1}},
-				       {gb_cpu_SET_0_E, {2, 2, 1}},
-				       {gb_cpu_SET_0_H, {2, 2, 1}},
-				       {gb_cpu_SET_0_L, {2, 2, 1}},
-				       {gb_cpu_SET_0_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SET_0_A, {2, 2, 1}},
-				       {gb_cpu_SET_1_B, {2, 2, 1}},
-				       {gb_cpu_SET_1_C, {2, 2, 1}},
-				       {gb_cpu_SET_1_D, {2, 2, 1}},
-				       {gb_cpu_SET_1_E, {2, 2, 1}},
-				       {gb_cpu_SET_1_H, {2, 2, 1}},
-				       {gb_cpu_SET_1_L, {2, 2, 1}},
-				       {gb_cpu_SET_1_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SET_1_A, {2, 2, 1}},
-				       {gb_cpu_SET_2_B, {2, 2, 1}},
-				       {gb_cpu_SET_2_C, {2, 2, 1}},
-				       {gb_cpu_SET_2_D, {2, 2, 1}},
-				       {gb_cpu_SET_2_E, {2, 2, 1}},
-				       {gb_cpu_SET_2_H, {2, 2, 1}},
-				       {gb_cpu_SET_2_L, {2, 2, 1}},
-				       {gb_cpu_SET_2_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SET_2_A, {2, 2, 1}},
-				       {gb_cpu_SET_3_B, {2, 2, 1}},
-				       {gb_cpu_SET_3_C, {2, 2, 1}},
-				       {gb_cpu_SET_3_D, {2, 2, 1}},
-				       {gb_cpu_SET_3_E, {2, 2, 1}},
-				       {gb_cpu_SET_3_H, {2, 2, 1}},
-				       {gb_cpu_SET_3_L, {2, 2, 1}},
-				       {gb_cpu_SET_3_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SET_3_A, {2, 2, 1}},
-				       {gb_cpu_SET_4_B, {2, 2, 1}},
-				       {gb_cpu_SET_4_C, {2, 2, 1}},
-				       {gb_cpu_SET_4_D, {2, 2, 1}},
-				       {gb_cpu_SET_4_E, {2, 2, 1}},
-				       {gb_cpu_SET_4_H, {2, 2, 1}},
-				       {gb_cpu_SET_4_L, {2, 2, 1}},
-				       {gb_cpu_SET_4_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SET_4_A, {2, 2, 1}},
-				       {gb_cpu_SET_5_B, {2, 2, 1}},
-				       {gb_cpu_SET_5_C, {2, 2, 1}},
-				       {gb_cpu_SET_5_D, {2, 2, 1}},
-				       {gb_cpu_SET_5_E, {2, 2, 1}},
-				       {gb_cpu_SET_5_H, {2, 2, 1}},
-				       {gb_cpu_SET_5_L, {2, 2, 1}},
-				       {gb_cpu_SET_5_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SET_5_A, {2, 2, 1}},
-				       {gb_cpu_SET_6_B, {2, 2, 1}},
-				       {gb_cpu_SET_6_C, {2, 2, 1}},
-				       {gb_cpu_SET_6_D, {2, 2, 1}},
-				       {gb_cpu_SET_6_E, {2, 2, 1}},
-				       {gb_cpu_SET_6_H, {2, 2, 1}},
-				       {gb_cpu_SET_6_L, {2, 2, 1}},
-				       {gb_cpu_SET_6_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SET_6_A, {2, 2, 1}},
-				       {gb_cpu_SET_7_B, {2, 2, 1}},
-				       {gb_cpu_SET_7_C, {2, 2, 1}},
-				       {gb_cpu_SET_7_D, {2, 2, 1}},
-				       {gb_cpu_SET_7_E, {2, 2, 1}},
-				       {gb_cpu_SET_7_H, {2, 2, 1}},
-				       {gb_cpu_SET_7_L, {2, 2, 1}},
-				       {gb_cpu_SET_7_HL, {2, 4, CUSTOM_TIMING}},
-				       {gb_cpu_SET_7_A, {2, 2, 1}}};
+/* Game Boy CPU instruction set, conditional instructions set their M-cycles themselves */
+#define gb_cpu_ILLEGAL NULL
+#define GB_CPU_INSTRUCTION(opcode, handler, mnemonic, operand, bytes, cycles, taken_cycles, step,  \
+			   ...)                                                                    \
+	[opcode] = {gb_cpu_##handler,                                                              \
+		    {bytes, ((cycles) == (taken_cycles)) ? (cycles) : CUSTOM_TIMING, step}},
+
+static const gb_instr_t instructions[256] = {GB_CPU_OPCODES(GB_CPU_INSTRUCTION)};
+
+/* Timing of the CB prefixed instructions on a register, of BIT on (HL) and of the other ones on
+ * (HL), see gb_cpu_prefix_info() */
+static const gb_instr_info_t prefix_info[3] = {{2, 2, 1}, {2, 3, 2}, {2, 4, CUSTOM_TIMING}};
+
+/**
+ * @brief Reads an instruction byte from outside of the page gb_cpu_fetch() has cached.
+ * @details The page holding the address becomes the cached one. Pages without host memory are
+ * not cached, their bytes are always read through gb_memory_read(). The cache is dropped whenever
+ * the cartridge pages are remapped, see gb_memory_map_cartridge().
+ * @param address address of the byte
+ * @returns byte read
+ */
+static uint8_t gb_cpu_fetch_page(gb_t *gb, uint16_t address)
+{
+	uint8_t page = address >> GB_MEMORY_PAGE_SHIFT;
+
+	gb->cpu.fetch_ptr = gb->pages.read[page];
+	gb->cpu.fetch_base = page << GB_MEMORY_PAGE_SHIFT;
+	gb->cpu.fetch_size = (gb->cpu.fetch_ptr != NULL) ? GB_MEMORY_PAGE_SIZE : 0;
+
+	return gb_memory_read(gb, address);
+}
 
 /*********************0x0X*/
-static void gb_cpu_NOP(gb_instr_info_t *info)
+static void gb_cpu_NOP(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
 }
 
-static void gb_cpu_LOAD_BC_d16(gb_instr_info_t *info)
+static void gb_cpu_LOAD_BC_d16(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.BC = CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	gb->mem.reg.BC = CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				   gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 }
 
-static void gb_cpu_LOAD_BC_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_BC_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.BC, mem.reg.A);
+	gb_memory_write(gb, gb->mem.reg.BC, gb->mem.reg.A);
 }
 
-static void gb_cpu_INC_BC(gb_instr_info_t *info)
+static void gb_cpu_INC_BC(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.BC++;
+	gb->mem.reg.BC++;
 }
 
-static void gb_cpu_INC_B(gb_instr_info_t *info)
+static void gb_cpu_INC_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_inc_register(&mem.reg.B, &mem.reg.F);
+	gb_cpu_inc_register(&gb->mem.reg.B, &gb->mem.reg.F);
 }
 
-static void gb_cpu_DEC_B(gb_instr_info_t *info)
+static void gb_cpu_DEC_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_dec_register(&mem.reg.B, &mem.reg.F);
+	gb_cpu_dec_register(&gb->mem.reg.B, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_B_d8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_B_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.B = gb_memory_read(mem.reg.PC + 1);
+	gb->mem.reg.B = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
 }
 
-static void gb_cpu_RLCA(gb_instr_info_t *info)
+static void gb_cpu_RLCA(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_carry = CHK_BIT(mem.reg.A, 7);
-	mem.reg.F = (temp_carry != 0) ? C_FLAG_VAL : 0x00;
-	mem.reg.A <<= 1;
-	mem.reg.A += temp_carry;
+	uint8_t temp_carry = CHK_BIT(gb->mem.reg.A, 7);
+	gb->mem.reg.F = (temp_carry != 0) ? C_FLAG_VAL : 0x00;
+	gb->mem.reg.A <<= 1;
+	gb->mem.reg.A += temp_carry;
 }
 
-static void gb_cpu_LOAD_a16_SP(gb_instr_info_t *info)
+static void gb_cpu_LOAD_a16_SP(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write_short(
-		CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2)),
-		mem.reg.SP);
+	gb_memory_write_short(gb,
+			      CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+					gb_cpu_fetch(gb, gb->mem.reg.PC + 2)),
+		gb->mem.reg.SP);
 }
 
-static void gb_cpu_ADD_HL_BC(gb_instr_info_t *info)
+static void gb_cpu_ADD_HL_BC(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_HL_register(&mem.reg.HL, &mem.reg.BC, &mem.reg.F);
+	gb_cpu_addition_HL_register(&gb->mem.reg.HL, &gb->mem.reg.BC, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_A_BC(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_BC(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = gb_memory_read(mem.reg.BC);
+	gb->mem.reg.A = gb_memory_read(gb, gb->mem.reg.BC);
 }
 
-static void gb_cpu_DEC_BC(gb_instr_info_t *info)
+static void gb_cpu_DEC_BC(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.BC--;
+	gb->mem.reg.BC--;
 }
 
-static void gb_cpu_INC_C(gb_instr_info_t *info)
+static void gb_cpu_INC_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_inc_register(&mem.reg.C, &mem.reg.F);
+	gb_cpu_inc_register(&gb->mem.reg.C, &gb->mem.reg.F);
 }
 
-static void gb_cpu_DEC_C(gb_instr_info_t *info)
+static void gb_cpu_DEC_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_dec_register(&mem.reg.C, &mem.reg.F);
+	gb_cpu_dec_register(&gb->mem.reg.C, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_C_d8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_C_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.C = gb_memory_read(mem.reg.PC + 1);
+	gb->mem.reg.C = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
 }
 
-static void gb_cpu_RRCA(gb_instr_info_t *info)
+static void gb_cpu_RRCA(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_carry = CHK_BIT(mem.reg.A, 0);
-	mem.reg.F = (temp_carry != 0) ? C_FLAG_VAL : 0x00;
-	mem.reg.A >>= 1;
+	uint8_t temp_carry = CHK_BIT(gb->mem.reg.A, 0);
+	gb->mem.reg.F = (temp_carry != 0) ? C_FLAG_VAL : 0x00;
+	gb->mem.reg.A >>= 1;
 	if (temp_carry != 0) {
-		SET_BIT(mem.reg.A, 7);
+		SET_BIT(gb->mem.reg.A, 7);
 	}
 }
 
 /*********************0x1X*/
-static void gb_cpu_STOP(gb_instr_info_t *info)
+static void gb_cpu_STOP(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	stopped = 1;
+	gb->cpu.stopped = 1;
 } // MORE NEEDED TO IMPLEMENT LATER
 
-static void gb_cpu_LOAD_DE_d16(gb_instr_info_t *info)
+static void gb_cpu_LOAD_DE_d16(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.DE = CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	gb->mem.reg.DE = CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				   gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 }
 
-static void gb_cpu_LOAD_DE_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_DE_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.DE, mem.reg.A);
+	gb_memory_write(gb, gb->mem.reg.DE, gb->mem.reg.A);
 }
 
-static void gb_cpu_INC_DE(gb_instr_info_t *info)
+static void gb_cpu_INC_DE(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.DE++;
+	gb->mem.reg.DE++;
 }
 
-static void gb_cpu_INC_D(gb_instr_info_t *info)
+static void gb_cpu_INC_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_inc_register(&mem.reg.D, &mem.reg.F);
+	gb_cpu_inc_register(&gb->mem.reg.D, &gb->mem.reg.F);
 }
 
-static void gb_cpu_DEC_D(gb_instr_info_t *info)
+static void gb_cpu_DEC_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_dec_register(&mem.reg.D, &mem.reg.F);
+	gb_cpu_dec_register(&gb->mem.reg.D, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_D_d8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_D_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.D = gb_memory_read(mem.reg.PC + 1);
+	gb->mem.reg.D = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
 }
 
-static void gb_cpu_RLA(gb_instr_info_t *info)
+static void gb_cpu_RLA(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t prev_carry = CHK_BIT(mem.reg.F, C_FLAG_BIT);
-	mem.reg.F = ((mem.reg.A & 0x80) != 0) ? C_FLAG_VAL : 0x00;
-	mem.reg.A <<= 1;
-	mem.reg.A += prev_carry;
+	uint8_t prev_carry = CHK_BIT(gb->mem.reg.F, C_FLAG_BIT);
+	gb->mem.reg.F = ((gb->mem.reg.A & 0x80) != 0) ? C_FLAG_VAL : 0x00;
+	gb->mem.reg.A <<= 1;
+	gb->mem.reg.A += prev_carry;
 }
 
-static void gb_cpu_JR_r8(gb_instr_info_t *info)
+static void gb_cpu_JR_r8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.PC += (int8_t)gb_memory_read(mem.reg.PC + 1);
+	gb->mem.reg.PC += (int8_t)gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
 }
 
-static void gb_cpu_ADD_HL_DE(gb_instr_info_t *info)
+static void gb_cpu_ADD_HL_DE(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_HL_register(&mem.reg.HL, &mem.reg.DE, &mem.reg.F);
+	gb_cpu_addition_HL_register(&gb->mem.reg.HL, &gb->mem.reg.DE, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_A_DE(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_DE(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = gb_memory_read(mem.reg.DE);
+	gb->mem.reg.A = gb_memory_read(gb, gb->mem.reg.DE);
 }
 
-static void gb_cpu_DEC_DE(gb_instr_info_t *info)
+static void gb_cpu_DEC_DE(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.DE--;
+	gb->mem.reg.DE--;
 }
 
-static void gb_cpu_INC_E(gb_instr_info_t *info)
+static void gb_cpu_INC_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_inc_register(&mem.reg.E, &mem.reg.F);
+	gb_cpu_inc_register(&gb->mem.reg.E, &gb->mem.reg.F);
 }
 
-static void gb_cpu_DEC_E(gb_instr_info_t *info)
+static void gb_cpu_DEC_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_dec_register(&mem.reg.E, &mem.reg.F);
+	gb_cpu_dec_register(&gb->mem.reg.E, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_E_d8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_E_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.E = gb_memory_read(mem.reg.PC + 1);
+	gb->mem.reg.E = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
 }
 
-static void gb_cpu_RRA(gb_instr_info_t *info)
+static void gb_cpu_RRA(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t prev_carry = CHK_BIT(mem.reg.F, C_FLAG_BIT);
-	mem.reg.F = ((mem.reg.A & 0x01) != 0) ? C_FLAG_VAL : 0x00;
-	mem.reg.A >>= 1;
-	mem.reg.A += (prev_carry << 7);
+	uint8_t prev_carry = CHK_BIT(gb->mem.reg.F, C_FLAG_BIT);
+	gb->mem.reg.F = ((gb->mem.reg.A & 0x01) != 0) ? C_FLAG_VAL : 0x00;
+	gb->mem.reg.A >>= 1;
+	gb->mem.reg.A += (prev_carry << 7);
 }
 
 /*********************0x2X*/
-static void gb_cpu_JR_NZ_r8(gb_instr_info_t *info)
+static void gb_cpu_JR_NZ_r8(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, Z_FLAG_BIT) != 0) ? 2 : 3;
-	} else if (info->current_cycle == 3) {
-		int8_t r8_val = (int8_t)gb_memory_read(mem.reg.PC + 1);
-		mem.reg.PC += r8_val;
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, Z_FLAG_BIT) != 0) ? 2 : 3;
+	} else if (gb->cpu.current_cycle == 3) {
+		int8_t r8_val = (int8_t)gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+		gb->mem.reg.PC += r8_val;
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_LOAD_HL_d16(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_d16(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.HL = CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	gb->mem.reg.HL = CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				   gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 }
 
-static void gb_cpu_LOAD_HLI_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HLI_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, mem.reg.A);
-	mem.reg.HL++;
+	gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.A);
+	gb->mem.reg.HL++;
 }
 
-static void gb_cpu_INC_HL(gb_instr_info_t *info)
+static void gb_cpu_INC_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.HL++;
+	gb->mem.reg.HL++;
 }
 
-static void gb_cpu_INC_H(gb_instr_info_t *info)
+static void gb_cpu_INC_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_inc_register(&mem.reg.H, &mem.reg.F);
+	gb_cpu_inc_register(&gb->mem.reg.H, &gb->mem.reg.F);
 }
 
-static void gb_cpu_DEC_H(gb_instr_info_t *info)
+static void gb_cpu_DEC_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_dec_register(&mem.reg.H, &mem.reg.F);
+	gb_cpu_dec_register(&gb->mem.reg.H, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_H_d8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_H_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.H = gb_memory_read(mem.reg.PC + 1);
+	gb->mem.reg.H = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
 }
 
-static void gb_cpu_DAA(gb_instr_info_t *info)
+static void gb_cpu_DAA(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint16_t tempShort = mem.reg.A;
-	if (CHK_BIT(mem.reg.F, N_FLAG_BIT) != 0) {
-		if (CHK_BIT(mem.reg.F, H_FLAG_BIT) != 0)
-			tempShort += 0xFA;
-		if (CHK_BIT(mem.reg.F, C_FLAG_BIT) != 0)
-			tempShort += 0xA0;
-	} else {
-		if (CHK_BIT(mem.reg.F, H_FLAG_BIT) || (tempShort & 0xF) > 9)
-			tempShort += 0x06;
-		if (CHK_BIT(mem.reg.F, C_FLAG_BIT) || ((tempShort & 0x1F0) > 0x90)) {
-			tempShort += 0x60;
-			SET_BIT(mem.reg.F, C_FLAG_BIT);
-		} else {
-			RST_BIT(mem.reg.F, C_FLAG_BIT);
-		}
-	}
-	mem.reg.A = (uint8_t)tempShort;
-	RST_BIT(mem.reg.F, H_FLAG_BIT);
-	(mem.reg.A != 0) ? RST_BIT(mem.reg.F, Z_FLAG_BIT) : SET_BIT(mem.reg.F, Z_FLAG_BIT);
+	gb_cpu_decimal_adjust_A_register(&gb->mem.reg.A, &gb->mem.reg.F);
 }
 
-static void gb_cpu_JR_Z_r8(gb_instr_info_t *info)
+static void gb_cpu_JR_Z_r8(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, Z_FLAG_BIT) != 0) ? 3 : 2;
-	} else if (info->current_cycle == 3) {
-		int8_t r8_val = (int8_t)gb_memory_read(mem.reg.PC + 1);
-		mem.reg.PC += r8_val;
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, Z_FLAG_BIT) != 0) ? 3 : 2;
+	} else if (gb->cpu.current_cycle == 3) {
+		int8_t r8_val = (int8_t)gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+		gb->mem.reg.PC += r8_val;
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_ADD_HL_HL(gb_instr_info_t *info)
+static void gb_cpu_ADD_HL_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_HL_register(&mem.reg.HL, &mem.reg.HL, &mem.reg.F);
+	gb_cpu_addition_HL_register(&gb->mem.reg.HL, &gb->mem.reg.HL, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_A_HLI(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_HLI(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = gb_memory_read(mem.reg.HL);
-	mem.reg.HL++;
+	gb->mem.reg.A = gb_memory_read(gb, gb->mem.reg.HL);
+	gb->mem.reg.HL++;
 }
 
-static void gb_cpu_DEC_HL(gb_instr_info_t *info)
+static void gb_cpu_DEC_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.HL--;
+	gb->mem.reg.HL--;
 }
 
-static void gb_cpu_INC_L(gb_instr_info_t *info)
+static void gb_cpu_INC_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_inc_register(&mem.reg.L, &mem.reg.F);
+	gb_cpu_inc_register(&gb->mem.reg.L, &gb->mem.reg.F);
 }
 
-static void gb_cpu_DEC_L(gb_instr_info_t *info)
+static void gb_cpu_DEC_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_dec_register(&mem.reg.L, &mem.reg.F);
+	gb_cpu_dec_register(&gb->mem.reg.L, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_L_d8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_L_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.L = gb_memory_read(mem.reg.PC + 1);
+	gb->mem.reg.L = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
 }
 
-static void gb_cpu_CPL(gb_instr_info_t *info)
+static void gb_cpu_CPL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = ~(mem.reg.A);
-	SET_BIT(mem.reg.F, N_FLAG_BIT);
-	SET_BIT(mem.reg.F, H_FLAG_BIT);
+	gb->mem.reg.A = ~(gb->mem.reg.A);
+	SET_BIT(gb->mem.reg.F, N_FLAG_BIT);
+	SET_BIT(gb->mem.reg.F, H_FLAG_BIT);
 }
 
 /*********************0x3X*/
-static void gb_cpu_JR_NC_r8(gb_instr_info_t *info)
+static void gb_cpu_JR_NC_r8(gb_t *gb, const gb_instr_info_t *info)
 {
+	(void)info;
 
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, C_FLAG_BIT) != 0) ? 2 : 3;
-	} else if (info->current_cycle == 3) {
-		int8_t r8_val = (int8_t)gb_memory_read(mem.reg.PC + 1);
-		mem.reg.PC += r8_val;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, C_FLAG_BIT) != 0) ? 2 : 3;
+	} else if (gb->cpu.current_cycle == 3) {
+		int8_t r8_val = (int8_t)gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+		gb->mem.reg.PC += r8_val;
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_LOAD_SP_d16(gb_instr_info_t *info)
+static void gb_cpu_LOAD_SP_d16(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.SP = CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	gb->mem.reg.SP = CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				   gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 }
 
-static void gb_cpu_LOAD_HLD_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HLD_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, mem.reg.A);
-	mem.reg.HL--;
+	gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.A);
+	gb->mem.reg.HL--;
 }
 
-static void gb_cpu_INC_SP(gb_instr_info_t *info)
+static void gb_cpu_INC_SP(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.SP++;
+	gb->mem.reg.SP++;
 }
 
-static void gb_cpu_INC_HL_ADDR(gb_instr_info_t *info)
+static void gb_cpu_INC_HL_ADDR(gb_t *gb, const gb_instr_info_t *info)
 {
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 1) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		((temp_res & 0x0F) == 0x0F) ? SET_BIT(mem.reg.F, H_FLAG_BIT)
-					    : RST_BIT(mem.reg.F, H_FLAG_BIT);
-		RST_BIT(mem.reg.F, N_FLAG_BIT);
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+		((gb->cpu.temp_res & 0x0F) == 0x0F) ? SET_BIT(gb->mem.reg.F, H_FLAG_BIT)
+						    : RST_BIT(gb->mem.reg.F, H_FLAG_BIT);
+		RST_BIT(gb->mem.reg.F, N_FLAG_BIT);
 
-	} else if (info->current_cycle == 2) {
-		gb_memory_write(mem.reg.HL, temp_res + 1);
-		temp_res = gb_memory_read(mem.reg.HL);
-		(temp_res != 0) ? RST_BIT(mem.reg.F, Z_FLAG_BIT) : SET_BIT(mem.reg.F, Z_FLAG_BIT);
+	} else if (gb->cpu.current_cycle == 2) {
+		gb_memory_write(gb, gb->mem.reg.HL, gb->cpu.temp_res + 1);
+		gb->cpu.temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+		(gb->cpu.temp_res != 0) ? RST_BIT(gb->mem.reg.F, Z_FLAG_BIT)
+					: SET_BIT(gb->mem.reg.F, Z_FLAG_BIT);
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_DEC_HL_ADDR(gb_instr_info_t *info)
+static void gb_cpu_DEC_HL_ADDR(gb_t *gb, const gb_instr_info_t *info)
 {
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 1) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		((temp_res & 0x0F) != 0) ? RST_BIT(mem.reg.F, H_FLAG_BIT)
-					 : SET_BIT(mem.reg.F, H_FLAG_BIT);
-		SET_BIT(mem.reg.F, N_FLAG_BIT);
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+		((gb->cpu.temp_res & 0x0F) != 0) ? RST_BIT(gb->mem.reg.F, H_FLAG_BIT)
+						 : SET_BIT(gb->mem.reg.F, H_FLAG_BIT);
+		SET_BIT(gb->mem.reg.F, N_FLAG_BIT);
 
-	} else if (info->current_cycle == 2) {
-		gb_memory_write(mem.reg.HL, temp_res - 1);
-		temp_res = gb_memory_read(mem.reg.HL);
-		(temp_res != 0) ? RST_BIT(mem.reg.F, Z_FLAG_BIT) : SET_BIT(mem.reg.F, Z_FLAG_BIT);
+	} else if (gb->cpu.current_cycle == 2) {
+		gb_memory_write(gb, gb->mem.reg.HL, gb->cpu.temp_res - 1);
+		gb->cpu.temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+		(gb->cpu.temp_res != 0) ? RST_BIT(gb->mem.reg.F, Z_FLAG_BIT)
+					: SET_BIT(gb->mem.reg.F, Z_FLAG_BIT);
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_LOAD_HL_d8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, gb_memory_read(mem.reg.PC + 1));
+	gb_memory_write(gb, gb->mem.reg.HL, gb_cpu_fetch(gb, gb->mem.reg.PC + 1));
 }
 
-static void gb_cpu_SCF(gb_instr_info_t *info)
+static void gb_cpu_SCF(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	RST_BIT(mem.reg.F, N_FLAG_BIT);
-	RST_BIT(mem.reg.F, H_FLAG_BIT);
-	SET_BIT(mem.reg.F, C_FLAG_BIT);
+	RST_BIT(gb->mem.reg.F, N_FLAG_BIT);
+	RST_BIT(gb->mem.reg.F, H_FLAG_BIT);
+	SET_BIT(gb->mem.reg.F, C_FLAG_BIT);
 }
 
-static void gb_cpu_JR_C_r8(gb_instr_info_t *info)
+static void gb_cpu_JR_C_r8(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, C_FLAG_BIT) != 0) ? 3 : 2;
-	} else if (info->current_cycle == 3) {
-		int8_t r8_val = (int8_t)gb_memory_read(mem.reg.PC + 1);
-		mem.reg.PC += r8_val;
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, C_FLAG_BIT) != 0) ? 3 : 2;
+	} else if (gb->cpu.current_cycle == 3) {
+		int8_t r8_val = (int8_t)gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+		gb->mem.reg.PC += r8_val;
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_ADD_HL_SP(gb_instr_info_t *info)
+static void gb_cpu_ADD_HL_SP(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_HL_register(&mem.reg.HL, &mem.reg.SP, &mem.reg.F);
+	gb_cpu_addition_HL_register(&gb->mem.reg.HL, &gb->mem.reg.SP, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_A_HLD(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_HLD(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = gb_memory_read(mem.reg.HL);
-	mem.reg.HL--;
+	gb->mem.reg.A = gb_memory_read(gb, gb->mem.reg.HL);
+	gb->mem.reg.HL--;
 }
 
-static void gb_cpu_DEC_SP(gb_instr_info_t *info)
+static void gb_cpu_DEC_SP(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.SP--;
+	gb->mem.reg.SP--;
 }
 
-static void gb_cpu_INC_A(gb_instr_info_t *info)
+static void gb_cpu_INC_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_inc_register(&mem.reg.A, &mem.reg.F);
+	gb_cpu_inc_register(&gb->mem.reg.A, &gb->mem.reg.F);
 }
 
-static void gb_cpu_DEC_A(gb_instr_info_t *info)
+static void gb_cpu_DEC_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_dec_register(&mem.reg.A, &mem.reg.F);
+	gb_cpu_dec_register(&gb->mem.reg.A, &gb->mem.reg.F);
 }
 
-static void gb_cpu_LOAD_A_d8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = gb_memory_read(mem.reg.PC + 1);
+	gb->mem.reg.A = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
 }
 
-static void gb_cpu_CCF(gb_instr_info_t *info)
+static void gb_cpu_CCF(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	RST_BIT(mem.reg.F, N_FLAG_BIT);
-	RST_BIT(mem.reg.F, H_FLAG_BIT);
-	(CHK_BIT(mem.reg.F, C_FLAG_BIT)) ? RST_BIT(mem.reg.F, C_FLAG_BIT)
-					 : SET_BIT(mem.reg.F, C_FLAG_BIT);
+	RST_BIT(gb->mem.reg.F, N_FLAG_BIT);
+	RST_BIT(gb->mem.reg.F, H_FLAG_BIT);
+	(CHK_BIT(gb->mem.reg.F, C_FLAG_BIT)) ? RST_BIT(gb->mem.reg.F, C_FLAG_BIT)
+					     : SET_BIT(gb->mem.reg.F, C_FLAG_BIT);
 }
 
 /*********************0x4X*/
-static void gb_cpu_LOAD_B_B(gb_instr_info_t *info)
+static void gb_cpu_LOAD_B_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.B = mem.reg.B;
+	gb->mem.reg.B = gb->mem.reg.B;
 }
 
-static void gb_cpu_LOAD_B_C(gb_instr_info_t *info)
+static void gb_cpu_LOAD_B_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.B = mem.reg.C;
+	gb->mem.reg.B = gb->mem.reg.C;
 }
 
-static void gb_cpu_LOAD_B_D(gb_instr_info_t *info)
+static void gb_cpu_LOAD_B_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.B = mem.reg.D;
+	gb->mem.reg.B = gb->mem.reg.D;
 }
 
-static void gb_cpu_LOAD_B_E(gb_instr_info_t *info)
+static void gb_cpu_LOAD_B_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.B = mem.reg.E;
+	gb->mem.reg.B = gb->mem.reg.E;
 }
 
-static void gb_cpu_LOAD_B_H(gb_instr_info_t *info)
+static void gb_cpu_LOAD_B_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.B = mem.reg.H;
+	gb->mem.reg.B = gb->mem.reg.H;
 }
 
-static void gb_cpu_LOAD_B_L(gb_instr_info_t *info)
+static void gb_cpu_LOAD_B_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.B = mem.reg.L;
+	gb->mem.reg.B = gb->mem.reg.L;
 }
 
-static void gb_cpu_LOAD_B_HL(gb_instr_info_t *info)
+static void gb_cpu_LOAD_B_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.B = gb_memory_read(mem.reg.HL);
+	gb->mem.reg.B = gb_memory_read(gb, gb->mem.reg.HL);
 }
 
-static void gb_cpu_LOAD_B_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_B_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.B = mem.reg.A;
+	gb->mem.reg.B = gb->mem.reg.A;
 }
 
-static void gb_cpu_LOAD_C_B(gb_instr_info_t *info)
+static void gb_cpu_LOAD_C_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.C = mem.reg.B;
+	gb->mem.reg.C = gb->mem.reg.B;
 }
 
-static void gb_cpu_LOAD_C_C(gb_instr_info_t *info)
+static void gb_cpu_LOAD_C_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.C = mem.reg.C;
+	gb->mem.reg.C = gb->mem.reg.C;
 }
 
-static void gb_cpu_LOAD_C_D(gb_instr_info_t *info)
+static void gb_cpu_LOAD_C_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.C = mem.reg.D;
+	gb->mem.reg.C = gb->mem.reg.D;
 }
 
-static void gb_cpu_LOAD_C_E(gb_instr_info_t *info)
+static void gb_cpu_LOAD_C_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.C = mem.reg.E;
+	gb->mem.reg.C = gb->mem.reg.E;
 }
 
-static void gb_cpu_LOAD_C_H(gb_instr_info_t *info)
+static void gb_cpu_LOAD_C_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.C = mem.reg.H;
+	gb->mem.reg.C = gb->mem.reg.H;
 }
 
-static void gb_cpu_LOAD_C_L(gb_instr_info_t *info)
+static void gb_cpu_LOAD_C_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.C = mem.reg.L;
+	gb->mem.reg.C = gb->mem.reg.L;
 }
 
-static void gb_cpu_LOAD_C_HL(gb_instr_info_t *info)
+static void gb_cpu_LOAD_C_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.C = gb_memory_read(mem.reg.HL);
+	gb->mem.reg.C = gb_memory_read(gb, gb->mem.reg.HL);
 }
 
-static void gb_cpu_LOAD_C_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_C_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.C = mem.reg.A;
+	gb->mem.reg.C = gb->mem.reg.A;
 }
 
 /*********************0x5X*/
-static void gb_cpu_LOAD_D_B(gb_instr_info_t *info)
+static void gb_cpu_LOAD_D_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.D = mem.reg.B;
+	gb->mem.reg.D = gb->mem.reg.B;
 }
 
-static void gb_cpu_LOAD_D_C(gb_instr_info_t *info)
+static void gb_cpu_LOAD_D_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.D = mem.reg.C;
+	gb->mem.reg.D = gb->mem.reg.C;
 }
 
-static void gb_cpu_LOAD_D_D(gb_instr_info_t *info)
+static void gb_cpu_LOAD_D_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.D = mem.reg.D;
+	gb->mem.reg.D = gb->mem.reg.D;
 }
 
-static void gb_cpu_LOAD_D_E(gb_instr_info_t *info)
+static void gb_cpu_LOAD_D_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.D = mem.reg.E;
+	gb->mem.reg.D = gb->mem.reg.E;
 }
 
-static void gb_cpu_LOAD_D_H(gb_instr_info_t *info)
+static void gb_cpu_LOAD_D_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.D = mem.reg.H;
+	gb->mem.reg.D = gb->mem.reg.H;
 }
 
-static void gb_cpu_LOAD_D_L(gb_instr_info_t *info)
+static void gb_cpu_LOAD_D_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.D = mem.reg.L;
+	gb->mem.reg.D = gb->mem.reg.L;
 }
 
-static void gb_cpu_LOAD_D_HL(gb_instr_info_t *info)
+static void gb_cpu_LOAD_D_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.D = gb_memory_read(mem.reg.HL);
+	gb->mem.reg.D = gb_memory_read(gb, gb->mem.reg.HL);
 }
 
-static void gb_cpu_LOAD_D_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_D_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.D = mem.reg.A;
+	gb->mem.reg.D = gb->mem.reg.A;
 }
 
-static void gb_cpu_LOAD_E_B(gb_instr_info_t *info)
+static void gb_cpu_LOAD_E_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.E = mem.reg.B;
+	gb->mem.reg.E = gb->mem.reg.B;
 }
 
-static void gb_cpu_LOAD_E_C(gb_instr_info_t *info)
+static void gb_cpu_LOAD_E_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.E = mem.reg.C;
+	gb->mem.reg.E = gb->mem.reg.C;
 }
 
-static void gb_cpu_LOAD_E_D(gb_instr_info_t *info)
+static void gb_cpu_LOAD_E_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.E = mem.reg.D;
+	gb->mem.reg.E = gb->mem.reg.D;
 }
 
-static void gb_cpu_LOAD_E_E(gb_instr_info_t *info)
+static void gb_cpu_LOAD_E_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.E = mem.reg.E;
+	gb->mem.reg.E = gb->mem.reg.E;
 }
 
-static void gb_cpu_LOAD_E_H(gb_instr_info_t *info)
+static void gb_cpu_LOAD_E_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.E = mem.reg.H;
+	gb->mem.reg.E = gb->mem.reg.H;
 }
 
-static void gb_cpu_LOAD_E_L(gb_instr_info_t *info)
+static void gb_cpu_LOAD_E_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.E = mem.reg.L;
+	gb->mem.reg.E = gb->mem.reg.L;
 }
 
-static void gb_cpu_LOAD_E_HL(gb_instr_info_t *info)
+static void gb_cpu_LOAD_E_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.E = gb_memory_read(mem.reg.HL);
+	gb->mem.reg.E = gb_memory_read(gb, gb->mem.reg.HL);
 }
 
-static void gb_cpu_LOAD_E_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_E_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.E = mem.reg.A;
+	gb->mem.reg.E = gb->mem.reg.A;
 }
 
 /*********************0x6X*/
-static void gb_cpu_LOAD_H_B(gb_instr_info_t *info)
+static void gb_cpu_LOAD_H_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.H = mem.reg.B;
+	gb->mem.reg.H = gb->mem.reg.B;
 }
 
-static void gb_cpu_LOAD_H_C(gb_instr_info_t *info)
+static void gb_cpu_LOAD_H_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.H = mem.reg.C;
+	gb->mem.reg.H = gb->mem.reg.C;
 }
 
-static void gb_cpu_LOAD_H_D(gb_instr_info_t *info)
+static void gb_cpu_LOAD_H_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.H = mem.reg.D;
+	gb->mem.reg.H = gb->mem.reg.D;
 }
 
-static void gb_cpu_LOAD_H_E(gb_instr_info_t *info)
+static void gb_cpu_LOAD_H_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.H = mem.reg.E;
+	gb->mem.reg.H = gb->mem.reg.E;
 }
 
-static void gb_cpu_LOAD_H_H(gb_instr_info_t *info)
+static void gb_cpu_LOAD_H_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.H = mem.reg.H;
+	gb->mem.reg.H = gb->mem.reg.H;
 }
 
-static void gb_cpu_LOAD_H_L(gb_instr_info_t *info)
+static void gb_cpu_LOAD_H_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.H = mem.reg.L;
+	gb->mem.reg.H = gb->mem.reg.L;
 }
 
-static void gb_cpu_LOAD_H_HL(gb_instr_info_t *info)
+static void gb_cpu_LOAD_H_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.H = gb_memory_read(mem.reg.HL);
+	gb->mem.reg.H = gb_memory_read(gb, gb->mem.reg.HL);
 }
 
-static void gb_cpu_LOAD_H_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_H_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.H = mem.reg.A;
+	gb->mem.reg.H = gb->mem.reg.A;
 }
 
-static void gb_cpu_LOAD_L_B(gb_instr_info_t *info)
+static void gb_cpu_LOAD_L_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.L = mem.reg.B;
+	gb->mem.reg.L = gb->mem.reg.B;
 }
 
-static void gb_cpu_LOAD_L_C(gb_instr_info_t *info)
+static void gb_cpu_LOAD_L_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.L = mem.reg.C;
+	gb->mem.reg.L = gb->mem.reg.C;
 }
 
-static void gb_cpu_LOAD_L_D(gb_instr_info_t *info)
+static void gb_cpu_LOAD_L_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.L = mem.reg.D;
+	gb->mem.reg.L = gb->mem.reg.D;
 }
 
-static void gb_cpu_LOAD_L_E(gb_instr_info_t *info)
+static void gb_cpu_LOAD_L_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.L = mem.reg.E;
+	gb->mem.reg.L = gb->mem.reg.E;
 }
 
-static void gb_cpu_LOAD_L_H(gb_instr_info_t *info)
+static void gb_cpu_LOAD_L_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.L = mem.reg.H;
+	gb->mem.reg.L = gb->mem.reg.H;
 }
 
-static void gb_cpu_LOAD_L_L(gb_instr_info_t *info)
+static void gb_cpu_LOAD_L_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.L = mem.reg.L;
+	gb->mem.reg.L = gb->mem.reg.L;
 }
 
-static void gb_cpu_LOAD_L_HL(gb_instr_info_t *info)
+static void gb_cpu_LOAD_L_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.L = gb_memory_read(mem.reg.HL);
+	gb->mem.reg.L = gb_memory_read(gb, gb->mem.reg.HL);
 }
 
-static void gb_cpu_LOAD_L_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_L_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.L = mem.reg.A;
+	gb->mem.reg.L = gb->mem.reg.A;
 }
 
 /*********************0x7X*/
-static void gb_cpu_LOAD_HL_B(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, mem.reg.B);
+	gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.B);
 }
 
-static void gb_cpu_LOAD_HL_C(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, mem.reg.C);
+	gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.C);
 }
 
-static void gb_cpu_LOAD_HL_D(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, mem.reg.D);
+	gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.D);
 }
 
-static void gb_cpu_LOAD_HL_E(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, mem.reg.E);
+	gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.E);
 }
 
-static void gb_cpu_LOAD_HL_H(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, mem.reg.H);
+	gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.H);
 }
 
-static void gb_cpu_LOAD_HL_L(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, mem.reg.L);
+	gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.L);
 }
 
-static void gb_cpu_HALT(gb_instr_info_t *info)
+static void gb_cpu_HALT(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	halted = 1;
+	gb->cpu.halted = 1;
 }
 
-static void gb_cpu_LOAD_HL_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(mem.reg.HL, mem.reg.A);
+	gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.A);
 }
 
-static void gb_cpu_LOAD_A_B(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = mem.reg.B;
+	gb->mem.reg.A = gb->mem.reg.B;
 }
 
-static void gb_cpu_LOAD_A_C(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = mem.reg.C;
+	gb->mem.reg.A = gb->mem.reg.C;
 }
 
-static void gb_cpu_LOAD_A_D(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = mem.reg.D;
+	gb->mem.reg.A = gb->mem.reg.D;
 }
 
-static void gb_cpu_LOAD_A_E(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = mem.reg.E;
+	gb->mem.reg.A = gb->mem.reg.E;
 }
 
-static void gb_cpu_LOAD_A_H(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = mem.reg.H;
+	gb->mem.reg.A = gb->mem.reg.H;
 }
 
-static void gb_cpu_LOAD_A_L(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = mem.reg.L;
+	gb->mem.reg.A = gb->mem.reg.L;
 }
 
-static void gb_cpu_LOAD_A_HL(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = gb_memory_read(mem.reg.HL);
+	gb->mem.reg.A = gb_memory_read(gb, gb->mem.reg.HL);
 }
 
-static void gb_cpu_LOAD_A_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = mem.reg.A;
+	gb->mem.reg.A = gb->mem.reg.A;
 }
 
 /*********************0x8X*/
-static void gb_cpu_ADD_A_B(gb_instr_info_t *info)
+static void gb_cpu_ADD_A_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.B);
+	gb_cpu_addition_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.B);
 }
 
-static void gb_cpu_ADD_A_C(gb_instr_info_t *info)
+static void gb_cpu_ADD_A_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.C);
+	gb_cpu_addition_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.C);
 }
 
-static void gb_cpu_ADD_A_D(gb_instr_info_t *info)
+static void gb_cpu_ADD_A_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.D);
+	gb_cpu_addition_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.D);
 }
 
-static void gb_cpu_ADD_A_E(gb_instr_info_t *info)
+static void gb_cpu_ADD_A_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.E);
+	gb_cpu_addition_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.E);
 }
 
-static void gb_cpu_ADD_A_H(gb_instr_info_t *info)
+static void gb_cpu_ADD_A_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.H);
+	gb_cpu_addition_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.H);
 }
 
-static void gb_cpu_ADD_A_L(gb_instr_info_t *info)
+static void gb_cpu_ADD_A_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.L);
+	gb_cpu_addition_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.L);
 }
 
-static void gb_cpu_ADD_A_HL(gb_instr_info_t *info)
+static void gb_cpu_ADD_A_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_addition_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+	gb_cpu_addition_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
 
-static void gb_cpu_ADD_A_A(gb_instr_info_t *info)
+static void gb_cpu_ADD_A_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.A);
+	gb_cpu_addition_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.A);
 }
 
-static void gb_cpu_ADC_A_B(gb_instr_info_t *info)
+static void gb_cpu_ADC_A_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.B);
+	gb_cpu_addition_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.B);
 }
 
-static void gb_cpu_ADC_A_C(gb_instr_info_t *info)
+static void gb_cpu_ADC_A_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.C);
+	gb_cpu_addition_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.C);
 }
 
-static void gb_cpu_ADC_A_D(gb_instr_info_t *info)
+static void gb_cpu_ADC_A_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.D);
+	gb_cpu_addition_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.D);
 }
 
-static void gb_cpu_ADC_A_E(gb_instr_info_t *info)
+static void gb_cpu_ADC_A_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.E);
+	gb_cpu_addition_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.E);
 }
 
-static void gb_cpu_ADC_A_H(gb_instr_info_t *info)
+static void gb_cpu_ADC_A_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.H);
+	gb_cpu_addition_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.H);
 }
 
-static void gb_cpu_ADC_A_L(gb_instr_info_t *info)
+static void gb_cpu_ADC_A_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.L);
+	gb_cpu_addition_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.L);
 }
 
-static void gb_cpu_ADC_A_HL(gb_instr_info_t *info)
+static void gb_cpu_ADC_A_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_addition_carry_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+	gb_cpu_addition_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
 
-static void gb_cpu_ADC_A_A(gb_instr_info_t *info)
+static void gb_cpu_ADC_A_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_addition_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.A);
+	gb_cpu_addition_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.A);
 }
 
 /*********************0x9X*/
-static void gb_cpu_SUB_B(gb_instr_info_t *info)
+static void gb_cpu_SUB_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.B);
+	gb_cpu_subtraction_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.B);
 }
 
-static void gb_cpu_SUB_C(gb_instr_info_t *info)
+static void gb_cpu_SUB_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.C);
+	gb_cpu_subtraction_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.C);
 }
 
-static void gb_cpu_SUB_D(gb_instr_info_t *info)
+static void gb_cpu_SUB_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.D);
+	gb_cpu_subtraction_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.D);
 }
 
-static void gb_cpu_SUB_E(gb_instr_info_t *info)
+static void gb_cpu_SUB_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.E);
+	gb_cpu_subtraction_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.E);
 }
 
-static void gb_cpu_SUB_H(gb_instr_info_t *info)
+static void gb_cpu_SUB_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.H);
+	gb_cpu_subtraction_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.H);
 }
 
-static void gb_cpu_SUB_L(gb_instr_info_t *info)
+static void gb_cpu_SUB_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.L);
+	gb_cpu_subtraction_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.L);
 }
 
-static void gb_cpu_SUB_HL(gb_instr_info_t *info)
+static void gb_cpu_SUB_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_subtraction_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+	gb_cpu_subtraction_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
 
-static void gb_cpu_SUB_A(gb_instr_info_t *info)
+static void gb_cpu_SUB_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.A);
+	gb_cpu_subtraction_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.A);
 }
 
-static void gb_cpu_SBC_A_B(gb_instr_info_t *info)
+static void gb_cpu_SBC_A_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.B);
+	gb_cpu_subtraction_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.B);
 }
 
-static void gb_cpu_SBC_A_C(gb_instr_info_t *info)
+static void gb_cpu_SBC_A_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.C);
+	gb_cpu_subtraction_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.C);
 }
 
-static void gb_cpu_SBC_A_D(gb_instr_info_t *info)
+static void gb_cpu_SBC_A_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.D);
+	gb_cpu_subtraction_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.D);
 }
 
-static void gb_cpu_SBC_A_E(gb_instr_info_t *info)
+static void gb_cpu_SBC_A_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.E);
+	gb_cpu_subtraction_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.E);
 }
 
-static void gb_cpu_SBC_A_H(gb_instr_info_t *info)
+static void gb_cpu_SBC_A_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.H);
+	gb_cpu_subtraction_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.H);
 }
 
-static void gb_cpu_SBC_A_L(gb_instr_info_t *info)
+static void gb_cpu_SBC_A_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.L);
+	gb_cpu_subtraction_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.L);
 }
 
-static void gb_cpu_SBC_A_HL(gb_instr_info_t *info)
+static void gb_cpu_SBC_A_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_subtraction_carry_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+	gb_cpu_subtraction_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
 
-static void gb_cpu_SBC_A_A(gb_instr_info_t *info)
+static void gb_cpu_SBC_A_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_subtraction_carry_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.A);
+	gb_cpu_subtraction_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.A);
 }
 
 /*********************0xAX*/
-static void gb_cpu_AND_B(gb_instr_info_t *info)
+static void gb_cpu_AND_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A &= mem.reg.B;
-	mem.reg.F = (mem.reg.A == 0) ? 0xA0 : 0x20;
+	gb->mem.reg.A &= gb->mem.reg.B;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0xA0 : 0x20;
 }
 
-static void gb_cpu_AND_C(gb_instr_info_t *info)
+static void gb_cpu_AND_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A &= mem.reg.C;
-	mem.reg.F = (mem.reg.A == 0) ? 0xA0 : 0x20;
+	gb->mem.reg.A &= gb->mem.reg.C;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0xA0 : 0x20;
 }
 
-static void gb_cpu_AND_D(gb_instr_info_t *info)
+static void gb_cpu_AND_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A &= mem.reg.D;
-	mem.reg.F = (mem.reg.A == 0) ? 0xA0 : 0x20;
+	gb->mem.reg.A &= gb->mem.reg.D;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0xA0 : 0x20;
 }
 
-static void gb_cpu_AND_E(gb_instr_info_t *info)
+static void gb_cpu_AND_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A &= mem.reg.E;
-	mem.reg.F = (mem.reg.A == 0) ? 0xA0 : 0x20;
+	gb->mem.reg.A &= gb->mem.reg.E;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0xA0 : 0x20;
 }
 
-static void gb_cpu_AND_H(gb_instr_info_t *info)
+static void gb_cpu_AND_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A &= mem.reg.H;
-	mem.reg.F = (mem.reg.A == 0) ? 0xA0 : 0x20;
+	gb->mem.reg.A &= gb->mem.reg.H;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0xA0 : 0x20;
 }
 
-static void gb_cpu_AND_L(gb_instr_info_t *info)
+static void gb_cpu_AND_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A &= mem.reg.L;
-	mem.reg.F = (mem.reg.A == 0) ? 0xA0 : 0x20;
+	gb->mem.reg.A &= gb->mem.reg.L;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0xA0 : 0x20;
 }
 
-static void gb_cpu_AND_HL(gb_instr_info_t *info)
+static void gb_cpu_AND_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A &= gb_memory_read(mem.reg.HL);
-	mem.reg.F = (mem.reg.A == 0) ? 0xA0 : 0x20;
+	gb->mem.reg.A &= gb_memory_read(gb, gb->mem.reg.HL);
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0xA0 : 0x20;
 }
 
-static void gb_cpu_AND_A(gb_instr_info_t *info)
+static void gb_cpu_AND_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A &= mem.reg.A;
-	mem.reg.F = (mem.reg.A == 0) ? 0xA0 : 0x20;
+	gb->mem.reg.A &= gb->mem.reg.A;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0xA0 : 0x20;
 }
 
-static void gb_cpu_XOR_B(gb_instr_info_t *info)
+static void gb_cpu_XOR_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A ^= mem.reg.B;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A ^= gb->mem.reg.B;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_XOR_C(gb_instr_info_t *info)
+static void gb_cpu_XOR_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A ^= mem.reg.C;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A ^= gb->mem.reg.C;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_XOR_D(gb_instr_info_t *info)
+static void gb_cpu_XOR_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A ^= mem.reg.D;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A ^= gb->mem.reg.D;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_XOR_E(gb_instr_info_t *info)
+static void gb_cpu_XOR_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A ^= mem.reg.E;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A ^= gb->mem.reg.E;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_XOR_H(gb_instr_info_t *info)
+static void gb_cpu_XOR_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A ^= mem.reg.H;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A ^= gb->mem.reg.H;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_XOR_L(gb_instr_info_t *info)
+static void gb_cpu_XOR_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A ^= mem.reg.L;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A ^= gb->mem.reg.L;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_XOR_HL(gb_instr_info_t *info)
+static void gb_cpu_XOR_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A ^= gb_memory_read(mem.reg.HL);
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A ^= gb_memory_read(gb, gb->mem.reg.HL);
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_XOR_A(gb_instr_info_t *info)
+static void gb_cpu_XOR_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A ^= mem.reg.A;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A ^= gb->mem.reg.A;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
 /*********************0xBX*/
-static void gb_cpu_OR_B(gb_instr_info_t *info)
+static void gb_cpu_OR_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A |= mem.reg.B;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A |= gb->mem.reg.B;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_OR_C(gb_instr_info_t *info)
+static void gb_cpu_OR_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A |= mem.reg.C;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A |= gb->mem.reg.C;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_OR_D(gb_instr_info_t *info)
+static void gb_cpu_OR_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A |= mem.reg.D;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A |= gb->mem.reg.D;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_OR_E(gb_instr_info_t *info)
+static void gb_cpu_OR_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A |= mem.reg.E;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A |= gb->mem.reg.E;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_OR_H(gb_instr_info_t *info)
+static void gb_cpu_OR_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A |= mem.reg.H;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A |= gb->mem.reg.H;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_OR_L(gb_instr_info_t *info)
+static void gb_cpu_OR_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A |= mem.reg.L;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A |= gb->mem.reg.L;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_OR_HL(gb_instr_info_t *info)
+static void gb_cpu_OR_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A |= gb_memory_read(mem.reg.HL);
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A |= gb_memory_read(gb, gb->mem.reg.HL);
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_OR_A(gb_instr_info_t *info)
+static void gb_cpu_OR_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A |= mem.reg.A;
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A |= gb->mem.reg.A;
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_CP_B(gb_instr_info_t *info)
+static void gb_cpu_CP_B(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_compare_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.B);
+	gb_cpu_compare_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.B);
 }
 
-static void gb_cpu_CP_C(gb_instr_info_t *info)
+static void gb_cpu_CP_C(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_compare_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.C);
+	gb_cpu_compare_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.C);
 }
 
-static void gb_cpu_CP_D(gb_instr_info_t *info)
+static void gb_cpu_CP_D(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_compare_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.D);
+	gb_cpu_compare_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.D);
 }
 
-static void gb_cpu_CP_E(gb_instr_info_t *info)
+static void gb_cpu_CP_E(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_compare_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.E);
+	gb_cpu_compare_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.E);
 }
 
-static void gb_cpu_CP_H(gb_instr_info_t *info)
+static void gb_cpu_CP_H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_compare_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.H);
+	gb_cpu_compare_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.H);
 }
 
-static void gb_cpu_CP_L(gb_instr_info_t *info)
+static void gb_cpu_CP_L(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_compare_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.L);
+	gb_cpu_compare_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.L);
 }
 
-static void gb_cpu_CP_HL(gb_instr_info_t *info)
+static void gb_cpu_CP_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_compare_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+	gb_cpu_compare_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
 
-static void gb_cpu_CP_A(gb_instr_info_t *info)
+static void gb_cpu_CP_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_compare_A_register(&mem.reg.A, &mem.reg.F, &mem.reg.A);
+	gb_cpu_compare_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &gb->mem.reg.A);
 }
 
 /*********************0xCX*/
-static void gb_cpu_RET_NZ(gb_instr_info_t *info)
+static void gb_cpu_RET_NZ(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, Z_FLAG_BIT)) ? 2 : 5;
-	} else if (info->current_cycle == 5) {
-		dont_update_pc = true;
-		gb_cpu_return_from_stack(&mem.reg.SP, &mem.reg.PC);
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, Z_FLAG_BIT)) ? 2 : 5;
+	} else if (gb->cpu.current_cycle == 5) {
+		gb->cpu.dont_update_pc = true;
+		gb_cpu_return_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.PC);
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_POP_BC(gb_instr_info_t *info)
+static void gb_cpu_POP_BC(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_pop_from_stack(&mem.reg.SP, &mem.reg.BC);
+	gb_cpu_pop_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.BC);
 }
 
-static void gb_cpu_JP_NZ_a16(gb_instr_info_t *info)
+static void gb_cpu_JP_NZ_a16(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, Z_FLAG_BIT) != 0) ? 3 : 4;
-	} else if (info->current_cycle == 4) {
-		dont_update_pc = true;
-		mem.reg.PC =
-			CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, Z_FLAG_BIT) != 0) ? 3 : 4;
+	} else if (gb->cpu.current_cycle == 4) {
+		gb->cpu.dont_update_pc = true;
+		gb->mem.reg.PC =
+			CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				  gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_JP_a16(gb_instr_info_t *info)
+static void gb_cpu_JP_a16(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	mem.reg.PC = CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	gb->cpu.dont_update_pc = true;
+	gb->mem.reg.PC = CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				   gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 }
 
-static void gb_cpu_CALL_NZ_a16(gb_instr_info_t *info)
+static void gb_cpu_CALL_NZ_a16(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, Z_FLAG_BIT) != 0) ? 3 : 6;
-	} else if (info->current_cycle == 6) {
-		dont_update_pc = true;
-		gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-		mem.reg.PC =
-			CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, Z_FLAG_BIT) != 0) ? 3 : 6;
+	} else if (gb->cpu.current_cycle == 6) {
+		gb->cpu.dont_update_pc = true;
+		gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+		gb->mem.reg.PC =
+			CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				  gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_PUSH_BC(gb_instr_info_t *info)
+static void gb_cpu_PUSH_BC(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.BC);
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.BC);
 }
 
-static void gb_cpu_ADD_A_d8(gb_instr_info_t *info)
+static void gb_cpu_ADD_A_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.PC + 1);
-	gb_cpu_addition_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+	gb_cpu_addition_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
 
-static void gb_cpu_RST_00H(gb_instr_info_t *info)
+static void gb_cpu_RST_00H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-	mem.reg.PC = 0x0000;
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+	gb->mem.reg.PC = 0x0000;
 }
 
-static void gb_cpu_RET_Z(gb_instr_info_t *info)
+static void gb_cpu_RET_Z(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, Z_FLAG_BIT)) ? 5 : 2;
-	} else if (info->current_cycle == 5) {
-		dont_update_pc = true;
-		gb_cpu_return_from_stack(&mem.reg.SP, &mem.reg.PC);
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, Z_FLAG_BIT)) ? 5 : 2;
+	} else if (gb->cpu.current_cycle == 5) {
+		gb->cpu.dont_update_pc = true;
+		gb_cpu_return_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.PC);
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_RET(gb_instr_info_t *info)
+static void gb_cpu_RET(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_return_from_stack(&mem.reg.SP, &mem.reg.PC);
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_return_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.PC);
 }
 
-static void gb_cpu_JP_Z_a16(gb_instr_info_t *info)
+static void gb_cpu_JP_Z_a16(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, Z_FLAG_BIT) != 0) ? 4 : 3;
-	} else if (info->current_cycle == 4) {
-		dont_update_pc = true;
-		mem.reg.PC =
-			CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, Z_FLAG_BIT) != 0) ? 4 : 3;
+	} else if (gb->cpu.current_cycle == 4) {
+		gb->cpu.dont_update_pc = true;
+		gb->mem.reg.PC =
+			CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				  gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_PREFIX(gb_instr_info_t *info)
-{
-	((void (*)(gb_instr_info_t *))prefix_instructions[gb_memory_read(mem.reg.PC + 1)].instr)(
-		info);
 }
 
-static void gb_cpu_CALL_Z_a16(gb_instr_info_t *info)
+static void gb_cpu_CALL_Z_a16(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, Z_FLAG_BIT) != 0) ? 6 : 3;
-	} else if (info->current_cycle == 6) {
-		dont_update_pc = true;
-		gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-		mem.reg.PC =
-			CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, Z_FLAG_BIT) != 0) ? 6 : 3;
+	} else if (gb->cpu.current_cycle == 6) {
+		gb->cpu.dont_update_pc = true;
+		gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+		gb->mem.reg.PC =
+			CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				  gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_CALL_a16(gb_instr_info_t *info)
+static void gb_cpu_CALL_a16(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-	mem.reg.PC = CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+	gb->mem.reg.PC = CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				   gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 }
 
-static void gb_cpu_ADC_A_d8(gb_instr_info_t *info)
+static void gb_cpu_ADC_A_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.PC + 1);
-	gb_cpu_addition_carry_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+	gb_cpu_addition_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
 
-static void gb_cpu_RST_08H(gb_instr_info_t *info)
+static void gb_cpu_RST_08H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-	mem.reg.PC = 0x0008;
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+	gb->mem.reg.PC = 0x0008;
 }
 
 /*********************0xDX*/
-static void gb_cpu_RET_NC(gb_instr_info_t *info)
+static void gb_cpu_RET_NC(gb_t *gb, const gb_instr_info_t *info)
 {
+	(void)info;
 
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, C_FLAG_BIT)) ? 2 : 5;
-	} else if (info->current_cycle == 5) {
-		dont_update_pc = true;
-		gb_cpu_return_from_stack(&mem.reg.SP, &mem.reg.PC);
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, C_FLAG_BIT)) ? 2 : 5;
+	} else if (gb->cpu.current_cycle == 5) {
+		gb->cpu.dont_update_pc = true;
+		gb_cpu_return_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.PC);
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_POP_DE(gb_instr_info_t *info)
+static void gb_cpu_POP_DE(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_pop_from_stack(&mem.reg.SP, &mem.reg.DE);
+	gb_cpu_pop_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.DE);
 }
 
-static void gb_cpu_JP_NC_a16(gb_instr_info_t *info)
+static void gb_cpu_JP_NC_a16(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, C_FLAG_BIT) != 0) ? 3 : 4;
-	} else if (info->current_cycle == 4) {
-		dont_update_pc = true;
-		mem.reg.PC =
-			CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, C_FLAG_BIT) != 0) ? 3 : 4;
+	} else if (gb->cpu.current_cycle == 4) {
+		gb->cpu.dont_update_pc = true;
+		gb->mem.reg.PC =
+			CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				  gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
 // -----------
-static void gb_cpu_CALL_NC_a16(gb_instr_info_t *info)
-{
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, C_FLAG_BIT) != 0) ? 3 : 6;
-	} else if (info->current_cycle == 6) {
-		dont_update_pc = true;
-		gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-		mem.reg.PC =
-			CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+static void gb_cpu_CALL_NC_a16(gb_t *gb, const gb_instr_info_t *info)
+{
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, C_FLAG_BIT) != 0) ? 3 : 6;
+	} else if (gb->cpu.current_cycle == 6) {
+		gb->cpu.dont_update_pc = true;
+		gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+		gb->mem.reg.PC =
+			CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				  gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_PUSH_DE(gb_instr_info_t *info)
+static void gb_cpu_PUSH_DE(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.DE);
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.DE);
 }
 
-static void gb_cpu_SUB_d8(gb_instr_info_t *info)
+static void gb_cpu_SUB_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.PC + 1);
-	gb_cpu_subtraction_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+	gb_cpu_subtraction_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
 
-static void gb_cpu_RST_10H(gb_instr_info_t *info)
+static void gb_cpu_RST_10H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-	mem.reg.PC = 0x0010;
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+	gb->mem.reg.PC = 0x0010;
 }
 
-static void gb_cpu_RET_C(gb_instr_info_t *info)
+static void gb_cpu_RET_C(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, C_FLAG_BIT)) ? 5 : 2;
-	} else if (info->current_cycle == 5) {
-		dont_update_pc = true;
-		gb_cpu_return_from_stack(&mem.reg.SP, &mem.reg.PC);
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, C_FLAG_BIT)) ? 5 : 2;
+	} else if (gb->cpu.current_cycle == 5) {
+		gb->cpu.dont_update_pc = true;
+		gb_cpu_return_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.PC);
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_RETI(gb_instr_info_t *info)
+static void gb_cpu_RETI(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	interrupt_master_enable = 1;
-	dont_update_pc = true;
-	gb_cpu_return_from_stack(&mem.reg.SP, &mem.reg.PC);
+	gb->cpu.interrupt_master_enable = 1;
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_return_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.PC);
 }
 
-static void gb_cpu_JP_C_a16(gb_instr_info_t *info)
+static void gb_cpu_JP_C_a16(gb_t *gb, const gb_instr_info_t *info)
 {
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, C_FLAG_BIT) != 0) ? 4 : 3;
-	} else if (info->current_cycle == 4) {
-		dont_update_pc = true;
-		mem.reg.PC =
-			CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+	(void)info;
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, C_FLAG_BIT) != 0) ? 4 : 3;
+	} else if (gb->cpu.current_cycle == 4) {
+		gb->cpu.dont_update_pc = true;
+		gb->mem.reg.PC =
+			CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				  gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
 // -----------
-static void gb_cpu_CALL_C_a16(gb_instr_info_t *info)
-{
-	if (info->current_cycle == 1) {
-		op_remaining = (CHK_BIT(mem.reg.F, C_FLAG_BIT) != 0) ? 6 : 3;
-	} else if (info->current_cycle == 6) {
-		dont_update_pc = true;
-		gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-		mem.reg.PC =
-			CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2));
+static void gb_cpu_CALL_C_a16(gb_t *gb, const gb_instr_info_t *info)
+{
+	if (gb->cpu.current_cycle == 1) {
+		gb->cpu.op_remaining = (CHK_BIT(gb->mem.reg.F, C_FLAG_BIT) != 0) ? 6 : 3;
+	} else if (gb->cpu.current_cycle == 6) {
+		gb->cpu.dont_update_pc = true;
+		gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+		gb->mem.reg.PC =
+			CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				  gb_cpu_fetch(gb, gb->mem.reg.PC + 2));
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
 // -----------
-static void gb_cpu_SBC_A_d8(gb_instr_info_t *info)
+static void gb_cpu_SBC_A_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.PC + 1);
-	gb_cpu_subtraction_carry_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+	gb_cpu_subtraction_carry_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
 
-static void gb_cpu_RST_18H(gb_instr_info_t *info)
+static void gb_cpu_RST_18H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-	mem.reg.PC = 0x0018;
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+	gb->mem.reg.PC = 0x0018;
 }
 
 /*********************0xEX*/
-static void gb_cpu_LOAD_a8_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_a8_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(0xFF00 + gb_memory_read(mem.reg.PC + 1), mem.reg.A);
+	gb_memory_write(gb, 0xFF00 + gb_cpu_fetch(gb, gb->mem.reg.PC + 1), gb->mem.reg.A);
 }
 
-static void gb_cpu_POP_HL(gb_instr_info_t *info)
+static void gb_cpu_POP_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_pop_from_stack(&mem.reg.SP, &mem.reg.HL);
+	gb_cpu_pop_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.HL);
 }
 
-static void gb_cpu_LOAD_fC_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_fC_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(0xFF00 + mem.reg.C, mem.reg.A);
+	gb_memory_write(gb, 0xFF00 + gb->mem.reg.C, gb->mem.reg.A);
 }
 
 // -----------
 // -----------
-static void gb_cpu_PUSH_HL(gb_instr_info_t *info)
+static void gb_cpu_PUSH_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.HL);
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.HL);
 }
 
-static void gb_cpu_AND_d8(gb_instr_info_t *info)
+static void gb_cpu_AND_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A &= gb_memory_read(mem.reg.PC + 1);
-	mem.reg.F = (mem.reg.A == 0) ? 0xA0 : 0x20;
+	gb->mem.reg.A &= gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0xA0 : 0x20;
 }
 
-static void gb_cpu_RST20H(gb_instr_info_t *info)
+static void gb_cpu_RST20H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-	mem.reg.PC = 0x0020;
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+	gb->mem.reg.PC = 0x0020;
 }
 
-static void gb_cpu_ADD_SP_r8(gb_instr_info_t *info)
+static void gb_cpu_ADD_SP_r8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t r8_val = gb_memory_read(mem.reg.PC + 1);
-	uint32_t temp_res = mem.reg.SP + r8_val;
-	((temp_res & 0xFF) < (mem.reg.SP & 0xFF)) ? SET_BIT(mem.reg.F, C_FLAG_BIT)
-						  : RST_BIT(mem.reg.F, C_FLAG_BIT);
-	((temp_res & 0xF) < (mem.reg.SP & 0xF)) ? SET_BIT(mem.reg.F, H_FLAG_BIT)
-						: RST_BIT(mem.reg.F, H_FLAG_BIT);
-	RST_BIT(mem.reg.F, Z_FLAG_BIT);
-	RST_BIT(mem.reg.F, N_FLAG_BIT);
-	mem.reg.SP += (int8_t)r8_val;
+	gb->mem.reg.SP = gb_cpu_offset_SP_register(gb->mem.reg.SP, &gb->mem.reg.F,
+						   gb_cpu_fetch(gb, gb->mem.reg.PC + 1));
 }
 
-static void gb_cpu_JP_HL(gb_instr_info_t *info)
+static void gb_cpu_JP_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	mem.reg.PC = mem.reg.HL;
+	gb->cpu.dont_update_pc = true;
+	gb->mem.reg.PC = gb->mem.reg.HL;
 }
 
-static void gb_cpu_LOAD_a16_A(gb_instr_info_t *info)
+static void gb_cpu_LOAD_a16_A(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_memory_write(CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2)),
-			mem.reg.A);
+	gb_memory_write(gb,
+			CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+				  gb_cpu_fetch(gb, gb->mem.reg.PC + 2)),
+			gb->mem.reg.A);
 }
 
 // -----------
 // -----------
 // -----------
-static void gb_cpu_XOR_d8(gb_instr_info_t *info)
+static void gb_cpu_XOR_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A ^= gb_memory_read(mem.reg.PC + 1);
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A ^= gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_RST_28H(gb_instr_info_t *info)
+static void gb_cpu_RST_28H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-	mem.reg.PC = 0x0028;
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+	gb->mem.reg.PC = 0x0028;
 }
 
 /*********************0xFX*/
-static void gb_cpu_LOAD_A_a8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_a8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = gb_memory_read(0xFF00 + gb_memory_read(mem.reg.PC + 1));
+	gb->mem.reg.A = gb_memory_read(gb, 0xFF00 + gb_cpu_fetch(gb, gb->mem.reg.PC + 1));
 }
 
-static void gb_cpu_POP_AF(gb_instr_info_t *info)
+static void gb_cpu_POP_AF(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_pop_from_stack(&mem.reg.SP, &mem.reg.AF);
-	mem.reg.AF &= 0xFFF0;
+	gb_cpu_pop_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.AF);
+	gb->mem.reg.AF &= 0xFFF0;
 }
 
-static void gb_cpu_LOAD_A_fC(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_fC(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = gb_memory_read(0xFF00 + mem.reg.C);
+	gb->mem.reg.A = gb_memory_read(gb, 0xFF00 + gb->mem.reg.C);
 }
 
-static void gb_cpu_DI(gb_instr_info_t *info)
+static void gb_cpu_DI(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	interrupt_master_enable = 0;
+	gb->cpu.interrupt_master_enable = 0;
 }
 
 // -----------
-static void gb_cpu_PUSH_AF(gb_instr_info_t *info)
+static void gb_cpu_PUSH_AF(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.AF);
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.AF);
 }
 
-static void gb_cpu_OR_d8(gb_instr_info_t *info)
+static void gb_cpu_OR_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A |= gb_memory_read(mem.reg.PC + 1);
-	mem.reg.F = (mem.reg.A == 0) ? 0x80 : 0x00;
+	gb->mem.reg.A |= gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+	gb->mem.reg.F = (gb->mem.reg.A == 0) ? 0x80 : 0x00;
 }
 
-static void gb_cpu_RST_30H(gb_instr_info_t *info)
+static void gb_cpu_RST_30H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-	mem.reg.PC = 0x0030;
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+	gb->mem.reg.PC = 0x0030;
 }
 
-static void gb_cpu_LOAD_HL_SP_r8(gb_instr_info_t *info)
+static void gb_cpu_LOAD_HL_SP_r8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t r8_val = gb_memory_read(mem.reg.PC + 1);
-	uint32_t temp_res = mem.reg.SP + r8_val;
-	((temp_res & 0xFF) < (mem.reg.SP & 0xFF)) ? SET_BIT(mem.reg.F, C_FLAG_BIT)
-						  : RST_BIT(mem.reg.F, C_FLAG_BIT);
-	((temp_res & 0xF) < (mem.reg.SP & 0xF)) ? SET_BIT(mem.reg.F, H_FLAG_BIT)
-						: RST_BIT(mem.reg.F, H_FLAG_BIT);
-	RST_BIT(mem.reg.F, Z_FLAG_BIT);
-	RST_BIT(mem.reg.F, N_FLAG_BIT);
-	mem.reg.HL = mem.reg.SP + (int8_t)r8_val;
+	gb->mem.reg.HL = gb_cpu_offset_SP_register(gb->mem.reg.SP, &gb->mem.reg.F,
+						   gb_cpu_fetch(gb, gb->mem.reg.PC + 1));
 }
 
-static void gb_cpu_LOAD_SP_HL(gb_instr_info_t *info)
+static void gb_cpu_LOAD_SP_HL(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.SP = mem.reg.HL;
+	gb->mem.reg.SP = gb->mem.reg.HL;
 }
 
-static void gb_cpu_LOAD_A_a16(gb_instr_info_t *info)
+static void gb_cpu_LOAD_A_a16(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	mem.reg.A = gb_memory_read(
-		CAT_BYTES(gb_memory_read(mem.reg.PC + 1), gb_memory_read(mem.reg.PC + 2)));
+	gb->mem.reg.A = gb_memory_read(gb,
+				       CAT_BYTES(gb_cpu_fetch(gb, gb->mem.reg.PC + 1),
+						 gb_cpu_fetch(gb, gb->mem.reg.PC + 2)));
 }
 
-static void gb_cpu_EI(gb_instr_info_t *info)
+static void gb_cpu_EI(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	interrupt_master_enable = 1;
+	gb->cpu.interrupt_master_enable = 1;
 }
 
 // -----------
 // -----------
-static void gb_cpu_CP_d8(gb_instr_info_t *info)
+static void gb_cpu_CP_d8(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.PC + 1);
-	gb_cpu_compare_A_register(&mem.reg.A, &mem.reg.F, &temp_res);
+	uint8_t temp_res = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+	gb_cpu_compare_A_register(&gb->mem.reg.A, &gb->mem.reg.F, &temp_res);
 }
-static void gb_cpu_RST_38H(gb_instr_info_t *info)
+static void gb_cpu_RST_38H(gb_t *gb, const gb_instr_info_t *info)
 {
 	(void)info;
-	dont_update_pc = true;
-	gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC + info->bytes);
-	mem.reg.PC = 0x0038;
+	gb->cpu.dont_update_pc = true;
+	gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC + info->bytes);
+	gb->mem.reg.PC = 0x0038;
 }
 
 /*Prefix implementation*/
 
-/*********************0x0X*/
-static void gb_cpu_RLC_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_left_with_carry(&mem.reg.B, &mem.reg.F);
-}
+/* Registers of the 3 bit register operand used by the LD, ALU and CB instructions, in the order
+ * B, C, D, E, H, L, (HL), A. (HL) is a memory operand and has no entry. */
+static const uint8_t gb_cpu_reg8_offset[8] = {
+	offsetof(registers_t, B),
+	offsetof(registers_t, C),
+	offsetof(registers_t, D),
+	offsetof(registers_t, E),
+	offsetof(registers_t, H),
+	offsetof(registers_t, L),
+	0,
+	offsetof(registers_t, A),
+};
 
-static void gb_cpu_RLC_C(gb_instr_info_t *info)
+/* Registers of the 2 bit register pair operand, in the order BC, DE, HL, SP */
+static const uint8_t gb_cpu_reg16_offset[4] = {
+	offsetof(registers_t, BC),
+	offsetof(registers_t, DE),
+	offsetof(registers_t, HL),
+	offsetof(registers_t, SP),
+};
+
+static inline uint8_t *gb_cpu_reg8(gb_t *gb, uint8_t index)
 {
-	(void)info;
-	gb_cpu_rotate_left_with_carry(&mem.reg.C, &mem.reg.F);
+	return (uint8_t *)&gb->mem.reg + gb_cpu_reg8_offset[index];
 }
 
-static void gb_cpu_RLC_D(gb_instr_info_t *info)
+static inline uint16_t *gb_cpu_reg16(gb_t *gb, uint8_t index)
 {
-	(void)info;
-	gb_cpu_rotate_left_with_carry(&mem.reg.D, &mem.reg.F);
+	return (uint16_t *)((uint8_t *)&gb->mem.reg + gb_cpu_reg16_offset[index]);
 }
 
-static void gb_cpu_RLC_E(gb_instr_info_t *info)
+/* Timing of a CB prefixed instruction, which only depends on its operand and on it being BIT */
+static inline const gb_instr_info_t *gb_cpu_prefix_info(uint8_t opcode)
 {
-	(void)info;
-	gb_cpu_rotate_left_with_carry(&mem.reg.E, &mem.reg.F);
+	if ((opcode & 0x07) != 6) {
+		return &prefix_info[0];
+	}
+	return &prefix_info[((opcode & 0xC0) == 0x40) ? 1 : 2];
 }
 
-static void gb_cpu_RLC_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_left_with_carry(&mem.reg.H, &mem.reg.F);
+/**
+ * @brief Runs the operation of a CB prefixed instruction on its operand.
+ * @details The opcode is made up of the operation class in bits 6 - 7 (rotates and shifts, BIT,
+ * RES, SET), the rotate or shift, or the bit, in bits 3 - 5 and the operand in bits 0 - 2.
+ * @param opcode instruction opcode following the prefix
+ * @param operand register, or the value read from (HL), the result is stored back into it
+ * @returns Nothing
+ */
+static inline void gb_cpu_prefix_operation(gb_t *gb, uint8_t opcode, uint8_t *operand)
+{
+	uint8_t bit = (opcode >> 3) & 0x07;
+
+	switch (opcode >> 6) {
+	case 0:
+		switch (bit) {
+		case 0:
+			gb_cpu_rotate_left_with_carry(operand, &gb->mem.reg.F);
+			break;
+		case 1:
+			gb_cpu_rotate_right_with_carry(operand, &gb->mem.reg.F);
+			break;
+		case 2:
+			gb_cpu_rotate_left_through_carry(operand, &gb->mem.reg.F);
+			break;
+		case 3:
+			gb_cpu_rotate_right_through_carry(operand, &gb->mem.reg.F);
+			break;
+		case 4:
+			gb_cpu_shift_left_into_carry(operand, &gb->mem.reg.F);
+			break;
+		case 5:
+			gb_cpu_shift_right_with_carry(operand, &gb->mem.reg.F);
+			break;
+		case 6:
+			gb_cpu_swap_nibbles(operand, &gb->mem.reg.F);
+			break;
+		default:
+			gb_cpu_shift_right_into_carry(operand, &gb->mem.reg.F);
+			break;
+		}
+		break;
+	case 1:
+		gb_cpu_bit_check(operand, bit, &gb->mem.reg.F);
+		break;
+	case 2:
+		RST_BIT(*operand, bit);
+		break;
+	default:
+		SET_BIT(*operand, bit);
+		break;
+	}
 }
 
-static void gb_cpu_RLC_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_left_with_carry(&mem.reg.L, &mem.reg.F);
+/**
+ * @brief Runs a CB prefixed instruction in the M-cycle core.
+ * @details Register operands are done on the first M-cycle. BIT reads (HL) on the second one,
+ * the other operations read it on the second M-cycle and write the result back on the third.
+ * @returns Nothing
+ */
+static void gb_cpu_PREFIX(gb_t *gb, const gb_instr_info_t *info)
+{
+	uint8_t opcode = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+	uint8_t index = opcode & 0x07;
+
+	(void)info;
+	if (index != 6) {
+		gb_cpu_prefix_operation(gb, opcode, gb_cpu_reg8(gb, index));
+	} else if ((opcode & 0xC0) == 0x40) {
+		gb->cpu.temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+		gb_cpu_prefix_operation(gb, opcode, &gb->cpu.temp_res);
+	} else if (gb->cpu.current_cycle == 2) {
+		gb->cpu.temp_res = gb_memory_read(gb, gb->mem.reg.HL);
+	} else if (gb->cpu.current_cycle == 3) {
+		gb_cpu_prefix_operation(gb, opcode, &gb->cpu.temp_res);
+		gb_memory_write(gb, gb->mem.reg.HL, gb->cpu.temp_res);
+	}
 }
 
-static void gb_cpu_RLC_HL(gb_instr_info_t *info)
+/**
+ * @brief If the corresponding IE and IF are both set then jump to the
+ * corresponding ISR
+ * @returns Nothing
+ */
+static void gb_cpu_interrupt_handler(gb_t *gb)
 {
-	static uint8_t temp_val = 0;
-	if (info->current_cycle == 2) {
-		temp_val = gb_memory_read(mem.reg.HL);
+	if (gb->cpu.one_cycle_interrupt_delay == 1) {
+		if (gb->cpu.pending_interrupts) {
+			gb->cpu.interrupt_master_enable = 0;
+			gb->cpu.one_cycle_interrupt_delay = 0;
+			gb->cpu.halted = 0;
+			uint8_t interrupt_triggered = 0;
+			uint8_t interrupt_set_and_enabled = gb->cpu.pending_interrupts;
+			if (interrupt_set_and_enabled & VBLANK_INTERRUPT) {
+				gb_memory_reset_bit(gb, IF_ADDR, 0);
+				gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC);
+				interrupt_triggered = 1;
+				gb->mem.reg.PC = VBLANK_VECTOR;
+			} else if (interrupt_set_and_enabled & LCDSTAT_INTERRUPT) {
+				gb_memory_reset_bit(gb, IF_ADDR, 1);
+				gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC);
+				interrupt_triggered = 1;
+				gb->mem.reg.PC = LCDSTAT_VECTOR;
+			} else if (interrupt_set_and_enabled & TIMER_INTERRUPT) {
+				gb_memory_reset_bit(gb, IF_ADDR, 2);
+				gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC);
+				interrupt_triggered = 1;
+				gb->mem.reg.PC = TIMER_VECTOR;
+			} else if (interrupt_set_and_enabled & SERIAL_INTERRUPT) {
+				gb_memory_reset_bit(gb, IF_ADDR, 3);
+				gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC);
+				interrupt_triggered = 1;
+				gb->mem.reg.PC = SERIAL_VECTOR;
+			} else if (interrupt_set_and_enabled & JOYPAD_INTERRUPT) {
+				gb_memory_reset_bit(gb, IF_ADDR, 4);
+				gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.PC);
+				interrupt_triggered = 1;
+				gb->mem.reg.PC = JOYPAD_VECTOR;
+			}
+
+			if (interrupt_triggered == 1) {
+				gb->cpu.interupt_dur += 5;
+			}
+		}
 
-	} else if (info->current_cycle == 3) {
-		gb_cpu_rotate_left_with_carry(&temp_val, &mem.reg.F);
-		gb_memory_write(mem.reg.HL, temp_val);
+	} else {
+		gb->cpu.one_cycle_interrupt_delay++;
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_RLC_A(gb_instr_info_t *info)
+/**
+ * @brief If the CPU is halted and interrupt_master_enable is not set, then this
+ * function will unhalt the CPU if both IE and IF flags are set without jumping
+ * to the ISR
+ * @returns Nothing
+ */
+static void gb_cpu_halted_handler(gb_t *gb)
 {
-	(void)info;
-	gb_cpu_rotate_left_with_carry(&mem.reg.A, &mem.reg.F);
+	if (gb->cpu.one_cycle_interrupt_delay == 1) {
+		if (gb->cpu.pending_interrupts) {
+			gb->cpu.interrupt_master_enable = 0;
+			gb->cpu.one_cycle_interrupt_delay = 0;
+			uint8_t interrupt_set_and_enabled = gb->cpu.pending_interrupts;
+			if (interrupt_set_and_enabled & VBLANK_INTERRUPT) {
+				gb->cpu.halted = 0;
+			} else if (interrupt_set_and_enabled & LCDSTAT_INTERRUPT) {
+				gb->cpu.halted = 0;
+			} else if (interrupt_set_and_enabled & TIMER_INTERRUPT) {
+				gb->cpu.halted = 0;
+			} else if (interrupt_set_and_enabled & SERIAL_INTERRUPT) {
+				gb->cpu.halted = 0;
+			} else if (interrupt_set_and_enabled & JOYPAD_INTERRUPT) {
+				gb->cpu.halted = 0;
+			}
+		}
+	} else {
+		gb->cpu.one_cycle_interrupt_delay++;
+	}
 }
 
-static void gb_cpu_RRC_B(gb_instr_info_t *info)
+/**
+ * @brief Runs the timer events due on the current M-cycle and, once the current instruction is
+ * done, handles interrupts
+ * @returns Nothing
+ */
+static void gb_cpu_end_m_cycle(gb_t *gb)
 {
-	(void)info;
-	gb_cpu_rotate_right_with_carry(&mem.reg.B, &mem.reg.F);
+	/* Run timer events due on this M-cycle */
+	gb_sched_run_cpu_events(gb);
+
+	/* Handle interupts */
+	if (gb->cpu.interrupt_master_enable == 1 && gb->cpu.op_remaining == 0) {
+		gb_cpu_interrupt_handler(gb);
+	} else if (gb->cpu.halted == 1 && gb->cpu.op_remaining == 0) {
+		gb_cpu_halted_handler(gb);
+	}
 }
 
-static void gb_cpu_RRC_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_right_with_carry(&mem.reg.C, &mem.reg.F);
+void gb_cpu_init(gb_t *gb)
+{
+	gb->cpu.mode = GB_CPU_MODE_INSTRUCTION;
+	gb->cpu.stopped = 0;
+	gb->cpu.halted = 0;
+	gb->cpu.interrupt_master_enable = 0;
+	gb->cpu.one_cycle_interrupt_delay = 0;
+	gb->cpu.pending_interrupts = 0;
+	gb->cpu.op_remaining = 0;
+	gb->cpu.interupt_dur = 0;
+	gb->cpu.opcode = 0;
+	gb->cpu.current_cycle = 0;
+	gb->cpu.dont_update_pc = false;
+	gb->cpu.next_instruction = 0;
+	gb->cpu.instr_info = NULL;
+	gb->cpu.flags_op = 0;
+	gb->cpu.idle_cycles = 0;
+	gb->cpu.fetch_ptr = NULL;
+	gb->cpu.fetch_base = 0;
+	gb->cpu.fetch_size = 0;
 }
 
-static void gb_cpu_RRC_D(gb_instr_info_t *info)
+/**
+ * @brief Selects the CPU core used by gb_run_cycles() and gb_run_frame().
+ * @details All cores produce the same state at instruction boundaries. The M-cycle core can stop
+ * in the middle of an instruction and is always used while a debugger is attached, the instruction
+ * core only stops between instructions but runs considerably faster. The JIT mode runs the
+ * instruction core with hot code translated to native code, it behaves like the instruction mode
+ * on hosts other than x86-64. The JIT check mode runs every translated segment a second time on
+ * the instruction core and compares the results, see gb_cpu_get_jit_mismatches().
+ * @param mode CPU core to use
+ * @returns Nothing
+ */
+void gb_cpu_set_mode(gb_t *gb, gb_cpu_mode_t mode)
 {
-	(void)info;
-	gb_cpu_rotate_right_with_carry(&mem.reg.D, &mem.reg.F);
+	gb->cpu.mode = mode;
 }
 
-static void gb_cpu_RRC_E(gb_instr_info_t *info)
+/**
+ * @brief Brings the CPU registers up to date.
+ * @details The instruction core leaves the flags of the arithmetic instructions in F to be worked
+ * out once they are needed, this does so for anything outside of the CPU that reads F.
+ * @returns Nothing
+ */
+void gb_cpu_sync(gb_t *gb)
 {
-	(void)info;
-	gb_cpu_rotate_right_with_carry(&mem.reg.E, &mem.reg.F);
+	gb_cpu_flags(gb);
 }
 
-static void gb_cpu_RRC_H(gb_instr_info_t *info)
+/**
+ * @brief Returns the number of clock cycles the CPU skipped over busy-wait loops for.
+ * @details The count covers the lifetime of the emulator context, which runs a single ROM.
+ * Loops are only skipped outside of the M-cycle mode.
+ * @returns clock cycles
+ */
+uint64_t gb_cpu_get_idle_cycles(const gb_t *gb)
 {
-	(void)info;
-	gb_cpu_rotate_right_with_carry(&mem.reg.H, &mem.reg.F);
+	return gb->cpu.idle_cycles;
 }
 
-static void gb_cpu_RRC_L(gb_instr_info_t *info)
+/**
+ * @brief Returns the number of native code segments that did not match the instruction core.
+ * @details Only the JIT check mode compares segments, each mismatch is also logged.
+ * @returns number of mismatching segments
+ */
+uint32_t gb_cpu_get_jit_mismatches(const gb_t *gb)
 {
-	(void)info;
-	gb_cpu_rotate_right_with_carry(&mem.reg.L, &mem.reg.F);
+	return gb->jit.mismatches;
 }
 
-static void gb_cpu_RRC_HL(gb_instr_info_t *info)
+/**
+ * @brief fetch, decode and execute 1 CPU instruction, increment timers and jump
+ * to interrupt handler
+ * @param opcode Opcode of instruction to be executed
+ * @returns Nothing
+ */
+void gb_cpu_step(gb_t *gb)
 {
-	static uint8_t temp_val = 0;
-	if (info->current_cycle == 2) {
-		temp_val = gb_memory_read(mem.reg.HL);
+	/* if halted */
+	if (gb->cpu.halted) {
+		goto finally;
+	}
 
-	} else if (info->current_cycle == 3) {
-		gb_cpu_rotate_right_with_carry(&temp_val, &mem.reg.F);
-		gb_memory_write(mem.reg.HL, temp_val);
+	if (gb->cpu.interupt_dur) {
+		gb->cpu.interupt_dur--;
+		goto finally;
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
 
-static void gb_cpu_RRC_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_right_with_carry(&mem.reg.A, &mem.reg.F);
-}
+	/* if no remaining op */
+	if (gb->cpu.op_remaining <= 0) {
+		gb->cpu.dont_update_pc = false;
+		gb->cpu.next_instruction = gb_cpu_fetch(gb, gb->mem.reg.PC);
+		if (gb->cpu.next_instruction != PREFIX_OPCODE) {
+			gb->cpu.opcode = gb->cpu.next_instruction;
+			gb->cpu.instr_info = &instructions[gb->cpu.opcode].info;
+		} else {
+			gb->cpu.opcode = gb_cpu_fetch(gb, gb->mem.reg.PC + 1);
+			gb->cpu.instr_info = gb_cpu_prefix_info(gb->cpu.opcode);
+		}
+		gb->cpu.op_remaining = gb->cpu.instr_info->cycles;
+		gb->cpu.current_cycle = 1;
+	}
 
-/*********************0x1X*/
-static void gb_cpu_RL_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_left_through_carry(&mem.reg.B, &mem.reg.F);
-}
+	const gb_instr_info_t *info = gb->cpu.instr_info;
 
-static void gb_cpu_RL_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_left_through_carry(&mem.reg.C, &mem.reg.F);
-}
+	if (info->current_cycle == gb->cpu.current_cycle || info->current_cycle == CUSTOM_TIMING) {
+		instructions[gb->cpu.next_instruction].instr(gb, info);
+	}
+	gb->cpu.current_cycle++;
 
-static void gb_cpu_RL_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_left_through_carry(&mem.reg.D, &mem.reg.F);
-}
+	/* dec op remaining */
+	gb->cpu.op_remaining--;
 
-static void gb_cpu_RL_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_left_through_carry(&mem.reg.E, &mem.reg.F);
+	if (gb->cpu.op_remaining == 0 && gb->cpu.dont_update_pc == false) {
+		gb->mem.reg.PC += info->bytes;
+	}
+
+finally:
+	gb_cpu_end_m_cycle(gb);
 }
 
-static void gb_cpu_RL_H(gb_instr_info_t *info)
+/* Condition of the JR, JP, CALL and RET cc instructions, encoded as NZ, Z, NC, C in bits 3 - 4 */
+static inline bool gb_cpu_condition(gb_t *gb, uint8_t opcode)
 {
-	(void)info;
-	gb_cpu_rotate_left_through_carry(&mem.reg.H, &mem.reg.F);
+	uint8_t flag = (opcode & 0x10) ? gb_cpu_flag_carry(gb) : gb_cpu_flag_zero(gb);
+
+	return (opcode & 0x08) ? flag : !flag;
 }
 
-static void gb_cpu_RL_L(gb_instr_info_t *info)
+/* Moves the clock to a later M-cycle of the instruction that is being executed */
+static inline void gb_cpu_wait(gb_t *gb, uint8_t m_cycles)
 {
-	(void)info;
-	gb_cpu_rotate_left_through_carry(&mem.reg.L, &mem.reg.F);
+	gb_sched_advance(gb, m_cycles * GB_CYCLES_PER_M_CYCLE);
 }
 
-static void gb_cpu_RL_HL(gb_instr_info_t *info)
+/* Runs one of the 8 ALU operations ADD, ADC, SUB, SBC, AND, XOR, OR and CP on the A register.
+ * The flags of the additions and subtractions are evaluated lazily. */
+static inline void gb_cpu_alu(gb_t *gb, uint8_t operation, uint8_t *operand)
 {
-	static uint8_t temp_val = 0;
-	if (info->current_cycle == 2) {
-		temp_val = gb_memory_read(mem.reg.HL);
+	uint8_t value = *operand;
+	uint16_t res;
 
-	} else if (info->current_cycle == 3) {
-		gb_cpu_rotate_left_through_carry(&temp_val, &mem.reg.F);
-		gb_memory_write(mem.reg.HL, temp_val);
+	switch (operation) {
+	case 0:
+	case 1:
+		res = gb->mem.reg.A + value + ((operation == 1) ? gb_cpu_flag_carry(gb) : 0);
+		gb_cpu_lazy_alu(gb, GB_CPU_FLAGS_LAZY, value, res);
+		gb->mem.reg.A = res;
+		break;
+	case 2:
+	case 3:
+	case 7:
+		res = gb->mem.reg.A - value - ((operation == 3) ? gb_cpu_flag_carry(gb) : 0);
+		gb_cpu_lazy_alu(gb, GB_CPU_FLAGS_LAZY | N_FLAG_VAL, value, res);
+		if (operation != 7) {
+			gb->mem.reg.A = res;
+		}
+		break;
+	case 4:
+		gb->mem.reg.A &= value;
+		gb_cpu_set_flags(gb, (gb->mem.reg.A == 0) ? 0xA0 : 0x20);
+		break;
+	case 5:
+		gb->mem.reg.A ^= value;
+		gb_cpu_set_flags(gb, (gb->mem.reg.A == 0) ? 0x80 : 0x00);
+		break;
+	default:
+		gb->mem.reg.A |= value;
+		gb_cpu_set_flags(gb, (gb->mem.reg.A == 0) ? 0x80 : 0x00);
+		break;
 	}
-	info->current_cycle = CUSTOM_TIMING;
 }
 
-static void gb_cpu_RL_A(gb_instr_info_t *info)
+/**
+ * @brief Executes an 8 bit load or ALU instruction of the 0x40 - 0xBF block, HALT excluded.
+ * @param opcode instruction opcode
+ * @returns M-cycles of the instruction left after the one its work was done on
+ */
+static inline uint8_t gb_cpu_execute_r8(gb_t *gb, uint8_t opcode)
 {
-	(void)info;
-	gb_cpu_rotate_left_through_carry(&mem.reg.A, &mem.reg.F);
-}
+	uint8_t src = opcode & 0x07;
+	uint8_t dst = (opcode >> 3) & 0x07;
+	uint8_t value;
+	uint8_t *operand = &value;
+	uint8_t remaining = 0;
 
-static void gb_cpu_RR_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_right_through_carry(&mem.reg.B, &mem.reg.F);
-}
+	if (src == 6) {
+		value = gb_memory_read(gb, gb->mem.reg.HL);
+		remaining = 1;
+	} else {
+		operand = gb_cpu_reg8(gb, src);
+	}
 
-static void gb_cpu_RR_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_right_through_carry(&mem.reg.C, &mem.reg.F);
-}
+	if (opcode >= 0x80) {
+		gb_cpu_alu(gb, dst, operand);
+	} else if (dst == 6) {
+		gb_memory_write(gb, gb->mem.reg.HL, *operand);
+		remaining = 1;
+	} else {
+		*gb_cpu_reg8(gb, dst) = *operand;
+	}
 
-static void gb_cpu_RR_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_right_through_carry(&mem.reg.D, &mem.reg.F);
+	return remaining;
 }
 
-static void gb_cpu_RR_E(gb_instr_info_t *info)
+/**
+ * @brief Executes a CB prefixed instruction.
+ * @details Register operands take 2 M-cycles. (HL) is read on the second M-cycle, BIT ends on the
+ * third while the other operations write the result back on it and end on the fourth.
+ * @param opcode instruction opcode following the prefix
+ * @returns M-cycles of the instruction left after the one its last access was done on
+ */
+static uint8_t gb_cpu_execute_prefix(gb_t *gb, uint8_t opcode)
 {
-	(void)info;
-	gb_cpu_rotate_right_through_carry(&mem.reg.E, &mem.reg.F);
-}
+	uint8_t index = opcode & 0x07;
+	uint8_t value;
+	uint8_t *operand = &value;
 
-static void gb_cpu_RR_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_right_through_carry(&mem.reg.H, &mem.reg.F);
-}
+	if (index == 6) {
+		gb_cpu_wait(gb, 1);
+		value = gb_memory_read(gb, gb->mem.reg.HL);
+	} else {
+		operand = gb_cpu_reg8(gb, index);
+	}
 
-static void gb_cpu_RR_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_right_through_carry(&mem.reg.L, &mem.reg.F);
-}
+	if (opcode < 0x80) {
+		/* The rotates, shifts and BIT work on F in place */
+		gb_cpu_flags(gb);
+	}
 
-static void gb_cpu_RR_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_val = 0;
-	if (info->current_cycle == 2) {
-		temp_val = gb_memory_read(mem.reg.HL);
+	gb_cpu_prefix_operation(gb, opcode, operand);
 
-	} else if (info->current_cycle == 3) {
-		gb_cpu_rotate_right_through_carry(&temp_val, &mem.reg.F);
-		gb_memory_write(mem.reg.HL, temp_val);
+	if (index == 6 && (opcode & 0xC0) != 0x40) {
+		gb_cpu_wait(gb, 1);
+		gb_memory_write(gb, gb->mem.reg.HL, value);
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
 
-static void gb_cpu_RR_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_rotate_right_through_carry(&mem.reg.A, &mem.reg.F);
+	return 1;
 }
 
-/*********************0x2X*/
-static void gb_cpu_SLA_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_left_into_carry(&mem.reg.B, &mem.reg.F);
-}
+/**
+ * @brief Executes one decoded instruction and moves the master clock over all of its M-cycles.
+ * @details Memory accesses happen on the same M-cycle as with gb_cpu_step(), the clock is only
+ * moved in between when an access is due on a later M-cycle of the instruction. Interrupts are
+ * handled at the end of the instruction.
+ * @param opcode instruction opcode
+ * @param operand immediate operand, or the opcode following the CB prefix
+ * @returns Nothing
+ */
+static void gb_cpu_run_instruction(gb_t *gb, uint8_t opcode, uint16_t operand)
+{
+	uint16_t pc = gb->mem.reg.PC;
+	uint8_t d8 = operand;
+	uint8_t remaining = 0;
+
+	switch (opcode) {
+	case 0x00: // NOP
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0x01: // LD rr,d16
+	case 0x11:
+	case 0x21:
+	case 0x31:
+		*gb_cpu_reg16(gb, opcode >> 4) = operand;
+		gb->mem.reg.PC = pc + 3;
+		remaining = 2;
+		break;
+	case 0x02: // LD (BC),A
+		gb_memory_write(gb, gb->mem.reg.BC, gb->mem.reg.A);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x12: // LD (DE),A
+		gb_memory_write(gb, gb->mem.reg.DE, gb->mem.reg.A);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x22: // LD (HL+),A
+		gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.A);
+		gb->mem.reg.HL++;
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x32: // LD (HL-),A
+		gb_memory_write(gb, gb->mem.reg.HL, gb->mem.reg.A);
+		gb->mem.reg.HL--;
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x03: // INC rr
+	case 0x13:
+	case 0x23:
+	case 0x33:
+		(*gb_cpu_reg16(gb, opcode >> 4))++;
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x0B: // DEC rr
+	case 0x1B:
+	case 0x2B:
+	case 0x3B:
+		(*gb_cpu_reg16(gb, opcode >> 4))--;
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x09: // ADD HL,rr
+	case 0x19:
+	case 0x29:
+	case 0x39:
+		gb_cpu_flags(gb);
+		gb_cpu_addition_HL_register(&gb->mem.reg.HL, gb_cpu_reg16(gb, opcode >> 4),
+					    &gb->mem.reg.F);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x04: // INC r
+	case 0x0C:
+	case 0x14:
+	case 0x1C:
+	case 0x24:
+	case 0x2C:
+	case 0x3C: {
+		uint8_t *reg = gb_cpu_reg8(gb, opcode >> 3);
+		gb_cpu_lazy_inc_dec(gb, GB_CPU_FLAGS_LAZY, *reg, *reg + 1);
+		(*reg)++;
+		gb->mem.reg.PC = pc + 1;
+		break;
+	}
+	case 0x05: // DEC r
+	case 0x0D:
+	case 0x15:
+	case 0x1D:
+	case 0x25:
+	case 0x2D:
+	case 0x3D: {
+		uint8_t *reg = gb_cpu_reg8(gb, opcode >> 3);
+		gb_cpu_lazy_inc_dec(gb, GB_CPU_FLAGS_LAZY | N_FLAG_VAL, *reg, *reg - 1);
+		(*reg)--;
+		gb->mem.reg.PC = pc + 1;
+		break;
+	}
+	case 0x06: // LD r,d8
+	case 0x0E:
+	case 0x16:
+	case 0x1E:
+	case 0x26:
+	case 0x2E:
+	case 0x3E:
+		*gb_cpu_reg8(gb, opcode >> 3) = d8;
+		gb->mem.reg.PC = pc + 2;
+		remaining = 1;
+		break;
+	case 0x0A: // LD A,(BC)
+		gb->mem.reg.A = gb_memory_read(gb, gb->mem.reg.BC);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x1A: // LD A,(DE)
+		gb->mem.reg.A = gb_memory_read(gb, gb->mem.reg.DE);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x2A: // LD A,(HL+)
+		gb->mem.reg.A = gb_memory_read(gb, gb->mem.reg.HL);
+		gb->mem.reg.HL++;
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x3A: // LD A,(HL-)
+		gb->mem.reg.A = gb_memory_read(gb, gb->mem.reg.HL);
+		gb->mem.reg.HL--;
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0x07: // RLCA
+		gb_cpu_RLCA(gb, NULL);
+		gb->cpu.flags_op = 0;
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0x0F: // RRCA
+		gb_cpu_RRCA(gb, NULL);
+		gb->cpu.flags_op = 0;
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0x17: // RLA
+		gb_cpu_flags(gb);
+		gb_cpu_RLA(gb, NULL);
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0x1F: // RRA
+		gb_cpu_flags(gb);
+		gb_cpu_RRA(gb, NULL);
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0x27: // DAA
+		gb_cpu_flags(gb);
+		gb_cpu_decimal_adjust_A_register(&gb->mem.reg.A, &gb->mem.reg.F);
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0x2F: // CPL
+		gb_cpu_flags(gb);
+		gb_cpu_CPL(gb, NULL);
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0x37: // SCF
+		gb_cpu_flags(gb);
+		gb_cpu_SCF(gb, NULL);
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0x3F: // CCF
+		gb_cpu_flags(gb);
+		gb_cpu_CCF(gb, NULL);
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0x08: // LD (a16),SP
+		gb_memory_write_short(gb, operand, gb->mem.reg.SP);
+		gb->mem.reg.PC = pc + 3;
+		remaining = 4;
+		break;
+	case 0x10: // STOP
+		gb->cpu.stopped = 1;
+		gb->mem.reg.PC = pc + 2;
+		break;
+	case 0x18: // JR r8
+		gb_cpu_wait(gb, 2);
+		gb->mem.reg.PC = pc + 2 + (int8_t)d8;
+		break;
+	case 0x20: // JR cc,r8
+	case 0x28:
+	case 0x30:
+	case 0x38:
+		if (gb_cpu_condition(gb, opcode)) {
+			gb_cpu_wait(gb, 2);
+			gb->mem.reg.PC = pc + 2 + (int8_t)d8;
+		} else {
+			gb->mem.reg.PC = pc + 2;
+			remaining = 1;
+		}
+		break;
+	case 0x34: { // INC (HL)
+		uint8_t value = gb_memory_read(gb, gb->mem.reg.HL);
+		gb_cpu_flags(gb);
+		((value & 0x0F) == 0x0F) ? SET_BIT(gb->mem.reg.F, H_FLAG_BIT)
+					 : RST_BIT(gb->mem.reg.F, H_FLAG_BIT);
+		RST_BIT(gb->mem.reg.F, N_FLAG_BIT);
+		gb_cpu_wait(gb, 1);
+		gb_memory_write(gb, gb->mem.reg.HL, value + 1);
+		value = gb_memory_read(gb, gb->mem.reg.HL);
+		(value != 0) ? RST_BIT(gb->mem.reg.F, Z_FLAG_BIT)
+			     : SET_BIT(gb->mem.reg.F, Z_FLAG_BIT);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	}
+	case 0x35: { // DEC (HL)
+		uint8_t value = gb_memory_read(gb, gb->mem.reg.HL);
+		gb_cpu_flags(gb);
+		((value & 0x0F) != 0) ? RST_BIT(gb->mem.reg.F, H_FLAG_BIT)
+				      : SET_BIT(gb->mem.reg.F, H_FLAG_BIT);
+		SET_BIT(gb->mem.reg.F, N_FLAG_BIT);
+		gb_cpu_wait(gb, 1);
+		gb_memory_write(gb, gb->mem.reg.HL, value - 1);
+		value = gb_memory_read(gb, gb->mem.reg.HL);
+		(value != 0) ? RST_BIT(gb->mem.reg.F, Z_FLAG_BIT)
+			     : SET_BIT(gb->mem.reg.F, Z_FLAG_BIT);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	}
+	case 0x36: // LD (HL),d8
+		gb_cpu_wait(gb, 1);
+		gb_memory_write(gb, gb->mem.reg.HL, d8);
+		gb->mem.reg.PC = pc + 2;
+		remaining = 1;
+		break;
+	case 0x76: // HALT
+		gb->cpu.halted = 1;
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0xC0: // RET cc
+	case 0xC8:
+	case 0xD0:
+	case 0xD8:
+		if (gb_cpu_condition(gb, opcode)) {
+			gb_cpu_wait(gb, 4);
+			gb_cpu_return_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.PC);
+		} else {
+			gb->mem.reg.PC = pc + 1;
+			remaining = 1;
+		}
+		break;
+	case 0xC9: // RET
+		gb_cpu_return_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.PC);
+		remaining = 3;
+		break;
+	case 0xD9: // RETI
+		gb->cpu.interrupt_master_enable = 1;
+		gb_cpu_return_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.PC);
+		remaining = 3;
+		break;
+	case 0xC2: // JP cc,a16
+	case 0xCA:
+	case 0xD2:
+	case 0xDA:
+		if (gb_cpu_condition(gb, opcode)) {
+			gb_cpu_wait(gb, 3);
+			gb->mem.reg.PC = operand;
+		} else {
+			gb->mem.reg.PC = pc + 3;
+			remaining = 2;
+		}
+		break;
+	case 0xC3: // JP a16
+		gb_cpu_wait(gb, 3);
+		gb->mem.reg.PC = operand;
+		break;
+	case 0xE9: // JP HL
+		gb->mem.reg.PC = gb->mem.reg.HL;
+		break;
+	case 0xC4: // CALL cc,a16
+	case 0xCC:
+	case 0xD4:
+	case 0xDC:
+		if (gb_cpu_condition(gb, opcode)) {
+			gb_cpu_wait(gb, 5);
+			gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, pc + 3);
+			gb->mem.reg.PC = operand;
+		} else {
+			gb->mem.reg.PC = pc + 3;
+			remaining = 2;
+		}
+		break;
+	case 0xCD: // CALL a16
+		gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, pc + 3);
+		gb->mem.reg.PC = operand;
+		remaining = 5;
+		break;
+	case 0xC7: // RST n
+	case 0xCF:
+	case 0xD7:
+	case 0xDF:
+	case 0xE7:
+	case 0xEF:
+	case 0xF7:
+	case 0xFF:
+		gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, pc + 1);
+		gb->mem.reg.PC = opcode & 0x38;
+		remaining = 3;
+		break;
+	case 0xC1: // POP rr
+	case 0xD1:
+	case 0xE1:
+		gb_cpu_pop_from_stack(gb, &gb->mem.reg.SP, gb_cpu_reg16(gb, (opcode >> 4) & 0x03));
+		gb->mem.reg.PC = pc + 1;
+		remaining = 2;
+		break;
+	case 0xF1: // POP AF
+		gb_cpu_pop_from_stack(gb, &gb->mem.reg.SP, &gb->mem.reg.AF);
+		gb->mem.reg.AF &= 0xFFF0;
+		gb->cpu.flags_op = 0;
+		gb->mem.reg.PC = pc + 1;
+		remaining = 2;
+		break;
+	case 0xC5: // PUSH rr
+	case 0xD5:
+	case 0xE5:
+		gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, *gb_cpu_reg16(gb, (opcode >> 4) & 0x03));
+		gb->mem.reg.PC = pc + 1;
+		remaining = 3;
+		break;
+	case 0xF5: // PUSH AF
+		gb_cpu_flags(gb);
+		gb_cpu_push_to_stack(gb, &gb->mem.reg.SP, gb->mem.reg.AF);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 3;
+		break;
+	case 0xC6: // ALU A,d8
+	case 0xCE:
+	case 0xD6:
+	case 0xDE:
+	case 0xE6:
+	case 0xEE:
+	case 0xF6:
+	case 0xFE:
+		gb_cpu_alu(gb, (opcode >> 3) & 0x07, &d8);
+		gb->mem.reg.PC = pc + 2;
+		remaining = 1;
+		break;
+	case 0xCB: // PREFIX CB
+		remaining = gb_cpu_execute_prefix(gb, d8);
+		gb->mem.reg.PC = pc + 2;
+		break;
+	case 0xE0: // LDH (a8),A
+		gb_cpu_wait(gb, 1);
+		gb_memory_write(gb, 0xFF00 + d8, gb->mem.reg.A);
+		gb->mem.reg.PC = pc + 2;
+		remaining = 1;
+		break;
+	case 0xF0: // LDH A,(a8)
+		gb_cpu_wait(gb, 1);
+		gb->mem.reg.A = gb_memory_read(gb, 0xFF00 + d8);
+		gb->mem.reg.PC = pc + 2;
+		remaining = 1;
+		break;
+	case 0xE2: // LD (C),A
+		gb_memory_write(gb, 0xFF00 + gb->mem.reg.C, gb->mem.reg.A);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0xF2: // LD A,(C)
+		gb->mem.reg.A = gb_memory_read(gb, 0xFF00 + gb->mem.reg.C);
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0xEA: // LD (a16),A
+		gb_cpu_wait(gb, 2);
+		gb_memory_write(gb, operand, gb->mem.reg.A);
+		gb->mem.reg.PC = pc + 3;
+		remaining = 1;
+		break;
+	case 0xFA: // LD A,(a16)
+		gb_cpu_wait(gb, 2);
+		gb->mem.reg.A = gb_memory_read(gb, operand);
+		gb->mem.reg.PC = pc + 3;
+		remaining = 1;
+		break;
+	case 0xE8: // ADD SP,r8
+		gb->mem.reg.SP = gb_cpu_offset_SP_register(gb->mem.reg.SP, &gb->mem.reg.F, d8);
+		gb->cpu.flags_op = 0;
+		gb->mem.reg.PC = pc + 2;
+		remaining = 3;
+		break;
+	case 0xF8: // LD HL,SP+r8
+		gb->mem.reg.HL = gb_cpu_offset_SP_register(gb->mem.reg.SP, &gb->mem.reg.F, d8);
+		gb->cpu.flags_op = 0;
+		gb->mem.reg.PC = pc + 2;
+		remaining = 2;
+		break;
+	case 0xF9: // LD SP,HL
+		gb->mem.reg.SP = gb->mem.reg.HL;
+		gb->mem.reg.PC = pc + 1;
+		remaining = 1;
+		break;
+	case 0xF3: // DI
+		gb->cpu.interrupt_master_enable = 0;
+		gb->mem.reg.PC = pc + 1;
+		break;
+	case 0xFB: // EI
+		gb->cpu.interrupt_master_enable = 1;
+		gb->mem.reg.PC = pc + 1;
+		break;
+	default: // LD r,r' and ALU A,r
+		remaining = gb_cpu_execute_r8(gb, opcode);
+		gb->mem.reg.PC = pc + 1;
+		break;
+	}
 
-static void gb_cpu_SLA_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_left_into_carry(&mem.reg.C, &mem.reg.F);
+	gb_cpu_wait(gb, remaining);
+	gb_cpu_end_m_cycle(gb);
+	gb_cpu_wait(gb, 1);
 }
 
-static void gb_cpu_SLA_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_left_into_carry(&mem.reg.D, &mem.reg.F);
-}
+/**
+ * @brief Executes one whole instruction and moves the master clock over all of its M-cycles.
+ * @details See gb_cpu_run_instruction(). While the CPU is halted, the one M-cycle of a halted CPU
+ * is run instead, an interrupt dispatch is skipped over as a whole and an instruction that was
+ * started by gb_cpu_step() or that locks the CPU up is stepped through one M-cycle at a time.
+ * @returns Nothing
+ */
+void gb_cpu_execute(gb_t *gb)
+{
+	uint16_t pc = gb->mem.reg.PC;
+	uint16_t operand = 0;
+	uint8_t opcode;
+	uint8_t bytes;
+
+	if (gb->cpu.interupt_dur && !gb->cpu.halted) {
+		/* Only timer events happen while the CPU jumps to an interrupt vector */
+		gb_cpu_wait(gb, gb->cpu.interupt_dur);
+		gb->cpu.interupt_dur = 0;
+		return;
+	}
 
-static void gb_cpu_SLA_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_left_into_carry(&mem.reg.E, &mem.reg.F);
-}
+	if (gb->cpu.halted || gb->cpu.op_remaining) {
+		gb_cpu_flags(gb);
+		gb_cpu_step(gb);
+		gb_cpu_wait(gb, 1);
+		return;
+	}
 
-static void gb_cpu_SLA_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_left_into_carry(&mem.reg.H, &mem.reg.F);
-}
+	opcode = gb_cpu_fetch(gb, pc);
+	if (instructions[opcode].instr == NULL) {
+		/* Illegal opcodes lock the CPU up, which the M-cycle core already takes care of */
+		gb_cpu_flags(gb);
+		gb_cpu_step(gb);
+		gb_cpu_wait(gb, 1);
+		return;
+	}
 
-static void gb_cpu_SLA_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_left_into_carry(&mem.reg.L, &mem.reg.F);
+	bytes = gb_cpu_opcodes[opcode].bytes;
+	if (bytes > 1) {
+		operand = gb_cpu_fetch(gb, pc + 1);
+	}
+	if (bytes > 2) {
+		operand |= gb_cpu_fetch(gb, pc + 2) << 8;
+	}
+
+	gb_cpu_run_instruction(gb, opcode, operand);
 }
 
-static void gb_cpu_SLA_HL(gb_instr_info_t *info)
+/**
+ * @brief Moves the clock of a halted CPU over the M-cycles in which nothing can wake it up.
+ * @details Interrupt flags are only raised by scheduled events, so while no enabled interrupt is
+ * requested, every M-cycle before the one that runs the next event only moves the clock. These
+ * M-cycles are skipped at once instead of being stepped through. The M-cycle that runs the event
+ * and the ones after it are left to gb_cpu_execute(). Nothing is skipped until the halted CPU
+ * checks for interrupts on every M-cycle.
+ * @param end clock cycle from which on no further M-cycle is started
+ * @returns Nothing
+ */
+static void gb_cpu_skip_halted(gb_t *gb, uint64_t end)
 {
-	static uint8_t temp_val = 0;
-	if (info->current_cycle == 2) {
-		temp_val = gb_memory_read(mem.reg.HL);
+	uint64_t cycle = GB_SCHED_KEY_CYCLE(gb->sched.next_key);
+	uint64_t m_cycles;
 
-	} else if (info->current_cycle == 3) {
-		gb_cpu_shift_left_into_carry(&temp_val, &mem.reg.F);
-		gb_memory_write(mem.reg.HL, temp_val);
+	if (gb->cpu.one_cycle_interrupt_delay != 1 || gb->cpu.op_remaining ||
+	    gb->cpu.pending_interrupts) {
+		return;
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
 
-static void gb_cpu_SLA_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_left_into_carry(&mem.reg.A, &mem.reg.F);
-}
+	if (cycle > end + GB_CYCLES_PER_M_CYCLE - 1) {
+		cycle = end + GB_CYCLES_PER_M_CYCLE - 1;
+	}
 
-static void gb_cpu_SRA_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_with_carry(&mem.reg.B, &mem.reg.F);
+	if (cycle > gb->sched.now) {
+		m_cycles = (cycle - gb->sched.now) / GB_CYCLES_PER_M_CYCLE;
+		gb_sched_advance(gb, m_cycles * GB_CYCLES_PER_M_CYCLE);
+	}
 }
 
-static void gb_cpu_SRA_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_with_carry(&mem.reg.C, &mem.reg.F);
-}
+/* A run of a busy-wait loop that is checked for being repeatable, see gb_cpu_skip_idle() */
+typedef struct {
+	// state the run started with
+	registers_t reg;
+	uint8_t interrupt_master_enable;
+	uint8_t one_cycle_interrupt_delay;
+	uint64_t start;
+	// clock cycle of the next event
+	uint64_t events;
+	// clock cycle up to which the PPU registers stay as they are
+	uint64_t video;
+	// set once a PPU register is read
+	bool video_read;
+	// cleared once the run does something that keeps it from being skipped over
+	bool repeatable;
+} gb_cpu_idle_t;
 
-static void gb_cpu_SRA_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_with_carry(&mem.reg.D, &mem.reg.F);
-}
+/**
+ * @brief Tells whether an instruction can be part of a busy-wait loop.
+ * @param instr decoded instruction
+ * @returns true if the instruction only changes registers and reads memory at most
+ */
+static bool gb_cpu_idle_instruction(const gb_cpu_decoded_t *instr)
+{
+	uint8_t opcode = instr->opcode;
+
+	switch (opcode) {
+	case 0x00: // NOP
+	case 0x07: // RLCA
+	case 0x0F: // RRCA
+	case 0x17: // RLA
+	case 0x1F: // RRA
+	case 0x27: // DAA
+	case 0x2F: // CPL
+	case 0x37: // SCF
+	case 0x3F: // CCF
+	case 0x0A: // LD A,(BC)
+	case 0x1A: // LD A,(DE)
+	case 0xF0: // LDH A,(a8)
+	case 0xF2: // LD A,(C)
+	case 0xFA: // LD A,(a16)
+		return true;
+
+	case PREFIX_OPCODE:
+		// BIT n,r and BIT n,(HL), the other CB instructions on registers only
+		return (instr->operand & 0xC0) == 0x40 || (instr->operand & 0x07) != 6;
+
+	default:
+		break;
+	}
 
-static void gb_cpu_SRA_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_with_carry(&mem.reg.E, &mem.reg.F);
-}
+	if ((opcode & 0xC7) == 0xC6) {
+		// ALU A,d8
+		return true;
+	} else if ((opcode & 0xC6) == 0x04 || (opcode & 0xC7) == 0x06) {
+		// INC r, DEC r and LD r,d8, the (HL) forms write memory
+		return ((opcode >> 3) & 0x07) != 6;
+	}
 
-static void gb_cpu_SRA_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_with_carry(&mem.reg.H, &mem.reg.F);
+	// LD r,r', LD r,(HL) and ALU A,r, without LD (HL),r and HALT
+	return opcode >= 0x40 && opcode <= 0xBF && (opcode & 0xF8) != 0x70;
 }
 
-static void gb_cpu_SRA_L(gb_instr_info_t *info)
+/**
+ * @brief Tells whether a block may be a busy-wait loop.
+ * @details The block has to end with a jump back to its first instruction and all other
+ * instructions may only change registers and read memory. Whether a run of the loop can be
+ * repeated without running it is only known at run time, see gb_cpu_skip_idle().
+ * @param block decoded block
+ * @returns true if the block is a busy-wait loop candidate
+ */
+bool gb_cpu_idle_loop(const gb_cpu_block_t *block)
 {
-	(void)info;
-	gb_cpu_shift_right_with_carry(&mem.reg.L, &mem.reg.F);
-}
-
-static void gb_cpu_SRA_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_val = 0;
-	if (info->current_cycle == 2) {
-		temp_val = gb_memory_read(mem.reg.HL);
-
-	} else if (info->current_cycle == 3) {
-		gb_cpu_shift_right_with_carry(&temp_val, &mem.reg.F);
-		gb_memory_write(mem.reg.HL, temp_val);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_SRA_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_with_carry(&mem.reg.A, &mem.reg.F);
-}
-
-/*********************0x3X*/
-static void gb_cpu_SWAP_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_swap_nibbles(&mem.reg.B, &mem.reg.F);
-}
-
-static void gb_cpu_SWAP_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_swap_nibbles(&mem.reg.C, &mem.reg.F);
-}
-
-static void gb_cpu_SWAP_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_swap_nibbles(&mem.reg.D, &mem.reg.F);
-}
-
-static void gb_cpu_SWAP_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_swap_nibbles(&mem.reg.E, &mem.reg.F);
-}
-
-static void gb_cpu_SWAP_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_swap_nibbles(&mem.reg.H, &mem.reg.F);
-}
-
-static void gb_cpu_SWAP_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_swap_nibbles(&mem.reg.L, &mem.reg.F);
-}
-
-static void gb_cpu_SWAP_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_val = 0;
-	if (info->current_cycle == 2) {
-		temp_val = gb_memory_read(mem.reg.HL);
-
-	} else if (info->current_cycle == 3) {
-		gb_cpu_swap_nibbles(&temp_val, &mem.reg.F);
-		gb_memory_write(mem.reg.HL, temp_val);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_SWAP_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_swap_nibbles(&mem.reg.A, &mem.reg.F);
-}
-
-static void gb_cpu_SRL_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_into_carry(&mem.reg.B, &mem.reg.F);
-}
-
-static void gb_cpu_SRL_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_into_carry(&mem.reg.C, &mem.reg.F);
-}
-
-static void gb_cpu_SRL_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_into_carry(&mem.reg.D, &mem.reg.F);
-}
-
-static void gb_cpu_SRL_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_into_carry(&mem.reg.E, &mem.reg.F);
-}
-
-static void gb_cpu_SRL_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_into_carry(&mem.reg.H, &mem.reg.F);
-}
-
-static void gb_cpu_SRL_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_into_carry(&mem.reg.L, &mem.reg.F);
-}
-
-static void gb_cpu_SRL_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_val = 0;
-	if (info->current_cycle == 2) {
-		temp_val = gb_memory_read(mem.reg.HL);
-
-	} else if (info->current_cycle == 3) {
-		gb_cpu_shift_right_into_carry(&temp_val, &mem.reg.F);
-		gb_memory_write(mem.reg.HL, temp_val);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_SRL_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_shift_right_into_carry(&mem.reg.A, &mem.reg.F);
-}
-
-/*********************0x4X*/
-static void gb_cpu_BIT_0_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.B, 0, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_0_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.C, 0, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_0_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.D, 0, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_0_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.E, 0, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_0_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.H, 0, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_0_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.L, 0, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_0_HL(gb_instr_info_t *info)
-{
-	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_bit_check(&temp_res, 0, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_0_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.A, 0, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_1_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.B, 1, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_1_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.C, 1, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_1_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.D, 1, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_1_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.E, 1, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_1_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.H, 1, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_1_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.L, 1, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_1_HL(gb_instr_info_t *info)
-{
-	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_bit_check(&temp_res, 1, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_1_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.A, 1, &mem.reg.F);
-}
-
-/*********************0x5X*/
-static void gb_cpu_BIT_2_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.B, 2, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_2_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.C, 2, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_2_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.D, 2, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_2_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.E, 2, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_2_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.H, 2, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_2_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.L, 2, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_2_HL(gb_instr_info_t *info)
-{
-	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_bit_check(&temp_res, 2, &mem.reg.F);
-}
-static void gb_cpu_BIT_2_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.A, 2, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_3_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.B, 3, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_3_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.C, 3, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_3_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.D, 3, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_3_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.E, 3, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_3_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.H, 3, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_3_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.L, 3, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_3_HL(gb_instr_info_t *info)
-{
-	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_bit_check(&temp_res, 3, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_3_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.A, 3, &mem.reg.F);
-}
-
-/*********************0x6X*/
-static void gb_cpu_BIT_4_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.B, 4, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_4_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.C, 4, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_4_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.D, 4, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_4_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.E, 4, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_4_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.H, 4, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_4_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.L, 4, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_4_HL(gb_instr_info_t *info)
-{
-	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_bit_check(&temp_res, 4, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_4_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.A, 4, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_5_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.B, 5, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_5_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.C, 5, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_5_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.D, 5, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_5_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.E, 5, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_5_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.H, 5, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_5_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.L, 5, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_5_HL(gb_instr_info_t *info)
-{
-	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_bit_check(&temp_res, 5, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_5_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.A, 5, &mem.reg.F);
-}
-
-/*********************0x7X*/
-static void gb_cpu_BIT_6_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.B, 6, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_6_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.C, 6, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_6_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.D, 6, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_6_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.E, 6, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_6_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.H, 6, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_6_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.L, 6, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_6_HL(gb_instr_info_t *info)
-{
-	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_bit_check(&temp_res, 6, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_6_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.A, 6, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_7_B(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.B, 7, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_7_C(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.C, 7, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_7_D(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.D, 7, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_7_E(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.E, 7, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_7_H(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.H, 7, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_7_L(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.L, 7, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_7_HL(gb_instr_info_t *info)
-{
-	(void)info;
-	uint8_t temp_res = gb_memory_read(mem.reg.HL);
-	gb_cpu_bit_check(&temp_res, 7, &mem.reg.F);
-}
-
-static void gb_cpu_BIT_7_A(gb_instr_info_t *info)
-{
-	(void)info;
-	gb_cpu_bit_check(&mem.reg.A, 7, &mem.reg.F);
-}
-
-/*********************0x8X*/
-static void gb_cpu_RES_0_B(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.B, 0);
-}
-
-static void gb_cpu_RES_0_C(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.C, 0);
-}
-
-static void gb_cpu_RES_0_D(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.D, 0);
-}
-
-static void gb_cpu_RES_0_E(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.E, 0);
-}
-
-static void gb_cpu_RES_0_H(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.H, 0);
-}
-
-static void gb_cpu_RES_0_L(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.L, 0);
-}
-
-static void gb_cpu_RES_0_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		RST_BIT(temp_res, 0);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_RES_0_A(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.A, 0);
-}
-
-static void gb_cpu_RES_1_B(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.B, 1);
-}
-
-static void gb_cpu_RES_1_C(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.C, 1);
-}
-
-static void gb_cpu_RES_1_D(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.D, 1);
-}
-
-static void gb_cpu_RES_1_E(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.E, 1);
-}
-
-static void gb_cpu_RES_1_H(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.H, 1);
-}
-
-static void gb_cpu_RES_1_L(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.L, 1);
-}
-
-static void gb_cpu_RES_1_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		RST_BIT(temp_res, 1);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_RES_1_A(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.A, 1);
-}
-
-/*********************0x9X*/
-static void gb_cpu_RES_2_B(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.B, 2);
-}
-
-static void gb_cpu_RES_2_C(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.C, 2);
-}
-
-static void gb_cpu_RES_2_D(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.D, 2);
-}
-
-static void gb_cpu_RES_2_E(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.E, 2);
-}
-
-static void gb_cpu_RES_2_H(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.H, 2);
-}
-
-static void gb_cpu_RES_2_L(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.L, 2);
-}
-
-static void gb_cpu_RES_2_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		RST_BIT(temp_res, 2);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_RES_2_A(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.A, 2);
-}
-
-static void gb_cpu_RES_3_B(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.B, 3);
-}
-
-static void gb_cpu_RES_3_C(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.C, 3);
-}
-
-static void gb_cpu_RES_3_D(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.D, 3);
-}
-
-static void gb_cpu_RES_3_E(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.E, 3);
-}
-
-static void gb_cpu_RES_3_H(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.H, 3);
-}
-
-static void gb_cpu_RES_3_L(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.L, 3);
-}
-
-static void gb_cpu_RES_3_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		RST_BIT(temp_res, 3);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_RES_3_A(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.A, 3);
-}
-
-/*********************0xAX*/
-static void gb_cpu_RES_4_B(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.B, 4);
-}
-
-static void gb_cpu_RES_4_C(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.C, 4);
-}
-
-static void gb_cpu_RES_4_D(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.D, 4);
-}
-
-static void gb_cpu_RES_4_E(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.E, 4);
-}
-
-static void gb_cpu_RES_4_H(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.H, 4);
-}
-
-static void gb_cpu_RES_4_L(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.L, 4);
-}
-
-static void gb_cpu_RES_4_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		RST_BIT(temp_res, 4);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_RES_4_A(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.A, 4);
-}
-
-static void gb_cpu_RES_5_B(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.B, 5);
-}
-
-static void gb_cpu_RES_5_C(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.C, 5);
-}
-
-static void gb_cpu_RES_5_D(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.D, 5);
-}
-
-static void gb_cpu_RES_5_E(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.E, 5);
-}
-
-static void gb_cpu_RES_5_H(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.H, 5);
-}
-
-static void gb_cpu_RES_5_L(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.L, 5);
-}
-
-static void gb_cpu_RES_5_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		RST_BIT(temp_res, 5);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_RES_5_A(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.A, 5);
-}
-
-/*********************0xBX*/
-static void gb_cpu_RES_6_B(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.B, 6);
-}
-
-static void gb_cpu_RES_6_C(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.C, 6);
-}
-
-static void gb_cpu_RES_6_D(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.D, 6);
-}
-
-static void gb_cpu_RES_6_E(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.E, 6);
-}
-
-static void gb_cpu_RES_6_H(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.H, 6);
-}
-
-static void gb_cpu_RES_6_L(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.L, 6);
-}
-
-static void gb_cpu_RES_6_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		RST_BIT(temp_res, 6);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_RES_6_A(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.A, 6);
-}
-
-static void gb_cpu_RES_7_B(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.B, 7);
-}
-
-static void gb_cpu_RES_7_C(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.C, 7);
-}
-
-static void gb_cpu_RES_7_D(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.D, 7);
-}
-
-static void gb_cpu_RES_7_E(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.E, 7);
-}
-
-static void gb_cpu_RES_7_H(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.H, 7);
-}
-
-static void gb_cpu_RES_7_L(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.L, 7);
-}
-
-static void gb_cpu_RES_7_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		RST_BIT(temp_res, 7);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_RES_7_A(gb_instr_info_t *info)
-{
-	(void)info;
-	RST_BIT(mem.reg.A, 7);
-}
-
-/*********************0xCX*/
-static void gb_cpu_SET_0_B(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.B, 0);
-}
-
-static void gb_cpu_SET_0_C(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.C, 0);
-}
-
-static void gb_cpu_SET_0_D(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.D, 0);
-}
-
-static void gb_cpu_SET_0_E(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.E, 0);
-}
-
-static void gb_cpu_SET_0_H(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.H, 0);
-}
-
-static void gb_cpu_SET_0_L(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.L, 0);
-}
-
-static void gb_cpu_SET_0_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		SET_BIT(temp_res, 0);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
-	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_SET_0_A(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.A, 0);
-}
-
-static void gb_cpu_SET_1_B(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.B, 1);
-}
-
-static void gb_cpu_SET_1_C(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.C, 1);
-}
-
-static void gb_cpu_SET_1_D(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.D, 1);
-}
-
-static void gb_cpu_SET_1_E(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.E, 1);
-}
-
-static void gb_cpu_SET_1_H(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.H, 1);
-}
-
-static void gb_cpu_SET_1_L(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.L, 1);
-}
-
-static void gb_cpu_SET_1_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		SET_BIT(temp_res, 1);
+	const gb_cpu_decoded_t *last = &block->instr[block->count - 1];
+	uint16_t pc = block->pc;
+	uint16_t target;
 
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
+	for (uint8_t i = 0; i < block->count - 1; i++) {
+		if (!gb_cpu_idle_instruction(&block->instr[i])) {
+			return false;
+		}
+		pc += block->instr[i].length;
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_SET_1_A(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.A, 1);
-}
-
-/*********************0xDX*/
-static void gb_cpu_SET_2_B(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.B, 2);
-}
-
-static void gb_cpu_SET_2_C(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.C, 2);
-}
-
-static void gb_cpu_SET_2_D(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.D, 2);
-}
-
-static void gb_cpu_SET_2_E(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.E, 2);
-}
-
-static void gb_cpu_SET_2_H(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.H, 2);
-}
-
-static void gb_cpu_SET_2_L(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.L, 2);
-}
-
-static void gb_cpu_SET_2_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		SET_BIT(temp_res, 2);
 
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
+	switch (last->opcode) {
+	case 0x18: // JR r8
+	case 0x20: // JR cc,r8
+	case 0x28:
+	case 0x30:
+	case 0x38:
+		target = pc + last->length + (int8_t)last->operand;
+		break;
+
+	case 0xC3: // JP a16
+	case 0xC2: // JP cc,a16
+	case 0xCA:
+	case 0xD2:
+	case 0xDA:
+		target = last->operand;
+		break;
+
+	default:
+		return false;
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
 
-static void gb_cpu_SET_2_A(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.A, 2);
+	return target == block->pc;
 }
 
-static void gb_cpu_SET_3_B(gb_instr_info_t *info)
+/**
+ * @brief Checks the memory an instruction of a busy-wait loop is about to read.
+ * @details Memory without a memory mapped register, IF and IE only change when the CPU writes
+ * them or an event runs, the PPU registers also when the PPU reaches its next dot with work. All
+ * other registers change on their own or have side effects when read.
+ * @param instr decoded instruction
+ * @param idle loop run, video_read is set if a PPU register is read
+ * @returns true if the instruction reads nothing or memory a busy-wait loop may read
+ */
+static bool gb_cpu_idle_read(gb_t *gb, const gb_cpu_decoded_t *instr, gb_cpu_idle_t *idle)
 {
-	(void)info;
-	SET_BIT(mem.reg.B, 3);
-}
+	uint16_t address;
 
-static void gb_cpu_SET_3_C(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.C, 3);
-}
+	switch (instr->opcode) {
+	case 0x0A:
+		address = gb->mem.reg.BC;
+		break;
 
-static void gb_cpu_SET_3_D(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.D, 3);
-}
+	case 0x1A:
+		address = gb->mem.reg.DE;
+		break;
 
-static void gb_cpu_SET_3_E(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.E, 3);
-}
+	case 0xF0:
+		address = IO_BASE | (uint8_t)instr->operand;
+		break;
 
-static void gb_cpu_SET_3_H(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.H, 3);
-}
+	case 0xF2:
+		address = IO_BASE | gb->mem.reg.C;
+		break;
 
-static void gb_cpu_SET_3_L(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.L, 3);
-}
+	case 0xFA:
+		address = instr->operand;
+		break;
 
-static void gb_cpu_SET_3_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		SET_BIT(temp_res, 3);
+	case PREFIX_OPCODE:
+		if ((instr->operand & 0x07) != 6) {
+			return true;
+		}
+		address = gb->mem.reg.HL;
+		break;
 
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
+	default:
+		if (instr->opcode < 0x40 || instr->opcode > 0xBF || (instr->opcode & 0x07) != 6) {
+			return true;
+		}
+		address = gb->mem.reg.HL;
+		break;
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_SET_3_A(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.A, 3);
-}
-
-/*********************0xEX*/
-static void gb_cpu_SET_4_B(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.B, 4);
-}
-
-static void gb_cpu_SET_4_C(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.C, 4);
-}
-
-static void gb_cpu_SET_4_D(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.D, 4);
-}
 
-static void gb_cpu_SET_4_E(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.E, 4);
-}
-
-static void gb_cpu_SET_4_H(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.H, 4);
-}
-
-static void gb_cpu_SET_4_L(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.L, 4);
-}
-
-static void gb_cpu_SET_4_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		SET_BIT(temp_res, 4);
-
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
+	if (gb->pages.read[address >> GB_MEMORY_PAGE_SHIFT] != NULL) {
+		return true;
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_SET_4_A(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.A, 4);
-}
-
-static void gb_cpu_SET_5_B(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.B, 5);
-}
 
-static void gb_cpu_SET_5_C(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.C, 5);
-}
+	if (address >= LCDC_ADDR && address < BOOT_EN_ADDR) {
+		idle->video_read = true;
+		return true;
+	}
 
-static void gb_cpu_SET_5_D(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.D, 5);
+	return address == IF_ADDR || address >= HRAM_BASE;
 }
 
-static void gb_cpu_SET_5_E(gb_instr_info_t *info)
+/**
+ * @brief Records the state a run of a busy-wait loop starts with.
+ * @details The flags are worked out first, F alone is stale while an arithmetic instruction's
+ * flags are still pending.
+ * @param idle loop run
+ * @returns Nothing
+ */
+static void gb_cpu_idle_begin(gb_t *gb, gb_cpu_idle_t *idle)
 {
-	(void)info;
-	SET_BIT(mem.reg.E, 5);
+	gb_cpu_flags(gb);
+	idle->reg = gb->mem.reg;
+	idle->interrupt_master_enable = gb->cpu.interrupt_master_enable;
+	idle->one_cycle_interrupt_delay = gb->cpu.one_cycle_interrupt_delay;
+	idle->start = gb->sched.now;
+	idle->events = GB_SCHED_KEY_CYCLE(gb->sched.next_key);
+	idle->video = gb_ppu_next_change(gb);
+	idle->video_read = false;
+	idle->repeatable = true;
 }
 
-static void gb_cpu_SET_5_H(gb_instr_info_t *info)
+/**
+ * @brief Skips the runs of a busy-wait loop that would all do the same as the one that just ended.
+ * @details A run that ended with the state it started with, while no event ran and the PPU
+ * registers it read did not change, only read memory that stayed the same. Every further run
+ * would do exactly the same until one of them changes, so the runs that end before that are
+ * skipped at once.
+ * @param idle run that just ended on the first instruction of the loop
+ * @param end clock cycle from which on no further instruction is started
+ * @returns Nothing
+ */
+static void gb_cpu_skip_idle(gb_t *gb, const gb_cpu_idle_t *idle, uint64_t end)
 {
-	(void)info;
-	SET_BIT(mem.reg.H, 5);
-}
+	uint64_t length = gb->sched.now - idle->start;
+	uint64_t until = (end < idle->events) ? end : idle->events;
+	uint64_t runs;
 
-static void gb_cpu_SET_5_L(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.L, 5);
-}
+	if (idle->video_read && idle->video < until) {
+		until = idle->video;
+	}
 
-static void gb_cpu_SET_5_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		SET_BIT(temp_res, 5);
+	/* A pending carry is part of the state the next run starts with */
+	gb_cpu_flags(gb);
 
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
+	if (gb->sched.now > until ||
+	    gb->cpu.interrupt_master_enable != idle->interrupt_master_enable ||
+	    gb->cpu.one_cycle_interrupt_delay != idle->one_cycle_interrupt_delay ||
+	    memcmp(&gb->mem.reg, &idle->reg, sizeof(registers_t)) != 0) {
+		return;
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_SET_5_A(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.A, 5);
-}
 
-/*********************0xFX*/
-static void gb_cpu_SET_6_B(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.B, 6);
+	runs = (until - gb->sched.now) / length;
+	gb->cpu.idle_cycles += runs * length;
+	gb_sched_advance(gb, runs * length);
 }
 
-static void gb_cpu_SET_6_C(gb_instr_info_t *info)
+/**
+ * @brief Copies the memory that native code may write to or from a snapshot.
+ * @param snapshot buffer of GB_MEMORY_PAGE_COUNT pages, indexed by page number
+ * @param restore copies the snapshot back into the memory if set
+ * @returns Nothing
+ */
+static void gb_cpu_jit_check_copy(gb_t *gb, uint8_t *snapshot, bool restore)
 {
-	(void)info;
-	SET_BIT(mem.reg.C, 6);
-}
+	for (uint16_t page = 0; page < GB_MEMORY_PAGE_COUNT; page++) {
+		uint8_t *copy = snapshot + page * GB_MEMORY_PAGE_SIZE;
 
-static void gb_cpu_SET_6_D(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.D, 6);
-}
+		if (gb->pages.write[page] == NULL) {
+			continue;
+		}
 
-static void gb_cpu_SET_6_E(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.E, 6);
+		if (restore) {
+			memcpy(gb->pages.write[page], copy, GB_MEMORY_PAGE_SIZE);
+		} else {
+			memcpy(copy, gb->pages.write[page], GB_MEMORY_PAGE_SIZE);
+		}
+	}
 }
 
-static void gb_cpu_SET_6_H(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.H, 6);
-}
+/**
+ * @brief Runs a native code segment and repeats it on the instruction core, for the JIT check
+ * mode.
+ * @details The native code runs first without moving the clock. Its registers and memory are set
+ * aside and rolled back, then the instruction core runs the same instructions, moving the clock
+ * and running events as usual. Registers with the flags worked out, the interrupt delay, the
+ * cycles taken and the memory native code may write are compared afterwards, every segment that
+ * does not match is logged and counted. The instruction core's state is the one kept. Without
+ * memory for the snapshots the segment is run like in the JIT mode.
+ * @param block block the segment belongs to
+ * @param segment segment to run, its first instruction has to be the one at PC
+ * @param end clock cycle from which on no further instruction is started
+ * @returns number of instructions run
+ */
+static uint8_t gb_cpu_jit_check(gb_t *gb, const gb_cpu_block_t *block,
+				const gb_jit_segment_t *segment, uint64_t end)
+{
+	const size_t size = GB_MEMORY_PAGE_COUNT * GB_MEMORY_PAGE_SIZE;
+	registers_t reg = gb->mem.reg;
+	registers_t native_reg;
+	uint8_t native_delay;
+	uint64_t start = gb->sched.now;
+	uint32_t cycles;
+	uint8_t *native;
+	uint8_t count;
+
+	if (gb->jit.check_memory == NULL) {
+		gb->jit.check_memory = malloc(2 * size);
+		if (gb->jit.check_memory == NULL) {
+			return gb_jit_run(gb, block, segment, end);
+		}
+	}
+	native = gb->jit.check_memory + size;
 
-static void gb_cpu_SET_6_L(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.L, 6);
-}
+	gb_cpu_jit_check_copy(gb, gb->jit.check_memory, false);
+	count = gb_jit_run_native(gb, block, segment, end, &cycles);
+	if (count == 0) {
+		return 0;
+	}
 
-static void gb_cpu_SET_6_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		SET_BIT(temp_res, 6);
+	native_reg = gb->mem.reg;
+	native_delay = gb->cpu.interrupt_master_enable ? 1 : gb->cpu.one_cycle_interrupt_delay;
+	gb_cpu_jit_check_copy(gb, native, false);
 
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
+	gb_cpu_jit_check_copy(gb, gb->jit.check_memory, true);
+	gb->mem.reg = reg;
+	for (uint8_t i = segment->first; i < segment->first + count; i++) {
+		gb_cpu_run_instruction(gb, block->instr[i].opcode, block->instr[i].operand);
+	}
+	gb_cpu_flags(gb);
+
+	if (memcmp(&gb->mem.reg, &native_reg, sizeof(registers_t)) != 0 ||
+	    gb->cpu.one_cycle_interrupt_delay != native_delay ||
+	    gb->sched.now - start != (uint64_t)cycles * GB_CYCLES_PER_M_CYCLE) {
+		LOG_ERR("JIT mismatch in segment at %04X: AF %04X/%04X BC %04X/%04X DE %04X/%04X "
+			"HL %04X/%04X SP %04X/%04X PC %04X/%04X",
+			reg.PC, native_reg.AF, gb->mem.reg.AF, native_reg.BC, gb->mem.reg.BC,
+			native_reg.DE, gb->mem.reg.DE, native_reg.HL, gb->mem.reg.HL, native_reg.SP,
+			gb->mem.reg.SP, native_reg.PC, gb->mem.reg.PC);
+		gb->jit.mismatches++;
+		return count;
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
-
-static void gb_cpu_SET_6_A(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.A, 6);
-}
 
-static void gb_cpu_SET_7_B(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.B, 7);
-}
+	for (uint16_t page = 0; page < GB_MEMORY_PAGE_COUNT; page++) {
+		const uint8_t *copy = native + page * GB_MEMORY_PAGE_SIZE;
 
-static void gb_cpu_SET_7_C(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.C, 7);
-}
+		if (gb->pages.write[page] != NULL &&
+		    memcmp(gb->pages.write[page], copy, GB_MEMORY_PAGE_SIZE) != 0) {
+			LOG_ERR("JIT mismatch in segment at %04X: memory page %02X", reg.PC, page);
+			gb->jit.mismatches++;
+			break;
+		}
+	}
 
-static void gb_cpu_SET_7_D(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.D, 7);
+	return count;
 }
 
-static void gb_cpu_SET_7_E(gb_instr_info_t *info)
+/**
+ * @brief Executes the basic block at PC from the block cache.
+ * @details Falls back to gb_cpu_execute() when the CPU is not about to start an instruction or
+ * when the code at PC can not be cached, a halted CPU first skips ahead to the next event. The
+ * block is left early once the clock reaches end, when an interrupt is dispatched and when its
+ * code is written to or banked out. In the JIT mode, the translated parts of hot blocks run as
+ * native code. Busy-wait loops are checked while they run and skipped over once they only wait,
+ * memory copy and fill loops run all but their last iteration at once.
+ * @param end clock cycle from which on no further instruction is started
+ * @returns Nothing
+ */
+void gb_cpu_execute_block(gb_t *gb, uint64_t end)
 {
-	(void)info;
-	SET_BIT(mem.reg.E, 7);
-}
+	gb_cpu_block_t *block = NULL;
+	const gb_jit_segment_t *segment = NULL;
+	gb_cpu_idle_t idle;
+	uint8_t i;
 
-static void gb_cpu_SET_7_H(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.H, 7);
-}
+	if (gb->cpu.halted) {
+		gb_cpu_skip_halted(gb, end);
+		if (gb->sched.now >= end) {
+			return;
+		}
+	} else if (!gb->cpu.op_remaining && !gb->cpu.interupt_dur) {
+		block = gb_cpu_cache_lookup(gb, gb->mem.reg.PC);
+	}
 
-static void gb_cpu_SET_7_L(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.L, 7);
-}
+	if (block == NULL) {
+		gb_cpu_execute(gb);
+		return;
+	}
 
-static void gb_cpu_SET_7_HL(gb_instr_info_t *info)
-{
-	static uint8_t temp_res = 0;
-	if (info->current_cycle == 2) {
-		temp_res = gb_memory_read(mem.reg.HL);
-		SET_BIT(temp_res, 7);
+	if (block->bulk.kind != GB_CPU_BULK_NONE) {
+		gb_cpu_flags(gb);
+		if (gb_cpu_bulk_run(gb, block, end) && gb->sched.now >= end) {
+			return;
+		}
+	}
 
-	} else if (info->current_cycle == 3) {
-		gb_memory_write(mem.reg.HL, temp_res);
+	if (block->idle) {
+		gb_cpu_idle_begin(gb, &idle);
+	} else if (gb->cpu.mode == GB_CPU_MODE_JIT || gb->cpu.mode == GB_CPU_MODE_JIT_CHECK) {
+		segment = gb_jit_lookup(gb, block);
 	}
-	info->current_cycle = CUSTOM_TIMING;
-}
 
-static void gb_cpu_SET_7_A(gb_instr_info_t *info)
-{
-	(void)info;
-	SET_BIT(mem.reg.A, 7);
-}
+	for (i = 0; i < block->count;) {
+		uint8_t done = 0;
 
-/**
- * @brief If the corresponding IE and IF are both set then jump to the
- * corresponding ISR
- * @returns Nothing
- */
-static void gb_cpu_interrupt_handler(int *interupt_dur)
-{
-	if (one_cycle_interrupt_delay == 1) {
-		if (gb_memory_read(IE_ADDR) & gb_memory_read(IF_ADDR) & 0x1F) {
-			interrupt_master_enable = 0;
-			one_cycle_interrupt_delay = 0;
-			halted = 0;
-			uint8_t interrupt_triggered = 0;
-			uint8_t interrupt_set_and_enabled =
-				gb_memory_read(IE_ADDR) & gb_memory_read(IF_ADDR);
-			if (interrupt_set_and_enabled & VBLANK_INTERRUPT) {
-				gb_memory_reset_bit(IF_ADDR, 0);
-				gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC);
-				interrupt_triggered = 1;
-				mem.reg.PC = VBLANK_VECTOR;
-			} else if (interrupt_set_and_enabled & LCDSTAT_INTERRUPT) {
-				gb_memory_reset_bit(IF_ADDR, 1);
-				gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC);
-				interrupt_triggered = 1;
-				mem.reg.PC = LCDSTAT_VECTOR;
-			} else if (interrupt_set_and_enabled & TIMER_INTERRUPT) {
-				gb_memory_reset_bit(IF_ADDR, 2);
-				gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC);
-				interrupt_triggered = 1;
-				mem.reg.PC = TIMER_VECTOR;
-			} else if (interrupt_set_and_enabled & SERIAL_INTERRUPT) {
-				gb_memory_reset_bit(IF_ADDR, 3);
-				gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC);
-				interrupt_triggered = 1;
-				mem.reg.PC = SERIAL_VECTOR;
-			} else if (interrupt_set_and_enabled & JOYPAD_INTERRUPT) {
-				gb_memory_reset_bit(IF_ADDR, 4);
-				gb_cpu_push_to_stack(&mem.reg.SP, mem.reg.PC);
-				interrupt_triggered = 1;
-				mem.reg.PC = JOYPAD_VECTOR;
-			}
+		if (block->idle && idle.repeatable) {
+			idle.repeatable = gb_cpu_idle_read(gb, &block->instr[i], &idle);
+		}
 
-			if (interrupt_triggered == 1) {
-				*interupt_dur += 5;
+		if (segment != NULL && segment->first == i) {
+			gb_cpu_flags(gb);
+			if (gb->cpu.mode == GB_CPU_MODE_JIT_CHECK) {
+				done = gb_cpu_jit_check(gb, block, segment, end);
+			} else {
+				done = gb_jit_run(gb, block, segment, end);
 			}
+			segment++;
 		}
 
-	} else {
-		one_cycle_interrupt_delay++;
-	}
-}
+		if (done == 0) {
+			gb_cpu_run_instruction(gb, block->instr[i].opcode, block->instr[i].operand);
+			done = 1;
+		}
+		i += done;
 
-/**
- * @brief If the CPU is halted and interrupt_master_enable is not set, then this
- * function will unhalt the CPU if both IE and IF flags are set without jumping
- * to the ISR
- * @returns Nothing
- */
-static void gb_cpu_halted_handler(void)
-{
-	if (one_cycle_interrupt_delay == 1) {
-		if (gb_memory_read(IE_ADDR) & gb_memory_read(IF_ADDR) & 0x1F) {
-			interrupt_master_enable = 0;
-			one_cycle_interrupt_delay = 0;
-			uint8_t interrupt_set_and_enabled =
-				gb_memory_read(IE_ADDR) & gb_memory_read(IF_ADDR);
-			if (interrupt_set_and_enabled & VBLANK_INTERRUPT) {
-				halted = 0;
-			} else if (interrupt_set_and_enabled & LCDSTAT_INTERRUPT) {
-				halted = 0;
-			} else if (interrupt_set_and_enabled & TIMER_INTERRUPT) {
-				halted = 0;
-			} else if (interrupt_set_and_enabled & SERIAL_INTERRUPT) {
-				halted = 0;
-			} else if (interrupt_set_and_enabled & JOYPAD_INTERRUPT) {
-				halted = 0;
-			}
+		if (gb->sched.now >= end || gb->cpu.interupt_dur ||
+		    !gb_cpu_cache_valid(gb, block)) {
+			break;
 		}
-	} else {
-		one_cycle_interrupt_delay++;
 	}
-}
 
-void gb_cpu_init(void)
-{
-	stopped = 0;
-	halted = 0;
-	interrupt_master_enable = 0;
-	one_cycle_interrupt_delay = 0;
-	op_remaining = 0;
-	interupt_dur = 0;
-	opcode = 0;
-	current_cycle = 0;
+	if (block->idle && idle.repeatable && i == block->count) {
+		gb_cpu_skip_idle(gb, &idle, end);
+	}
 }
 
 /**
- * @brief fetch, decode and execute 1 CPU instruction, increment timers and jump
- * to interrupt handler
- * @param opcode Opcode of instruction to be executed
- * @returns Nothing
+ * @brief Decodes an instruction for the block cache.
+ * @param code host memory holding the instruction
+ * @param size number of bytes that may be read from code
+ * @param decoded decoded instruction
+ * @param ends_block set if the instruction jumps, calls, returns, halts or stops, no further
+ * instruction may be decoded into the same block
+ * @returns length of the instruction, 0 if it is illegal or longer than size
  */
-void gb_cpu_step(void)
+uint8_t gb_cpu_decode(const uint8_t *code, uint16_t size, gb_cpu_decoded_t *decoded,
+		      bool *ends_block)
 {
-	static uint8_t next_instruction = 0;
-	static gb_instr_t *intstruction_table = NULL;
-
-	/* if halted */
-	if (halted) {
-		goto finally;
-	}
+	const gb_cpu_opcode_t *info = &gb_cpu_opcodes[code[0]];
+	uint8_t bytes = info->bytes;
 
-	if (interupt_dur) {
-		interupt_dur--;
-		goto finally;
+	if (bytes == 0 || bytes > size) {
+		return 0;
 	}
 
-	/* if no remaining op */
-	if (op_remaining <= 0) {
-		dont_update_pc = false;
-		next_instruction = gb_memory_read(mem.reg.PC);
-		if (next_instruction != PREFIX_OPCODE) {
-			opcode = next_instruction;
-			intstruction_table = instructions;
-		} else {
-			opcode = gb_memory_read(mem.reg.PC + 1);
-			intstruction_table = prefix_instructions;
-		}
-		op_remaining = intstruction_table[opcode].info.cycles;
-		current_cycle = 1;
+	*ends_block = info->flow != GB_CPU_FLOW_NONE;
+	if (code[0] == PREFIX_OPCODE) {
+		info = &gb_cpu_prefix_opcodes[code[1]];
 	}
 
-	if (intstruction_table[opcode].info.current_cycle == current_cycle ||
-	    intstruction_table[opcode].info.current_cycle == CUSTOM_TIMING) {
-
-		if (intstruction_table[opcode].info.current_cycle == CUSTOM_TIMING) {
-			intstruction_table[opcode].info.current_cycle = current_cycle;
-		}
-
-		((void (*)(gb_instr_info_t *))instructions[next_instruction].instr)(
-			&intstruction_table[opcode].info);
+	decoded->opcode = code[0];
+	decoded->length = bytes;
+	decoded->cycles = (info->cycles == info->taken_cycles) ? info->cycles : 0;
+	decoded->operand = 0;
+	if (bytes > 1) {
+		decoded->operand = code[1];
 	}
-	current_cycle++;
-
-	/* dec op remaining */
-	op_remaining--;
-
-	if (op_remaining == 0 && dont_update_pc == false) {
-		mem.reg.PC += intstruction_table[opcode].info.bytes;
+	if (bytes > 2) {
+		decoded->operand |= code[2] << 8;
 	}
 
-finally:
-	/* Inc timers */
-	gb_memory_inc_timers(1);
-
-	/* Handle interupts */
-	if (interrupt_master_enable == 1 && op_remaining == 0) {
-		gb_cpu_interrupt_handler(&interupt_dur);
-	} else if (halted == 1 && op_remaining == 0) {
-		gb_cpu_halted_handler();
-	}
+	return bytes;
 }
@@ -0,0 +1,405 @@
+/**
+ * @file gb_cpu_bulk.c
+ * @brief Gameboy memory copy and fill loop acceleration.
+ *
+ * This file recognizes the loops games use to copy and fill memory a byte at a time, such as
+ * LD (HL+),A / DEC B / JR NZ or LD A,(DE) / LD (HL+),A / INC DE / DEC BC / LD A,B / OR C / JR NZ,
+ * and runs their iterations as a whole on the host memory behind the memory page table. Only
+ * memory without memory mapped registers is touched this way, video RAM and OAM through the
+ * write handler of the PPU. The last iteration of a loop is always left to the instruction core,
+ * so the loop is left with the flags it computes, and the iterations run at once never span an
+ * interrupt or a change of the PPU state, which keeps the result exact.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#include "gb_cpu_bulk.h"
+#include "gb_memory.h"
+#include "gb_ppu.h"
+#include "gb_priv.h"
+#include "gb_sched.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* 2 bit register pair operands used by copy and fill loops */
+#define PAIR_BC 0
+#define PAIR_DE 1
+#define PAIR_HL 2
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/*Function Prototypes*/
+static uint16_t *gb_cpu_bulk_pair(registers_t *reg, uint8_t pair);
+static uint8_t *gb_cpu_bulk_reg8(registers_t *reg, uint8_t index);
+static uint32_t gb_cpu_bulk_page_room(uint16_t address, int8_t step);
+static uint32_t gb_cpu_bulk_store(gb_t *gb, const gb_cpu_bulk_t *bulk, uint16_t dst, uint16_t src,
+				  uint32_t count, uint8_t *last);
+
+/**
+ * @brief Checks whether a block is a memory copy or fill loop and fills in block->bulk.
+ * @details A loop has to jump back to its start with JR NZ or JP NZ and consist of exactly one
+ * store through a register pair, LD (rr),A, LD (HL+),A, LD (HL-),A or LD (HL),d8, a load
+ * through another pair before it for copies, an increment or decrement of each pointer after its
+ * use and a counter. The counter is either an 8 bit register that is decremented or a register
+ * pair that is decremented and tested with LD A,r / OR r after the store. Fills of A need an 8
+ * bit counter, the test of a pair counter overwrites A. The counter may not be a pointer.
+ * @param block decoded block
+ * @returns Nothing
+ */
+void gb_cpu_bulk_match(gb_cpu_block_t *block)
+{
+	gb_cpu_bulk_t bulk = {.kind = GB_CPU_BULK_NONE};
+	const gb_cpu_decoded_t *last = &block->instr[block->count - 1];
+	uint16_t pc = block->pc;
+	uint8_t tested = 0xFF;
+	bool loaded = false;
+	bool stored = false;
+	bool counted = false;
+	bool zero_test = false;
+	bool dst_stepped = false;
+	bool src_stepped = false;
+
+	block->bulk.kind = GB_CPU_BULK_NONE;
+
+	for (uint8_t i = 0; i < block->count - 1; i++) {
+		const gb_cpu_decoded_t *instr = &block->instr[i];
+		uint8_t opcode = instr->opcode;
+		int8_t step = (opcode & 0x08) ? -1 : 1;
+
+		pc += instr->length;
+		bulk.cycles += instr->cycles;
+
+		switch (opcode) {
+		case 0x0A: // LD A,(BC)
+		case 0x1A: // LD A,(DE)
+		case 0x2A: // LD A,(HL+)
+		case 0x3A: // LD A,(HL-)
+		case 0x7E: // LD A,(HL)
+			if (loaded || stored) {
+				return;
+			}
+			loaded = true;
+			bulk.src = (opcode == 0x7E) ? PAIR_HL : MIN(opcode >> 4, PAIR_HL);
+			if (opcode == 0x2A || opcode == 0x3A) {
+				bulk.src_step = (opcode == 0x2A) ? 1 : -1;
+				src_stepped = true;
+			}
+			break;
+
+		case 0x02: // LD (BC),A
+		case 0x12: // LD (DE),A
+		case 0x22: // LD (HL+),A
+		case 0x32: // LD (HL-),A
+		case 0x77: // LD (HL),A
+		case 0x36: // LD (HL),d8
+			if (stored) {
+				return;
+			}
+			stored = true;
+			bulk.dst = (opcode >= 0x36) ? PAIR_HL : MIN(opcode >> 4, PAIR_HL);
+			bulk.immediate = (opcode == 0x36);
+			bulk.value = (uint8_t)instr->operand;
+			if (opcode == 0x22 || opcode == 0x32) {
+				bulk.dst_step = (opcode == 0x22) ? 1 : -1;
+				dst_stepped = true;
+			}
+			break;
+
+		case 0x03: // INC rr
+		case 0x13:
+		case 0x23:
+		case 0x0B: // DEC rr
+		case 0x1B:
+		case 0x2B:
+			if (stored && !dst_stepped && opcode >> 4 == bulk.dst) {
+				bulk.dst_step = step;
+				dst_stepped = true;
+			} else if (loaded && !src_stepped && opcode >> 4 == bulk.src) {
+				bulk.src_step = step;
+				src_stepped = true;
+			} else if (!counted && step < 0) {
+				bulk.counter = opcode >> 4;
+				bulk.wide = true;
+				counted = true;
+			} else {
+				return;
+			}
+			break;
+
+		case 0x05: // DEC B
+		case 0x0D: // DEC C
+		case 0x15: // DEC D
+		case 0x1D: // DEC E
+			if (counted) {
+				return;
+			}
+			bulk.counter = opcode >> 3;
+			counted = true;
+			break;
+
+		case 0x78: // LD A,B
+		case 0x79: // LD A,C
+		case 0x7A: // LD A,D
+		case 0x7B: // LD A,E
+			if (!counted || !bulk.wide || !stored || tested != 0xFF) {
+				return;
+			}
+			tested = opcode & 0x07;
+			break;
+
+		case 0xB0: // OR B
+		case 0xB1: // OR C
+		case 0xB2: // OR D
+		case 0xB3: // OR E
+			if (tested == 0xFF || zero_test || (tested >> 1) != bulk.counter ||
+			    ((opcode & 0x07) ^ tested) != 1) {
+				return;
+			}
+			zero_test = true;
+			break;
+
+		default:
+			return;
+		}
+	}
+
+	if (last->opcode == 0x20 &&
+	    (uint16_t)(pc + last->length + (int8_t)last->operand) == block->pc) {
+		// JR NZ,r8 taken
+		bulk.cycles += 3;
+	} else if (last->opcode == 0xC2 && last->operand == block->pc) {
+		// JP NZ,a16 taken
+		bulk.cycles += 4;
+	} else {
+		return;
+	}
+
+	if (!stored || !dst_stepped || !counted || bulk.wide != zero_test ||
+	    (bulk.wide ? bulk.counter : bulk.counter >> 1) == bulk.dst) {
+		return;
+	}
+
+	if (loaded) {
+		if (!src_stepped || bulk.src == bulk.dst || bulk.immediate ||
+		    (bulk.wide ? bulk.counter : bulk.counter >> 1) == bulk.src) {
+			return;
+		}
+		bulk.kind = GB_CPU_BULK_COPY;
+	} else {
+		if (!bulk.immediate && bulk.wide) {
+			return;
+		}
+		bulk.kind = GB_CPU_BULK_FILL;
+	}
+
+	block->bulk = bulk;
+}
+
+/**
+ * @brief Runs all but the last iteration of a copy or fill loop at once.
+ * @details Has to be called with PC on the first instruction of the loop. Iterations are only
+ * run until the cycle budget is used up, with IME set only until the next event and, when video
+ * RAM or OAM is written, only until the PPU reaches its next dot with work. They stop early at
+ * the first page that is not plain memory. The registers, flags and the clock are left as if the
+ * iterations had been run one instruction at a time.
+ * @param block decoded block with a recognized loop
+ * @param end clock cycle from which on no further instruction is started
+ * @returns number of iterations that were run
+ */
+uint32_t gb_cpu_bulk_run(gb_t *gb, const gb_cpu_block_t *block, uint64_t end)
+{
+	const gb_cpu_bulk_t *bulk = &block->bulk;
+	registers_t *reg = &gb->mem.reg;
+	uint16_t *dst = gb_cpu_bulk_pair(reg, bulk->dst);
+	uint16_t *src = gb_cpu_bulk_pair(reg, bulk->src);
+	uint32_t length = bulk->cycles * GB_CYCLES_PER_M_CYCLE;
+	uint64_t until = end;
+	uint32_t iterations;
+	uint32_t done = 0;
+	uint8_t last = reg->A;
+
+	if (bulk->wide) {
+		uint16_t *counter = gb_cpu_bulk_pair(reg, bulk->counter);
+		iterations = *counter ? *counter : 0x10000;
+	} else {
+		uint8_t *counter = gb_cpu_bulk_reg8(reg, bulk->counter);
+		iterations = *counter ? *counter : 0x100;
+	}
+
+	if (gb->cpu.interrupt_master_enable) {
+		if (gb->cpu.one_cycle_interrupt_delay != 1 || gb->cpu.pending_interrupts) {
+			return 0;
+		}
+		until = MIN(until, GB_SCHED_KEY_CYCLE(gb->sched.next_key));
+	}
+
+	if (until <= gb->sched.now) {
+		return 0;
+	}
+	iterations = (uint32_t)MIN((uint64_t)iterations - 1, (until - gb->sched.now) / length);
+
+	while (done < iterations) {
+		uint16_t to = *dst + (int32_t)done * bulk->dst_step;
+		uint16_t from = *src + (int32_t)done * bulk->src_step;
+		uint8_t page = to >> GB_MEMORY_PAGE_SHIFT;
+		uint32_t count = MIN(iterations - done, gb_cpu_bulk_page_room(to, bulk->dst_step));
+
+		if (bulk->kind == GB_CPU_BULK_COPY) {
+			count = MIN(count, gb_cpu_bulk_page_room(from, bulk->src_step));
+		}
+
+		if (gb->pages.write[page] == NULL &&
+		    gb->pages.write_handler[page] == gb_ppu_memory_write) {
+			uint64_t video = gb_ppu_next_change(gb);
+
+			if (video <= gb->sched.now) {
+				break;
+			}
+			iterations = (uint32_t)MIN((uint64_t)iterations,
+						   (video - gb->sched.now) / length);
+			if (iterations <= done) {
+				break;
+			}
+			count = MIN(count, iterations - done);
+		}
+
+		count = gb_cpu_bulk_store(gb, bulk, to, from, count, &last);
+		if (count == 0) {
+			break;
+		}
+		done += count;
+	}
+
+	if (done == 0) {
+		return 0;
+	}
+
+	*dst += (int32_t)done * bulk->dst_step;
+	if (bulk->kind == GB_CPU_BULK_COPY) {
+		*src += (int32_t)done * bulk->src_step;
+		reg->A = last;
+	}
+
+	if (bulk->wide) {
+		uint16_t *counter = gb_cpu_bulk_pair(reg, bulk->counter);
+
+		// LD A,r / OR r on a counter that is not 0 yet
+		*counter -= done;
+		reg->A = (*counter >> 8) | (*counter & 0xFF);
+		reg->F = 0x00;
+	} else {
+		uint8_t *counter = gb_cpu_bulk_reg8(reg, bulk->counter);
+
+		// DEC r down to a counter that is not 0 yet, the carry flag is left alone
+		*counter -= done;
+		reg->F = (reg->F & 0x10) | 0x40 | ((((*counter + 1) & 0x0F) == 0) ? 0x20 : 0x00);
+	}
+
+	gb_sched_advance(gb, done * length);
+
+	return done;
+}
+
+/**
+ * @brief Stores the bytes of a part of a loop that lies in one page of the destination and of
+ * the source.
+ * @param dst address the first byte is stored to
+ * @param src address the first byte of a copy is loaded from
+ * @param count number of bytes
+ * @param last set to the last byte that was copied
+ * @returns count, 0 if the destination or the source is not plain memory
+ */
+static uint32_t gb_cpu_bulk_store(gb_t *gb, const gb_cpu_bulk_t *bulk, uint16_t dst, uint16_t src,
+				  uint32_t count, uint8_t *last)
+{
+	uint8_t page = dst >> GB_MEMORY_PAGE_SHIFT;
+	uint8_t *to = gb->pages.write[page];
+	const uint8_t *from = NULL;
+	uint8_t value = bulk->immediate ? bulk->value : gb->mem.reg.A;
+
+	if (to == NULL && gb->pages.write_handler[page] != gb_ppu_memory_write) {
+		return 0;
+	}
+
+	if (bulk->kind == GB_CPU_BULK_COPY) {
+		from = gb->pages.read[src >> GB_MEMORY_PAGE_SHIFT];
+		if (from == NULL) {
+			return 0;
+		}
+		from += src & (GB_MEMORY_PAGE_SIZE - 1);
+	}
+
+	if (to == NULL) {
+		// video RAM and OAM, the PPU is up to date and stays so until all bytes are written
+		for (uint32_t i = 0; i < count; i++) {
+			if (from != NULL) {
+				value = from[(int32_t)i * bulk->src_step];
+			}
+			gb_ppu_memory_write(gb, dst + (int32_t)i * bulk->dst_step, value);
+		}
+	} else if (from == NULL) {
+		to += (bulk->dst_step > 0) ? (dst & (GB_MEMORY_PAGE_SIZE - 1))
+					   : (dst & (GB_MEMORY_PAGE_SIZE - 1)) - (count - 1);
+		memset(to, value, count);
+	} else {
+		to += dst & (GB_MEMORY_PAGE_SIZE - 1);
+		if (bulk->dst_step > 0 && bulk->src_step > 0 &&
+		    (to + count <= from || from + count <= to)) {
+			memcpy(to, from, count);
+		} else {
+			// overlapping or backwards copies repeat bytes just like the loop does
+			for (uint32_t i = 0; i < count; i++) {
+				to[(int32_t)i * bulk->dst_step] = from[(int32_t)i * bulk->src_step];
+			}
+		}
+	}
+
+	if (from != NULL) {
+		*last = from[(int32_t)(count - 1) * bulk->src_step];
+	}
+
+	return count;
+}
+
+/**
+ * @brief Returns the number of bytes from an address up to the end of its page in the direction
+ * of a step.
+ * @param address memory map address
+ * @param step 1 or -1
+ * @returns number of bytes, including the one at address
+ */
+static uint32_t gb_cpu_bulk_page_room(uint16_t address, int8_t step)
+{
+	uint32_t offset = address & (GB_MEMORY_PAGE_SIZE - 1);
+
+	return (step > 0) ? GB_MEMORY_PAGE_SIZE - offset : offset + 1;
+}
+
+static uint16_t *gb_cpu_bulk_pair(registers_t *reg, uint8_t pair)
+{
+	switch (pair) {
+	case PAIR_BC:
+		return &reg->BC;
+	case PAIR_DE:
+		return &reg->DE;
+	default:
+		return &reg->HL;
+	}
+}
+
+/* 8 bit counter registers, in the order of the 3 bit register operand B, C, D, E */
+static uint8_t *gb_cpu_bulk_reg8(registers_t *reg, uint8_t index)
+{
+	static const size_t offset[4] = {
+		offsetof(registers_t, B),
+		offsetof(registers_t, C),
+		offsetof(registers_t, D),
+		offsetof(registers_t, E),
+	};
+
+	return (uint8_t *)reg + offset[index & 0x03];
+}
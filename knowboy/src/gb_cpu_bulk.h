@@ -0,0 +1,19 @@
+/**
+ * @file gb_cpu_bulk.h
+ * @brief Private API of the memory copy and fill loop acceleration.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#ifndef SRC_GB_CPU_BULK_H_
+#define SRC_GB_CPU_BULK_H_
+
+#include "gb_priv.h"
+
+#include <stdint.h>
+
+void gb_cpu_bulk_match(gb_cpu_block_t *block);
+uint32_t gb_cpu_bulk_run(gb_t *gb, const gb_cpu_block_t *block, uint64_t end);
+
+#endif /* SRC_GB_CPU_BULK_H_ */
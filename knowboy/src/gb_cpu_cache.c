@@ -0,0 +1,205 @@
+/**
+ * @file gb_cpu_cache.c
+ * @brief Decoded basic block cache of the CPU.
+ *
+ * This file keeps the instructions of recently executed basic blocks in decoded form, so the
+ * instruction core does not have to fetch and decode the opcode and operand bytes of every
+ * instruction through the memory map again. Only code in cartridge ROM and work RAM is cached.
+ * Blocks are looked up by the host address of their first byte, which tells apart the ROM banks,
+ * the boot ROM overlay and work RAM without further bookkeeping. Work RAM pages holding decoded
+ * code are write protected in the memory page table, the first write to such a page invalidates
+ * all blocks decoded from it.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#include "gb_cpu_bulk.h"
+#include "gb_cpu_cache.h"
+#include "gb_memory.h"
+#include "gb_priv.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// work RAM is mirrored by echo RAM up to the last page before OAM
+#define ECHO_OFFSET	(ECHORAM_BASE - GBRAM_BANK0)
+#define ECHO_LAST_PAGE	((OAM_BASE >> GB_MEMORY_PAGE_SHIFT) - 1)
+
+/*Function Prototypes*/
+static bool gb_cpu_cache_page_cacheable(uint8_t page);
+static bool gb_cpu_cache_decode(gb_t *gb, gb_cpu_block_t *block, uint16_t pc,
+				const uint8_t *code);
+static uint8_t gb_cpu_cache_mirror(uint8_t page);
+static void gb_cpu_cache_protect(gb_t *gb, uint8_t page);
+static void gb_cpu_cache_write(gb_t *gb, uint16_t address, uint8_t data);
+
+/**
+ * @brief Drops all decoded blocks and forgets about write protected pages.
+ * @details Has to be called whenever the memory page table is rebuilt from scratch.
+ * @returns Nothing
+ */
+void gb_cpu_cache_init(gb_t *gb)
+{
+	memset(&gb->cpu_cache, 0, sizeof(gb->cpu_cache));
+}
+
+/**
+ * @brief Returns the decoded block starting at pc, decoding it first if it is not cached yet.
+ * @param pc address of the first instruction
+ * @returns decoded block, NULL if the code at pc can not be cached
+ */
+gb_cpu_block_t *gb_cpu_cache_lookup(gb_t *gb, uint16_t pc)
+{
+	uint8_t page = pc >> GB_MEMORY_PAGE_SHIFT;
+	const uint8_t *code;
+	gb_cpu_block_t *block;
+	uintptr_t hash;
+
+	if (!gb_cpu_cache_page_cacheable(page) || gb->pages.read[page] == NULL) {
+		return NULL;
+	}
+
+	code = gb->pages.read[page] + (pc & (GB_MEMORY_PAGE_SIZE - 1));
+	hash = (uintptr_t)code;
+	block = &gb->cpu_cache.blocks[(hash ^ (hash >> 11)) & (GB_CPU_CACHE_BLOCKS - 1)];
+
+	if (block->code == code && block->pc == pc &&
+	    block->generation == gb->cpu_cache.generation[page]) {
+		return block;
+	}
+
+	return gb_cpu_cache_decode(gb, block, pc, code) ? block : NULL;
+}
+
+/**
+ * @brief Tells whether code in a page can be cached.
+ * @details Cartridge ROM can only change by switching banks. Work RAM and its echo can only be
+ * written by the CPU, through the page table where writes can be caught. Video RAM and OAM
+ * writes are handled by the PPU, cartridge RAM is banked and HRAM shares its page with the IO
+ * registers, code in there is rare and runs uncached.
+ * @param page page of the address space
+ * @returns true if blocks may be decoded from the page
+ */
+static bool gb_cpu_cache_page_cacheable(uint8_t page)
+{
+	return page < (VRAM_BASE >> GB_MEMORY_PAGE_SHIFT) ||
+	       (page >= (GBRAM_BANK0 >> GB_MEMORY_PAGE_SHIFT) && page <= ECHO_LAST_PAGE);
+}
+
+/**
+ * @brief Decodes the block starting at pc into a cache entry.
+ * @details The block ends after the first instruction that jumps, calls, returns, halts or
+ * stops, after GB_CPU_BLOCK_INSTRUCTIONS instructions, before an illegal opcode and before an
+ * instruction that does not fit into the page of pc. Work RAM pages are write protected so the
+ * block is invalidated by the next write to them.
+ * @param block cache entry to overwrite
+ * @param pc address of the first instruction
+ * @param code host memory pc is mapped to
+ * @returns true if at least one instruction was decoded
+ */
+static bool gb_cpu_cache_decode(gb_t *gb, gb_cpu_block_t *block, uint16_t pc,
+				const uint8_t *code)
+{
+	uint8_t page = pc >> GB_MEMORY_PAGE_SHIFT;
+	uint16_t size = GB_MEMORY_PAGE_SIZE - (pc & (GB_MEMORY_PAGE_SIZE - 1));
+	uint16_t offset = 0;
+	uint8_t count = 0;
+	bool ends_block = false;
+
+	while (!ends_block && count < GB_CPU_BLOCK_INSTRUCTIONS) {
+		uint8_t length = gb_cpu_decode(&code[offset], size - offset, &block->instr[count],
+					       &ends_block);
+		if (length == 0) {
+			break;
+		}
+
+		offset += length;
+		count++;
+	}
+
+	if (count == 0) {
+		block->code = NULL;
+		return false;
+	}
+
+	if (page >= (GBRAM_BANK0 >> GB_MEMORY_PAGE_SHIFT)) {
+		gb_cpu_cache_protect(gb, page);
+	}
+
+	block->code = code;
+	block->generation = gb->cpu_cache.generation[page];
+	block->pc = pc;
+	block->count = count;
+	block->idle = gb_cpu_idle_loop(block);
+	gb_cpu_bulk_match(block);
+	block->hits = 0;
+	block->jit_epoch = 0;
+
+	return true;
+}
+
+/**
+ * @brief Returns the other address range a work RAM page is visible at.
+ * @param page work RAM or echo RAM page
+ * @returns mirrored page, 0 if the page has no mirror
+ */
+static uint8_t gb_cpu_cache_mirror(uint8_t page)
+{
+	if (page >= (ECHORAM_BASE >> GB_MEMORY_PAGE_SHIFT)) {
+		return page - (ECHO_OFFSET >> GB_MEMORY_PAGE_SHIFT);
+	} else if (page + (ECHO_OFFSET >> GB_MEMORY_PAGE_SHIFT) <= ECHO_LAST_PAGE) {
+		return page + (ECHO_OFFSET >> GB_MEMORY_PAGE_SHIFT);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write protects a work RAM page and its mirror, so their writes go through
+ * gb_cpu_cache_write().
+ * @param page work RAM or echo RAM page
+ * @returns Nothing
+ */
+static void gb_cpu_cache_protect(gb_t *gb, uint8_t page)
+{
+	uint8_t mirror = gb_cpu_cache_mirror(page);
+
+	if (gb->pages.write[page] == NULL) {
+		return;
+	}
+
+	gb->cpu_cache.protected_write[page] = gb->pages.write[page];
+	gb->pages.write[page] = NULL;
+	gb->pages.write_handler[page] = gb_cpu_cache_write;
+
+	if (mirror != 0) {
+		gb->cpu_cache.protected_write[mirror] = gb->pages.write[mirror];
+		gb->pages.write[mirror] = NULL;
+		gb->pages.write_handler[mirror] = gb_cpu_cache_write;
+	}
+}
+
+/**
+ * @brief Write handler of protected pages, invalidates the blocks decoded from the page and its
+ * mirror and lifts their protection before writing.
+ * @param address memory map address
+ * @param data byte of data
+ * @returns Nothing
+ */
+static void gb_cpu_cache_write(gb_t *gb, uint16_t address, uint8_t data)
+{
+	uint8_t page = address >> GB_MEMORY_PAGE_SHIFT;
+	uint8_t mirror = gb_cpu_cache_mirror(page);
+
+	gb->pages.write[page] = gb->cpu_cache.protected_write[page];
+	gb->cpu_cache.generation[page]++;
+
+	if (mirror != 0) {
+		gb->pages.write[mirror] = gb->cpu_cache.protected_write[mirror];
+		gb->cpu_cache.generation[mirror]++;
+	}
+
+	gb->pages.write[page][address & (GB_MEMORY_PAGE_SIZE - 1)] = data;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file gb_cpu_cache.h
+ * @brief Private API of the decoded basic block cache.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#ifndef SRC_GB_CPU_CACHE_H_
+#define SRC_GB_CPU_CACHE_H_
+
+#include "gb_priv.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void gb_cpu_cache_init(gb_t *gb);
+gb_cpu_block_t *gb_cpu_cache_lookup(gb_t *gb, uint16_t pc);
+
+/* Decoder and busy-wait loop check of the CPU core, see gb_cpu.c */
+uint8_t gb_cpu_decode(const uint8_t *code, uint16_t size, gb_cpu_decoded_t *decoded,
+		      bool *ends_block);
+bool gb_cpu_idle_loop(const gb_cpu_block_t *block);
+
+/* Checks that the code of a block is still mapped at its address and has not been written to */
+static inline bool gb_cpu_cache_valid(gb_t *gb, const gb_cpu_block_t *block)
+{
+	uint8_t page = block->pc >> GB_MEMORY_PAGE_SHIFT;
+
+	return block->generation == gb->cpu_cache.generation[page] &&
+	       gb->pages.read[page] + (block->pc & (GB_MEMORY_PAGE_SIZE - 1)) == block->code;
+}
+
+#endif /* SRC_GB_CPU_CACHE_H_ */
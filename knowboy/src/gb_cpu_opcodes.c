@@ -0,0 +1,124 @@
+/**
+ * @file gb_cpu_opcodes.c
+ * @brief Gameboy CPU instruction set description and disassembler.
+ *
+ * This file builds the opcode tables from the X-macros in gb_cpu_opcodes.h.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#include "gb_cpu_opcodes.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define GB_CPU_OPCODE(opcode, handler, mnemonic, operand, bytes, cycles, taken_cycles, step,       \
+		      access, read, written, flow)                                                 \
+	[opcode] = {mnemonic,                                                                      \
+		    GB_CPU_OPERAND_##operand,                                                      \
+		    bytes,                                                                         \
+		    cycles,                                                                        \
+		    taken_cycles,                                                                  \
+		    GB_CPU_ACCESS_##access,                                                        \
+		    GB_CPU_F_##read,                                                               \
+		    GB_CPU_F_##written,                                                            \
+		    GB_CPU_FLOW_##flow},
+
+#define GB_CPU_PREFIX_OPCODE(mnemonic, read, written, cycles, access)                              \
+	{mnemonic,                                                                                 \
+	 GB_CPU_OPERAND_NONE,                                                                      \
+	 2,                                                                                        \
+	 cycles,                                                                                   \
+	 cycles,                                                                                   \
+	 GB_CPU_ACCESS_##access,                                                                   \
+	 GB_CPU_F_##read,                                                                          \
+	 GB_CPU_F_##written,                                                                       \
+	 GB_CPU_FLOW_NONE},
+
+const gb_cpu_opcode_t gb_cpu_opcodes[256] = {GB_CPU_OPCODES(GB_CPU_OPCODE)};
+
+const gb_cpu_opcode_t gb_cpu_prefix_opcodes[256] = {GB_CPU_PREFIX_OPCODES(GB_CPU_PREFIX_OPCODE)};
+
+/* Names of the operand kinds as they appear in the mnemonics */
+static const char *const gb_cpu_operand_names[] = {
+	[GB_CPU_OPERAND_D8] = "d8",   [GB_CPU_OPERAND_D16] = "d16", [GB_CPU_OPERAND_A8] = "a8",
+	[GB_CPU_OPERAND_A16] = "a16", [GB_CPU_OPERAND_R8] = "r8",
+};
+
+/**
+ * @brief Turns an instruction into text.
+ * @details The operand kind in the mnemonic is replaced by the value of the operand. Relative
+ * jumps show their target, the other signed offsets are shown with their sign. Illegal opcodes
+ * and instructions that do not fit into size are shown as a data byte.
+ * @param code instruction bytes
+ * @param size number of bytes that may be read from code, at least 1
+ * @param address address of the instruction
+ * @param text buffer for the text
+ * @param len size of text
+ * @returns number of bytes taken by the instruction
+ */
+uint8_t gb_cpu_disassemble(const uint8_t *code, uint16_t size, uint16_t address, char *text,
+			   size_t len)
+{
+	const gb_cpu_opcode_t *info = &gb_cpu_opcodes[code[0]];
+	const char *name;
+	const char *suffix;
+	uint16_t operand;
+	int prefix_len;
+	char value[8];
+
+	if (info->bytes == 0 || info->bytes > size) {
+		snprintf(text, len, "DB $%02X", code[0]);
+		return 1;
+	}
+
+	if (code[0] == PREFIX_OPCODE) {
+		snprintf(text, len, "%s", gb_cpu_prefix_opcodes[code[1]].mnemonic);
+		return info->bytes;
+	}
+
+	if (info->operand == GB_CPU_OPERAND_NONE) {
+		snprintf(text, len, "%s", info->mnemonic);
+		return info->bytes;
+	}
+
+	operand = code[1];
+	if (info->bytes > 2) {
+		operand |= code[2] << 8;
+	}
+
+	name = strstr(info->mnemonic, gb_cpu_operand_names[info->operand]);
+	suffix = name + strlen(gb_cpu_operand_names[info->operand]);
+	prefix_len = (int)(name - info->mnemonic);
+
+	switch (info->operand) {
+	case GB_CPU_OPERAND_D8:
+		snprintf(value, sizeof(value), "$%02X", operand);
+		break;
+	case GB_CPU_OPERAND_A8:
+		snprintf(value, sizeof(value), "$FF%02X", operand);
+		break;
+	case GB_CPU_OPERAND_R8:
+		if (info->flow == GB_CPU_FLOW_JUMP) {
+			snprintf(value, sizeof(value), "$%04X",
+				 (uint16_t)(address + info->bytes + (int8_t)operand));
+		} else {
+			// SP+r8 takes the sign of the offset instead
+			if (prefix_len > 0 && info->mnemonic[prefix_len - 1] == '+') {
+				prefix_len--;
+			}
+			snprintf(value, sizeof(value), "%+d", (int8_t)operand);
+		}
+		break;
+	default:
+		snprintf(value, sizeof(value), "$%04X", operand);
+		break;
+	}
+
+	snprintf(text, len, "%.*s%s%s", prefix_len, info->mnemonic, value, suffix);
+
+	return info->bytes;
+}
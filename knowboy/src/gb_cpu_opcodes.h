@@ -0,0 +1,391 @@
+/**
+ * @file gb_cpu_opcodes.h
+ * @brief Description of the Gameboy CPU instruction set.
+ *
+ * The opcode tables in this file are the only place that holds the length, timing, memory
+ * accesses and flag usage of the instructions. The M-cycle core, the block cache decoder, the
+ * disassembler and the debugger trace are all built from them.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#ifndef SRC_GB_CPU_OPCODES_H_
+#define SRC_GB_CPU_OPCODES_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* M-cycle core handlers that check gb->cpu.current_cycle themselves are run on every M-cycle */
+#define CUSTOM_TIMING 255
+#define PREFIX_OPCODE 0xCB
+
+/* Immediate operand following the opcode */
+typedef enum {
+	GB_CPU_OPERAND_NONE,
+	GB_CPU_OPERAND_D8,
+	GB_CPU_OPERAND_D16,
+	// low byte of an address in 0xFF00 - 0xFFFF
+	GB_CPU_OPERAND_A8,
+	GB_CPU_OPERAND_A16,
+	// signed offset
+	GB_CPU_OPERAND_R8,
+} gb_cpu_operand_t;
+
+/* Data memory accesses, the stack included and the opcode and operand fetches left out */
+#define GB_CPU_ACCESS_NONE  0x00
+#define GB_CPU_ACCESS_READ  0x01
+#define GB_CPU_ACCESS_WRITE 0x02
+#define GB_CPU_ACCESS_RW    (GB_CPU_ACCESS_READ | GB_CPU_ACCESS_WRITE)
+
+/* Flags read or written, at their bit positions in F */
+#define GB_CPU_F_NONE 0x00
+#define GB_CPU_F_Z    0x80
+#define GB_CPU_F_C    0x10
+#define GB_CPU_F_NH   0x60
+#define GB_CPU_F_NHC  0x70
+#define GB_CPU_F_ZHC  0xB0
+#define GB_CPU_F_ZNH  0xE0
+#define GB_CPU_F_ZNHC 0xF0
+
+/* Change of the program flow, anything but GB_CPU_FLOW_NONE ends a basic block */
+typedef enum {
+	GB_CPU_FLOW_NONE,
+	GB_CPU_FLOW_JUMP,
+	// CALL and RST
+	GB_CPU_FLOW_CALL,
+	// RET and RETI
+	GB_CPU_FLOW_RET,
+	GB_CPU_FLOW_HALT,
+	GB_CPU_FLOW_STOP,
+	// illegal opcode, locks the CPU up
+	GB_CPU_FLOW_LOCK,
+} gb_cpu_flow_t;
+
+typedef struct {
+	// operands named after their kind, e.g. "LD A,(a16)"
+	const char *mnemonic;
+	gb_cpu_operand_t operand;
+	// length including the CB prefix, 0 for illegal opcodes
+	uint8_t bytes;
+	// M-cycles, conditional instructions take cycles when the condition is false and
+	// taken_cycles when it is true
+	uint8_t cycles;
+	uint8_t taken_cycles;
+	uint8_t access;
+	uint8_t flags_read;
+	uint8_t flags_written;
+	gb_cpu_flow_t flow;
+} gb_cpu_opcode_t;
+
+/*
+ * Instructions without prefix, one entry per opcode:
+ * X(opcode, handler, mnemonic, operand, bytes, cycles, taken cycles, step, access, flags read,
+ *   flags written, flow)
+ * handler is the M-cycle core function gb_cpu_<handler>, ILLEGAL if there is none, and step the
+ * M-cycle it is run on, see gb_cpu_step(). The CB prefix entry only gives the length, the
+ * instructions behind it are described by GB_CPU_PREFIX_OPCODES.
+ */
+#define GB_CPU_OPCODES(X)                                                                          \
+	X(0x00, NOP, "NOP", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                              \
+	X(0x01, LOAD_BC_d16, "LD BC,d16", D16, 3, 3, 3, 1, NONE, NONE, NONE, NONE)                 \
+	X(0x02, LOAD_BC_A, "LD (BC),A", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                 \
+	X(0x03, INC_BC, "INC BC", NONE, 1, 2, 2, 1, NONE, NONE, NONE, NONE)                        \
+	X(0x04, INC_B, "INC B", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x05, DEC_B, "DEC B", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x06, LOAD_B_d8, "LD B,d8", D8, 2, 2, 2, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x07, RLCA, "RLCA", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0x08, LOAD_a16_SP, "LD (a16),SP", A16, 3, 5, 5, 1, WRITE, NONE, NONE, NONE)              \
+	X(0x09, ADD_HL_BC, "ADD HL,BC", NONE, 1, 2, 2, 1, NONE, NONE, NHC, NONE)                   \
+	X(0x0A, LOAD_A_BC, "LD A,(BC)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                  \
+	X(0x0B, DEC_BC, "DEC BC", NONE, 1, 2, 2, 1, NONE, NONE, NONE, NONE)                        \
+	X(0x0C, INC_C, "INC C", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x0D, DEC_C, "DEC C", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x0E, LOAD_C_d8, "LD C,d8", D8, 2, 2, 2, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x0F, RRCA, "RRCA", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0x10, STOP, "STOP", NONE, 2, 1, 1, 1, NONE, NONE, NONE, STOP)                            \
+	X(0x11, LOAD_DE_d16, "LD DE,d16", D16, 3, 3, 3, 1, NONE, NONE, NONE, NONE)                 \
+	X(0x12, LOAD_DE_A, "LD (DE),A", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                 \
+	X(0x13, INC_DE, "INC DE", NONE, 1, 2, 2, 1, NONE, NONE, NONE, NONE)                        \
+	X(0x14, INC_D, "INC D", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x15, DEC_D, "DEC D", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x16, LOAD_D_d8, "LD D,d8", D8, 2, 2, 2, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x17, RLA, "RLA", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                                 \
+	X(0x18, JR_r8, "JR r8", R8, 2, 3, 3, 3, NONE, NONE, NONE, JUMP)                            \
+	X(0x19, ADD_HL_DE, "ADD HL,DE", NONE, 1, 2, 2, 1, NONE, NONE, NHC, NONE)                   \
+	X(0x1A, LOAD_A_DE, "LD A,(DE)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                  \
+	X(0x1B, DEC_DE, "DEC DE", NONE, 1, 2, 2, 1, NONE, NONE, NONE, NONE)                        \
+	X(0x1C, INC_E, "INC E", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x1D, DEC_E, "DEC E", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x1E, LOAD_E_d8, "LD E,d8", D8, 2, 2, 2, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x1F, RRA, "RRA", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                                 \
+	X(0x20, JR_NZ_r8, "JR NZ,r8", R8, 2, 2, 3, CUSTOM_TIMING, NONE, Z, NONE, JUMP)             \
+	X(0x21, LOAD_HL_d16, "LD HL,d16", D16, 3, 3, 3, 1, NONE, NONE, NONE, NONE)                 \
+	X(0x22, LOAD_HLI_A, "LD (HL+),A", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)               \
+	X(0x23, INC_HL, "INC HL", NONE, 1, 2, 2, 1, NONE, NONE, NONE, NONE)                        \
+	X(0x24, INC_H, "INC H", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x25, DEC_H, "DEC H", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x26, LOAD_H_d8, "LD H,d8", D8, 2, 2, 2, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x27, DAA, "DAA", NONE, 1, 1, 1, 1, NONE, NHC, ZHC, NONE)                                \
+	X(0x28, JR_Z_r8, "JR Z,r8", R8, 2, 2, 3, CUSTOM_TIMING, NONE, Z, NONE, JUMP)               \
+	X(0x29, ADD_HL_HL, "ADD HL,HL", NONE, 1, 2, 2, 1, NONE, NONE, NHC, NONE)                   \
+	X(0x2A, LOAD_A_HLI, "LD A,(HL+)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                \
+	X(0x2B, DEC_HL, "DEC HL", NONE, 1, 2, 2, 1, NONE, NONE, NONE, NONE)                        \
+	X(0x2C, INC_L, "INC L", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x2D, DEC_L, "DEC L", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x2E, LOAD_L_d8, "LD L,d8", D8, 2, 2, 2, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x2F, CPL, "CPL", NONE, 1, 1, 1, 1, NONE, NONE, NH, NONE)                                \
+	X(0x30, JR_NC_r8, "JR NC,r8", R8, 2, 2, 3, CUSTOM_TIMING, NONE, C, NONE, JUMP)             \
+	X(0x31, LOAD_SP_d16, "LD SP,d16", D16, 3, 3, 3, 1, NONE, NONE, NONE, NONE)                 \
+	X(0x32, LOAD_HLD_A, "LD (HL-),A", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)               \
+	X(0x33, INC_SP, "INC SP", NONE, 1, 2, 2, 1, NONE, NONE, NONE, NONE)                        \
+	X(0x34, INC_HL_ADDR, "INC (HL)", NONE, 1, 3, 3, CUSTOM_TIMING, RW, NONE, ZNH, NONE)        \
+	X(0x35, DEC_HL_ADDR, "DEC (HL)", NONE, 1, 3, 3, CUSTOM_TIMING, RW, NONE, ZNH, NONE)        \
+	X(0x36, LOAD_HL_d8, "LD (HL),d8", D8, 2, 3, 3, 2, WRITE, NONE, NONE, NONE)                 \
+	X(0x37, SCF, "SCF", NONE, 1, 1, 1, 1, NONE, NONE, NHC, NONE)                               \
+	X(0x38, JR_C_r8, "JR C,r8", R8, 2, 2, 3, CUSTOM_TIMING, NONE, C, NONE, JUMP)               \
+	X(0x39, ADD_HL_SP, "ADD HL,SP", NONE, 1, 2, 2, 1, NONE, NONE, NHC, NONE)                   \
+	X(0x3A, LOAD_A_HLD, "LD A,(HL-)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                \
+	X(0x3B, DEC_SP, "DEC SP", NONE, 1, 2, 2, 1, NONE, NONE, NONE, NONE)                        \
+	X(0x3C, INC_A, "INC A", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x3D, DEC_A, "DEC A", NONE, 1, 1, 1, 1, NONE, NONE, ZNH, NONE)                           \
+	X(0x3E, LOAD_A_d8, "LD A,d8", D8, 2, 2, 2, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x3F, CCF, "CCF", NONE, 1, 1, 1, 1, NONE, C, NHC, NONE)                                  \
+	X(0x40, LOAD_B_B, "LD B,B", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x41, LOAD_B_C, "LD B,C", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x42, LOAD_B_D, "LD B,D", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x43, LOAD_B_E, "LD B,E", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x44, LOAD_B_H, "LD B,H", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x45, LOAD_B_L, "LD B,L", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x46, LOAD_B_HL, "LD B,(HL)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                  \
+	X(0x47, LOAD_B_A, "LD B,A", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x48, LOAD_C_B, "LD C,B", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x49, LOAD_C_C, "LD C,C", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x4A, LOAD_C_D, "LD C,D", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x4B, LOAD_C_E, "LD C,E", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x4C, LOAD_C_H, "LD C,H", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x4D, LOAD_C_L, "LD C,L", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x4E, LOAD_C_HL, "LD C,(HL)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                  \
+	X(0x4F, LOAD_C_A, "LD C,A", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x50, LOAD_D_B, "LD D,B", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x51, LOAD_D_C, "LD D,C", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x52, LOAD_D_D, "LD D,D", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x53, LOAD_D_E, "LD D,E", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x54, LOAD_D_H, "LD D,H", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x55, LOAD_D_L, "LD D,L", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x56, LOAD_D_HL, "LD D,(HL)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                  \
+	X(0x57, LOAD_D_A, "LD D,A", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x58, LOAD_E_B, "LD E,B", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x59, LOAD_E_C, "LD E,C", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x5A, LOAD_E_D, "LD E,D", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x5B, LOAD_E_E, "LD E,E", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x5C, LOAD_E_H, "LD E,H", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x5D, LOAD_E_L, "LD E,L", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x5E, LOAD_E_HL, "LD E,(HL)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                  \
+	X(0x5F, LOAD_E_A, "LD E,A", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x60, LOAD_H_B, "LD H,B", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x61, LOAD_H_C, "LD H,C", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x62, LOAD_H_D, "LD H,D", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x63, LOAD_H_E, "LD H,E", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x64, LOAD_H_H, "LD H,H", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x65, LOAD_H_L, "LD H,L", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x66, LOAD_H_HL, "LD H,(HL)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                  \
+	X(0x67, LOAD_H_A, "LD H,A", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x68, LOAD_L_B, "LD L,B", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x69, LOAD_L_C, "LD L,C", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x6A, LOAD_L_D, "LD L,D", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x6B, LOAD_L_E, "LD L,E", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x6C, LOAD_L_H, "LD L,H", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x6D, LOAD_L_L, "LD L,L", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x6E, LOAD_L_HL, "LD L,(HL)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                  \
+	X(0x6F, LOAD_L_A, "LD L,A", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x70, LOAD_HL_B, "LD (HL),B", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                 \
+	X(0x71, LOAD_HL_C, "LD (HL),C", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                 \
+	X(0x72, LOAD_HL_D, "LD (HL),D", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                 \
+	X(0x73, LOAD_HL_E, "LD (HL),E", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                 \
+	X(0x74, LOAD_HL_H, "LD (HL),H", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                 \
+	X(0x75, LOAD_HL_L, "LD (HL),L", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                 \
+	X(0x76, HALT, "HALT", NONE, 1, 1, 1, 1, NONE, NONE, NONE, HALT)                            \
+	X(0x77, LOAD_HL_A, "LD (HL),A", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                 \
+	X(0x78, LOAD_A_B, "LD A,B", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x79, LOAD_A_C, "LD A,C", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x7A, LOAD_A_D, "LD A,D", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x7B, LOAD_A_E, "LD A,E", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x7C, LOAD_A_H, "LD A,H", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x7D, LOAD_A_L, "LD A,L", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x7E, LOAD_A_HL, "LD A,(HL)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                  \
+	X(0x7F, LOAD_A_A, "LD A,A", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                      \
+	X(0x80, ADD_A_B, "ADD A,B", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                      \
+	X(0x81, ADD_A_C, "ADD A,C", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                      \
+	X(0x82, ADD_A_D, "ADD A,D", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                      \
+	X(0x83, ADD_A_E, "ADD A,E", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                      \
+	X(0x84, ADD_A_H, "ADD A,H", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                      \
+	X(0x85, ADD_A_L, "ADD A,L", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                      \
+	X(0x86, ADD_A_HL, "ADD A,(HL)", NONE, 1, 2, 2, 1, READ, NONE, ZNHC, NONE)                  \
+	X(0x87, ADD_A_A, "ADD A,A", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                      \
+	X(0x88, ADC_A_B, "ADC A,B", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x89, ADC_A_C, "ADC A,C", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x8A, ADC_A_D, "ADC A,D", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x8B, ADC_A_E, "ADC A,E", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x8C, ADC_A_H, "ADC A,H", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x8D, ADC_A_L, "ADC A,L", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x8E, ADC_A_HL, "ADC A,(HL)", NONE, 1, 2, 2, 1, READ, C, ZNHC, NONE)                     \
+	X(0x8F, ADC_A_A, "ADC A,A", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x90, SUB_B, "SUB B", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0x91, SUB_C, "SUB C", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0x92, SUB_D, "SUB D", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0x93, SUB_E, "SUB E", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0x94, SUB_H, "SUB H", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0x95, SUB_L, "SUB L", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0x96, SUB_HL, "SUB (HL)", NONE, 1, 2, 2, 1, READ, NONE, ZNHC, NONE)                      \
+	X(0x97, SUB_A, "SUB A", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0x98, SBC_A_B, "SBC A,B", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x99, SBC_A_C, "SBC A,C", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x9A, SBC_A_D, "SBC A,D", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x9B, SBC_A_E, "SBC A,E", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x9C, SBC_A_H, "SBC A,H", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x9D, SBC_A_L, "SBC A,L", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0x9E, SBC_A_HL, "SBC A,(HL)", NONE, 1, 2, 2, 1, READ, C, ZNHC, NONE)                     \
+	X(0x9F, SBC_A_A, "SBC A,A", NONE, 1, 1, 1, 1, NONE, C, ZNHC, NONE)                         \
+	X(0xA0, AND_B, "AND B", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xA1, AND_C, "AND C", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xA2, AND_D, "AND D", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xA3, AND_E, "AND E", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xA4, AND_H, "AND H", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xA5, AND_L, "AND L", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xA6, AND_HL, "AND (HL)", NONE, 1, 2, 2, 1, READ, NONE, ZNHC, NONE)                      \
+	X(0xA7, AND_A, "AND A", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xA8, XOR_B, "XOR B", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xA9, XOR_C, "XOR C", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xAA, XOR_D, "XOR D", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xAB, XOR_E, "XOR E", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xAC, XOR_H, "XOR H", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xAD, XOR_L, "XOR L", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xAE, XOR_HL, "XOR (HL)", NONE, 1, 2, 2, 1, READ, NONE, ZNHC, NONE)                      \
+	X(0xAF, XOR_A, "XOR A", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xB0, OR_B, "OR B", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xB1, OR_C, "OR C", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xB2, OR_D, "OR D", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xB3, OR_E, "OR E", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xB4, OR_H, "OR H", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xB5, OR_L, "OR L", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xB6, OR_HL, "OR (HL)", NONE, 1, 2, 2, 1, READ, NONE, ZNHC, NONE)                        \
+	X(0xB7, OR_A, "OR A", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xB8, CP_B, "CP B", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xB9, CP_C, "CP C", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xBA, CP_D, "CP D", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xBB, CP_E, "CP E", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xBC, CP_H, "CP H", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xBD, CP_L, "CP L", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xBE, CP_HL, "CP (HL)", NONE, 1, 2, 2, 1, READ, NONE, ZNHC, NONE)                        \
+	X(0xBF, CP_A, "CP A", NONE, 1, 1, 1, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xC0, RET_NZ, "RET NZ", NONE, 1, 2, 5, CUSTOM_TIMING, READ, Z, NONE, RET)                \
+	X(0xC1, POP_BC, "POP BC", NONE, 1, 3, 3, 1, READ, NONE, NONE, NONE)                        \
+	X(0xC2, JP_NZ_a16, "JP NZ,a16", A16, 3, 3, 4, CUSTOM_TIMING, NONE, Z, NONE, JUMP)          \
+	X(0xC3, JP_a16, "JP a16", A16, 3, 4, 4, 4, NONE, NONE, NONE, JUMP)                         \
+	X(0xC4, CALL_NZ_a16, "CALL NZ,a16", A16, 3, 3, 6, CUSTOM_TIMING, WRITE, Z, NONE, CALL)     \
+	X(0xC5, PUSH_BC, "PUSH BC", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, NONE)                     \
+	X(0xC6, ADD_A_d8, "ADD A,d8", D8, 2, 2, 2, 1, NONE, NONE, ZNHC, NONE)                      \
+	X(0xC7, RST_00H, "RST 00H", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, CALL)                     \
+	X(0xC8, RET_Z, "RET Z", NONE, 1, 2, 5, CUSTOM_TIMING, READ, Z, NONE, RET)                  \
+	X(0xC9, RET, "RET", NONE, 1, 4, 4, 1, READ, NONE, NONE, RET)                               \
+	X(0xCA, JP_Z_a16, "JP Z,a16", A16, 3, 3, 4, CUSTOM_TIMING, NONE, Z, NONE, JUMP)            \
+	X(0xCB, PREFIX, "PREFIX CB", NONE, 2, 2, 2, CUSTOM_TIMING, NONE, NONE, NONE, NONE)         \
+	X(0xCC, CALL_Z_a16, "CALL Z,a16", A16, 3, 3, 6, CUSTOM_TIMING, WRITE, Z, NONE, CALL)       \
+	X(0xCD, CALL_a16, "CALL a16", A16, 3, 6, 6, 1, WRITE, NONE, NONE, CALL)                    \
+	X(0xCE, ADC_A_d8, "ADC A,d8", D8, 2, 2, 2, 1, NONE, C, ZNHC, NONE)                         \
+	X(0xCF, RST_08H, "RST 08H", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, CALL)                     \
+	X(0xD0, RET_NC, "RET NC", NONE, 1, 2, 5, CUSTOM_TIMING, READ, C, NONE, RET)                \
+	X(0xD1, POP_DE, "POP DE", NONE, 1, 3, 3, 1, READ, NONE, NONE, NONE)                        \
+	X(0xD2, JP_NC_a16, "JP NC,a16", A16, 3, 3, 4, CUSTOM_TIMING, NONE, C, NONE, JUMP)          \
+	X(0xD3, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xD4, CALL_NC_a16, "CALL NC,a16", A16, 3, 3, 6, CUSTOM_TIMING, WRITE, C, NONE, CALL)     \
+	X(0xD5, PUSH_DE, "PUSH DE", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, NONE)                     \
+	X(0xD6, SUB_d8, "SUB d8", D8, 2, 2, 2, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xD7, RST_10H, "RST 10H", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, CALL)                     \
+	X(0xD8, RET_C, "RET C", NONE, 1, 2, 5, CUSTOM_TIMING, READ, C, NONE, RET)                  \
+	X(0xD9, RETI, "RETI", NONE, 1, 4, 4, 1, READ, NONE, NONE, RET)                             \
+	X(0xDA, JP_C_a16, "JP C,a16", A16, 3, 3, 4, CUSTOM_TIMING, NONE, C, NONE, JUMP)            \
+	X(0xDB, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xDC, CALL_C_a16, "CALL C,a16", A16, 3, 3, 6, CUSTOM_TIMING, WRITE, C, NONE, CALL)       \
+	X(0xDD, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xDE, SBC_A_d8, "SBC A,d8", D8, 2, 2, 2, 1, NONE, C, ZNHC, NONE)                         \
+	X(0xDF, RST_18H, "RST 18H", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, CALL)                     \
+	X(0xE0, LOAD_a8_A, "LDH (a8),A", A8, 2, 3, 3, 2, WRITE, NONE, NONE, NONE)                  \
+	X(0xE1, POP_HL, "POP HL", NONE, 1, 3, 3, 1, READ, NONE, NONE, NONE)                        \
+	X(0xE2, LOAD_fC_A, "LD (C),A", NONE, 1, 2, 2, 1, WRITE, NONE, NONE, NONE)                  \
+	X(0xE3, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xE4, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xE5, PUSH_HL, "PUSH HL", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, NONE)                     \
+	X(0xE6, AND_d8, "AND d8", D8, 2, 2, 2, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xE7, RST20H, "RST 20H", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, CALL)                      \
+	X(0xE8, ADD_SP_r8, "ADD SP,r8", R8, 2, 4, 4, 1, NONE, NONE, ZNHC, NONE)                    \
+	X(0xE9, JP_HL, "JP HL", NONE, 1, 1, 1, 1, NONE, NONE, NONE, JUMP)                          \
+	X(0xEA, LOAD_a16_A, "LD (a16),A", A16, 3, 4, 4, 3, WRITE, NONE, NONE, NONE)                \
+	X(0xEB, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xEC, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xED, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xEE, XOR_d8, "XOR d8", D8, 2, 2, 2, 1, NONE, NONE, ZNHC, NONE)                          \
+	X(0xEF, RST_28H, "RST 28H", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, CALL)                     \
+	X(0xF0, LOAD_A_a8, "LDH A,(a8)", A8, 2, 3, 3, 2, READ, NONE, NONE, NONE)                   \
+	X(0xF1, POP_AF, "POP AF", NONE, 1, 3, 3, 1, READ, NONE, ZNHC, NONE)                        \
+	X(0xF2, LOAD_A_fC, "LD A,(C)", NONE, 1, 2, 2, 1, READ, NONE, NONE, NONE)                   \
+	X(0xF3, DI, "DI", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                                \
+	X(0xF4, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xF5, PUSH_AF, "PUSH AF", NONE, 1, 4, 4, 1, WRITE, ZNHC, NONE, NONE)                     \
+	X(0xF6, OR_d8, "OR d8", D8, 2, 2, 2, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xF7, RST_30H, "RST 30H", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, CALL)                     \
+	X(0xF8, LOAD_HL_SP_r8, "LD HL,SP+r8", R8, 2, 3, 3, 1, NONE, NONE, ZNHC, NONE)              \
+	X(0xF9, LOAD_SP_HL, "LD SP,HL", NONE, 1, 2, 2, 1, NONE, NONE, NONE, NONE)                  \
+	X(0xFA, LOAD_A_a16, "LD A,(a16)", A16, 3, 4, 4, 3, READ, NONE, NONE, NONE)                 \
+	X(0xFB, EI, "EI", NONE, 1, 1, 1, 1, NONE, NONE, NONE, NONE)                                \
+	X(0xFC, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xFD, ILLEGAL, "ILLEGAL", NONE, 0, 0, 0, 0, NONE, NONE, NONE, LOCK)                      \
+	X(0xFE, CP_d8, "CP d8", D8, 2, 2, 2, 1, NONE, NONE, ZNHC, NONE)                            \
+	X(0xFF, RST_38H, "RST 38H", NONE, 1, 4, 4, 1, WRITE, NONE, NONE, CALL)
+
+/*
+ * Instructions following the CB prefix, in opcode order:
+ * X(mnemonic, flags read, flags written, cycles, access)
+ * The operation is in bits 3 - 7 of the opcode and the operand register in bits 0 - 2.
+ */
+#define GB_CPU_PREFIX_OPERANDS(X, name, read, written, hl_cycles, hl_access)                       \
+	X(name "B", read, written, 2, NONE)                                                        \
+	X(name "C", read, written, 2, NONE)                                                        \
+	X(name "D", read, written, 2, NONE)                                                        \
+	X(name "E", read, written, 2, NONE)                                                        \
+	X(name "H", read, written, 2, NONE)                                                        \
+	X(name "L", read, written, 2, NONE)                                                        \
+	X(name "(HL)", read, written, hl_cycles, hl_access)                                        \
+	X(name "A", read, written, 2, NONE)
+
+#define GB_CPU_PREFIX_BITS(X, name, written, hl_cycles, hl_access)                                 \
+	GB_CPU_PREFIX_OPERANDS(X, name " 0,", NONE, written, hl_cycles, hl_access)                 \
+	GB_CPU_PREFIX_OPERANDS(X, name " 1,", NONE, written, hl_cycles, hl_access)                 \
+	GB_CPU_PREFIX_OPERANDS(X, name " 2,", NONE, written, hl_cycles, hl_access)                 \
+	GB_CPU_PREFIX_OPERANDS(X, name " 3,", NONE, written, hl_cycles, hl_access)                 \
+	GB_CPU_PREFIX_OPERANDS(X, name " 4,", NONE, written, hl_cycles, hl_access)                 \
+	GB_CPU_PREFIX_OPERANDS(X, name " 5,", NONE, written, hl_cycles, hl_access)                 \
+	GB_CPU_PREFIX_OPERANDS(X, name " 6,", NONE, written, hl_cycles, hl_access)                 \
+	GB_CPU_PREFIX_OPERANDS(X, name " 7,", NONE, written, hl_cycles, hl_access)
+
+#define GB_CPU_PREFIX_OPCODES(X)                                                                   \
+	GB_CPU_PREFIX_OPERANDS(X, "RLC ", NONE, ZNHC, 4, RW)                                       \
+	GB_CPU_PREFIX_OPERANDS(X, "RRC ", NONE, ZNHC, 4, RW)                                       \
+	GB_CPU_PREFIX_OPERANDS(X, "RL ", C, ZNHC, 4, RW)                                           \
+	GB_CPU_PREFIX_OPERANDS(X, "RR ", C, ZNHC, 4, RW)                                           \
+	GB_CPU_PREFIX_OPERANDS(X, "SLA ", NONE, ZNHC, 4, RW)                                       \
+	GB_CPU_PREFIX_OPERANDS(X, "SRA ", NONE, ZNHC, 4, RW)                                       \
+	GB_CPU_PREFIX_OPERANDS(X, "SWAP ", NONE, ZNHC, 4, RW)                                      \
+	GB_CPU_PREFIX_OPERANDS(X, "SRL ", NONE, ZNHC, 4, RW)                                       \
+	GB_CPU_PREFIX_BITS(X, "BIT", ZNH, 3, READ)                                                 \
+	GB_CPU_PREFIX_BITS(X, "RES", NONE, 4, RW)                                                  \
+	GB_CPU_PREFIX_BITS(X, "SET", NONE, 4, RW)
+
+extern const gb_cpu_opcode_t gb_cpu_opcodes[256];
+extern const gb_cpu_opcode_t gb_cpu_prefix_opcodes[256];
+
+uint8_t gb_cpu_disassemble(const uint8_t *code, uint16_t size, uint16_t address, char *text,
+			   size_t len);
+
+#endif /* SRC_GB_CPU_OPCODES_H_ */
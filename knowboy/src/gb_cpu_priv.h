@@ -10,7 +10,9 @@
 #define SRC_GB_CPU_PRIV_H_
 
 #include "gb_common.h"
+#include "gb_cpu_opcodes.h"
 #include "gb_memory.h"
+#include "gb_priv.h"
 
 #include <stdint.h>
 #include <stdio.h>
@@ -37,8 +39,9 @@
 #define H_FLAG_VAL (0x1 << H_FLAG_BIT)
 #define C_FLAG_VAL (0x1 << C_FLAG_BIT)
 
-#define CUSTOM_TIMING 255
-#define PREFIX_OPCODE 0xCB
+/* Lazily evaluated flags, N_FLAG_VAL is set for subtractions */
+#define GB_CPU_FLAGS_LAZY   0x01
+#define GB_CPU_FLAGS_KEEP_C 0x02
 
 /* Increment 8 bit register */
 static inline void gb_cpu_inc_register(uint8_t *reg, uint8_t *flag_reg)
@@ -132,25 +135,63 @@ static inline void gb_cpu_compare_A_register(uint8_t *reg_a, uint8_t *flag_reg,
 	SET_BIT(*flag_reg, N_FLAG_BIT);
 }
 
+/* Adjusts the A register to BCD after an addition or a subtraction */
+static inline void gb_cpu_decimal_adjust_A_register(uint8_t *reg_a, uint8_t *flag_reg)
+{
+	uint16_t tempShort = *reg_a;
+	if (CHK_BIT(*flag_reg, N_FLAG_BIT) != 0) {
+		if (CHK_BIT(*flag_reg, H_FLAG_BIT) != 0)
+			tempShort += 0xFA;
+		if (CHK_BIT(*flag_reg, C_FLAG_BIT) != 0)
+			tempShort += 0xA0;
+	} else {
+		if (CHK_BIT(*flag_reg, H_FLAG_BIT) || (tempShort & 0xF) > 9)
+			tempShort += 0x06;
+		if (CHK_BIT(*flag_reg, C_FLAG_BIT) || ((tempShort & 0x1F0) > 0x90)) {
+			tempShort += 0x60;
+			SET_BIT(*flag_reg, C_FLAG_BIT);
+		} else {
+			RST_BIT(*flag_reg, C_FLAG_BIT);
+		}
+	}
+	*reg_a = (uint8_t)tempShort;
+	RST_BIT(*flag_reg, H_FLAG_BIT);
+	(*reg_a != 0) ? RST_BIT(*flag_reg, Z_FLAG_BIT) : SET_BIT(*flag_reg, Z_FLAG_BIT);
+}
+
+/* Returns SP plus a signed 8 bit offset, flags are set from the unsigned low byte addition */
+static inline uint16_t gb_cpu_offset_SP_register(uint16_t reg_sp, uint8_t *flag_reg,
+						  uint8_t r8_val)
+{
+	uint32_t temp_res = reg_sp + r8_val;
+	((temp_res & 0xFF) < (reg_sp & 0xFF)) ? SET_BIT(*flag_reg, C_FLAG_BIT)
+					      : RST_BIT(*flag_reg, C_FLAG_BIT);
+	((temp_res & 0xF) < (reg_sp & 0xF)) ? SET_BIT(*flag_reg, H_FLAG_BIT)
+					    : RST_BIT(*flag_reg, H_FLAG_BIT);
+	RST_BIT(*flag_reg, Z_FLAG_BIT);
+	RST_BIT(*flag_reg, N_FLAG_BIT);
+	return reg_sp + (int8_t)r8_val;
+}
+
 /* Pop two bytes from the stack and jump to that address */
-static inline void gb_cpu_return_from_stack(uint16_t *reg_sp, uint16_t *reg_pc)
+static inline void gb_cpu_return_from_stack(gb_t *gb, uint16_t *reg_sp, uint16_t *reg_pc)
 {
-	*reg_pc = CAT_BYTES(gb_memory_read(*reg_sp), gb_memory_read(*reg_sp + 1));
+	*reg_pc = CAT_BYTES(gb_memory_read(gb, *reg_sp), gb_memory_read(gb, *reg_sp + 1));
 	*reg_sp += 2;
 }
 
 /*Pop two bytes off of the stack and into 16 bit register, increments the stack pointer by 2 */
-static inline void gb_cpu_pop_from_stack(uint16_t *reg_sp, uint16_t *reg_16)
+static inline void gb_cpu_pop_from_stack(gb_t *gb, uint16_t *reg_sp, uint16_t *reg_16)
 {
-	*reg_16 = CAT_BYTES(gb_memory_read(*reg_sp), gb_memory_read(*reg_sp + 1));
+	*reg_16 = CAT_BYTES(gb_memory_read(gb, *reg_sp), gb_memory_read(gb, *reg_sp + 1));
 	*reg_sp += 2;
 }
 
 /*Pushes 16 bit register onto stack */
-static inline void gb_cpu_push_to_stack(uint16_t *reg_sp, uint16_t reg_16)
+static inline void gb_cpu_push_to_stack(gb_t *gb, uint16_t *reg_sp, uint16_t reg_16)
 {
-	gb_memory_write(*reg_sp - 1, (uint8_t)((reg_16 & 0xFF00) >> 8));
-	gb_memory_write(*reg_sp - 2, (uint8_t)(reg_16 & 0x00FF));
+	gb_memory_write(gb, *reg_sp - 1, (uint8_t)((reg_16 & 0xFF00) >> 8));
+	gb_memory_write(gb, *reg_sp - 2, (uint8_t)(reg_16 & 0x00FF));
 	*reg_sp -= 2;
 }
 
@@ -255,565 +296,368 @@ static inline void gb_cpu_bit_check(uint8_t *reg_x, uint8_t bit, uint8_t *flag_r
 	SET_BIT(*flag_reg, H_FLAG_BIT);
 }
 
+/* Brings F up to date with the last lazily evaluated operation and returns it. Z comes from the
+ * low byte of the result, H and C from the carries into bits 4 and 8. */
+static inline uint8_t gb_cpu_flags(gb_t *gb)
+{
+	uint8_t op = gb->cpu.flags_op;
+	uint16_t res = gb->cpu.flags_res;
+
+	if (op != 0) {
+		uint8_t carry = (op & GB_CPU_FLAGS_KEEP_C) ? (gb->mem.reg.F & C_FLAG_VAL)
+							   : ((res >> 4) & C_FLAG_VAL);
+
+		gb->mem.reg.F = (((res & 0xFF) == 0) ? Z_FLAG_VAL : 0) | (op & N_FLAG_VAL) |
+				(((gb->cpu.flags_xor ^ res) << 1) & H_FLAG_VAL) | carry;
+		gb->cpu.flags_op = 0;
+	}
+
+	return gb->mem.reg.F;
+}
+
+/* Zero flag, without bringing F up to date */
+static inline uint8_t gb_cpu_flag_zero(gb_t *gb)
+{
+	if (gb->cpu.flags_op != 0) {
+		return (gb->cpu.flags_res & 0xFF) == 0;
+	}
+	return CHK_BIT(gb->mem.reg.F, Z_FLAG_BIT);
+}
+
+/* Carry flag, without bringing F up to date */
+static inline uint8_t gb_cpu_flag_carry(gb_t *gb)
+{
+	if ((gb->cpu.flags_op & (GB_CPU_FLAGS_LAZY | GB_CPU_FLAGS_KEEP_C)) == GB_CPU_FLAGS_LAZY) {
+		return (gb->cpu.flags_res >> 8) & 0x1;
+	}
+	return CHK_BIT(gb->mem.reg.F, C_FLAG_BIT);
+}
+
+/* Overwrites all of the flags */
+static inline void gb_cpu_set_flags(gb_t *gb, uint8_t flags)
+{
+	gb->mem.reg.F = flags;
+	gb->cpu.flags_op = 0;
+}
+
+/* Records an 8 bit addition or subtraction of A and value, the carry in included */
+static inline void gb_cpu_lazy_alu(gb_t *gb, uint8_t op, uint8_t value, uint16_t res)
+{
+	gb->cpu.flags_op = op;
+	gb->cpu.flags_xor = gb->mem.reg.A ^ value;
+	gb->cpu.flags_res = res;
+}
+
+/* Records an 8 bit increment or decrement of value, which keeps the carry flag as it is */
+static inline void gb_cpu_lazy_inc_dec(gb_t *gb, uint8_t op, uint8_t value, uint8_t res)
+{
+	if ((gb->cpu.flags_op & (GB_CPU_FLAGS_LAZY | GB_CPU_FLAGS_KEEP_C)) == GB_CPU_FLAGS_LAZY) {
+		gb->mem.reg.F = (gb->cpu.flags_res >> 4) & C_FLAG_VAL;
+	}
+	gb->cpu.flags_op = op | GB_CPU_FLAGS_KEEP_C;
+	gb->cpu.flags_xor = value ^ 0x01;
+	gb->cpu.flags_res = res;
+}
+
 /* type defs */
-typedef struct {
+typedef struct gb_instr_info {
 	uint8_t bytes;
 	uint8_t cycles;
 	uint8_t current_cycle;
 } gb_instr_info_t;
 
-typedef void (*gb_instr_func_t)(gb_instr_info_t *);
+typedef void (*gb_instr_func_t)(gb_t *, const gb_instr_info_t *);
 
-typedef struct {
+typedef struct gb_instr {
 	gb_instr_func_t instr;
 	gb_instr_info_t info;
 } gb_instr_t;
 
 /* function prototypes -----------------------------------------------*/
-static void gb_cpu_NOP(gb_instr_info_t *info);
-static void gb_cpu_LOAD_BC_d16(gb_instr_info_t *info);
-static void gb_cpu_LOAD_BC_A(gb_instr_info_t *info);
-static void gb_cpu_INC_BC(gb_instr_info_t *info);
-static void gb_cpu_INC_B(gb_instr_info_t *info);
-static void gb_cpu_DEC_B(gb_instr_info_t *info);
-static void gb_cpu_LOAD_B_d8(gb_instr_info_t *info);
-static void gb_cpu_RLCA(gb_instr_info_t *info);
-static void gb_cpu_LOAD_a16_SP(gb_instr_info_t *info);
-static void gb_cpu_ADD_HL_BC(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_BC(gb_instr_info_t *info);
-static void gb_cpu_DEC_BC(gb_instr_info_t *info);
-static void gb_cpu_INC_C(gb_instr_info_t *info);
-static void gb_cpu_DEC_C(gb_instr_info_t *info);
-static void gb_cpu_LOAD_C_d8(gb_instr_info_t *info);
-static void gb_cpu_RRCA(gb_instr_info_t *info);
-
-static void gb_cpu_STOP(gb_instr_info_t *info);
-static void gb_cpu_LOAD_DE_d16(gb_instr_info_t *info);
-static void gb_cpu_LOAD_DE_A(gb_instr_info_t *info);
-static void gb_cpu_INC_DE(gb_instr_info_t *info);
-static void gb_cpu_INC_D(gb_instr_info_t *info);
-static void gb_cpu_DEC_D(gb_instr_info_t *info);
-static void gb_cpu_LOAD_D_d8(gb_instr_info_t *info);
-static void gb_cpu_RLA(gb_instr_info_t *info);
-static void gb_cpu_JR_r8(gb_instr_info_t *info);
-static void gb_cpu_ADD_HL_DE(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_DE(gb_instr_info_t *info);
-static void gb_cpu_DEC_DE(gb_instr_info_t *info);
-static void gb_cpu_INC_E(gb_instr_info_t *info);
-static void gb_cpu_DEC_E(gb_instr_info_t *info);
-static void gb_cpu_LOAD_E_d8(gb_instr_info_t *info);
-static void gb_cpu_RRA(gb_instr_info_t *info);
-
-static void gb_cpu_JR_NZ_r8(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HL_d16(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HLI_A(gb_instr_info_t *info);
-static void gb_cpu_INC_HL(gb_instr_info_t *info);
-static void gb_cpu_INC_H(gb_instr_info_t *info);
-static void gb_cpu_DEC_H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_H_d8(gb_instr_info_t *info);
-static void gb_cpu_DAA(gb_instr_info_t *info);
-static void gb_cpu_JR_Z_r8(gb_instr_info_t *info);
-static void gb_cpu_ADD_HL_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_HLI(gb_instr_info_t *info);
-static void gb_cpu_DEC_HL(gb_instr_info_t *info);
-static void gb_cpu_INC_L(gb_instr_info_t *info);
-static void gb_cpu_DEC_L(gb_instr_info_t *info);
-static void gb_cpu_LOAD_L_d8(gb_instr_info_t *info);
-static void gb_cpu_CPL(gb_instr_info_t *info);
-
-static void gb_cpu_JR_NC_r8(gb_instr_info_t *info);
-static void gb_cpu_LOAD_SP_d16(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HLD_A(gb_instr_info_t *info);
-static void gb_cpu_INC_SP(gb_instr_info_t *info);
-static void gb_cpu_INC_HL_ADDR(gb_instr_info_t *info);
-static void gb_cpu_DEC_HL_ADDR(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HL_d8(gb_instr_info_t *info);
-static void gb_cpu_SCF(gb_instr_info_t *info);
-static void gb_cpu_JR_C_r8(gb_instr_info_t *info);
-static void gb_cpu_ADD_HL_SP(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_HLD(gb_instr_info_t *info);
-static void gb_cpu_DEC_SP(gb_instr_info_t *info);
-static void gb_cpu_INC_A(gb_instr_info_t *info);
-static void gb_cpu_DEC_A(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_d8(gb_instr_info_t *info);
-static void gb_cpu_CCF(gb_instr_info_t *info);
-
-static void gb_cpu_LOAD_B_B(gb_instr_info_t *info);
-static void gb_cpu_LOAD_B_C(gb_instr_info_t *info);
-static void gb_cpu_LOAD_B_D(gb_instr_info_t *info);
-static void gb_cpu_LOAD_B_E(gb_instr_info_t *info);
-static void gb_cpu_LOAD_B_H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_B_L(gb_instr_info_t *info);
-static void gb_cpu_LOAD_B_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_B_A(gb_instr_info_t *info);
-static void gb_cpu_LOAD_C_B(gb_instr_info_t *info);
-static void gb_cpu_LOAD_C_C(gb_instr_info_t *info);
-static void gb_cpu_LOAD_C_D(gb_instr_info_t *info);
-static void gb_cpu_LOAD_C_E(gb_instr_info_t *info);
-static void gb_cpu_LOAD_C_H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_C_L(gb_instr_info_t *info);
-static void gb_cpu_LOAD_C_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_C_A(gb_instr_info_t *info);
-
-static void gb_cpu_LOAD_D_B(gb_instr_info_t *info);
-static void gb_cpu_LOAD_D_C(gb_instr_info_t *info);
-static void gb_cpu_LOAD_D_D(gb_instr_info_t *info);
-static void gb_cpu_LOAD_D_E(gb_instr_info_t *info);
-static void gb_cpu_LOAD_D_H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_D_L(gb_instr_info_t *info);
-static void gb_cpu_LOAD_D_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_D_A(gb_instr_info_t *info);
-static void gb_cpu_LOAD_E_B(gb_instr_info_t *info);
-static void gb_cpu_LOAD_E_C(gb_instr_info_t *info);
-static void gb_cpu_LOAD_E_D(gb_instr_info_t *info);
-static void gb_cpu_LOAD_E_E(gb_instr_info_t *info);
-static void gb_cpu_LOAD_E_H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_E_L(gb_instr_info_t *info);
-static void gb_cpu_LOAD_E_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_E_A(gb_instr_info_t *info);
-
-static void gb_cpu_LOAD_H_B(gb_instr_info_t *info);
-static void gb_cpu_LOAD_H_C(gb_instr_info_t *info);
-static void gb_cpu_LOAD_H_D(gb_instr_info_t *info);
-static void gb_cpu_LOAD_H_E(gb_instr_info_t *info);
-static void gb_cpu_LOAD_H_H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_H_L(gb_instr_info_t *info);
-static void gb_cpu_LOAD_H_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_H_A(gb_instr_info_t *info);
-static void gb_cpu_LOAD_L_B(gb_instr_info_t *info);
-static void gb_cpu_LOAD_L_C(gb_instr_info_t *info);
-static void gb_cpu_LOAD_L_D(gb_instr_info_t *info);
-static void gb_cpu_LOAD_L_E(gb_instr_info_t *info);
-static void gb_cpu_LOAD_L_H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_L_L(gb_instr_info_t *info);
-static void gb_cpu_LOAD_L_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_L_A(gb_instr_info_t *info);
-
-static void gb_cpu_LOAD_HL_B(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HL_C(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HL_D(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HL_E(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HL_H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HL_L(gb_instr_info_t *info);
-static void gb_cpu_HALT(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HL_A(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_B(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_C(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_D(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_E(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_L(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_A(gb_instr_info_t *info);
-
-static void gb_cpu_ADD_A_B(gb_instr_info_t *info);
-static void gb_cpu_ADD_A_C(gb_instr_info_t *info);
-static void gb_cpu_ADD_A_D(gb_instr_info_t *info);
-static void gb_cpu_ADD_A_E(gb_instr_info_t *info);
-static void gb_cpu_ADD_A_H(gb_instr_info_t *info);
-static void gb_cpu_ADD_A_L(gb_instr_info_t *info);
-static void gb_cpu_ADD_A_HL(gb_instr_info_t *info);
-static void gb_cpu_ADD_A_A(gb_instr_info_t *info);
-static void gb_cpu_ADC_A_B(gb_instr_info_t *info);
-static void gb_cpu_ADC_A_C(gb_instr_info_t *info);
-static void gb_cpu_ADC_A_D(gb_instr_info_t *info);
-static void gb_cpu_ADC_A_E(gb_instr_info_t *info);
-static void gb_cpu_ADC_A_H(gb_instr_info_t *info);
-static void gb_cpu_ADC_A_L(gb_instr_info_t *info);
-static void gb_cpu_ADC_A_HL(gb_instr_info_t *info);
-static void gb_cpu_ADC_A_A(gb_instr_info_t *info);
-
-static void gb_cpu_SUB_B(gb_instr_info_t *info);
-static void gb_cpu_SUB_C(gb_instr_info_t *info);
-static void gb_cpu_SUB_D(gb_instr_info_t *info);
-static void gb_cpu_SUB_E(gb_instr_info_t *info);
-static void gb_cpu_SUB_H(gb_instr_info_t *info);
-static void gb_cpu_SUB_L(gb_instr_info_t *info);
-static void gb_cpu_SUB_HL(gb_instr_info_t *info);
-static void gb_cpu_SUB_A(gb_instr_info_t *info);
-static void gb_cpu_SBC_A_B(gb_instr_info_t *info);
-static void gb_cpu_SBC_A_C(gb_instr_info_t *info);
-static void gb_cpu_SBC_A_D(gb_instr_info_t *info);
-static void gb_cpu_SBC_A_E(gb_instr_info_t *info);
-static void gb_cpu_SBC_A_H(gb_instr_info_t *info);
-static void gb_cpu_SBC_A_L(gb_instr_info_t *info);
-static void gb_cpu_SBC_A_HL(gb_instr_info_t *info);
-static void gb_cpu_SBC_A_A(gb_instr_info_t *info);
-
-static void gb_cpu_AND_B(gb_instr_info_t *info);
-static void gb_cpu_AND_C(gb_instr_info_t *info);
-static void gb_cpu_AND_D(gb_instr_info_t *info);
-static void gb_cpu_AND_E(gb_instr_info_t *info);
-static void gb_cpu_AND_H(gb_instr_info_t *info);
-static void gb_cpu_AND_L(gb_instr_info_t *info);
-static void gb_cpu_AND_HL(gb_instr_info_t *info);
-static void gb_cpu_AND_A(gb_instr_info_t *info);
-static void gb_cpu_XOR_B(gb_instr_info_t *info);
-static void gb_cpu_XOR_C(gb_instr_info_t *info);
-static void gb_cpu_XOR_D(gb_instr_info_t *info);
-static void gb_cpu_XOR_E(gb_instr_info_t *info);
-static void gb_cpu_XOR_H(gb_instr_info_t *info);
-static void gb_cpu_XOR_L(gb_instr_info_t *info);
-static void gb_cpu_XOR_HL(gb_instr_info_t *info);
-static void gb_cpu_XOR_A(gb_instr_info_t *info);
-
-static void gb_cpu_OR_B(gb_instr_info_t *info);
-static void gb_cpu_OR_C(gb_instr_info_t *info);
-static void gb_cpu_OR_D(gb_instr_info_t *info);
-static void gb_cpu_OR_E(gb_instr_info_t *info);
-static void gb_cpu_OR_H(gb_instr_info_t *info);
-static void gb_cpu_OR_L(gb_instr_info_t *info);
-static void gb_cpu_OR_HL(gb_instr_info_t *info);
-static void gb_cpu_OR_A(gb_instr_info_t *info);
-static void gb_cpu_CP_B(gb_instr_info_t *info);
-static void gb_cpu_CP_C(gb_instr_info_t *info);
-static void gb_cpu_CP_D(gb_instr_info_t *info);
-static void gb_cpu_CP_E(gb_instr_info_t *info);
-static void gb_cpu_CP_H(gb_instr_info_t *info);
-static void gb_cpu_CP_L(gb_instr_info_t *info);
-static void gb_cpu_CP_HL(gb_instr_info_t *info);
-static void gb_cpu_CP_A(gb_instr_info_t *info);
-
-static void gb_cpu_RET_NZ(gb_instr_info_t *info);
-static void gb_cpu_POP_BC(gb_instr_info_t *info);
-static void gb_cpu_JP_NZ_a16(gb_instr_info_t *info);
-static void gb_cpu_JP_a16(gb_instr_info_t *info);
-static void gb_cpu_CALL_NZ_a16(gb_instr_info_t *info);
-static void gb_cpu_PUSH_BC(gb_instr_info_t *info);
-static void gb_cpu_ADD_A_d8(gb_instr_info_t *info);
-static void gb_cpu_RST_00H(gb_instr_info_t *info);
-static void gb_cpu_RET_Z(gb_instr_info_t *info);
-static void gb_cpu_RET(gb_instr_info_t *info);
-static void gb_cpu_JP_Z_a16(gb_instr_info_t *info);
-static void gb_cpu_PREFIX(gb_instr_info_t *info);
-static void gb_cpu_CALL_Z_a16(gb_instr_info_t *info);
-static void gb_cpu_CALL_a16(gb_instr_info_t *info);
-static void gb_cpu_ADC_A_d8(gb_instr_info_t *info);
-static void gb_cpu_RST_08H(gb_instr_info_t *info);
-
-static void gb_cpu_RET_NC(gb_instr_info_t *info);
-static void gb_cpu_POP_DE(gb_instr_info_t *info);
-static void gb_cpu_JP_NC_a16(gb_instr_info_t *info);
+static uint8_t gb_cpu_fetch_page(gb_t *gb, uint16_t address);
+
+/* Reads an opcode or immediate operand, a single load while PC stays within the same page */
+static inline uint8_t gb_cpu_fetch(gb_t *gb, uint16_t address)
+{
+	uint16_t offset = address - gb->cpu.fetch_base;
+
+	if (offset < gb->cpu.fetch_size) {
+		return gb->cpu.fetch_ptr[offset];
+	}
+
+	return gb_cpu_fetch_page(gb, address);
+}
+
+static void gb_cpu_NOP(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_BC_d16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_BC_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_BC(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_B_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RLCA(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_a16_SP(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_HL_BC(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_BC(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_BC(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_C_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RRCA(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_STOP(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_DE_d16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_DE_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_DE(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_D_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RLA(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_JR_r8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_HL_DE(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_DE(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_DE(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_E_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RRA(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_JR_NZ_r8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HL_d16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HLI_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_H_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DAA(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_JR_Z_r8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_HL_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_HLI(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_L_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CPL(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_JR_NC_r8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_SP_d16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HLD_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_SP(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_HL_ADDR(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_HL_ADDR(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HL_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SCF(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_JR_C_r8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_HL_SP(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_HLD(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_SP(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_INC_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DEC_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CCF(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_LOAD_B_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_B_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_B_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_B_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_B_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_B_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_B_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_B_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_C_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_C_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_C_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_C_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_C_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_C_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_C_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_C_A(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_LOAD_D_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_D_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_D_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_D_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_D_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_D_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_D_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_D_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_E_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_E_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_E_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_E_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_E_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_E_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_E_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_E_A(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_LOAD_H_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_H_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_H_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_H_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_H_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_H_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_H_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_H_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_L_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_L_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_L_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_L_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_L_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_L_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_L_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_L_A(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_LOAD_HL_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HL_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HL_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HL_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HL_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HL_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_HALT(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HL_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_A(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_ADD_A_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_A_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_A_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_A_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_A_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_A_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_A_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_A_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADC_A_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADC_A_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADC_A_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADC_A_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADC_A_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADC_A_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADC_A_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADC_A_A(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_SUB_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SUB_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SUB_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SUB_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SUB_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SUB_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SUB_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SUB_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SBC_A_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SBC_A_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SBC_A_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SBC_A_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SBC_A_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SBC_A_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SBC_A_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SBC_A_A(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_AND_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_AND_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_AND_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_AND_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_AND_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_AND_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_AND_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_AND_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_XOR_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_XOR_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_XOR_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_XOR_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_XOR_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_XOR_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_XOR_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_XOR_A(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_OR_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_OR_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_OR_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_OR_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_OR_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_OR_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_OR_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_OR_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CP_B(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CP_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CP_D(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CP_E(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CP_H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CP_L(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CP_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CP_A(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_RET_NZ(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_POP_BC(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_JP_NZ_a16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_JP_a16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CALL_NZ_a16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_PUSH_BC(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_A_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RST_00H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RET_Z(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RET(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_JP_Z_a16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_PREFIX(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CALL_Z_a16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_CALL_a16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADC_A_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RST_08H(gb_t *gb, const gb_instr_info_t *info);
+
+static void gb_cpu_RET_NC(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_POP_DE(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_JP_NC_a16(gb_t *gb, const gb_instr_info_t *info);
 // -----------
-static void gb_cpu_CALL_NC_a16(gb_instr_info_t *info);
-static void gb_cpu_PUSH_DE(gb_instr_info_t *info);
-static void gb_cpu_SUB_d8(gb_instr_info_t *info);
-static void gb_cpu_RST_10H(gb_instr_info_t *info);
-static void gb_cpu_RET_C(gb_instr_info_t *info);
-static void gb_cpu_RETI(gb_instr_info_t *info);
-static void gb_cpu_JP_C_a16(gb_instr_info_t *info);
+static void gb_cpu_CALL_NC_a16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_PUSH_DE(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_SUB_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RST_10H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RET_C(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RETI(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_JP_C_a16(gb_t *gb, const gb_instr_info_t *info);
 // -----------
-static void gb_cpu_CALL_C_a16(gb_instr_info_t *info);
+static void gb_cpu_CALL_C_a16(gb_t *gb, const gb_instr_info_t *info);
 // -----------
-static void gb_cpu_SBC_A_d8(gb_instr_info_t *info);
-static void gb_cpu_RST_18H(gb_instr_info_t *info);
+static void gb_cpu_SBC_A_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RST_18H(gb_t *gb, const gb_instr_info_t *info);
 
-static void gb_cpu_LOAD_a8_A(gb_instr_info_t *info);
-static void gb_cpu_POP_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_fC_A(gb_instr_info_t *info);
+static void gb_cpu_LOAD_a8_A(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_POP_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_fC_A(gb_t *gb, const gb_instr_info_t *info);
 // -----------
 // -----------
-static void gb_cpu_PUSH_HL(gb_instr_info_t *info);
-static void gb_cpu_AND_d8(gb_instr_info_t *info);
-static void gb_cpu_RST20H(gb_instr_info_t *info);
-static void gb_cpu_ADD_SP_r8(gb_instr_info_t *info);
-static void gb_cpu_JP_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_a16_A(gb_instr_info_t *info);
+static void gb_cpu_PUSH_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_AND_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RST20H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_ADD_SP_r8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_JP_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_a16_A(gb_t *gb, const gb_instr_info_t *info);
 // -----------
 // -----------
 // -----------
-static void gb_cpu_XOR_d8(gb_instr_info_t *info);
-static void gb_cpu_RST_28H(gb_instr_info_t *info);
+static void gb_cpu_XOR_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RST_28H(gb_t *gb, const gb_instr_info_t *info);
 
-static void gb_cpu_LOAD_A_a8(gb_instr_info_t *info);
-static void gb_cpu_POP_AF(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_fC(gb_instr_info_t *info);
-static void gb_cpu_DI(gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_a8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_POP_AF(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_fC(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_DI(gb_t *gb, const gb_instr_info_t *info);
 // -----------
-static void gb_cpu_PUSH_AF(gb_instr_info_t *info);
-static void gb_cpu_OR_d8(gb_instr_info_t *info);
-static void gb_cpu_RST_30H(gb_instr_info_t *info);
-static void gb_cpu_LOAD_HL_SP_r8(gb_instr_info_t *info);
-static void gb_cpu_LOAD_SP_HL(gb_instr_info_t *info);
-static void gb_cpu_LOAD_A_a16(gb_instr_info_t *info);
-static void gb_cpu_EI(gb_instr_info_t *info);
+static void gb_cpu_PUSH_AF(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_OR_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RST_30H(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_HL_SP_r8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_SP_HL(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_LOAD_A_a16(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_EI(gb_t *gb, const gb_instr_info_t *info);
 // -----------
 // -----------
-static void gb_cpu_CP_d8(gb_instr_info_t *info);
-static void gb_cpu_RST_38H(gb_instr_info_t *info);
-
-/* Prefix instruction */
-
-static void gb_cpu_RLC_B(gb_instr_info_t *info);
-static void gb_cpu_RLC_C(gb_instr_info_t *info);
-static void gb_cpu_RLC_D(gb_instr_info_t *info);
-static void gb_cpu_RLC_E(gb_instr_info_t *info);
-static void gb_cpu_RLC_H(gb_instr_info_t *info);
-static void gb_cpu_RLC_L(gb_instr_info_t *info);
-static void gb_cpu_RLC_HL(gb_instr_info_t *info);
-static void gb_cpu_RLC_A(gb_instr_info_t *info);
-static void gb_cpu_RRC_B(gb_instr_info_t *info);
-static void gb_cpu_RRC_C(gb_instr_info_t *info);
-static void gb_cpu_RRC_D(gb_instr_info_t *info);
-static void gb_cpu_RRC_E(gb_instr_info_t *info);
-static void gb_cpu_RRC_H(gb_instr_info_t *info);
-static void gb_cpu_RRC_L(gb_instr_info_t *info);
-static void gb_cpu_RRC_HL(gb_instr_info_t *info);
-static void gb_cpu_RRC_A(gb_instr_info_t *info);
-
-static void gb_cpu_RL_B(gb_instr_info_t *info);
-static void gb_cpu_RL_C(gb_instr_info_t *info);
-static void gb_cpu_RL_D(gb_instr_info_t *info);
-static void gb_cpu_RL_E(gb_instr_info_t *info);
-static void gb_cpu_RL_H(gb_instr_info_t *info);
-static void gb_cpu_RL_L(gb_instr_info_t *info);
-static void gb_cpu_RL_HL(gb_instr_info_t *info);
-static void gb_cpu_RL_A(gb_instr_info_t *info);
-static void gb_cpu_RR_B(gb_instr_info_t *info);
-static void gb_cpu_RR_C(gb_instr_info_t *info);
-static void gb_cpu_RR_D(gb_instr_info_t *info);
-static void gb_cpu_RR_E(gb_instr_info_t *info);
-static void gb_cpu_RR_H(gb_instr_info_t *info);
-static void gb_cpu_RR_L(gb_instr_info_t *info);
-static void gb_cpu_RR_HL(gb_instr_info_t *info);
-static void gb_cpu_RR_A(gb_instr_info_t *info);
-
-static void gb_cpu_SLA_B(gb_instr_info_t *info);
-static void gb_cpu_SLA_C(gb_instr_info_t *info);
-static void gb_cpu_SLA_D(gb_instr_info_t *info);
-static void gb_cpu_SLA_E(gb_instr_info_t *info);
-static void gb_cpu_SLA_H(gb_instr_info_t *info);
-static void gb_cpu_SLA_L(gb_instr_info_t *info);
-static void gb_cpu_SLA_HL(gb_instr_info_t *info);
-static void gb_cpu_SLA_A(gb_instr_info_t *info);
-static void gb_cpu_SRA_B(gb_instr_info_t *info);
-static void gb_cpu_SRA_C(gb_instr_info_t *info);
-static void gb_cpu_SRA_D(gb_instr_info_t *info);
-static void gb_cpu_SRA_E(gb_instr_info_t *info);
-static void gb_cpu_SRA_H(gb_instr_info_t *info);
-static void gb_cpu_SRA_L(gb_instr_info_t *info);
-static void gb_cpu_SRA_HL(gb_instr_info_t *info);
-static void gb_cpu_SRA_A(gb_instr_info_t *info);
-
-static void gb_cpu_SWAP_B(gb_instr_info_t *info);
-static void gb_cpu_SWAP_C(gb_instr_info_t *info);
-static void gb_cpu_SWAP_D(gb_instr_info_t *info);
-static void gb_cpu_SWAP_E(gb_instr_info_t *info);
-static void gb_cpu_SWAP_H(gb_instr_info_t *info);
-static void gb_cpu_SWAP_L(gb_instr_info_t *info);
-static void gb_cpu_SWAP_HL(gb_instr_info_t *info);
-static void gb_cpu_SWAP_A(gb_instr_info_t *info);
-static void gb_cpu_SRL_B(gb_instr_info_t *info);
-static void gb_cpu_SRL_C(gb_instr_info_t *info);
-static void gb_cpu_SRL_D(gb_instr_info_t *info);
-static void gb_cpu_SRL_E(gb_instr_info_t *info);
-static void gb_cpu_SRL_H(gb_instr_info_t *info);
-static void gb_cpu_SRL_L(gb_instr_info_t *info);
-static void gb_cpu_SRL_HL(gb_instr_info_t *info);
-static void gb_cpu_SRL_A(gb_instr_info_t *info);
-
-static void gb_cpu_BIT_0_B(gb_instr_info_t *info);
-static void gb_cpu_BIT_0_C(gb_instr_info_t *info);
-static void gb_cpu_BIT_0_D(gb_instr_info_t *info);
-static void gb_cpu_BIT_0_E(gb_instr_info_t *info);
-static void gb_cpu_BIT_0_H(gb_instr_info_t *info);
-static void gb_cpu_BIT_0_L(gb_instr_info_t *info);
-static void gb_cpu_BIT_0_HL(gb_instr_info_t *info);
-static void gb_cpu_BIT_0_A(gb_instr_info_t *info);
-static void gb_cpu_BIT_1_B(gb_instr_info_t *info);
-static void gb_cpu_BIT_1_C(gb_instr_info_t *info);
-static void gb_cpu_BIT_1_D(gb_instr_info_t *info);
-static void gb_cpu_BIT_1_E(gb_instr_info_t *info);
-static void gb_cpu_BIT_1_H(gb_instr_info_t *info);
-static void gb_cpu_BIT_1_L(gb_instr_info_t *info);
-static void gb_cpu_BIT_1_HL(gb_instr_info_t *info);
-static void gb_cpu_BIT_1_A(gb_instr_info_t *info);
-
-static void gb_cpu_BIT_2_B(gb_instr_info_t *info);
-static void gb_cpu_BIT_2_C(gb_instr_info_t *info);
-static void gb_cpu_BIT_2_D(gb_instr_info_t *info);
-static void gb_cpu_BIT_2_E(gb_instr_info_t *info);
-static void gb_cpu_BIT_2_H(gb_instr_info_t *info);
-static void gb_cpu_BIT_2_L(gb_instr_info_t *info);
-static void gb_cpu_BIT_2_HL(gb_instr_info_t *info);
-static void gb_cpu_BIT_2_A(gb_instr_info_t *info);
-static void gb_cpu_BIT_3_B(gb_instr_info_t *info);
-static void gb_cpu_BIT_3_C(gb_instr_info_t *info);
-static void gb_cpu_BIT_3_D(gb_instr_info_t *info);
-static void gb_cpu_BIT_3_E(gb_instr_info_t *info);
-static void gb_cpu_BIT_3_H(gb_instr_info_t *info);
-static void gb_cpu_BIT_3_L(gb_instr_info_t *info);
-static void gb_cpu_BIT_3_HL(gb_instr_info_t *info);
-static void gb_cpu_BIT_3_A(gb_instr_info_t *info);
-
-static void gb_cpu_BIT_4_B(gb_instr_info_t *info);
-static void gb_cpu_BIT_4_C(gb_instr_info_t *info);
-static void gb_cpu_BIT_4_D(gb_instr_info_t *info);
-static void gb_cpu_BIT_4_E(gb_instr_info_t *info);
-static void gb_cpu_BIT_4_H(gb_instr_info_t *info);
-static void gb_cpu_BIT_4_L(gb_instr_info_t *info);
-static void gb_cpu_BIT_4_HL(gb_instr_info_t *info);
-static void gb_cpu_BIT_4_A(gb_instr_info_t *info);
-static void gb_cpu_BIT_5_B(gb_instr_info_t *info);
-static void gb_cpu_BIT_5_C(gb_instr_info_t *info);
-static void gb_cpu_BIT_5_D(gb_instr_info_t *info);
-static void gb_cpu_BIT_5_E(gb_instr_info_t *info);
-static void gb_cpu_BIT_5_H(gb_instr_info_t *info);
-static void gb_cpu_BIT_5_L(gb_instr_info_t *info);
-static void gb_cpu_BIT_5_HL(gb_instr_info_t *info);
-static void gb_cpu_BIT_5_A(gb_instr_info_t *info);
-
-static void gb_cpu_BIT_6_B(gb_instr_info_t *info);
-static void gb_cpu_BIT_6_C(gb_instr_info_t *info);
-static void gb_cpu_BIT_6_D(gb_instr_info_t *info);
-static void gb_cpu_BIT_6_E(gb_instr_info_t *info);
-static void gb_cpu_BIT_6_H(gb_instr_info_t *info);
-static void gb_cpu_BIT_6_L(gb_instr_info_t *info);
-static void gb_cpu_BIT_6_HL(gb_instr_info_t *info);
-static void gb_cpu_BIT_6_A(gb_instr_info_t *info);
-static void gb_cpu_BIT_7_B(gb_instr_info_t *info);
-static void gb_cpu_BIT_7_C(gb_instr_info_t *info);
-static void gb_cpu_BIT_7_D(gb_instr_info_t *info);
-static void gb_cpu_BIT_7_E(gb_instr_info_t *info);
-static void gb_cpu_BIT_7_H(gb_instr_info_t *info);
-static void gb_cpu_BIT_7_L(gb_instr_info_t *info);
-static void gb_cpu_BIT_7_HL(gb_instr_info_t *info);
-static void gb_cpu_BIT_7_A(gb_instr_info_t *info);
-
-static void gb_cpu_RES_0_B(gb_instr_info_t *info);
-static void gb_cpu_RES_0_C(gb_instr_info_t *info);
-static void gb_cpu_RES_0_D(gb_instr_info_t *info);
-static void gb_cpu_RES_0_E(gb_instr_info_t *info);
-static void gb_cpu_RES_0_H(gb_instr_info_t *info);
-static void gb_cpu_RES_0_L(gb_instr_info_t *info);
-static void gb_cpu_RES_0_HL(gb_instr_info_t *info);
-static void gb_cpu_RES_0_A(gb_instr_info_t *info);
-static void gb_cpu_RES_1_B(gb_instr_info_t *info);
-static void gb_cpu_RES_1_C(gb_instr_info_t *info);
-static void gb_cpu_RES_1_D(gb_instr_info_t *info);
-static void gb_cpu_RES_1_E(gb_instr_info_t *info);
-static void gb_cpu_RES_1_H(gb_instr_info_t *info);
-static void gb_cpu_RES_1_L(gb_instr_info_t *info);
-static void gb_cpu_RES_1_HL(gb_instr_info_t *info);
-static void gb_cpu_RES_1_A(gb_instr_info_t *info);
-
-static void gb_cpu_RES_2_B(gb_instr_info_t *info);
-static void gb_cpu_RES_2_C(gb_instr_info_t *info);
-static void gb_cpu_RES_2_D(gb_instr_info_t *info);
-static void gb_cpu_RES_2_E(gb_instr_info_t *info);
-static void gb_cpu_RES_2_H(gb_instr_info_t *info);
-static void gb_cpu_RES_2_L(gb_instr_info_t *info);
-static void gb_cpu_RES_2_HL(gb_instr_info_t *info);
-static void gb_cpu_RES_2_A(gb_instr_info_t *info);
-static void gb_cpu_RES_3_B(gb_instr_info_t *info);
-static void gb_cpu_RES_3_C(gb_instr_info_t *info);
-static void gb_cpu_RES_3_D(gb_instr_info_t *info);
-static void gb_cpu_RES_3_E(gb_instr_info_t *info);
-static void gb_cpu_RES_3_H(gb_instr_info_t *info);
-static void gb_cpu_RES_3_L(gb_instr_info_t *info);
-static void gb_cpu_RES_3_HL(gb_instr_info_t *info);
-static void gb_cpu_RES_3_A(gb_instr_info_t *info);
-
-static void gb_cpu_RES_4_B(gb_instr_info_t *info);
-static void gb_cpu_RES_4_C(gb_instr_info_t *info);
-static void gb_cpu_RES_4_D(gb_instr_info_t *info);
-static void gb_cpu_RES_4_E(gb_instr_info_t *info);
-static void gb_cpu_RES_4_H(gb_instr_info_t *info);
-static void gb_cpu_RES_4_L(gb_instr_info_t *info);
-static void gb_cpu_RES_4_HL(gb_instr_info_t *info);
-static void gb_cpu_RES_4_A(gb_instr_info_t *info);
-static void gb_cpu_RES_5_B(gb_instr_info_t *info);
-static void gb_cpu_RES_5_C(gb_instr_info_t *info);
-static void gb_cpu_RES_5_D(gb_instr_info_t *info);
-static void gb_cpu_RES_5_E(gb_instr_info_t *info);
-static void gb_cpu_RES_5_H(gb_instr_info_t *info);
-static void gb_cpu_RES_5_L(gb_instr_info_t *info);
-static void gb_cpu_RES_5_HL(gb_instr_info_t *info);
-static void gb_cpu_RES_5_A(gb_instr_info_t *info);
-
-static void gb_cpu_RES_6_B(gb_instr_info_t *info);
-static void gb_cpu_RES_6_C(gb_instr_info_t *info);
-static void gb_cpu_RES_6_D(gb_instr_info_t *info);
-static void gb_cpu_RES_6_E(gb_instr_info_t *info);
-static void gb_cpu_RES_6_H(gb_instr_info_t *info);
-static void gb_cpu_RES_6_L(gb_instr_info_t *info);
-static void gb_cpu_RES_6_HL(gb_instr_info_t *info);
-static void gb_cpu_RES_6_A(gb_instr_info_t *info);
-static void gb_cpu_RES_7_B(gb_instr_info_t *info);
-static void gb_cpu_RES_7_C(gb_instr_info_t *info);
-static void gb_cpu_RES_7_D(gb_instr_info_t *info);
-static void gb_cpu_RES_7_E(gb_instr_info_t *info);
-static void gb_cpu_RES_7_H(gb_instr_info_t *info);
-static void gb_cpu_RES_7_L(gb_instr_info_t *info);
-static void gb_cpu_RES_7_HL(gb_instr_info_t *info);
-static void gb_cpu_RES_7_A(gb_instr_info_t *info);
-
-static void gb_cpu_SET_0_B(gb_instr_info_t *info);
-static void gb_cpu_SET_0_C(gb_instr_info_t *info);
-static void gb_cpu_SET_0_D(gb_instr_info_t *info);
-static void gb_cpu_SET_0_E(gb_instr_info_t *info);
-static void gb_cpu_SET_0_H(gb_instr_info_t *info);
-static void gb_cpu_SET_0_L(gb_instr_info_t *info);
-static void gb_cpu_SET_0_HL(gb_instr_info_t *info);
-static void gb_cpu_SET_0_A(gb_instr_info_t *info);
-static void gb_cpu_SET_1_B(gb_instr_info_t *info);
-static void gb_cpu_SET_1_C(gb_instr_info_t *info);
-static void gb_cpu_SET_1_D(gb_instr_info_t *info);
-static void gb_cpu_SET_1_E(gb_instr_info_t *info);
-static void gb_cpu_SET_1_H(gb_instr_info_t *info);
-static void gb_cpu_SET_1_L(gb_instr_info_t *info);
-static void gb_cpu_SET_1_HL(gb_instr_info_t *info);
-static void gb_cpu_SET_1_A(gb_instr_info_t *info);
-
-static void gb_cpu_SET_2_B(gb_instr_info_t *info);
-static void gb_cpu_SET_2_C(gb_instr_info_t *info);
-static void gb_cpu_SET_2_D(gb_instr_info_t *info);
-static void gb_cpu_SET_2_E(gb_instr_info_t *info);
-static void gb_cpu_SET_2_H(gb_instr_info_t *info);
-static void gb_cpu_SET_2_L(gb_instr_info_t *info);
-static void gb_cpu_SET_2_HL(gb_instr_info_t *info);
-static void gb_cpu_SET_2_A(gb_instr_info_t *info);
-static void gb_cpu_SET_3_B(gb_instr_info_t *info);
-static void gb_cpu_SET_3_C(gb_instr_info_t *info);
-static void gb_cpu_SET_3_D(gb_instr_info_t *info);
-static void gb_cpu_SET_3_E(gb_instr_info_t *info);
-static void gb_cpu_SET_3_H(gb_instr_info_t *info);
-static void gb_cpu_SET_3_L(gb_instr_info_t *info);
-static void gb_cpu_SET_3_HL(gb_instr_info_t *info);
-static void gb_cpu_SET_3_A(gb_instr_info_t *info);
-
-static void gb_cpu_SET_4_B(gb_instr_info_t *info);
-static void gb_cpu_SET_4_C(gb_instr_info_t *info);
-static void gb_cpu_SET_4_D(gb_instr_info_t *info);
-static void gb_cpu_SET_4_E(gb_instr_info_t *info);
-static void gb_cpu_SET_4_H(gb_instr_info_t *info);
-static void gb_cpu_SET_4_L(gb_instr_info_t *info);
-static void gb_cpu_SET_4_HL(gb_instr_info_t *info);
-static void gb_cpu_SET_4_A(gb_instr_info_t *info);
-static void gb_cpu_SET_5_B(gb_instr_info_t *info);
-static void gb_cpu_SET_5_C(gb_instr_info_t *info);
-static void gb_cpu_SET_5_D(gb_instr_info_t *info);
-static void gb_cpu_SET_5_E(gb_instr_info_t *info);
-static void gb_cpu_SET_5_H(gb_instr_info_t *info);
-static void gb_cpu_SET_5_L(gb_instr_info_t *info);
-static void gb_cpu_SET_5_HL(gb_instr_info_t *info);
-static void gb_cpu_SET_5_A(gb_instr_info_t *info);
-
-static void gb_cpu_SET_6_B(gb_instr_info_t *info);
-static void gb_cpu_SET_6_C(gb_instr_info_t *info);
-static void gb_cpu_SET_6_D(gb_instr_info_t *info);
-static void gb_cpu_SET_6_E(gb_instr_info_t *info);
-static void gb_cpu_SET_6_H(gb_instr_info_t *info);
-static void gb_cpu_SET_6_L(gb_instr_info_t *info);
-static void gb_cpu_SET_6_HL(gb_instr_info_t *info);
-static void gb_cpu_SET_6_A(gb_instr_info_t *info);
-static void gb_cpu_SET_7_B(gb_instr_info_t *info);
-static void gb_cpu_SET_7_C(gb_instr_info_t *info);
-static void gb_cpu_SET_7_D(gb_instr_info_t *info);
-static void gb_cpu_SET_7_E(gb_instr_info_t *info);
-static void gb_cpu_SET_7_H(gb_instr_info_t *info);
-static void gb_cpu_SET_7_L(gb_instr_info_t *info);
-static void gb_cpu_SET_7_HL(gb_instr_info_t *info);
-static void gb_cpu_SET_7_A(gb_instr_info_t *info);
+static void gb_cpu_CP_d8(gb_t *gb, const gb_instr_info_t *info);
+static void gb_cpu_RST_38H(gb_t *gb, const gb_instr_info_t *info);
 
 #endif /* SRC_GB_CPU_PRIV_H_ */
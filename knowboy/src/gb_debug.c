@@ -1,5 +1,5 @@
 /**
- * @file gb_mbc.c
+ * @file gb_debug.c
  * @brief Gameboy debugger Functionality.
  *
  * This file implements debugger functionality for the gameboy.
@@ -8,30 +8,16 @@
  * @date 2024-06-30
  */
 
+#include "gb_cpu_opcodes.h"
 #include "gb_debug.h"
 #include "gb_memory.h"
+#include "gb_priv.h"
 #include "logging.h"
 
 #include <ctype.h>
 #include <stdint.h>
 #include <string.h>
 
-#define MAX_BREAKPOINTS 5
-
-typedef struct {
-	uint16_t address[MAX_BREAKPOINTS];
-	bool activated[MAX_BREAKPOINTS];
-} breakpoints_t;
-
-static bool debugger_stopped;
-static breakpoints_t breakpoints;
-static gb_debug_check_msg_queue_t gb_debug_check_queue;
-static gb_debug_flush_t gb_debug_flush;
-static void *gb_debug_queue_ctx;
-static bool proceed;
-static uint16_t prev_PC;
-extern memory_t mem;
-
 static bool gb_debug_parse_address(char *str, int len, uint16_t *result)
 {
 	int num = 0;
@@ -109,54 +95,113 @@ static void gb_debug_deactivate_all_breakpoints(breakpoints_t *bps)
 	}
 }
 
-void gb_debug_init(gb_debug_check_msg_queue_t check_msg_queue, gb_debug_flush_t flush,
+/* Reads a byte without running any read handler, false if the byte is behind one */
+static bool gb_debug_peek(gb_t *gb, uint16_t address, uint8_t *data)
+{
+	const uint8_t *host = gb->pages.read[address >> GB_MEMORY_PAGE_SHIFT];
+
+	if (host != NULL) {
+		*data = host[address & (GB_MEMORY_PAGE_SIZE - 1)];
+		return true;
+	}
+
+	// HRAM shares the last page with the registers but is plain memory
+	if (address >= HRAM_BASE && address < IE_ADDR) {
+		*data = gb->mem.map[address];
+		return true;
+	}
+
+	return false;
+}
+
+/* Logs the instruction at an address and returns its length, bytes behind a read handler are
+ * not read so the debugger does not change the state it shows */
+static uint8_t gb_debug_log_instruction(gb_t *gb, uint16_t address)
+{
+	uint8_t code[3];
+	char text[QUEUE_MSG_LEN];
+	uint8_t bytes;
+	uint8_t size = 0;
+
+	while (size < sizeof(code) && gb_debug_peek(gb, address + size, &code[size])) {
+		size++;
+	}
+
+	if (size == 0) {
+		LOG_DBG("%04x: ??", address);
+		return 1;
+	}
+
+	bytes = gb_cpu_disassemble(code, size, address, text, sizeof(text));
+	LOG_DBG("%04x: %s", address, text);
+
+	return bytes;
+}
+
+/* Logs the instruction the M-cycle core is about to fetch while tracing */
+static void gb_debug_trace(gb_t *gb)
+{
+	if (gb->debug.trace && gb->cpu.op_remaining == 0 && !gb->cpu.halted &&
+	    !gb->cpu.interupt_dur) {
+		gb_debug_log_instruction(gb, gb->mem.reg.PC);
+		gb->debug.flush();
+	}
+}
+
+void gb_debug_init(gb_t *gb, gb_debug_check_msg_queue_t check_msg_queue, gb_debug_flush_t flush,
 		   void *queue_ctx)
 {
-	debugger_stopped = false;
-	proceed = false;
-	prev_PC = 0xFFFF;
-	gb_debug_check_queue = check_msg_queue;
-	gb_debug_queue_ctx = queue_ctx;
-	gb_debug_flush = flush;
-	gb_debug_deactivate_all_breakpoints(&breakpoints);
+	gb->debug.debugger_stopped = false;
+	gb->debug.proceed = false;
+	gb->debug.prev_PC = 0xFFFF;
+	gb->debug.trace = false;
+	gb->debug.check_queue = check_msg_queue;
+	gb->debug.queue_ctx = queue_ctx;
+	gb->debug.flush = flush;
+	gb_debug_deactivate_all_breakpoints(&gb->debug.breakpoints);
 }
 
-void gb_debug_check_msg_queue(void)
+void gb_debug_check_msg_queue(gb_t *gb)
 {
 	char message[QUEUE_MSG_LEN];
-	if (gb_debug_check_queue(gb_debug_queue_ctx, message)) {
+	if (gb->debug.check_queue(gb->debug.queue_ctx, message)) {
 		if (strncmp(message, "stop", QUEUE_MSG_LEN) == 0) {
-			debugger_stopped = true;
+			gb->debug.debugger_stopped = true;
 		} else if (strncmp(message, "continue", QUEUE_MSG_LEN) == 0) {
-			debugger_stopped = false;
+			gb->debug.debugger_stopped = false;
 		} else if (strncmp(message, "step", QUEUE_MSG_LEN) == 0) {
-			proceed = true;
-			prev_PC = mem.reg.PC;
+			gb->debug.proceed = true;
+			gb->debug.prev_PC = gb->mem.reg.PC;
 		} else if (strncmp(message, "registers", QUEUE_MSG_LEN) == 0) {
 			LOG_DBG("opcode: %x, PC: %x, AF: %x, BC: %x, DE: %x, HL: %x, SP: %x",
-				mem.map[mem.reg.PC], mem.reg.PC, mem.reg.AF, mem.reg.BC, mem.reg.DE,
-				mem.reg.HL, mem.reg.SP);
+				gb->mem.map[gb->mem.reg.PC], gb->mem.reg.PC, gb->mem.reg.AF,
+				gb->mem.reg.BC, gb->mem.reg.DE, gb->mem.reg.HL, gb->mem.reg.SP);
+			gb_debug_log_instruction(gb, gb->mem.reg.PC);
+		} else if (strncmp(message, "trace", QUEUE_MSG_LEN) == 0) {
+			gb->debug.trace = !gb->debug.trace;
 		} else if (strncmp(message, "break", sizeof("break") - 1) == 0) {
 			uint16_t address;
 			bool valid =
 				gb_debug_parse_address(&message[sizeof("break")],
 						       QUEUE_MSG_LEN - (sizeof("break")), &address);
-			if (valid && !gb_debug_is_breakpoint_activated(&breakpoints, address)) {
-				int index = gb_debug_get_free_breakpoint(&breakpoints);
+			if (valid &&
+			    !gb_debug_is_breakpoint_activated(&gb->debug.breakpoints, address)) {
+				int index = gb_debug_get_free_breakpoint(&gb->debug.breakpoints);
 				if (index < 0) {
 					LOG_ERR("No more breakpoints availible");
 					return;
 				}
-				breakpoints.address[index] = address;
-				breakpoints.activated[index] = true;
+				gb->debug.breakpoints.address[index] = address;
+				gb->debug.breakpoints.activated[index] = true;
 			}
 		} else if (strncmp(message, "delete", sizeof("delete") - 1) == 0) {
 			uint16_t address;
 			bool valid = gb_debug_parse_address(&message[sizeof("delete")],
 							    QUEUE_MSG_LEN - (sizeof("delete")),
 							    &address);
-			if (valid && gb_debug_is_breakpoint_activated(&breakpoints, address)) {
-				gb_debug_deactivate_breakpoint(&breakpoints, address);
+			if (valid &&
+			    gb_debug_is_breakpoint_activated(&gb->debug.breakpoints, address)) {
+				gb_debug_deactivate_breakpoint(&gb->debug.breakpoints, address);
 			}
 		} else if (strncmp(message, "print", sizeof("print") - 1) == 0) {
 			uint16_t address;
@@ -164,34 +209,52 @@ void gb_debug_check_msg_queue(void)
 				gb_debug_parse_address(&message[sizeof("print")],
 						       QUEUE_MSG_LEN - (sizeof("print")), &address);
 			if (valid) {
-				LOG_DBG("address %x: %x", address, mem.map[address]);
+				LOG_DBG("address %x: %x", address, gb->mem.map[address]);
+			}
+		} else if (strncmp(message, "disassemble", sizeof("disassemble") - 1) == 0) {
+			uint16_t address;
+			bool valid = gb_debug_parse_address(&message[sizeof("disassemble")],
+							    QUEUE_MSG_LEN - (sizeof("disassemble")),
+							    &address);
+			if (valid) {
+				for (int i = 0; i < DISASSEMBLE_INSTRUCTIONS; i++) {
+					address += gb_debug_log_instruction(gb, address);
+				}
 			}
 		}
-		gb_debug_flush();
+		gb->debug.flush();
 	}
 }
 
-bool gb_debug_step(void)
+bool gb_debug_step(gb_t *gb)
 {
-	if (proceed == true) {
-		if (mem.reg.PC == prev_PC) {
+	bool stopped;
+
+	if (gb->debug.proceed == true) {
+		if (gb->mem.reg.PC == gb->debug.prev_PC) {
+			gb_debug_trace(gb);
 			return false;
 		} else {
-			proceed = false;
+			gb->debug.proceed = false;
 		}
 	}
 
 	for (int i = 0; i < MAX_BREAKPOINTS; i++) {
-		if (breakpoints.activated[i] == true) {
-			if (mem.reg.PC == breakpoints.address[i]) {
-				debugger_stopped = true;
+		if (gb->debug.breakpoints.activated[i] == true) {
+			if (gb->mem.reg.PC == gb->debug.breakpoints.address[i]) {
+				gb->debug.debugger_stopped = true;
 			}
 		}
 	}
 
-	if (debugger_stopped) {
-		gb_debug_check_msg_queue();
+	if (gb->debug.debugger_stopped) {
+		gb_debug_check_msg_queue(gb);
+	}
+
+	stopped = gb->debug.debugger_stopped && !gb->debug.proceed;
+	if (!stopped) {
+		gb_debug_trace(gb);
 	}
 
-	return debugger_stopped && !proceed;
+	return stopped;
 }
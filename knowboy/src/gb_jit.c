@@ -0,0 +1,913 @@
+/**
+ * @file gb_jit.c
+ * @brief Gameboy x86-64 dynamic recompiler.
+ *
+ * This file translates runs of instructions of hot blocks from the block cache into native x86-64
+ * code. The guest registers live in host registers for the length of a run and memory is accessed
+ * through the memory page table. A run is left before any access to a page without host memory,
+ * which covers the memory mapped registers, video RAM writes and writes to work RAM that blocks
+ * were decoded from, so these are handled by the instruction core. Only instructions that take a
+ * fixed number of M-cycles are translated and the master clock is moved over a whole run at once.
+ * Translated code only touches memory that nothing but the CPU reads or writes, which keeps this
+ * exact as long as no interrupt can be dispatched in between, runs that an interrupt could end are
+ * handed to the instruction core. On other hosts nothing is translated.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#include "gb_jit.h"
+#include "gb_memory.h"
+#include "gb_priv.h"
+#include "gb_sched.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__))
+#define GB_JIT_X86_64
+#include <sys/mman.h>
+#endif
+
+// runs of a block before it is translated
+#define GB_JIT_HOT_RUNS 16
+
+// size of the code buffer and upper bound of the native code of one segment
+#define GB_JIT_BUFFER_SIZE  (1024 * 1024)
+#define GB_JIT_SEGMENT_SIZE 2048
+
+// first instruction of unused segments, never matches an instruction of a block
+#define GB_JIT_NO_SEGMENT 0xFF
+
+/* The code buffer is mapped writable and only made executable once the code is emitted. macOS
+ * with the hardened runtime only allows MAP_JIT mappings to be executable. The per thread write
+ * protection of MAP_JIT mappings does nothing on x86-64, so mprotect() is used there as well. */
+#ifdef __APPLE__
+#define GB_JIT_MAP_FLAGS (MAP_PRIVATE | MAP_ANONYMOUS | MAP_JIT)
+#else
+#define GB_JIT_MAP_FLAGS (MAP_PRIVATE | MAP_ANONYMOUS)
+#endif
+
+#ifdef GB_JIT_X86_64
+
+/* Host registers */
+enum { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+/* Host registers of the 3 bit register operand B, C, D, E, H, L, (HL), A */
+static const uint8_t gb_jit_reg8[8] = {R8, R9, R10, R11, R12, R13, 0xFF, RBX};
+
+/* Host registers of the other guest registers and of the arguments of the native code */
+#define HOST_F	   RBP
+#define HOST_SP	   R14
+#define HOST_TEMP  R15
+#define HOST_REGS  RDI
+#define HOST_READ  RSI
+#define HOST_WRITE RDX
+
+/* x86 ALU operations in the order ADD, ADC, SUB, SBC, AND, XOR, OR, CP of the guest */
+static const uint8_t gb_jit_alu_ext[8] = {0, 2, 5, 3, 4, 6, 1, 7};
+
+typedef struct {
+	uint8_t *p;
+	// rel32 fields of the jumps that leave the segment early and the instruction counts they
+	// return
+	uint8_t *exit[GB_CPU_BLOCK_INSTRUCTIONS];
+	uint8_t exit_count[GB_CPU_BLOCK_INSTRUCTIONS];
+	uint8_t exits;
+} gb_jit_emitter_t;
+
+/*Function Prototypes*/
+static void gb_jit_compile(gb_t *gb, gb_cpu_block_t *block);
+static uint8_t gb_jit_translate(gb_jit_emitter_t *e, const gb_cpu_block_t *block, uint8_t first);
+static bool gb_jit_instruction(gb_jit_emitter_t *e, const gb_cpu_decoded_t *instr, uint8_t index);
+static bool gb_jit_prefix(gb_jit_emitter_t *e, uint8_t opcode);
+static void gb_jit_alu(gb_jit_emitter_t *e, uint8_t operation, uint8_t src, bool immediate,
+		       uint8_t imm);
+static void gb_jit_flags(gb_jit_emitter_t *e, uint8_t keep, uint8_t take, uint8_t set);
+static void gb_jit_page(gb_jit_emitter_t *e, uint8_t table, uint8_t index);
+static void gb_jit_pair(gb_jit_emitter_t *e, uint8_t pair);
+static void gb_jit_step_hl(gb_jit_emitter_t *e, bool decrement);
+static void gb_jit_guest_registers(gb_jit_emitter_t *e, bool store);
+
+static inline void gb_jit_byte(gb_jit_emitter_t *e, uint8_t byte)
+{
+	*e->p++ = byte;
+}
+
+static inline void gb_jit_dword(gb_jit_emitter_t *e, uint32_t dword)
+{
+	memcpy(e->p, &dword, sizeof(dword));
+	e->p += sizeof(dword);
+}
+
+/* REX prefix, byte_regs has to be set for 8 bit register operands so 4 - 7 select SPL - DIL */
+static inline void gb_jit_rex(gb_jit_emitter_t *e, bool wide, uint8_t reg, uint8_t rm,
+			      bool byte_regs)
+{
+	uint8_t rex = 0x40 | (wide << 3) | ((reg >> 3) << 2) | (rm >> 3);
+
+	if (rex != 0x40 || byte_regs) {
+		gb_jit_byte(e, rex);
+	}
+}
+
+static inline void gb_jit_modrm(gb_jit_emitter_t *e, uint8_t mod, uint8_t reg, uint8_t rm)
+{
+	gb_jit_byte(e, (mod << 6) | ((reg & 7) << 3) | (rm & 7));
+}
+
+/* op r/m8, r8 */
+static inline void gb_jit_op8(gb_jit_emitter_t *e, uint8_t opcode, uint8_t dst, uint8_t src)
+{
+	gb_jit_rex(e, false, src, dst, true);
+	gb_jit_byte(e, opcode);
+	gb_jit_modrm(e, 3, src, dst);
+}
+
+/* op r/m8 of the 0xD0, 0xF6 and 0xFE groups */
+static inline void gb_jit_unary8(gb_jit_emitter_t *e, uint8_t opcode, uint8_t ext, uint8_t dst)
+{
+	gb_jit_rex(e, false, 0, dst, true);
+	gb_jit_byte(e, opcode);
+	gb_jit_modrm(e, 3, ext, dst);
+}
+
+/* op r/m8, imm8 of the 0x80, 0xC0 and 0xF6 groups */
+static inline void gb_jit_op8_imm(gb_jit_emitter_t *e, uint8_t opcode, uint8_t ext, uint8_t dst,
+				  uint8_t imm)
+{
+	gb_jit_unary8(e, opcode, ext, dst);
+	gb_jit_byte(e, imm);
+}
+
+/* op r/m32, r32 */
+static inline void gb_jit_op32(gb_jit_emitter_t *e, uint8_t opcode, uint8_t dst, uint8_t src)
+{
+	gb_jit_rex(e, false, src, dst, false);
+	gb_jit_byte(e, opcode);
+	gb_jit_modrm(e, 3, src, dst);
+}
+
+/* op r/m32, imm8 of the 0x83 (sign extended) and 0xC1 (shift) groups */
+static inline void gb_jit_op32_imm(gb_jit_emitter_t *e, uint8_t opcode, uint8_t ext, uint8_t dst,
+				   uint8_t imm)
+{
+	gb_jit_rex(e, false, 0, dst, false);
+	gb_jit_byte(e, opcode);
+	gb_jit_modrm(e, 3, ext, dst);
+	gb_jit_byte(e, imm);
+}
+
+/* mov r32, imm32 */
+static inline void gb_jit_mov_imm(gb_jit_emitter_t *e, uint8_t dst, uint32_t imm)
+{
+	gb_jit_rex(e, false, 0, dst, false);
+	gb_jit_byte(e, 0xB8 + (dst & 7));
+	gb_jit_dword(e, imm);
+}
+
+/* movzx r32, r/m8 and r32, r/m16 */
+static inline void gb_jit_movzx(gb_jit_emitter_t *e, uint8_t dst, uint8_t src, bool word)
+{
+	gb_jit_rex(e, false, dst, src, !word);
+	gb_jit_byte(e, 0x0F);
+	gb_jit_byte(e, word ? 0xB7 : 0xB6);
+	gb_jit_modrm(e, 3, dst, src);
+}
+
+/* bt ebp, 4, copies the guest carry flag into the host carry flag */
+static inline void gb_jit_carry_in(gb_jit_emitter_t *e)
+{
+	gb_jit_byte(e, 0x0F);
+	gb_jit_byte(e, 0xBA);
+	gb_jit_modrm(e, 3, 4, HOST_F);
+	gb_jit_byte(e, 4);
+}
+
+/**
+ * @brief Allocates the code buffer and starts the first epoch.
+ * @details The buffer is only mapped once the first block gets hot.
+ * @returns Nothing
+ */
+void gb_jit_init(gb_t *gb)
+{
+	gb->jit.buf = NULL;
+	gb->jit.size = 0;
+	gb->jit.used = 0;
+	gb->jit.epoch = 1;
+	gb->jit.unavailable = false;
+	gb->jit.check_memory = NULL;
+	gb->jit.mismatches = 0;
+}
+
+/**
+ * @brief Unmaps the code buffer and frees the memory snapshots of the JIT check mode.
+ * @returns Nothing
+ */
+void gb_jit_destroy(gb_t *gb)
+{
+	if (gb->jit.buf != NULL) {
+		munmap(gb->jit.buf, gb->jit.size);
+		gb->jit.buf = NULL;
+	}
+	free(gb->jit.check_memory);
+	gb->jit.check_memory = NULL;
+}
+
+/**
+ * @brief Makes the code buffer either writable or executable, never both.
+ * @param writable makes the buffer writable if set, executable otherwise
+ * @returns true on success
+ */
+static bool gb_jit_protect(gb_t *gb, bool writable)
+{
+	int prot = writable ? (PROT_READ | PROT_WRITE) : (PROT_READ | PROT_EXEC);
+
+	return mprotect(gb->jit.buf, gb->jit.size, prot) == 0;
+}
+
+/**
+ * @brief Unmaps the code buffer for good after its protection could not be changed.
+ * @details The epoch is bumped, so every block drops its segments and runs on the instruction
+ * core from then on.
+ * @returns Nothing
+ */
+static void gb_jit_release(gb_t *gb)
+{
+	munmap(gb->jit.buf, gb->jit.size);
+	gb->jit.buf = NULL;
+	gb->jit.used = 0;
+	gb->jit.epoch++;
+	gb->jit.unavailable = true;
+}
+
+/**
+ * @brief Translates the instructions of a block into segments of native code.
+ * @details Every run of at least two instructions that can be translated becomes a segment. The
+ * code buffer is flushed when it runs full, which invalidates the segments of all other blocks.
+ * The buffer is only writable while the code is emitted.
+ * @param block decoded block
+ * @returns Nothing
+ */
+static void gb_jit_compile(gb_t *gb, gb_cpu_block_t *block)
+{
+	uint8_t segments = 0;
+
+	if (gb->jit.buf == NULL && !gb->jit.unavailable) {
+		void *buf =
+		    mmap(NULL, GB_JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE, GB_JIT_MAP_FLAGS, -1, 0);
+		if (buf == MAP_FAILED) {
+			gb->jit.unavailable = true;
+		} else {
+			gb->jit.buf = buf;
+			gb->jit.size = GB_JIT_BUFFER_SIZE;
+		}
+	}
+
+	if (gb->jit.buf != NULL && !gb_jit_protect(gb, true)) {
+		gb_jit_release(gb);
+	}
+
+	if (gb->jit.buf != NULL &&
+	    gb->jit.used + GB_JIT_BLOCK_SEGMENTS * GB_JIT_SEGMENT_SIZE > gb->jit.size) {
+		gb->jit.used = 0;
+		gb->jit.epoch++;
+	}
+
+	for (uint8_t i = 0; i <= GB_JIT_BLOCK_SEGMENTS; i++) {
+		block->jit[i].code = NULL;
+		block->jit[i].first = GB_JIT_NO_SEGMENT;
+	}
+	block->jit_epoch = gb->jit.epoch;
+
+	for (uint8_t first = 0; gb->jit.buf != NULL && first < block->count &&
+				segments < GB_JIT_BLOCK_SEGMENTS;) {
+		gb_jit_emitter_t e = {.p = gb->jit.buf + gb->jit.used};
+		uint8_t count = gb_jit_translate(&e, block, first);
+		gb_jit_segment_t *segment = &block->jit[segments];
+
+		if (count >= 2) {
+			segment->code = (gb_jit_func_t)(gb->jit.buf + gb->jit.used);
+			segment->first = first;
+			segment->count = count;
+			segment->cycles = 0;
+			for (uint8_t i = first; i < first + count; i++) {
+				segment->cycles += block->instr[i].cycles;
+			}
+
+			gb->jit.used = (e.p - gb->jit.buf + 15) & ~15u;
+			segments++;
+		}
+
+		first += count + 1;
+	}
+
+	if (gb->jit.buf != NULL && !gb_jit_protect(gb, false)) {
+		gb_jit_release(gb);
+		for (uint8_t i = 0; i < segments; i++) {
+			block->jit[i].code = NULL;
+			block->jit[i].first = GB_JIT_NO_SEGMENT;
+		}
+		block->jit_epoch = gb->jit.epoch;
+	}
+}
+
+/**
+ * @brief Emits the native code of the longest run of instructions starting at first.
+ * @param first index of the first instruction in the block
+ * @returns number of instructions translated, nothing is emitted for a run of less than two
+ */
+static uint8_t gb_jit_translate(gb_jit_emitter_t *e, const gb_cpu_block_t *block, uint8_t first)
+{
+	static const uint8_t saved[] = {RBX, RBP, R12, R13, R14, R15};
+	uint8_t *start = e->p;
+	uint8_t *epilogue;
+	uint8_t count = 0;
+
+	for (uint8_t i = 0; i < sizeof(saved); i++) {
+		gb_jit_rex(e, false, 0, saved[i], false);
+		gb_jit_byte(e, 0x50 + (saved[i] & 7));
+	}
+	gb_jit_guest_registers(e, false);
+
+	while (first + count < block->count &&
+	       gb_jit_instruction(e, &block->instr[first + count], count)) {
+		count++;
+	}
+
+	if (count < 2) {
+		e->p = start;
+		return count;
+	}
+
+	gb_jit_mov_imm(e, RAX, count);
+	epilogue = e->p;
+	gb_jit_guest_registers(e, true);
+	for (uint8_t i = sizeof(saved); i > 0; i--) {
+		gb_jit_rex(e, false, 0, saved[i - 1], false);
+		gb_jit_byte(e, 0x58 + (saved[i - 1] & 7));
+	}
+	gb_jit_byte(e, 0xC3);
+
+	for (uint8_t i = 0; i < e->exits; i++) {
+		int32_t rel = e->p - (e->exit[i] + 4);
+
+		memcpy(e->exit[i], &rel, sizeof(rel));
+		gb_jit_mov_imm(e, RAX, e->exit_count[i]);
+		gb_jit_byte(e, 0xE9);
+		gb_jit_dword(e, epilogue - (e->p + 4));
+	}
+
+	return count;
+}
+
+/**
+ * @brief Moves the guest registers between the registers_t structure and the host registers.
+ * @param store true to write the host registers back
+ * @returns Nothing
+ */
+static void gb_jit_guest_registers(gb_jit_emitter_t *e, bool store)
+{
+	static const uint8_t offset[8] = {
+		offsetof(registers_t, B), offsetof(registers_t, C), offsetof(registers_t, D),
+		offsetof(registers_t, E), offsetof(registers_t, H), offsetof(registers_t, L),
+		offsetof(registers_t, F), offsetof(registers_t, A),
+	};
+
+	for (uint8_t i = 0; i < 8; i++) {
+		uint8_t host = (i == 6) ? HOST_F : gb_jit_reg8[i];
+
+		gb_jit_rex(e, false, host, HOST_REGS, store);
+		if (store) {
+			gb_jit_byte(e, 0x88);
+		} else {
+			gb_jit_byte(e, 0x0F);
+			gb_jit_byte(e, 0xB6);
+		}
+		gb_jit_modrm(e, 1, host, HOST_REGS);
+		gb_jit_byte(e, offset[i]);
+	}
+
+	if (store) {
+		gb_jit_byte(e, 0x66);
+	}
+	gb_jit_rex(e, false, HOST_SP, HOST_REGS, false);
+	if (store) {
+		gb_jit_byte(e, 0x89);
+	} else {
+		gb_jit_byte(e, 0x0F);
+		gb_jit_byte(e, 0xB7);
+	}
+	gb_jit_modrm(e, 1, HOST_SP, HOST_REGS);
+	gb_jit_byte(e, offsetof(registers_t, SP));
+}
+
+/**
+ * @brief Emits the native code of one instruction.
+ * @details Instructions that branch, that take a variable number of M-cycles, that change the
+ * interrupt state or that access memory through the stack pointer, the IO page or more than once
+ * are not translated. Nothing is emitted for them.
+ * @param instr decoded instruction
+ * @param index index of the instruction in the segment, returned if the segment is left before it
+ * @returns true if the instruction was translated
+ */
+static bool gb_jit_instruction(gb_jit_emitter_t *e, const gb_cpu_decoded_t *instr, uint8_t index)
+{
+	uint8_t opcode = instr->opcode;
+	uint8_t dst = gb_jit_reg8[(opcode >> 3) & 0x07];
+	uint8_t src = gb_jit_reg8[opcode & 0x07];
+	uint8_t hi = gb_jit_reg8[(opcode >> 3) & 0x06];
+	uint8_t lo = gb_jit_reg8[((opcode >> 3) & 0x06) + 1];
+
+	switch (opcode) {
+	case 0x00: // NOP
+		break;
+	case 0x01: // LD rr,d16
+	case 0x11:
+	case 0x21:
+		gb_jit_mov_imm(e, hi, instr->operand >> 8);
+		gb_jit_mov_imm(e, lo, instr->operand & 0xFF);
+		break;
+	case 0x31: // LD SP,d16
+		gb_jit_mov_imm(e, HOST_SP, instr->operand);
+		break;
+	case 0x03: // INC rr
+	case 0x13:
+	case 0x23:
+		gb_jit_op8_imm(e, 0x80, 0, lo, 1);
+		gb_jit_op8_imm(e, 0x80, 2, hi, 0);
+		break;
+	case 0x0B: // DEC rr
+	case 0x1B:
+	case 0x2B:
+		gb_jit_op8_imm(e, 0x80, 5, lo, 1);
+		gb_jit_op8_imm(e, 0x80, 3, hi, 0);
+		break;
+	case 0x33: // INC SP
+	case 0x3B: // DEC SP
+		gb_jit_op32_imm(e, 0x83, (opcode == 0x33) ? 0 : 5, HOST_SP, 1);
+		gb_jit_movzx(e, HOST_SP, HOST_SP, true);
+		break;
+	case 0x04: // INC r
+	case 0x0C:
+	case 0x14:
+	case 0x1C:
+	case 0x24:
+	case 0x2C:
+	case 0x3C:
+		gb_jit_unary8(e, 0xFE, 0, dst);
+		gb_jit_flags(e, 0x10, 0xA0, 0x00);
+		break;
+	case 0x05: // DEC r
+	case 0x0D:
+	case 0x15:
+	case 0x1D:
+	case 0x25:
+	case 0x2D:
+	case 0x3D:
+		gb_jit_unary8(e, 0xFE, 1, dst);
+		gb_jit_flags(e, 0x10, 0xA0, 0x40);
+		break;
+	case 0x06: // LD r,d8
+	case 0x0E:
+	case 0x16:
+	case 0x1E:
+	case 0x26:
+	case 0x2E:
+	case 0x3E:
+		gb_jit_mov_imm(e, dst, instr->operand);
+		break;
+	case 0x36: // LD (HL),d8
+		gb_jit_pair(e, 2);
+		gb_jit_page(e, HOST_WRITE, index);
+		gb_jit_byte(e, 0xC6);
+		gb_jit_modrm(e, 0, 0, 4);
+		gb_jit_modrm(e, 0, RAX, RCX);
+		gb_jit_byte(e, instr->operand);
+		break;
+	case 0x07: // RLCA
+	case 0x0F: // RRCA
+	case 0x17: // RLA
+	case 0x1F: // RRA
+		if (opcode >= 0x17) {
+			gb_jit_carry_in(e);
+		}
+		gb_jit_unary8(e, 0xD0, opcode >> 3, RBX);
+		gb_jit_flags(e, 0x00, 0x10, 0x00);
+		break;
+	case 0x2F: // CPL
+		gb_jit_unary8(e, 0xF6, 2, RBX);
+		gb_jit_op32_imm(e, 0x83, 1, HOST_F, 0x60);
+		break;
+	case 0x37: // SCF
+		gb_jit_op32_imm(e, 0x83, 4, HOST_F, 0x80);
+		gb_jit_op32_imm(e, 0x83, 1, HOST_F, 0x10);
+		break;
+	case 0x3F: // CCF
+		gb_jit_op32_imm(e, 0x83, 4, HOST_F, 0x90);
+		gb_jit_op32_imm(e, 0x83, 6, HOST_F, 0x10);
+		break;
+	case 0x02: // LD (BC),A
+	case 0x12: // LD (DE),A
+	case 0x22: // LD (HL+),A
+	case 0x32: // LD (HL-),A
+		gb_jit_pair(e, (opcode < 0x20) ? opcode >> 4 : 2);
+		gb_jit_page(e, HOST_WRITE, index);
+		gb_jit_rex(e, false, RBX, 0, true);
+		gb_jit_byte(e, 0x88);
+		gb_jit_modrm(e, 0, RBX, 4);
+		gb_jit_modrm(e, 0, RAX, RCX);
+		if (opcode >= 0x20) {
+			gb_jit_step_hl(e, opcode == 0x32);
+		}
+		break;
+	case 0x0A: // LD A,(BC)
+	case 0x1A: // LD A,(DE)
+	case 0x2A: // LD A,(HL+)
+	case 0x3A: // LD A,(HL-)
+		gb_jit_pair(e, (opcode < 0x20) ? opcode >> 4 : 2);
+		gb_jit_page(e, HOST_READ, index);
+		gb_jit_rex(e, false, RBX, 0, false);
+		gb_jit_byte(e, 0x0F);
+		gb_jit_byte(e, 0xB6);
+		gb_jit_modrm(e, 0, RBX, 4);
+		gb_jit_modrm(e, 0, RAX, RCX);
+		if (opcode >= 0x20) {
+			gb_jit_step_hl(e, opcode == 0x3A);
+		}
+		break;
+	case 0xEA: // LD (a16),A
+		gb_jit_mov_imm(e, RAX, instr->operand);
+		gb_jit_page(e, HOST_WRITE, index);
+		gb_jit_rex(e, false, RBX, 0, true);
+		gb_jit_byte(e, 0x88);
+		gb_jit_modrm(e, 0, RBX, 4);
+		gb_jit_modrm(e, 0, RAX, RCX);
+		break;
+	case 0xFA: // LD A,(a16)
+		gb_jit_mov_imm(e, RAX, instr->operand);
+		gb_jit_page(e, HOST_READ, index);
+		gb_jit_rex(e, false, RBX, 0, false);
+		gb_jit_byte(e, 0x0F);
+		gb_jit_byte(e, 0xB6);
+		gb_jit_modrm(e, 0, RBX, 4);
+		gb_jit_modrm(e, 0, RAX, RCX);
+		break;
+	case 0xF9: // LD SP,HL
+		gb_jit_pair(e, 2);
+		gb_jit_op32(e, 0x89, HOST_SP, RAX);
+		break;
+	case 0xC6: // ALU A,d8
+	case 0xCE:
+	case 0xD6:
+	case 0xDE:
+	case 0xE6:
+	case 0xEE:
+	case 0xF6:
+	case 0xFE:
+		gb_jit_alu(e, (opcode >> 3) & 0x07, 0, true, instr->operand);
+		break;
+	case 0xCB: // PREFIX CB
+		return gb_jit_prefix(e, instr->operand);
+	default:
+		if (opcode >= 0x40 && opcode < 0xC0 && opcode != 0x76) {
+			if (src == 0xFF) {
+				// LD r,(HL) and ALU A,(HL), ALU operands are loaded into ecx
+				uint8_t value = (opcode < 0x80) ? dst : RCX;
+
+				gb_jit_pair(e, 2);
+				gb_jit_page(e, HOST_READ, index);
+				gb_jit_rex(e, false, value, 0, false);
+				gb_jit_byte(e, 0x0F);
+				gb_jit_byte(e, 0xB6);
+				gb_jit_modrm(e, 0, value, 4);
+				gb_jit_modrm(e, 0, RAX, RCX);
+				src = RCX;
+			} else if (dst == 0xFF && opcode < 0x80) {
+				// LD (HL),r
+				gb_jit_pair(e, 2);
+				gb_jit_page(e, HOST_WRITE, index);
+				gb_jit_rex(e, false, src, 0, true);
+				gb_jit_byte(e, 0x88);
+				gb_jit_modrm(e, 0, src, 4);
+				gb_jit_modrm(e, 0, RAX, RCX);
+				break;
+			} else if (opcode < 0x80) {
+				gb_jit_op8(e, 0x88, dst, src);
+				break;
+			}
+
+			if (opcode >= 0x80) {
+				gb_jit_alu(e, (opcode >> 3) & 0x07, src, false, 0);
+			}
+			break;
+		}
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Emits the native code of a CB prefixed instruction with a register operand.
+ * @param opcode instruction opcode following the prefix
+ * @returns true if the instruction was translated, false for (HL) operands
+ */
+static bool gb_jit_prefix(gb_jit_emitter_t *e, uint8_t opcode)
+{
+	// x86 rotate and shift group operations of RLC, RRC, RL, RR, SLA, SRA, SWAP and SRL
+	static const uint8_t shift_ext[8] = {0, 1, 2, 3, 4, 7, 0, 5};
+	uint8_t reg = gb_jit_reg8[opcode & 0x07];
+	uint8_t operation = (opcode >> 3) & 0x07;
+
+	if (reg == 0xFF) {
+		return false;
+	}
+
+	switch (opcode >> 6) {
+	case 0:
+		if (operation == 6) {
+			// SWAP
+			gb_jit_op8_imm(e, 0xC0, 0, reg, 4);
+			gb_jit_op8(e, 0x84, reg, reg);
+			gb_jit_flags(e, 0x00, 0x80, 0x00);
+		} else if (operation >= 4) {
+			// SLA, SRA and SRL set the host zero and carry flags
+			gb_jit_unary8(e, 0xD0, shift_ext[operation], reg);
+			gb_jit_flags(e, 0x00, 0x90, 0x00);
+		} else {
+			// rotates leave the host zero flag alone, the carry is set aside in r15
+			if (operation >= 2) {
+				gb_jit_carry_in(e);
+			}
+			gb_jit_unary8(e, 0xD0, shift_ext[operation], reg);
+			gb_jit_rex(e, false, 0, HOST_TEMP, true);
+			gb_jit_byte(e, 0x0F);
+			gb_jit_byte(e, 0x92);
+			gb_jit_modrm(e, 3, 0, HOST_TEMP);
+			gb_jit_movzx(e, HOST_TEMP, HOST_TEMP, false);
+			gb_jit_op8(e, 0x84, reg, reg);
+			gb_jit_flags(e, 0x00, 0x80, 0x00);
+			gb_jit_op32_imm(e, 0xC1, 4, HOST_TEMP, 4);
+			gb_jit_op32(e, 0x09, HOST_F, HOST_TEMP);
+		}
+		break;
+	case 1: // BIT
+		gb_jit_op8_imm(e, 0xF6, 0, reg, 1 << operation);
+		gb_jit_flags(e, 0x10, 0x80, 0x20);
+		break;
+	case 2: // RES
+		gb_jit_op8_imm(e, 0x80, 4, reg, ~(1 << operation));
+		break;
+	default: // SET
+		gb_jit_op8_imm(e, 0x80, 1, reg, 1 << operation);
+		break;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Emits one of the 8 ALU operations on the A register.
+ * @param operation ADD, ADC, SUB, SBC, AND, XOR, OR or CP
+ * @param src host register holding the operand
+ * @param immediate use imm instead of src
+ * @param imm immediate operand
+ * @returns Nothing
+ */
+static void gb_jit_alu(gb_jit_emitter_t *e, uint8_t operation, uint8_t src, bool immediate,
+		       uint8_t imm)
+{
+	uint8_t ext = gb_jit_alu_ext[operation];
+
+	if (operation == 1 || operation == 3) {
+		gb_jit_carry_in(e);
+	}
+
+	if (immediate) {
+		gb_jit_op8_imm(e, 0x80, ext, RBX, imm);
+	} else {
+		gb_jit_op8(e, ext << 3, RBX, src);
+	}
+
+	switch (operation) {
+	case 0:
+	case 1:
+		gb_jit_flags(e, 0x00, 0xB0, 0x00);
+		break;
+	case 2:
+	case 3:
+	case 7:
+		gb_jit_flags(e, 0x00, 0xB0, 0x40);
+		break;
+	case 4:
+		gb_jit_flags(e, 0x00, 0x80, 0x20);
+		break;
+	default:
+		gb_jit_flags(e, 0x00, 0x80, 0x00);
+		break;
+	}
+}
+
+/**
+ * @brief Emits the update of the guest flags from the host flags of the previous instruction.
+ * @details The host zero, auxiliary carry and carry flags map to the guest Z, H and C flags. The
+ * new F is (F & keep) | (host flags & take) | set.
+ * @returns Nothing
+ */
+static void gb_jit_flags(gb_jit_emitter_t *e, uint8_t keep, uint8_t take, uint8_t set)
+{
+	// lahf, movzx ecx, ah
+	gb_jit_byte(e, 0x9F);
+	gb_jit_byte(e, 0x0F);
+	gb_jit_byte(e, 0xB6);
+	gb_jit_byte(e, 0xCC);
+
+	// ZF and AF are bits 6 and 4 of ah, CF is bit 0
+	gb_jit_op32(e, 0x89, RAX, RCX);
+	gb_jit_op32_imm(e, 0x83, 4, RCX, 0x50);
+	gb_jit_op32(e, 0x01, RCX, RCX);
+	gb_jit_op32_imm(e, 0x83, 4, RAX, 0x01);
+	gb_jit_op32_imm(e, 0xC1, 4, RAX, 4);
+	gb_jit_op32(e, 0x09, RCX, RAX);
+	if (take != 0xB0) {
+		gb_jit_op32_imm(e, 0x83, 4, RCX, take);
+	}
+
+	if (keep) {
+		gb_jit_op32_imm(e, 0x83, 4, HOST_F, keep);
+		gb_jit_op32(e, 0x09, HOST_F, RCX);
+	} else {
+		gb_jit_op32(e, 0x89, HOST_F, RCX);
+	}
+
+	if (set) {
+		gb_jit_op32_imm(e, 0x83, 1, HOST_F, set);
+	}
+}
+
+/**
+ * @brief Emits the page table lookup of the guest address in eax.
+ * @details Leaves the host memory of the page in rcx and the offset into the page in eax, or
+ * leaves the segment if the page has no host memory.
+ * @param table host register holding the read or write page table
+ * @param index instruction count returned when leaving the segment
+ * @returns Nothing
+ */
+static void gb_jit_page(gb_jit_emitter_t *e, uint8_t table, uint8_t index)
+{
+	// mov ecx, eax; shr ecx, 8
+	gb_jit_op32(e, 0x89, RCX, RAX);
+	gb_jit_op32_imm(e, 0xC1, 5, RCX, GB_MEMORY_PAGE_SHIFT);
+
+	// mov rcx, [table + rcx * 8]; test rcx, rcx; jz exit
+	gb_jit_rex(e, true, RCX, table, false);
+	gb_jit_byte(e, 0x8B);
+	gb_jit_modrm(e, 0, RCX, 4);
+	gb_jit_modrm(e, 3, RCX, table);
+	gb_jit_rex(e, true, RCX, RCX, false);
+	gb_jit_byte(e, 0x85);
+	gb_jit_modrm(e, 3, RCX, RCX);
+	gb_jit_byte(e, 0x0F);
+	gb_jit_byte(e, 0x84);
+	e->exit[e->exits] = e->p;
+	e->exit_count[e->exits++] = index;
+	gb_jit_dword(e, 0);
+
+	gb_jit_movzx(e, RAX, RAX, false);
+}
+
+/**
+ * @brief Emits eax = register pair.
+ * @param pair BC, DE or HL
+ * @returns Nothing
+ */
+static void gb_jit_pair(gb_jit_emitter_t *e, uint8_t pair)
+{
+	gb_jit_op32(e, 0x89, RAX, gb_jit_reg8[pair * 2]);
+	gb_jit_op32_imm(e, 0xC1, 4, RAX, 8);
+	gb_jit_op32(e, 0x09, RAX, gb_jit_reg8[pair * 2 + 1]);
+}
+
+/**
+ * @brief Emits the increment or decrement of HL, which leaves the guest flags alone.
+ * @returns Nothing
+ */
+static void gb_jit_step_hl(gb_jit_emitter_t *e, bool decrement)
+{
+	gb_jit_op8_imm(e, 0x80, decrement ? 5 : 0, R13, 1);
+	gb_jit_op8_imm(e, 0x80, decrement ? 3 : 2, R12, 0);
+}
+
+#else
+
+void gb_jit_init(gb_t *gb)
+{
+	gb->jit.buf = NULL;
+	gb->jit.size = 0;
+	gb->jit.used = 0;
+	gb->jit.epoch = 1;
+	gb->jit.unavailable = true;
+	gb->jit.check_memory = NULL;
+	gb->jit.mismatches = 0;
+}
+
+void gb_jit_destroy(gb_t *gb)
+{
+	free(gb->jit.check_memory);
+	gb->jit.check_memory = NULL;
+}
+
+static void gb_jit_compile(gb_t *gb, gb_cpu_block_t *block)
+{
+	for (uint8_t i = 0; i <= GB_JIT_BLOCK_SEGMENTS; i++) {
+		block->jit[i].code = NULL;
+		block->jit[i].first = GB_JIT_NO_SEGMENT;
+	}
+	block->jit_epoch = gb->jit.epoch;
+}
+
+#endif /* GB_JIT_X86_64 */
+
+/**
+ * @brief Returns the native code segments of a block, translating it once it is hot.
+ * @param block decoded block
+ * @returns first segment of the block, NULL if it has none
+ */
+const gb_jit_segment_t *gb_jit_lookup(gb_t *gb, gb_cpu_block_t *block)
+{
+	if (block->jit_epoch != gb->jit.epoch) {
+		if (block->hits < GB_JIT_HOT_RUNS) {
+			block->hits++;
+			return NULL;
+		}
+		gb_jit_compile(gb, block);
+	}
+
+	return (block->jit[0].code != NULL) ? block->jit : NULL;
+}
+
+/**
+ * @brief Runs the native code of a segment without moving the clock.
+ * @details Nothing is run if the segment would exceed the cycle budget, or if interrupts are
+ * enabled and one is pending or an event is due before the segment ends, the caller has to run
+ * the first instruction of the segment itself then. The segment is left early before a memory
+ * access that needs a handler.
+ * @param block block the segment belongs to
+ * @param segment segment to run, its first instruction has to be the one at PC
+ * @param end clock cycle from which on no further instruction is started
+ * @param cycles set to the M-cycles of the instructions that were run
+ * @returns number of instructions run
+ */
+uint8_t gb_jit_run_native(gb_t *gb, const gb_cpu_block_t *block, const gb_jit_segment_t *segment,
+			  uint64_t end, uint32_t *cycles)
+{
+	uint64_t finish = gb->sched.now + segment->cycles * GB_CYCLES_PER_M_CYCLE;
+	uint8_t count;
+
+	*cycles = 0;
+
+	if (finish > end) {
+		return 0;
+	}
+
+	if (gb->cpu.interrupt_master_enable &&
+	    (gb->cpu.pending_interrupts || gb->sched.next_key < GB_SCHED_KEY(finish, 0))) {
+		return 0;
+	}
+
+	count = segment->code(&gb->mem.reg, gb->pages.read, gb->pages.write);
+	for (uint8_t i = segment->first; i < segment->first + count; i++) {
+		gb->mem.reg.PC += block->instr[i].length;
+		*cycles += block->instr[i].cycles;
+	}
+
+	return count;
+}
+
+/**
+ * @brief Runs the native code of a segment and moves the clock over the instructions it ran.
+ * @details See gb_jit_run_native() for when nothing is run.
+ * @param block block the segment belongs to
+ * @param segment segment to run, its first instruction has to be the one at PC
+ * @param end clock cycle from which on no further instruction is started
+ * @returns number of instructions run
+ */
+uint8_t gb_jit_run(gb_t *gb, const gb_cpu_block_t *block, const gb_jit_segment_t *segment,
+		   uint64_t end)
+{
+	uint32_t cycles;
+	uint8_t count = gb_jit_run_native(gb, block, segment, end, &cycles);
+
+	/* The interrupt handler of the instruction core arms the one instruction delay of EI */
+	if (count && gb->cpu.interrupt_master_enable) {
+		gb->cpu.one_cycle_interrupt_delay = 1;
+	}
+
+	gb_sched_advance(gb, cycles * GB_CYCLES_PER_M_CYCLE);
+
+	return count;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file gb_jit.h
+ * @brief Private API of the x86-64 dynamic recompiler.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#ifndef SRC_GB_JIT_H_
+#define SRC_GB_JIT_H_
+
+#include "gb_priv.h"
+
+#include <stdint.h>
+
+void gb_jit_init(gb_t *gb);
+void gb_jit_destroy(gb_t *gb);
+const gb_jit_segment_t *gb_jit_lookup(gb_t *gb, gb_cpu_block_t *block);
+uint8_t gb_jit_run_native(gb_t *gb, const gb_cpu_block_t *block, const gb_jit_segment_t *segment,
+			  uint64_t end, uint32_t *cycles);
+uint8_t gb_jit_run(gb_t *gb, const gb_cpu_block_t *block, const gb_jit_segment_t *segment,
+		   uint64_t end);
+
+#endif /* SRC_GB_JIT_H_ */
@@ -9,7 +9,9 @@
  * @date 2021-06-11
  */
 
+#include "gb_mbc.h"
 #include "gb_memory.h"
+#include "gb_priv.h"
 #include "logging.h"
 
 #include <stdint.h>
@@ -18,18 +20,6 @@
 #define ROM_BANK_SIZE 16384
 #define RAM_BANK_SIZE 8192
 
-static uint8_t gb_mbc_controller_code = 0;
-static uint8_t gb_mbc_rom_bank_count = 0;
-static uint8_t gb_mbc_ram_bank_count = 0;
-static uint8_t gb_mbc_ram_enable = 0;
-static uint8_t gb_mbc_bank1 = 0x01;
-static uint8_t gb_mbc_bank2 = 0x0;
-static uint8_t gb_mbc_bank_mode = 0x0;
-static uint8_t *gb_mbc_bank_ram = NULL;
-
-extern const uint8_t *rom;
-extern memory_t mem;
-
 static const uint8_t gb_mbc_rom_bank_lut[] = {
   2,   // 32KB
   4,   // 64KB
@@ -51,13 +41,57 @@ static const uint8_t gb_mbc_ram_bank_lut[] = {
   8   // 64KB  (8 banks of 8KB each)
 };
 
-void gbc_mbc_init(void)
+/*Function Prototypes*/
+static void gb_mbc_update_banks(gb_t *gb);
+
+void gbc_mbc_init(gb_t *gb)
 {
-	gb_mbc_controller_code = 0;
-	gb_mbc_ram_enable = 0;
-	gb_mbc_bank1 = 0x01;
-	gb_mbc_bank2 = 0x0;
-	gb_mbc_bank_mode = 0x0;
+	gb->mbc.controller_code = 0;
+	gb->mbc.ram_enable = 0;
+	gb->mbc.bank1 = 0x01;
+	gb->mbc.bank2 = 0x0;
+	gb->mbc.bank_mode = 0x0;
+	gb->mbc.bank0_ptr = NULL;
+	gb->mbc.bankX_ptr = NULL;
+	gb->mbc.sram_ptr = NULL;
+}
+
+/**
+ * @brief Points bank0_ptr, bankX_ptr and sram_ptr at the banks selected by the MBC registers
+ * @details The memory page table is updated to match.
+ * @returns Nothing
+ */
+static void gb_mbc_update_banks(gb_t *gb)
+{
+	uint32_t bank;
+
+	if (gb->mbc.controller_code == 0) {
+		gb->mbc.bank0_ptr = gb->rom;
+		gb->mbc.bankX_ptr = gb->rom + ROM_BANK_SIZE;
+	} else {
+		bank = (gb->mbc.bank_mode == 0) ? 0 : (gb->mbc.bank2 << 5);
+		if (bank >= gb->mbc.rom_bank_count) {
+			bank = bank % gb->mbc.rom_bank_count;
+		}
+		gb->mbc.bank0_ptr = gb->rom + (bank * ROM_BANK_SIZE);
+
+		bank = (gb->mbc.bank2 << 5) + gb->mbc.bank1;
+		if (bank >= gb->mbc.rom_bank_count) {
+			bank = bank % gb->mbc.rom_bank_count;
+		}
+		gb->mbc.bankX_ptr = gb->rom + (bank * ROM_BANK_SIZE);
+	}
+
+	gb->mbc.sram_ptr = NULL;
+	if (gb->mbc.ram_enable && gb->mbc.bank_ram != NULL) {
+		bank = (gb->mbc.bank_mode == 0) ? 0 : gb->mbc.bank2;
+		if (bank >= gb->mbc.ram_bank_count) {
+			bank = bank % gb->mbc.ram_bank_count;
+		}
+		gb->mbc.sram_ptr = gb->mbc.bank_ram + (bank * RAM_BANK_SIZE);
+	}
+
+	gb_memory_map_cartridge(gb);
 }
 
 /**
@@ -66,14 +100,17 @@ void gbc_mbc_init(void)
  * @param code data stored at memory location 0x147
  * @returns Nothing
  */
-void gb_mbc_set_cartridge_info(uint8_t code, uint8_t rom_size, uint8_t ram_size)
+void gb_mbc_set_cartridge_info(gb_t *gb, uint8_t code, uint8_t rom_size, uint8_t ram_size)
 {
-	gb_mbc_controller_code = code;
-	gb_mbc_rom_bank_count = gb_mbc_rom_bank_lut[rom_size];
-	gb_mbc_ram_bank_count = gb_mbc_ram_bank_lut[ram_size];
-  if (gb_mbc_ram_bank_count > 0) {
-    gb_mbc_bank_ram = (uint8_t *)malloc(gb_mbc_ram_bank_count * RAM_BANK_SIZE);
+	gb->mbc.controller_code = code;
+	gb->mbc.rom_bank_count = gb_mbc_rom_bank_lut[rom_size];
+	gb->mbc.ram_bank_count = gb_mbc_ram_bank_lut[ram_size];
+  free(gb->mbc.bank_ram);
+  gb->mbc.bank_ram = NULL;
+  if (gb->mbc.ram_bank_count > 0) {
+    gb->mbc.bank_ram = (uint8_t *)malloc(gb->mbc.ram_bank_count * RAM_BANK_SIZE);
   }
+	gb_mbc_update_banks(gb);
 }
 
 /**
@@ -82,25 +119,13 @@ void gb_mbc_set_cartridge_info(uint8_t code, uint8_t rom_size, uint8_t ram_size)
  * @param address memory map address
  * @returns data stored at specified ROM address
  */
-uint8_t gb_mbc_read_rom_bank(uint16_t address)
+uint8_t gb_mbc_read_rom_bank(gb_t *gb, uint16_t address)
 {
-  if (gb_mbc_controller_code == 0) {
-		return (uint8_t)rom[address];
-	} else if (address < CARTROM_BANKX) {
-    uint32_t bank = (gb_mbc_bank_mode == 0) ? 0 : (gb_mbc_bank2 << 5);
-    if (bank >= gb_mbc_rom_bank_count) {
-      bank = bank % gb_mbc_rom_bank_count;
-    }
-    uint32_t addr = (uint32_t)(bank * ROM_BANK_SIZE) + address;
-    return rom[addr];
-	} else {
-    uint32_t bank = (gb_mbc_bank2 << 5) + gb_mbc_bank1;
-    if (bank >= gb_mbc_rom_bank_count) {
-      bank = bank % gb_mbc_rom_bank_count;
-    }
-    uint32_t addr = (uint32_t)(bank * ROM_BANK_SIZE) + (address & (ROM_BANK_SIZE - 1));
-    return rom[addr];
+	if (address < CARTROM_BANKX) {
+		return gb->mbc.bank0_ptr[address];
 	}
+
+	return gb->mbc.bankX_ptr[address & (ROM_BANK_SIZE - 1)];
 }
 
 /**
@@ -116,25 +141,26 @@ uint8_t gb_mbc_read_rom_bank(uint16_t address)
  * @param data byte to be written to MBC register
  * @returns Nothing
  */
-void gb_mbc_write_register(uint16_t address, uint8_t data)
+void gb_mbc_write_register(gb_t *gb, uint16_t address, uint8_t data)
 {
-	if (gb_mbc_controller_code > 0) {
+	if (gb->mbc.controller_code > 0) {
 		if (address < 0x2000) {
 			if ((data & 0x0F) == 0x0A) {
-				gb_mbc_ram_enable = 1;
+				gb->mbc.ram_enable = 1;
 			} else {
-				gb_mbc_ram_enable = 0;
+				gb->mbc.ram_enable = 0;
 			}
 		} else if (address < 0x4000) {
-			gb_mbc_bank1 = (data & 0x1F);
-			if (gb_mbc_bank1 == 0) {
-				gb_mbc_bank1 = 1;
+			gb->mbc.bank1 = (data & 0x1F);
+			if (gb->mbc.bank1 == 0) {
+				gb->mbc.bank1 = 1;
 			}
 		} else if (address < 0x6000) {
-      gb_mbc_bank2 = (data & 0x03);
+      gb->mbc.bank2 = (data & 0x03);
 		} else if (address < 0x8000) {
-			gb_mbc_bank_mode = (data & 0x01);
+			gb->mbc.bank_mode = (data & 0x01);
 		}
+		gb_mbc_update_banks(gb);
 	}
 }
 
@@ -144,17 +170,13 @@ void gb_mbc_write_register(uint16_t address, uint8_t data)
  * @param address memory map address
  * @returns data stored at specified RAM address
  */
-uint8_t gb_mbc_read_ram_bank(uint16_t address)
+uint8_t gb_mbc_read_ram_bank(gb_t *gb, uint16_t address)
 {
-  if(gb_mbc_ram_enable && gb_mbc_bank_ram != NULL){
-    uint32_t bank = (gb_mbc_bank_mode == 0) ? 0 : gb_mbc_bank2;
-    if (bank >= gb_mbc_ram_bank_count) {
-      bank = bank % gb_mbc_ram_bank_count;
-    }
-    return gb_mbc_bank_ram[bank * RAM_BANK_SIZE + (address & (RAM_BANK_SIZE - 1))];
-  }else{
-    return 0xFF;
-  }
+	if (gb->mbc.sram_ptr == NULL) {
+		return 0xFF;
+	}
+
+	return gb->mbc.sram_ptr[address & (RAM_BANK_SIZE - 1)];
 }
 
 /**
@@ -164,15 +186,9 @@ uint8_t gb_mbc_read_ram_bank(uint16_t address)
  * @param data byte to be written to RAM location
  * @returns Nothing
  */
-void gb_mbc_write_ram_bank(uint16_t address, uint8_t data)
+void gb_mbc_write_ram_bank(gb_t *gb, uint16_t address, uint8_t data)
 {
-  if(gb_mbc_ram_enable && gb_mbc_bank_ram != NULL){
-    uint32_t bank = (gb_mbc_bank_mode == 0) ? 0 : gb_mbc_bank2;
-    if (bank >= gb_mbc_ram_bank_count) {
-      bank = bank % gb_mbc_ram_bank_count;
-    }
-    gb_mbc_bank_ram[bank * RAM_BANK_SIZE + (address & (RAM_BANK_SIZE - 1))] = data;
-  }else{
-    return;
-  }
+	if (gb->mbc.sram_ptr != NULL) {
+		gb->mbc.sram_ptr[address & (RAM_BANK_SIZE - 1)] = data;
+	}
 }
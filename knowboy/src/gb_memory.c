@@ -10,44 +10,62 @@
 
 #include "gb_apu.h"
 #include "gb_common.h"
+#include "gb_cpu_cache.h"
 #include "gb_mbc.h"
 #include "gb_memory.h"
+#include "gb_ppu.h"
+#include "gb_priv.h"
+#include "gb_sched.h"
 #include "logging.h"
 
 #include <stdint.h>
 #include <string.h>
 
-memory_t mem;
-const uint8_t *rom;
-static uint8_t joypad_sel_dir = 0;
-static uint8_t joypad_sel_but = 0;
-static uint8_t timer_stop_start = 0;
-static uint8_t clock_mode = 0;
-static uint8_t data_trans_flag = 0;
+// DIV is incremented on the M-cycles starting at TIMER_DIV_PHASE + n * TIMER_DIV_PERIOD
+#define TIMER_DIV_PERIOD 256
+#define TIMER_DIV_PHASE	 252
 
-static gb_memory_controls_t gb_memory_controls;
+// DIV increments a serial transfer takes
+#define SERIAL_DIV_TICKS 16
+
+// log2 of the amount added to the TIMA prescaler every M-cycle, indexed by the TAC clock select
+static const uint8_t tima_prescaler_shift[4] = {0, 6, 4, 2};
 
 /*Function Prototypes*/
-static uint8_t gb_memory_joypad(void);
+static uint8_t gb_memory_joypad(gb_t *gb);
+static void gb_memory_update_pages(gb_t *gb);
+static void gb_memory_write_io(gb_t *gb, uint16_t address, uint8_t data);
+static uint8_t gb_memory_read_io(gb_t *gb, uint16_t address);
+static uint64_t gb_memory_div_ticks(uint64_t cycle);
+static uint8_t gb_memory_div(gb_t *gb);
+static uint64_t gb_memory_next_div_cycle(gb_t *gb);
+static void gb_memory_serial_start(gb_t *gb);
+static void gb_memory_serial_event(gb_t *gb, uint64_t cycle);
+static void gb_memory_sync_tima(gb_t *gb, uint64_t cycle);
+static void gb_memory_tima_event(gb_t *gb, uint64_t cycle);
+static void gb_memory_tima_schedule(gb_t *gb);
+static void gb_memory_update_interrupts(gb_t *gb);
 
 /**
  * @brief Sets function used in gb_memory_joypad() without needing to include control.h
  * @param gb_memory_controls_function function pointer holding address of ucControlsJoypad()
  * function in controls.c
+ * @param controls_ctx context handed back to the controls function on every call
  * @return None
  */
-void gb_memory_set_control_function(gb_memory_controls_t controls)
+void gb_memory_set_control_function(gb_t *gb, gb_memory_controls_t controls, void *controls_ctx)
 {
-	gb_memory_controls = controls;
+	gb->io.controls = controls;
+	gb->io.controls_ctx = controls_ctx;
 }
 
 /**
  * @brief Returns pointer to Start of Gameboy ROM
  * @return Gameboy ROM
  */
-const uint8_t *gb_memory_get_rom_pointer(void)
+const uint8_t *gb_memory_get_rom_pointer(gb_t *gb)
 {
-	return rom;
+	return gb->rom;
 }
 
 /**
@@ -56,51 +74,59 @@ const uint8_t *gb_memory_get_rom_pointer(void)
  * being pressed. The IF register should read 0xE1 to set the appropriate flags.
  * @return Nothing
  */
-void gb_memory_init(const uint8_t *boot_rom, const uint8_t *game_rom, bool boot_skip)
+void gb_memory_init(gb_t *gb, const uint8_t *boot_rom, const uint8_t *game_rom, bool boot_skip)
 {
-	gbc_mbc_init();
-	rom = game_rom;
-	memset(&mem.map[0], 0x00, 0xFFFF);
-	gb_memory_load(game_rom, 32768);
-	gb_mbc_set_cartridge_info(mem.map[0x147], mem.map[0x148], mem.map[0x149]);
-	gb_memory_write(TAC_ADDR, 0xF8);
-	mem.map[JOY_ADDR] = 0xCF;
-	mem.map[IF_ADDR] = 0xE1;
+	gbc_mbc_init(gb);
+	gb->rom = game_rom;
+	memset(&gb->mem.map[0], 0x00, 0xFFFF);
+	gb_memory_load(gb, game_rom, 32768);
+	gb_ppu_invalidate_tiles(gb);
+	gb_mbc_set_cartridge_info(gb, gb->mem.map[0x147], gb->mem.map[0x148], gb->mem.map[0x149]);
+	gb_memory_update_pages(gb);
+	gb_cpu_cache_init(gb);
+	gb->io.timer_div_cycle = gb->sched.now;
+	gb->io.timer_tima_cycle = gb->sched.now;
+	gb_memory_write(gb, TAC_ADDR, 0xF8);
+	gb->mem.map[JOY_ADDR] = 0xCF;
+	gb->mem.map[IF_ADDR] = 0xE1;
+	gb_memory_update_interrupts(gb);
 
 	if (boot_skip) {
-		mem.map[LCDC_ADDR] = 0x91;
-		mem.map[STAT_ADDR] = 0x01;
-		mem.map[DIV_ADDR] = 0xAB;
-		mem.map[NR11_ADDR] = 0x80;
-		mem.map[NR12_ADDR] = 0xF3;
-		mem.map[NR13_ADDR] = 0xC1;
-		mem.map[NR14_ADDR] = 0x87;
-		mem.map[NR50_ADDR] = 0x77;
-		mem.map[NR51_ADDR] = 0xF3;
-		mem.map[NR52_ADDR] = 0xF1;
-		mem.map[LY_ADDR] = 0x99;
-		gb_memory_write(mem.map[BGP_ADDR], 0xFC);
-		mem.map[BOOT_EN_ADDR] = 0x01;
-		mem.map[0xFFFA] = 0x39;
-		mem.map[0xFFFB] = 0x01;
-		mem.map[0xFFFC] = 0x2E;
-		mem.reg.PC = 0x0100;
-		mem.reg.AF = 0x01B0;
-		mem.reg.BC = 0x0013;
-		mem.reg.DE = 0x0008;
-		mem.reg.HL = 0x014D;
-		mem.reg.SP = 0xFFFE;
+		gb->mem.map[LCDC_ADDR] = 0x91;
+		gb->mem.map[STAT_ADDR] = 0x01;
+		gb->mem.map[DIV_ADDR] = 0xAB;
+		gb->mem.map[NR11_ADDR] = 0x80;
+		gb->mem.map[NR12_ADDR] = 0xF3;
+		gb->mem.map[NR13_ADDR] = 0xC1;
+		gb->mem.map[NR14_ADDR] = 0x87;
+		gb->mem.map[NR50_ADDR] = 0x77;
+		gb->mem.map[NR51_ADDR] = 0xF3;
+		gb->mem.map[NR52_ADDR] = 0xF1;
+		gb->mem.map[LY_ADDR] = 0x99;
+		gb_memory_write(gb, gb->mem.map[BGP_ADDR], 0xFC);
+		gb->mem.map[BOOT_EN_ADDR] = 0x01;
+		gb_memory_map_cartridge(gb);
+		gb->mem.map[0xFFFA] = 0x39;
+		gb->mem.map[0xFFFB] = 0x01;
+		gb->mem.map[0xFFFC] = 0x2E;
+		gb->mem.reg.PC = 0x0100;
+		gb->mem.reg.AF = 0x01B0;
+		gb->mem.reg.BC = 0x0013;
+		gb->mem.reg.DE = 0x0008;
+		gb->mem.reg.HL = 0x014D;
+		gb->mem.reg.SP = 0xFFFE;
 	} else {
-		gb_memory_load(boot_rom, 256);
-		mem.reg.PC = 0;
-		mem.reg.AF = 0;
-		mem.reg.BC = 0;
-		mem.reg.DE = 0;
-		mem.reg.HL = 0;
-		mem.reg.SP = 0;
-		clock_mode = 0;
-		timer_stop_start = 0;
-		data_trans_flag = 0;
+		gb_memory_load(gb, boot_rom, 256);
+		gb->mem.reg.PC = 0;
+		gb->mem.reg.AF = 0;
+		gb->mem.reg.BC = 0;
+		gb->mem.reg.DE = 0;
+		gb->mem.reg.HL = 0;
+		gb->mem.reg.SP = 0;
+		gb->io.clock_mode = 0;
+		gb->io.timer_stop_start = 0;
+		gb->io.data_trans_flag = 0;
+		gb_sched_cancel(gb, GB_EVENT_SERIAL);
 	}
 }
 
@@ -110,9 +136,9 @@ void gb_memory_init(const uint8_t *boot_rom, const uint8_t *game_rom, bool boot_
  * @param size amount of bytes.
  * @return Nothing
  */
-void gb_memory_load(const void *data, uint32_t bytes)
+void gb_memory_load(gb_t *gb, const void *data, uint32_t bytes)
 {
-	memcpy(mem.map, data, bytes);
+	memcpy(gb->mem.map, data, bytes);
 }
 
 /**
@@ -120,85 +146,184 @@ void gb_memory_load(const void *data, uint32_t bytes)
  * @param data data trying to be written to Joypad Register.
  * @return Joypad Keys pressed
  */
-static uint8_t gb_memory_joypad(void)
+static uint8_t gb_memory_joypad(gb_t *gb)
 {
-	return gb_memory_controls(&joypad_sel_dir, &joypad_sel_but);
+	return gb->io.controls(gb->io.controls_ctx, &gb->io.joypad_sel_dir, &gb->io.joypad_sel_but);
 }
 
 /**
- * @brief Write data to location in memory map specified by address variable
- * @param address memory map address
- * @param data byte of data
+ * @brief Rebuilds the memory page table
+ * @details Pages of plain memory point straight at the host memory backing them, pages holding
+ * memory mapped registers point at the handler of their region.
  * @returns Nothing
  */
-void gb_memory_write(uint16_t address, uint8_t data)
+static void gb_memory_update_pages(gb_t *gb)
 {
+	for (uint32_t page = 0; page < GB_MEMORY_PAGE_COUNT; page++) {
+		uint16_t address = page << GB_MEMORY_PAGE_SHIFT;
+
+		gb->pages.read[page] = NULL;
+		gb->pages.write[page] = NULL;
+		gb->pages.read_handler[page] = NULL;
+		gb->pages.write_handler[page] = NULL;
+
+		if (address < VRAM_BASE) {
+			// cartridge ROM, see gb_memory_map_cartridge()
+		} else if (address < CARTRAM_BASE) {
+			gb->pages.read[page] = &gb->mem.map[address];
+			gb->pages.write_handler[page] = gb_ppu_memory_write;
+		} else if (address < GBRAM_BANK0) {
+			// cartridge RAM, see gb_memory_map_cartridge()
+		} else if (address < ECHORAM_BASE) {
+			gb->pages.read[page] = &gb->mem.map[address];
+			gb->pages.write[page] = &gb->mem.map[address];
+		} else if (address < OAM_BASE) {
+			gb->pages.read[page] = &gb->mem.map[address - 0x2000];
+			gb->pages.write[page] = &gb->mem.map[address - 0x2000];
+		} else if (address < IO_BASE) {
+			gb->pages.read[page] = &gb->mem.map[address];
+			gb->pages.write_handler[page] = gb_ppu_memory_write;
+		} else {
+			gb->pages.read_handler[page] = gb_memory_read_io;
+			gb->pages.write_handler[page] = gb_memory_write_io;
+		}
+	}
 
-	if (address >= IO_BASE) {
+	gb_memory_map_cartridge(gb);
+}
 
-		if (address == JOY_ADDR) {
-			joypad_sel_dir = data & 0x10;
-			joypad_sel_but = data & 0x20;
-			return;
-		}
+/**
+ * @brief Updates the cartridge ROM and RAM pages of the memory page table
+ * @details ROM pages point at the boot ROM overlay in the memory map while it is mapped and at
+ * the ROM banks selected by the MBC otherwise. RAM pages point at the selected RAM bank while
+ * cartridge RAM is enabled. Called by the MBC on every bank register write and when the boot ROM
+ * is unmapped.
+ * @returns Nothing
+ */
+void gb_memory_map_cartridge(gb_t *gb)
+{
+	bool boot_rom_mapped = gb->mem.map[BOOT_EN_ADDR] == 0;
 
-		else if (address == DIV_ADDR) {
-			mem.map[DIV_ADDR] = 0;
-			return;
-		}
+	for (uint32_t page = 0; page < (VRAM_BASE >> GB_MEMORY_PAGE_SHIFT); page++) {
+		uint16_t address = page << GB_MEMORY_PAGE_SHIFT;
 
-		else if (address == TAC_ADDR) {
-			timer_stop_start = CHK_BIT(data, 2);
-			clock_mode = (CHK_BIT(data, 1) * 2) + CHK_BIT(data, 0);
-			mem.map[address] = data;
-			return;
+		if (boot_rom_mapped) {
+			gb->pages.read[page] = &gb->mem.map[address];
+		} else if (address < CARTROM_BANKX) {
+			gb->pages.read[page] = &gb->mbc.bank0_ptr[address];
+		} else {
+			gb->pages.read[page] = &gb->mbc.bankX_ptr[address - CARTROM_BANKX];
 		}
+		gb->pages.write[page] = NULL;
+		gb->pages.read_handler[page] = NULL;
+		gb->pages.write_handler[page] = gb_mbc_write_register;
+	}
 
-		else if (address == STC_ADDR) {
-			if (CHK_BIT(data, 7)) {
-				data_trans_flag = 1;
-				LOG_DBG("SER: %c", mem.map[SB_ADDR]);
-			}
-			mem.map[address] = data;
-			return;
-		}
+	for (uint32_t page = CARTRAM_BASE >> GB_MEMORY_PAGE_SHIFT;
+	     page < (GBRAM_BANK0 >> GB_MEMORY_PAGE_SHIFT); page++) {
+		uint16_t offset = (page << GB_MEMORY_PAGE_SHIFT) - CARTRAM_BASE;
 
-		else if (address >= NR10_ADDR && address < LCDC_ADDR) {
-			gb_apu_memory_write(address, data);
-			return;
+		if (gb->mbc.sram_ptr != NULL) {
+			gb->pages.read[page] = &gb->mbc.sram_ptr[offset];
+			gb->pages.write[page] = &gb->mbc.sram_ptr[offset];
+		} else {
+			gb->pages.read[page] = NULL;
+			gb->pages.write[page] = NULL;
 		}
+		gb->pages.read_handler[page] = gb_mbc_read_ram_bank;
+		gb->pages.write_handler[page] = gb_mbc_write_ram_bank;
+	}
 
-		else if (address >= LCDC_ADDR && address < BOOT_EN_ADDR) {
-			gb_ppu_memory_write(address, data);
-			return;
-		}
+	/* The page the CPU fetches instructions from may have been remapped, see gb_cpu_fetch() */
+	gb->cpu.fetch_size = 0;
+}
 
-		else if (address == BOOT_EN_ADDR) {
-			if (data == 1) {
-				gb_memory_load(gb_memory_get_rom_pointer(), 256);
-			}
-		}
+/**
+ * @brief Write data to location in memory map specified by address variable
+ * @param address memory map address
+ * @param data byte of data
+ * @returns Nothing
+ */
+void gb_memory_write(gb_t *gb, uint16_t address, uint8_t data)
+{
+	uint8_t *page = gb->pages.write[address >> GB_MEMORY_PAGE_SHIFT];
+
+	if (page != NULL) {
+		page[address & 0xFF] = data;
+		return;
+	}
+
+	gb->pages.write_handler[address >> GB_MEMORY_PAGE_SHIFT](gb, address, data);
+}
+
+/**
+ * @brief Write data to a register or HRAM in the last page of the memory map
+ * @param address memory map address
+ * @param data byte of data
+ * @returns Nothing
+ */
+static void gb_memory_write_io(gb_t *gb, uint16_t address, uint8_t data)
+{
+	if (address == JOY_ADDR) {
+		gb->io.joypad_sel_dir = data & 0x10;
+		gb->io.joypad_sel_but = data & 0x20;
+		return;
+	}
+
+	else if (address == DIV_ADDR) {
+		gb->mem.map[DIV_ADDR] = 0;
+		gb->io.timer_div_cycle = gb->sched.now;
+		return;
+	}
+
+	else if (address == TIMA_ADDR) {
+		gb_memory_sync_tima(gb, gb->sched.now);
+		gb->mem.map[address] = data;
+		gb_memory_tima_schedule(gb);
+		return;
+	}
+
+	else if (address == TAC_ADDR) {
+		gb_memory_sync_tima(gb, gb->sched.now);
+		gb->io.timer_stop_start = CHK_BIT(data, 2);
+		gb->io.clock_mode = (CHK_BIT(data, 1) * 2) + CHK_BIT(data, 0);
+		gb->mem.map[address] = data;
+		gb_memory_tima_schedule(gb);
+		return;
+	}
 
-		mem.map[address] = data;
+	else if (address == STC_ADDR) {
+		if (CHK_BIT(data, 7)) {
+			gb_memory_serial_start(gb);
+			LOG_DBG("SER: %c", gb->mem.map[SB_ADDR]);
+		}
+		gb->mem.map[address] = data;
 		return;
 	}
 
-	if ((address >= CARTROM_BANK0 && address < VRAM_BASE)) {
-		gb_mbc_write_register(address, data);
+	else if (address >= NR10_ADDR && address < LCDC_ADDR) {
+		gb_apu_memory_write(gb, address, data);
 		return;
 	}
 
-  if ((address >= CARTRAM_BASE && address < GBRAM_BANK0)) {
-    gb_mbc_write_ram_bank(address, data);
-    return;
-  }
+	else if (address >= LCDC_ADDR && address < BOOT_EN_ADDR) {
+		gb_ppu_memory_write(gb, address, data);
+		return;
+	}
 
-	if (address >= ECHORAM_BASE && address < OAM_BASE) {
-		mem.map[address - 0x2000] = data;
+	else if (address == BOOT_EN_ADDR) {
+		if (data == 1) {
+			gb_memory_load(gb, gb_memory_get_rom_pointer(gb), 256);
+		}
+		gb->mem.map[address] = data;
+		gb_memory_map_cartridge(gb);
 		return;
 	}
 
-	mem.map[address] = data;
+	gb->mem.map[address] = data;
+	if (address == IF_ADDR || address == IE_ADDR) {
+		gb_memory_update_interrupts(gb);
+	}
 }
 
 /**
@@ -207,10 +332,10 @@ void gb_memory_write(uint16_t address, uint8_t data)
  * @param data 2 bytes of data
  * @returns Nothing
  */
-void gb_memory_write_short(uint16_t address, uint16_t data)
+void gb_memory_write_short(gb_t *gb, uint16_t address, uint16_t data)
 {
-	gb_memory_write(address, data & 0xFF);
-	gb_memory_write(address + 1, data >> 8);
+	gb_memory_write(gb, address, data & 0xFF);
+	gb_memory_write(gb, address + 1, data >> 8);
 }
 
 /**
@@ -219,15 +344,18 @@ void gb_memory_write_short(uint16_t address, uint16_t data)
  * @param bit which bit to set (0 - 7)
  * @returns Nothing
  */
-void gb_memory_set_bit(uint16_t address, uint8_t bit)
+void gb_memory_set_bit(gb_t *gb, uint16_t address, uint8_t bit)
 {
 	if (address >= ECHORAM_BASE && address < OAM_BASE)
-		mem.map[address - 0x2000] |= (0x1 << bit);
+		gb->mem.map[address - 0x2000] |= (0x1 << bit);
 
 	if ((address >= CARTROM_BANK0 && address < VRAM_BASE))
 		return;
 
-	mem.map[address] |= (0x1 << bit);
+	gb->mem.map[address] |= (0x1 << bit);
+	if (address == IF_ADDR || address == IE_ADDR) {
+		gb_memory_update_interrupts(gb);
+	}
 }
 
 /**
@@ -236,16 +364,30 @@ void gb_memory_set_bit(uint16_t address, uint8_t bit)
  * @param bit which bit to reset (0 - 7)
  * @returns Nothing
  */
-void gb_memory_reset_bit(uint16_t address, uint8_t bit)
+void gb_memory_reset_bit(gb_t *gb, uint16_t address, uint8_t bit)
 {
 
 	if (address >= ECHORAM_BASE && address < OAM_BASE)
-		mem.map[address - 0x2000] &= ~(0x1 << bit);
+		gb->mem.map[address - 0x2000] &= ~(0x1 << bit);
 
 	if ((address >= CARTROM_BANK0 && address < VRAM_BASE))
 		return;
 
-	mem.map[address] &= ~(0x1 << bit);
+	gb->mem.map[address] &= ~(0x1 << bit);
+	if (address == IF_ADDR || address == IE_ADDR) {
+		gb_memory_update_interrupts(gb);
+	}
+}
+
+/**
+ * @brief Brings the pending interrupts of the CPU up to date
+ * @details Called on every change of IE or IF so the CPU only has to check a single value for
+ * interrupts to dispatch.
+ * @returns Nothing
+ */
+static void gb_memory_update_interrupts(gb_t *gb)
+{
+	gb->cpu.pending_interrupts = gb->mem.map[IE_ADDR] & gb->mem.map[IF_ADDR] & 0x1F;
 }
 
 /**
@@ -253,43 +395,50 @@ void gb_memory_reset_bit(uint16_t address, uint8_t bit)
  * @param address memory map address
  * @return data byte of data located in memory map
  */
-uint8_t gb_memory_read(uint16_t address)
+uint8_t gb_memory_read(gb_t *gb, uint16_t address)
 {
+	const uint8_t *page = gb->pages.read[address >> GB_MEMORY_PAGE_SHIFT];
 
-	if ((address >= CARTROM_BANK0 && address < VRAM_BASE) && mem.map[BOOT_EN_ADDR] != 0) {
-		return gb_mbc_read_rom_bank(address);
+	if (page != NULL) {
+		return page[address & 0xFF];
 	}
 
-	else if (address >= IO_BASE) {
-		if (address == JOY_ADDR) {
-			return gb_memory_joypad();
-		}
+	return gb->pages.read_handler[address >> GB_MEMORY_PAGE_SHIFT](gb, address);
+}
 
-		else if (address == SB_ADDR) {
-			return 0xFF;
-		}
+/**
+ * @brief Read from a register or HRAM in the last page of the memory map
+ * @param address memory map address
+ * @return data byte of data located in memory map
+ */
+static uint8_t gb_memory_read_io(gb_t *gb, uint16_t address)
+{
+	if (address == JOY_ADDR) {
+		return gb_memory_joypad(gb);
+	}
 
-		else if (address >= NR10_ADDR && address < LCDC_ADDR) {
-			return gb_apu_memory_read(address);
-		}
+	else if (address == SB_ADDR) {
+		return 0xFF;
+	}
 
-		else if (address >= LCDC_ADDR && address < BOOT_EN_ADDR) {
-			return gb_ppu_memory_read(address);
-		}
+	else if (address == DIV_ADDR) {
+		return gb_memory_div(gb);
+	}
 
-		else {
-			return mem.map[address];
-		}
+	else if (address == TIMA_ADDR) {
+		gb_memory_sync_tima(gb, gb->sched.now);
+		return gb->mem.map[TIMA_ADDR];
 	}
 
-  else if ((address >= CARTRAM_BASE && address < GBRAM_BANK0)) {
-    return gb_mbc_read_ram_bank(address);
-  }
+	else if (address >= NR10_ADDR && address < LCDC_ADDR) {
+		return gb_apu_memory_read(gb, address);
+	}
 
-	else if (address >= ECHORAM_BASE && address < OAM_BASE)
-		return mem.map[address - 0x2000];
+	else if (address >= LCDC_ADDR && address < BOOT_EN_ADDR) {
+		return gb_ppu_memory_read(gb, address);
+	}
 
-	return mem.map[address];
+	return gb->mem.map[address];
 }
 
 /**
@@ -297,75 +446,137 @@ uint8_t gb_memory_read(uint16_t address)
  * @param address memory map address
  * @return Short information of data in memory map
  */
-uint16_t gb_memory_read_short(uint16_t address)
+uint16_t gb_memory_read_short(gb_t *gb, uint16_t address)
+{
+	return CAT_BYTES(gb_memory_read(gb, address), gb_memory_read(gb, address + 1));
+}
+
+/**
+ * @brief Returns the number of DIV increments before a clock cycle
+ * @details DIV is incremented every 256 clock cycles, on the M-cycles starting at
+ * TIMER_DIV_PHASE + n * TIMER_DIV_PERIOD.
+ * @param cycle clock cycle
+ * @returns number of increments due on the clock cycles before cycle
+ */
+static uint64_t gb_memory_div_ticks(uint64_t cycle)
+{
+	return (cycle + TIMER_DIV_PERIOD - TIMER_DIV_PHASE - 1) / TIMER_DIV_PERIOD;
+}
+
+/**
+ * @brief Returns the DIV Register as of the current M-cycle
+ * @details DIV is not stepped, it is worked out from the master clock and the clock cycle it was
+ * last written on. Writing DIV only clears the register, it does not restart the divider.
+ * @returns DIV Register
+ */
+static uint8_t gb_memory_div(gb_t *gb)
 {
-	return CAT_BYTES(mem.map[address], mem.map[address + 1]);
+	return gb->mem.map[DIV_ADDR] + gb_memory_div_ticks(gb->sched.now) -
+	       gb_memory_div_ticks(gb->io.timer_div_cycle);
 }
 
 /**
- * @brief Ticks all timers currently in use
- * @details Ticks the DIV and possibly the TIMA timers at their correct Hertz
- * @param duration Amount of T states that have passed executing the current instruction.
+ * @brief Returns the clock cycle of the first DIV increment at or after the current M-cycle
+ * @returns clock cycle
+ */
+static uint64_t gb_memory_next_div_cycle(gb_t *gb)
+{
+	return gb->sched.now + ((TIMER_DIV_PHASE - gb->sched.now) & (TIMER_DIV_PERIOD - 1));
+}
+
+/**
+ * @brief Starts a serial transfer unless one is already in progress
  * @returns Nothing
  */
-void gb_memory_inc_timers(uint8_t duration)
+static void gb_memory_serial_start(gb_t *gb)
 {
-	static uint8_t timer_div = 0;
-	static uint8_t timer_tima = 0;
-	static uint8_t old_tima = 0;
-	static uint8_t timer_div_8k = 0;
-
-	if ((timer_div + (duration << 2)) > 0xFF) {
-		mem.map[DIV_ADDR]++;
-
-		if (data_trans_flag) {
-			timer_div_8k++;
-			if (timer_div_8k == 0x10) {
-				timer_div_8k = 0;
-				gb_memory_reset_bit(STC_ADDR, 7);
-				data_trans_flag = 0;
-				// gb_memory_set_bit(IF_ADDR, 3);
-			}
-		}
+	uint64_t cycle;
+
+	if (gb->io.data_trans_flag) {
+		return;
 	}
 
-	timer_div += (duration << 2);
-
-	if (timer_stop_start) {
-		uint16_t curDuration = 0;
-
-		switch (clock_mode) {
-		case 0x0:
-			curDuration = (duration << 0);
-			break;
-		case 0x1:
-			curDuration = (duration << 6);
-			break;
-		case 0x2:
-			curDuration = (duration << 4);
-			break;
-		case 0x3:
-			curDuration = (duration << 2);
-			break;
-		default:
-			break;
-		}
+	cycle = gb_memory_next_div_cycle(gb) + ((SERIAL_DIV_TICKS - 1) * TIMER_DIV_PERIOD);
+	gb_sched_schedule(gb, GB_EVENT_SERIAL, cycle, gb_memory_serial_event);
+	gb->io.data_trans_flag = 1;
+}
 
-		if (timer_tima + curDuration > 0xFF) {
-			mem.map[TIMA_ADDR]++;
-		}
+/**
+ * @brief Completes a serial transfer
+ * @details A transfer completes on the SERIAL_DIV_TICKS'th DIV increment after it was started
+ * @param cycle clock cycle the transfer completes on
+ * @returns Nothing
+ */
+static void gb_memory_serial_event(gb_t *gb, uint64_t cycle)
+{
+	(void)cycle;
+	gb_memory_reset_bit(gb, STC_ADDR, 7);
+	gb->io.data_trans_flag = 0;
+	// gb_memory_set_bit(IF_ADDR, 3);
+}
 
-		if (timer_tima + curDuration > 0x1FE) {
-			mem.map[TIMA_ADDR]++;
-		}
+/**
+ * @brief Brings the TIMA prescaler and the TIMA Register up to a clock cycle
+ * @details The prescaler adds a fixed amount every M-cycle the timer is running and TIMA is
+ * incremented whenever it overflows. Only the M-cycles before cycle are added, TIMA does not
+ * wrap around in them as the overflow event runs on the M-cycle it does. An interrupt dispatch
+ * may still write TIMA or TAC on the M-cycle the overflow event ran on, which is added already.
+ * @param cycle clock cycle of the first M-cycle that should not be added yet
+ * @returns Nothing
+ */
+static void gb_memory_sync_tima(gb_t *gb, uint64_t cycle)
+{
+	uint32_t prescaler;
 
-		timer_tima += curDuration;
+	if (cycle < gb->io.timer_tima_cycle) {
+		return;
+	}
 
-		if (mem.map[TIMA_ADDR] < 5 && old_tima == 0xFF) {
-			mem.map[TIMA_ADDR] = mem.map[TMA_ADDR];
-			gb_memory_set_bit(IF_ADDR, 2);
-		}
+	if (gb->io.timer_stop_start) {
+		prescaler = gb->io.timer_tima +
+			    ((uint32_t)((cycle - gb->io.timer_tima_cycle) / GB_CYCLES_PER_M_CYCLE)
+			     << tima_prescaler_shift[gb->io.clock_mode]);
+		gb->mem.map[TIMA_ADDR] += prescaler >> 8;
+		gb->io.timer_tima = prescaler & 0xFF;
+	}
+	gb->io.timer_tima_cycle = cycle;
+}
+
+/**
+ * @brief Reloads TIMA from TMA and requests the timer interrupt
+ * @details Runs on the M-cycle the TIMA Register wraps around on, then schedules the next
+ * overflow.
+ * @param cycle clock cycle of the current M-cycle
+ * @returns Nothing
+ */
+static void gb_memory_tima_event(gb_t *gb, uint64_t cycle)
+{
+	gb_memory_sync_tima(gb, cycle + GB_CYCLES_PER_M_CYCLE);
+	gb->mem.map[TIMA_ADDR] = gb->mem.map[TMA_ADDR];
+	gb_memory_set_bit(gb, IF_ADDR, 2);
+	gb_memory_tima_schedule(gb);
+}
 
-		old_tima = mem.map[TIMA_ADDR];
+/**
+ * @brief Schedules the next TIMA overflow if the timer is running
+ * @details Has to be called right after gb_memory_sync_tima(), the overflow is due on the
+ * M-cycle that adds the last of the prescaler counts missing until TIMA wraps around.
+ * @returns Nothing
+ */
+static void gb_memory_tima_schedule(gb_t *gb)
+{
+	uint8_t shift = tima_prescaler_shift[gb->io.clock_mode];
+	uint32_t counts;
+	uint32_t m_cycles;
+
+	if (!gb->io.timer_stop_start) {
+		gb_sched_cancel(gb, GB_EVENT_TIMA);
+		return;
 	}
+
+	counts = ((0x100 - gb->mem.map[TIMA_ADDR]) << 8) - gb->io.timer_tima;
+	m_cycles = (counts + (1 << shift) - 1) >> shift;
+	gb_sched_schedule(gb, GB_EVENT_TIMA,
+			  gb->io.timer_tima_cycle + ((m_cycles - 1) * GB_CYCLES_PER_M_CYCLE),
+			  gb_memory_tima_event);
 }
@@ -13,6 +13,9 @@
 #include "gb_common.h"
 #include "gb_memory.h"
 #include "gb_ppu.h"
+#include "gb_ppu_line.h"
+#include "gb_priv.h"
+#include "gb_sched.h"
 #include "logging.h"
 
 #include <string.h>
@@ -21,8 +24,12 @@
 #define PPU_OBJECT_HEIGHT_SHORT 8
 #define PPU_OBJECT_HEIGHT_TALL	16
 
-#define PPU_MAX_OBJECTS		     40
-#define PPU_MAX_OBJECTS_PER_SCANLINE 10
+#define PPU_MAX_OBJECTS 40
+
+#define PPU_TILE_SIZE  8
+#define PPU_TILE_BYTES 16
+// tiles a scanline of the background or the window touches at most
+#define PPU_LINE_TILES ((GAMEBOY_SCREEN_WIDTH / PPU_TILE_SIZE) + 1)
 
 #define PPU_DOTS_PER_SCANLINE 456
 
@@ -37,144 +44,335 @@
 #define DARK_SHADE   0XFF306230
 #define BLACK_SHADE  0XFF0F380F
 
-typedef struct {
-	uint32_t buf[8];
-	uint8_t obj_index;
-	int16_t x_coord;
-	int16_t y_coord;
-	uint8_t start;
-	uint8_t len;
-	bool obj_prio;
-} oam_obj_t;
+// ARGB8888 color to RGB565
+#define PPU_RGB565(color)                                                                          \
+	((((color) >> 8) & 0xF800) | (((color) >> 5) & 0x07E0) | (((color) >> 3) & 0x001F))
 
-static oam_obj_t oam_line_slot[PPU_MAX_OBJECTS_PER_SCANLINE];
-static uint8_t oam_line_prio_buffer[GAMEBOY_SCREEN_WIDTH];
-static uint32_t oam_line_data_buffer[GAMEBOY_SCREEN_WIDTH];
-static uint8_t bg_wn_buffer[GAMEBOY_SCREEN_WIDTH];
+// pixels in a byte of a packed indexed frame
+#define PPU_PACKED_PIXELS 4
 
-// Gameboy Memory struct
-extern memory_t mem;
+// the index of the completed frame may be read by a frontend thread while the next one is drawn
+#if defined(__GNUC__)
+#define PPU_STORE_RELEASE(dst, value) __atomic_store_n(&(dst), (value), __ATOMIC_RELEASE)
+#define PPU_LOAD_ACQUIRE(src)	      __atomic_load_n(&(src), __ATOMIC_ACQUIRE)
+#else
+#define PPU_STORE_RELEASE(dst, value) ((dst) = (value))
+#define PPU_LOAD_ACQUIRE(src)	      (src)
+#endif
 
-// dot counter
-static uint32_t ppu_dot_counter;
+/*Function Prototypes*/
+static void gb_ppu_event(gb_t *gb, uint64_t cycle);
+static void gb_ppu_advance(gb_t *gb);
+static void gb_ppu_start_frame(gb_t *gb);
+static void gb_ppu_schedule_irq(gb_t *gb);
+static void gb_ppu_set_enable(gb_t *gb, bool enable);
+static void gb_ppu_oam_scan(gb_t *gb, uint8_t obj_end);
+static void gb_ppu_oam_scan_sync(gb_t *gb);
+static void gb_ppu_oam_process_next_object(gb_t *gb, uint8_t obj_index);
+static void gb_ppu_find_object_data(gb_t *gb);
+static inline void gb_ppu_check_lyc(gb_t *gb);
+static void gb_ppu_set_stat_mode(gb_t *gb, uint8_t mode);
+static void gb_ppu_decode_tiles(gb_t *gb);
+static const uint8_t *gb_ppu_get_tile_line(gb_t *gb, uint16_t map_addr, uint8_t line);
+static void gb_ppu_draw_line_background(gb_t *gb);
+static void gb_ppu_draw_line_window(gb_t *gb);
+static bool gb_ppu_window_shown(gb_t *gb);
+static void gb_ppu_draw_line_objects(gb_t *gb);
+static void gb_ppu_draw_line(gb_t *gb);
+static void gb_ppu_set_line_shades(gb_t *gb, uint8_t entry, uint8_t palette);
+static inline uint8_t gb_ppu_get_shade(const gb_t *gb, const uint8_t *frame, int pixel);
+
+/* Frame buffer colors of the shades */
+static const uint32_t gb_ppu_shade_colors[4] = {LIGHT_SHADE, MEDIUM_SHADE, DARK_SHADE,
+						BLACK_SHADE};
+static const uint16_t gb_ppu_shade_colors_rgb565[4] = {
+	PPU_RGB565(LIGHT_SHADE), PPU_RGB565(MEDIUM_SHADE), PPU_RGB565(DARK_SHADE),
+	PPU_RGB565(BLACK_SHADE)};
 
-// oam object count
-uint8_t oam_obj_count = 0;
+/**
+ * @brief Sets function used in gb_ppu_draw_line() without needing to include
+ * control.h
+ * @param display_buffer function pointer holding address of
+ * displayFrameBuffer() function in display.c
+ * @param display_ctx opaque pointer handed back to the display function, may be NULL if the
+ * frontend reads completed frames with gb_ppu_get_frame() instead
+ * @return None
+ */
+void gb_ppu_set_display_frame_buffer(gb_t *gb, gb_ppu_display_frame_buffer_t display_frame_buffer,
+				     void *display_ctx)
+{
+	gb->ppu.display_frame_buffer = display_frame_buffer;
+	gb->ppu.display_ctx = display_ctx;
+}
 
-// internal window line counter
-uint8_t wn_internal_line = 0;
+/**
+ * @brief Returns the last completed ARGB8888 frame
+ * @details The frame is owned by the core and can be handed to the display without copying it.
+ * There are only two frame buffers: the core draws the next frame into the other one, and once
+ * that frame is completed the returned one is drawn over from line 0. The frame therefore has to
+ * be consumed before the next gb_run_frame() returns. A frontend thread that may take longer has
+ * to copy it, a frame that is drawn over while it is read cannot be detected. Frames skipped by
+ * gb_ppu_set_render_skip() are never completed. Before the first frame is completed it is blank.
+ * Only frames drawn in GB_PPU_OUTPUT_ARGB8888 are returned, after a switch to an indexed format
+ * gb_ppu_get_indexed_frame() returns the frames instead. A switch made with gb_ppu_set_output()
+ * takes effect when the next frame starts, so a completed frame is always in a single format.
+ * @return GAMEBOY_SCREEN_WIDTH * GAMEBOY_SCREEN_HEIGHT colors, line by line, NULL if the last
+ * completed frame was drawn in an indexed format
+ */
+const uint32_t *gb_ppu_get_frame(const gb_t *gb)
+{
+	uint8_t front = PPU_LOAD_ACQUIRE(gb->ppu.front_buffer);
 
-// Palettes
-static uint32_t bgp_color_to_palette[4];
-static uint32_t obp0_color_to_palette[4];
-static uint32_t obp1_color_to_palette[4];
+	if (gb->ppu.front_output != GB_PPU_OUTPUT_ARGB8888) {
+		return NULL;
+	}
 
-// Frame Buffer variables
-static uint32_t frame_buffer[GAMEBOY_SCREEN_WIDTH * GAMEBOY_SCREEN_HEIGHT * sizeof(uint32_t)];
+	return gb->ppu.frame_buffers[front];
+}
 
-// Function Pointer pointing to external function in display.c
-static gb_ppu_display_frame_buffer_t gb_ppu_display_frame_buffer;
+/**
+ * @brief Selects the format frames are drawn in
+ * @details Indexed frames skip the frame buffer colors entirely, they are read with
+ * gb_ppu_get_indexed_frame() and only turned into colors by gb_ppu_expand_argb8888() or
+ * gb_ppu_expand_rgb565() if needed. The display function is still called once per frame, with a
+ * NULL frame buffer. The format is switched when the next frame starts on scanline 0, the frame
+ * in progress is completed in the format it was started in.
+ * @param output frame format
+ * @return Nothing
+ */
+void gb_ppu_set_output(gb_t *gb, gb_ppu_output_t output)
+{
+	gb->ppu.next_output = output;
+}
 
-// LCDC register
-static bool ppu_enable = false;
-static uint16_t wn_display_addr = TILE_MAP_LOCATION_LOW;
-static bool wn_enable = false;
-static uint16_t tile_data_addr = TILE_DATA_SIGNED_ADDR;
-static uint16_t bg_display_addr = TILE_MAP_LOCATION_LOW;
-static bool obj_size = false;
-static bool obj_enable = false;
-static bool bg_wn_enable = false;
+/**
+ * @brief Skips the pixel work of frames that will not be shown
+ * @details After each rendered frame the given number of frames is skipped. Skipped frames keep
+ * the timing of the modes, STAT, LY and the interrupts, but no objects are searched in OAM, no
+ * lines are drawn and the display function is not called for them. The frame buffer and the
+ * indexed frame keep the last rendered frame. Takes effect from the next frame on, which is
+ * rendered only if frames is 0.
+ * @param frames number of frames skipped after each rendered one, 0 to render all of them or
+ * GB_PPU_RENDER_SKIP_ALL to render none
+ * @return Nothing
+ */
+void gb_ppu_set_render_skip(gb_t *gb, uint32_t frames)
+{
+	gb->ppu.render_skip = frames;
+	gb->ppu.render_skip_count = frames;
+}
 
-// stat register
-static uint8_t stat_mode;
-static bool lyc_int_sel = false;
-static bool mode_2_sel = false;
-static bool mode_1_sel = false;
-static bool mode_0_sel = false;
+/**
+ * @brief Renders the next frame whatever the render skip
+ * @details Frames are counted from the next one on, the frame in progress is not affected. The
+ * render skip starts over after the rendered frame.
+ * @return Nothing
+ */
+void gb_ppu_render_next_frame(gb_t *gb)
+{
+	gb->ppu.render_next = true;
+}
 
-// scy register
-static uint8_t scy = 0;
+/**
+ * @brief Returns the last completed frame drawn in one of the indexed formats
+ * @details Lines are GAMEBOY_SCREEN_WIDTH bytes apart, or GAMEBOY_SCREEN_WIDTH / 4 bytes if
+ * packed. Indexed frames are double buffered like the ARGB8888 ones, so the frame has to be
+ * consumed before the next gb_run_frame() returns, see gb_ppu_get_frame().
+ * @return indexed frame, NULL if the last completed frame was drawn in GB_PPU_OUTPUT_ARGB8888 or
+ * no frame has been completed in an indexed format yet
+ */
+const uint8_t *gb_ppu_get_indexed_frame(const gb_t *gb)
+{
+	uint8_t front = PPU_LOAD_ACQUIRE(gb->ppu.front_buffer);
 
-// scx register
-static uint8_t scx = 0;
+	if (gb->ppu.front_output == GB_PPU_OUTPUT_ARGB8888) {
+		return NULL;
+	}
 
-// ly register
-static uint8_t ly = 0;
+	return gb->ppu.indexed_frames[front];
+}
 
-// wy register
-static uint8_t wy = 0;
+/**
+ * @brief Turns the indexed frame into ARGB8888 colors
+ * @details Does nothing if gb_ppu_get_indexed_frame() has no frame.
+ * @param pixels GAMEBOY_SCREEN_WIDTH * GAMEBOY_SCREEN_HEIGHT colors
+ * @return Nothing
+ */
+void gb_ppu_expand_argb8888(const gb_t *gb, uint32_t *pixels)
+{
+	const uint8_t *frame = gb_ppu_get_indexed_frame(gb);
 
-// wx register
-static uint8_t wx = 0;
+	if (frame == NULL) {
+		return;
+	}
 
-/*Function Prototypes*/
-static void gb_ppu_oam_process_next_object(uint8_t obj_index);
-static void gb_ppu_find_object_data(void);
-static void inline gb_ppu_check_lyc(void);
-static void gb_ppu_set_stat_mode(uint8_t mode);
-static void gb_ppu_update_frame_buffer(uint32_t data, int pixel_pos);
-static void gb_ppu_draw_line_background(void);
-static void gb_ppu_draw_line_window(void);
-static void gb_ppu_draw_line_objects(void);
-static void gb_ppu_draw_line(void);
-static uint16_t gb_ppu_get_tile_line_data(uint16_t tile_offset, uint8_t line_offset,
-					  uint16_t display_addr);
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH * GAMEBOY_SCREEN_HEIGHT; i++) {
+		pixels[i] = gb_ppu_shade_colors[gb_ppu_get_shade(gb, frame, i)];
+	}
+}
 
 /**
- * @brief Sets function used in gb_ppu_draw_line() without needing to include
- * control.h
- * @param display_buffer function pointer holding address of
- * displayFrameBuffer() function in display.c
- * @return None
+ * @brief Turns the indexed frame into RGB565 colors
+ * @details Does nothing if gb_ppu_get_indexed_frame() has no frame.
+ * @param pixels GAMEBOY_SCREEN_WIDTH * GAMEBOY_SCREEN_HEIGHT colors
+ * @return Nothing
  */
-void gb_ppu_set_display_frame_buffer(gb_ppu_display_frame_buffer_t display_frame_buffer)
+void gb_ppu_expand_rgb565(const gb_t *gb, uint16_t *pixels)
 {
-	gb_ppu_display_frame_buffer = display_frame_buffer;
+	const uint8_t *frame = gb_ppu_get_indexed_frame(gb);
+
+	if (frame == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH * GAMEBOY_SCREEN_HEIGHT; i++) {
+		pixels[i] = gb_ppu_shade_colors_rgb565[gb_ppu_get_shade(gb, frame, i)];
+	}
 }
 
 /**
  * @brief Zeros All Memory in the Line Buffer
  * @return Nothing
  */
-void gb_ppu_init(void)
-{
-	memset(frame_buffer, 0, GAMEBOY_SCREEN_WIDTH * GAMEBOY_SCREEN_HEIGHT * sizeof(uint32_t));
-	memset(oam_line_data_buffer, 0, GAMEBOY_SCREEN_WIDTH * sizeof(uint32_t));
-	memset(oam_line_prio_buffer, 0, GAMEBOY_SCREEN_WIDTH * sizeof(uint8_t));
-	ppu_dot_counter = 0;
-	stat_mode = 0;
-
-	ppu_enable = false;
-	wn_display_addr = TILE_MAP_LOCATION_LOW;
-	wn_enable = false;
-	tile_data_addr = TILE_DATA_SIGNED_ADDR;
-	bg_display_addr = TILE_MAP_LOCATION_LOW;
-	obj_size = false;
-	obj_enable = false;
-	bg_wn_enable = false;
-
-	lyc_int_sel = false;
-	mode_2_sel = false;
-	mode_1_sel = false;
-	mode_0_sel = false;
-
-	scy = 0;
-	scx = 0;
-	ly = 0;
-	wy = 0;
-	wx = 0;
-
-	oam_obj_count = 0;
-	wn_internal_line = 0;
+void gb_ppu_init(gb_t *gb)
+{
+	memset(gb->ppu.frame_buffers, 0, sizeof(gb->ppu.frame_buffers));
+	gb->ppu.back_buffer = 0;
+	gb->ppu.front_buffer = 1;
+	memset(gb->ppu.oam_line_data_buffer, 0, GAMEBOY_SCREEN_WIDTH * sizeof(uint8_t));
+	memset(gb->ppu.line_palette, 0, sizeof(gb->ppu.line_palette));
+	memset(gb->ppu.line_shades, 0, sizeof(gb->ppu.line_shades));
+	memset(gb->ppu.indexed_frames, 0, sizeof(gb->ppu.indexed_frames));
+	gb->ppu.compositor = gb_ppu_line_select();
+	gb->ppu.ppu_dot_counter = 0;
+	gb->ppu.line_cycle = gb->sched.now;
+	gb->ppu.oam_scan_count = PPU_MAX_OBJECTS;
+	gb->ppu.stat_mode = 0;
+	gb->ppu.skip_frame = false;
+
+	gb->ppu.ppu_enable = false;
+	gb->ppu.wn_display_addr = TILE_MAP_LOCATION_LOW;
+	gb->ppu.wn_enable = false;
+	gb->ppu.tile_data_addr = TILE_DATA_SIGNED_ADDR;
+	gb->ppu.bg_display_addr = TILE_MAP_LOCATION_LOW;
+	gb->ppu.obj_size = false;
+	gb->ppu.obj_enable = false;
+	gb->ppu.bg_wn_enable = false;
+
+	gb->ppu.lyc_int_sel = false;
+	gb->ppu.mode_2_sel = false;
+	gb->ppu.mode_1_sel = false;
+	gb->ppu.mode_0_sel = false;
+
+	gb->ppu.scy = 0;
+	gb->ppu.scx = 0;
+	gb->ppu.ly = 0;
+	gb->ppu.wy = 0;
+	gb->ppu.wx = 0;
+
+	gb->ppu.oam_obj_count = 0;
+	gb->ppu.wn_internal_line = 0;
+
+	gb->ppu.tile_dirty_count = 0;
+	memset(gb->ppu.tile_dirty, 0, sizeof(gb->ppu.tile_dirty));
+	gb_ppu_invalidate_tiles(gb);
+
+	// hold LY at 0 until the screen is enabled
+	gb_sched_schedule(gb, GB_EVENT_PPU, gb->sched.now, gb_ppu_event);
 }
 
 /**
- * @brief Steps the PPU by tStates
- * @details This function steps the PPU by the tStates variable if the screen
- * enable (7th) bit of LCDC Register is high, the function sets the mode in the
- * STAT Register using the gb_ppu_set_stat_mode() function depending on how many tStates
- * have elapsed. after a full line is has passed the LY register is updated
- * gb_ppu_draw_line() is called to place data in the Line buffer.
+ * @brief Brings the PPU up to the current M-cycle
+ * @details The PPU does not run on every M-cycle, it only records the clock cycle its next piece
+ * of work is due on and catches up in one go whenever the CPU is about to observe or change video
+ * state: PPU registers, VRAM, OAM and the end of gb_run_cycles() and gb_run_frame(). The only
+ * piece of its work that cannot wait for that is raising an interrupt, so a PPU event is
+ * scheduled on the next dot that sets a bit in the IF Register and nowhere else.
+ * @return Nothing
+ */
+void gb_ppu_sync(gb_t *gb)
+{
+	if (!gb->ppu.ppu_enable) {
+		return;
+	}
+
+	while (gb->ppu.line_cycle + gb->ppu.ppu_dot_counter < gb->sched.now) {
+		gb_ppu_advance(gb);
+	}
+
+	gb_ppu_oam_scan_sync(gb);
+}
+
+/**
+ * @brief Brings the PPU up to the current M-cycle and tells until when its registers stay as
+ * they are
+ * @details The PPU registers only change on the dots gb_ppu_advance() has work to do on, or when
+ * the CPU writes them. Reads up to the returned clock cycle give the values they would give now,
+ * and VRAM and OAM writes up to it are seen by the PPU as if they were made now.
+ * @return clock cycle of the next dot with work, UINT64_MAX while the screen is disabled
+ */
+uint64_t gb_ppu_next_change(gb_t *gb)
+{
+	if (!gb->ppu.ppu_enable) {
+		return UINT64_MAX;
+	}
+
+	gb_ppu_sync(gb);
+
+	if (gb->ppu.oam_scan_count < PPU_MAX_OBJECTS) {
+		// the OAM scan moves on to the next object after this dot, see gb_ppu_oam_scan_sync()
+		return gb->ppu.line_cycle + 2 * gb->ppu.oam_scan_count;
+	}
+
+	return gb->ppu.line_cycle + gb->ppu.ppu_dot_counter;
+}
+
+/**
+ * @brief Marks every tile of the tile cache to be decoded again
+ * @details Has to be called whenever VRAM is changed without gb_ppu_memory_write(), such as when
+ * the memory map is loaded.
+ * @return Nothing
+ */
+void gb_ppu_invalidate_tiles(gb_t *gb)
+{
+	for (uint16_t tile = 0; tile < PPU_TILE_COUNT; tile++) {
+		if (!gb->ppu.tile_dirty[tile]) {
+			gb->ppu.tile_dirty[tile] = true;
+			gb->ppu.tile_dirty_list[gb->ppu.tile_dirty_count++] = tile;
+		}
+	}
+}
+
+/**
+ * @brief Catches the PPU up to the interrupt it was scheduled for and schedules the next one
+ * @details While the screen is disabled LY is held at 0 and nothing is scheduled.
+ * @param cycle clock cycle of the dot
+ * @return Nothing
+ */
+static void gb_ppu_event(gb_t *gb, uint64_t cycle)
+{
+	(void)cycle;
+
+	if (!gb->ppu.ppu_enable) {
+		gb->ppu.ly = 0;
+		gb->mem.map[LY_ADDR] = gb->ppu.ly;
+		gb->ppu.ppu_dot_counter = 0;
+		gb->ppu.oam_scan_count = PPU_MAX_OBJECTS;
+		return;
+	}
+
+	gb_ppu_sync(gb);
+	gb_ppu_schedule_irq(gb);
+}
+
+/**
+ * @brief Runs the PPU work due on the dot stored in ppu_dot_counter
+ * @details While the screen enable (7th) bit of the LCDC Register is high the PPU only has work
+ * to do on a few dots of each scanline: the mode changes in the STAT Register at dots 0
+ * (OAM scan), 80 (drawing) and 252 (HBlank), and the LY update at the last dot. Each call
+ * handles one of them and moves ppu_dot_counter on to the next one, during VBlank only the last
+ * dot of a scanline has work to do. gb_ppu_draw_line() is called to place data in the frame
+ * buffer when HBlank starts. Frames that are skipped leave out the OAM scan and the drawing.
  * @return Nothing
  * @note The function and the Gameboy both mimic CRT Displays in that their are
  * both a horizontal H-Blank after a Line is "drawn" and there is a vertical
@@ -184,203 +382,364 @@ void gb_ppu_init(void)
  * more research into when and how often these Registers are updated must be
  * conducted.
  */
-void gb_ppu_step(void)
+static void gb_ppu_advance(gb_t *gb)
 {
-	if (!ppu_enable) {
-		ly = 0;
-		mem.map[LY_ADDR] = ly;
-		ppu_dot_counter = 0;
-		return;
-	}
+	switch (gb->ppu.ppu_dot_counter) {
+	case MODE_2_START:
+		// OAM region
+		if (gb->ppu.ly == 0) {
+			gb_ppu_start_frame(gb);
+		}
+		gb_ppu_set_stat_mode(gb, STAT_MODE_2);
+		if (!gb->ppu.skip_frame) {
+			gb->ppu.oam_scan_count = 0;
+			gb_ppu_oam_scan(gb, 1);
+		}
+		gb->ppu.ppu_dot_counter = MODE_3_START;
+		break;
 
-	for (int dot_cycles = 0; dot_cycles < 4; dot_cycles++) {
+	case MODE_3_START:
+		// VRAM region
+		gb_ppu_oam_scan(gb, PPU_MAX_OBJECTS);
+		gb_ppu_set_stat_mode(gb, STAT_MODE_3);
+		if (!gb->ppu.skip_frame) {
+			gb_ppu_find_object_data(gb);
+		}
+		gb->ppu.ppu_dot_counter = MODE_0_START_MIN;
+		break;
 
-		if (ly > 143 && ppu_dot_counter != (PPU_DOTS_PER_SCANLINE - 1)) {
-			ppu_dot_counter++;
-			continue;
+	case MODE_0_START_MIN:
+		// HBlank region
+		gb_ppu_set_stat_mode(gb, STAT_MODE_0);
+		if (!gb->ppu.skip_frame) {
+			gb_ppu_draw_line(gb);
+		} else if (gb->ppu.bg_wn_enable && gb->ppu.wn_enable && gb_ppu_window_shown(gb)) {
+			// the window line counter carries over into the next frame when the screen
+			// is switched off before VBlank
+			gb->ppu.wn_internal_line++;
+		}
+		if (gb->ppu.mode_0_sel) {
+			gb_memory_set_bit(gb, IF_ADDR, 1);
 		}
+		gb->ppu.ppu_dot_counter = PPU_DOTS_PER_SCANLINE - 1;
+		break;
 
-		if (ppu_dot_counter >= MODE_2_START && ppu_dot_counter < MODE_3_START) {
-			// OAM region
-			if (ppu_dot_counter == 0) {
-				gb_ppu_set_stat_mode(STAT_MODE_2);
+	default:
+		// last dot of the scanline
+		gb->ppu.ly++;
+		gb->ppu.oam_obj_count = 0;
+		gb_ppu_check_lyc(gb);
+
+		if (gb->ppu.ly >= MODE_1_SCANLINE) {
+			// VBlank region
+			gb->ppu.wn_internal_line = 0;
+			gb_ppu_set_stat_mode(gb, STAT_MODE_1);
+			if (gb->ppu.mode_1_sel) {
+				gb_memory_set_bit(gb, IF_ADDR, 1);
 			}
 
-			if (ppu_dot_counter % 2 == 0) {
-				gb_ppu_oam_process_next_object(ppu_dot_counter / 2);
+			if (gb->ppu.ly == MODE_1_SCANLINE) {
+				gb_memory_set_bit(gb, IF_ADDR, 0);
+				gb->ppu.vblank = true;
 			}
 		}
 
-		else if (ppu_dot_counter >= MODE_3_START && ppu_dot_counter < MODE_0_START_MIN) {
-			// VRAM region
-			if (ppu_dot_counter == MODE_3_START) {
-				gb_ppu_set_stat_mode(STAT_MODE_3);
-				gb_ppu_find_object_data();
+		if (gb->ppu.ly > PPU_FINAL_SCANLINE) {
+			// End of VBlank region
+			gb_ppu_set_stat_mode(gb, STAT_MODE_2);
+			gb->ppu.ly = 0;
+
+			if (gb->ppu.mode_2_sel) {
+				gb_memory_set_bit(gb, IF_ADDR, 1);
 			}
 		}
 
-		else if (ppu_dot_counter >= MODE_0_START_MIN &&
-			 ppu_dot_counter < (PPU_DOTS_PER_SCANLINE - 1)) {
-			// HBlank region
-			if (ppu_dot_counter == MODE_0_START_MIN) {
-				gb_ppu_set_stat_mode(STAT_MODE_0);
-				gb_ppu_draw_line();
-				if (mode_0_sel) {
-					SET_BIT(mem.map[IF_ADDR], 1);
-				}
+		gb->mem.map[LY_ADDR] = gb->ppu.ly;
+		gb->ppu.line_cycle += PPU_DOTS_PER_SCANLINE;
+		gb->ppu.ppu_dot_counter =
+			(gb->ppu.ly >= MODE_1_SCANLINE) ? PPU_DOTS_PER_SCANLINE - 1 : MODE_2_START;
+		break;
+	}
+}
+
+/**
+ * @brief Decides whether the frame starting on scanline 0 is rendered or skipped
+ * @details A format switched with gb_ppu_set_output() is taken over here, so no frame is drawn
+ * in two formats.
+ * @return Nothing
+ */
+static void gb_ppu_start_frame(gb_t *gb)
+{
+	gb->ppu.output = gb->ppu.next_output;
+
+	if (gb->ppu.render_next || gb->ppu.render_skip_count == 0) {
+		gb->ppu.render_next = false;
+		gb->ppu.render_skip_count = gb->ppu.render_skip;
+		gb->ppu.skip_frame = false;
+		return;
+	}
+
+	if (gb->ppu.render_skip_count != GB_PPU_RENDER_SKIP_ALL) {
+		gb->ppu.render_skip_count--;
+	}
+	gb->ppu.skip_frame = true;
+}
+
+/**
+ * @brief Schedules the PPU event on the next dot that raises an interrupt
+ * @details Walks the dots with work ahead of the synced PPU without running them, following the
+ * same rules as gb_ppu_advance(). The walk always ends on the first VBlank scanline at the
+ * latest, since that one raises the VBlank interrupt. Must be called again whenever the STAT
+ * interrupt selects, LYC or the screen enable bit change.
+ * @return Nothing
+ */
+static void gb_ppu_schedule_irq(gb_t *gb)
+{
+	uint32_t dot = gb->ppu.ppu_dot_counter;
+	uint64_t line_cycle = gb->ppu.line_cycle;
+	uint8_t ly = gb->ppu.ly;
+	uint8_t lyc = gb->mem.map[LYC_ADDR];
+
+	for (;;) {
+		if (dot == MODE_2_START) {
+			dot = MODE_3_START;
+			continue;
+		}
+
+		if (dot == MODE_3_START) {
+			dot = MODE_0_START_MIN;
+			continue;
+		}
+
+		if (dot == MODE_0_START_MIN) {
+			if (gb->ppu.mode_0_sel) {
+				break;
 			}
+			dot = PPU_DOTS_PER_SCANLINE - 1;
+			continue;
 		}
 
-		else if (ppu_dot_counter == (PPU_DOTS_PER_SCANLINE - 1)) {
-			ly++;
-			oam_obj_count = 0;
-			gb_ppu_check_lyc();
-
-			if (ly >= MODE_1_SCANLINE) {
-				// VBlank region
-				wn_internal_line = 0;
-				gb_ppu_set_stat_mode(STAT_MODE_1);
-				if (mode_1_sel) {
-					SET_BIT(mem.map[IF_ADDR], 1);
-				}
-
-				if (ly == MODE_1_SCANLINE) {
-					SET_BIT(mem.map[IF_ADDR], 0);
-				}
+		// last dot of the scanline, see gb_ppu_check_lyc()
+		ly++;
+		if (ly == lyc) {
+			if (gb->ppu.lyc_int_sel) {
+				break;
 			}
+			SET_BIT(lyc, 2);
+		}
 
-			if (ly > PPU_FINAL_SCANLINE) {
-				// End of VBlank region
-				gb_ppu_set_stat_mode(STAT_MODE_2);
-				ly = 0;
+		if (ly == MODE_1_SCANLINE || (ly > MODE_1_SCANLINE && gb->ppu.mode_1_sel)) {
+			break;
+		}
 
-				if (mode_2_sel) {
-					SET_BIT(mem.map[IF_ADDR], 1);
-				}
+		if (ly > PPU_FINAL_SCANLINE) {
+			if (gb->ppu.mode_2_sel) {
+				break;
 			}
-
-			mem.map[LY_ADDR] = ly;
-			ppu_dot_counter -= PPU_DOTS_PER_SCANLINE;
+			ly = 0;
 		}
 
-		ppu_dot_counter++;
+		line_cycle += PPU_DOTS_PER_SCANLINE;
+		dot = (ly >= MODE_1_SCANLINE) ? PPU_DOTS_PER_SCANLINE - 1 : MODE_2_START;
+	}
+
+	gb_sched_schedule(gb, GB_EVENT_PPU, line_cycle + dot, gb_ppu_event);
+}
+
+/**
+ * @brief Turns the PPU on or off according to the screen enable bit written to LCDC
+ * @details Switching the PPU on starts a new frame at the first dot of scanline 0 on the current
+ * M-cycle, switching it off resets LY.
+ * @param enable state of the screen enable bit
+ * @return Nothing
+ */
+static void gb_ppu_set_enable(gb_t *gb, bool enable)
+{
+	if (enable == gb->ppu.ppu_enable) {
+		return;
+	}
+
+	gb->ppu.ppu_enable = enable;
+	gb->ppu.ppu_dot_counter = MODE_2_START;
+	gb->ppu.line_cycle = gb->sched.now;
+	if (enable) {
+		gb_ppu_schedule_irq(gb);
+	} else {
+		gb_sched_schedule(gb, GB_EVENT_PPU, gb->sched.now, gb_ppu_event);
 	}
 }
 
-static void gb_ppu_oam_process_next_object(uint8_t obj_index)
+/**
+ * @brief Scans OAM entries for objects on the current scanline
+ * @details One object is checked every 2 dots of mode 2, the scan continues from the last
+ * checked object up to obj_end.
+ * @param obj_end number of objects that have to be checked after the call
+ * @return Nothing
+ */
+static void gb_ppu_oam_scan(gb_t *gb, uint8_t obj_end)
 {
-	if (oam_obj_count >= PPU_MAX_OBJECTS_PER_SCANLINE) {
+	for (; gb->ppu.oam_scan_count < obj_end; gb->ppu.oam_scan_count++) {
+		gb_ppu_oam_process_next_object(gb, gb->ppu.oam_scan_count);
+	}
+}
+
+/**
+ * @brief Brings the OAM scan up to the current M-cycle
+ * @details Called by gb_ppu_sync() while the OAM scan of a scanline is in progress, so OAM and
+ * the object size can be changed part way through it.
+ * @return Nothing
+ */
+static void gb_ppu_oam_scan_sync(gb_t *gb)
+{
+	if (gb->ppu.oam_scan_count >= PPU_MAX_OBJECTS) {
 		return;
 	}
 
-	int16_t y_coord = mem.map[OAM_BASE + (obj_index * 4)] - 16;
-	int16_t x_coord = mem.map[OAM_BASE + (obj_index * 4) + 1] - 8;
-	uint8_t obj_height = (obj_size == 0) ? PPU_OBJECT_HEIGHT_SHORT : PPU_OBJECT_HEIGHT_TALL;
+	// every object up to the last dot before the current M-cycle has been checked
+	uint64_t obj_end = (gb->sched.now - gb->ppu.line_cycle + 1) / 2;
+	gb_ppu_oam_scan(gb, (obj_end < PPU_MAX_OBJECTS) ? obj_end : PPU_MAX_OBJECTS);
+}
 
-	if (y_coord <= ly && (y_coord + obj_height) > ly) {
+static void gb_ppu_oam_process_next_object(gb_t *gb, uint8_t obj_index)
+{
+	if (gb->ppu.oam_obj_count >= PPU_MAX_OBJECTS_PER_SCANLINE) {
+		return;
+	}
 
-		oam_line_slot[oam_obj_count].x_coord = x_coord;
-		oam_line_slot[oam_obj_count].y_coord = y_coord;
-		oam_line_slot[oam_obj_count].obj_index = obj_index;
+	int16_t y_coord = gb->mem.map[OAM_BASE + (obj_index * 4)] - 16;
+	int16_t x_coord = gb->mem.map[OAM_BASE + (obj_index * 4) + 1] - 8;
+	uint8_t obj_height =
+		(gb->ppu.obj_size == 0) ? PPU_OBJECT_HEIGHT_SHORT : PPU_OBJECT_HEIGHT_TALL;
+
+	if (y_coord <= gb->ppu.ly && (y_coord + obj_height) > gb->ppu.ly) {
+
+		gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].x_coord = x_coord;
+		gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].y_coord = y_coord;
+		gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].obj_index = obj_index;
 		if (x_coord + PPU_OBJECT_WIDTH < 0 || x_coord >= GAMEBOY_SCREEN_WIDTH) {
-			oam_line_slot[oam_obj_count].start = 0;
-			oam_line_slot[oam_obj_count].len = 0;
+			gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].start = 0;
+			gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].len = 0;
 		} else if (x_coord < 0) {
-			oam_line_slot[oam_obj_count].start = 0;
-			oam_line_slot[oam_obj_count].len = PPU_OBJECT_WIDTH + x_coord;
+			gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].start = 0;
+			gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].len =
+				PPU_OBJECT_WIDTH + x_coord;
 		} else if (x_coord + PPU_OBJECT_WIDTH >= GAMEBOY_SCREEN_WIDTH) {
-			oam_line_slot[oam_obj_count].start = x_coord;
-			oam_line_slot[oam_obj_count].len = (GAMEBOY_SCREEN_WIDTH - 1) - x_coord;
+			gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].start = x_coord;
+			gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].len =
+				(GAMEBOY_SCREEN_WIDTH - 1) - x_coord;
 		} else {
-			oam_line_slot[oam_obj_count].start = x_coord;
-			oam_line_slot[oam_obj_count].len = PPU_OBJECT_WIDTH;
+			gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].start = x_coord;
+			gb->ppu.oam_line_slot[gb->ppu.oam_obj_count].len = PPU_OBJECT_WIDTH;
 		}
-		oam_obj_count++;
+		gb->ppu.oam_obj_count++;
 	}
 }
 
-static void gb_ppu_find_object_data(void)
+static void gb_ppu_find_object_data(gb_t *gb)
 {
-	for (int i = 0; i < oam_obj_count; i++) {
-		int16_t x_coord = oam_line_slot[i].x_coord;
-		int16_t y_coord = oam_line_slot[i].y_coord;
-		uint8_t data_tile = mem.map[OAM_BASE + (oam_line_slot[i].obj_index * 4) + 2];
-		uint8_t obj_prio =
-			CHK_BIT(mem.map[OAM_BASE + (oam_line_slot[i].obj_index * 4) + 3], 7);
-		uint8_t obj_y_flip =
-			CHK_BIT(mem.map[OAM_BASE + (oam_line_slot[i].obj_index * 4) + 3], 6);
-		uint8_t obj_x_flip =
-			CHK_BIT(mem.map[OAM_BASE + (oam_line_slot[i].obj_index * 4) + 3], 5);
-		uint8_t obj_palette =
-			CHK_BIT(mem.map[OAM_BASE + (oam_line_slot[i].obj_index * 4) + 3], 4);
+	gb_ppu_decode_tiles(gb);
+	memcpy(&gb->ppu.line_palette[GB_PPU_LINE_OBP0], gb->ppu.obp0_color_to_palette,
+	       sizeof(gb->ppu.obp0_color_to_palette));
+	memcpy(&gb->ppu.line_palette[GB_PPU_LINE_OBP1], gb->ppu.obp1_color_to_palette,
+	       sizeof(gb->ppu.obp1_color_to_palette));
+	gb_ppu_set_line_shades(gb, GB_PPU_LINE_OBP0, gb->mem.map[OBP0_ADDR]);
+	gb_ppu_set_line_shades(gb, GB_PPU_LINE_OBP1, gb->mem.map[OBP1_ADDR]);
+
+	for (int i = 0; i < gb->ppu.oam_obj_count; i++) {
+		int16_t x_coord = gb->ppu.oam_line_slot[i].x_coord;
+		int16_t y_coord = gb->ppu.oam_line_slot[i].y_coord;
+		uint8_t data_tile =
+			gb->mem.map[OAM_BASE + (gb->ppu.oam_line_slot[i].obj_index * 4) + 2];
+		uint8_t obj_prio = CHK_BIT(
+			gb->mem.map[OAM_BASE + (gb->ppu.oam_line_slot[i].obj_index * 4) + 3], 7);
+		uint8_t obj_y_flip = CHK_BIT(
+			gb->mem.map[OAM_BASE + (gb->ppu.oam_line_slot[i].obj_index * 4) + 3], 6);
+		uint8_t obj_x_flip = CHK_BIT(
+			gb->mem.map[OAM_BASE + (gb->ppu.oam_line_slot[i].obj_index * 4) + 3], 5);
+		uint8_t obj_palette = CHK_BIT(
+			gb->mem.map[OAM_BASE + (gb->ppu.oam_line_slot[i].obj_index * 4) + 3], 4);
 		uint8_t obj_height =
-			(obj_size == 0) ? PPU_OBJECT_HEIGHT_SHORT : PPU_OBJECT_HEIGHT_TALL;
+			(gb->ppu.obj_size == 0) ? PPU_OBJECT_HEIGHT_SHORT : PPU_OBJECT_HEIGHT_TALL;
 
 		if (obj_height == PPU_OBJECT_HEIGHT_TALL) {
 			data_tile = data_tile & 0xFE;
 		}
 
 		uint8_t line_offset =
-			obj_y_flip ? ((obj_height - 1) - (ly - y_coord)) * 2 : (ly - y_coord) * 2;
-		uint16_t address = TILE_DATA_UNSIGNED_ADDR + (data_tile * 0x10) + line_offset;
-		uint16_t tile_data = CAT_BYTES(mem.map[address], mem.map[address + 1]);
-		uint32_t *palette =
-			(obj_palette) ? &obp1_color_to_palette[0] : &obp0_color_to_palette[0];
+			obj_y_flip ? ((obj_height - 1) - (gb->ppu.ly - y_coord)) * 2
+				   : (gb->ppu.ly - y_coord) * 2;
+		// tall objects go on with the next tile after the 8th line
+		const uint8_t *colors =
+			&gb->ppu.tile_cache[obj_x_flip][data_tile + (line_offset / PPU_TILE_BYTES)]
+					   [((line_offset % PPU_TILE_BYTES) / 2) * PPU_TILE_SIZE];
+		uint8_t palette = (obj_palette) ? GB_PPU_LINE_OBP1 : GB_PPU_LINE_OBP0;
 
 		for (int pixel_num = 0, buf_pos = 0; pixel_num < 8; pixel_num++) {
-
-			uint16_t color_info = (obj_x_flip)
-						      ? (((tile_data >> pixel_num) & 0x0101) << 7)
-						      : ((tile_data << pixel_num) & 0x8080);
-			uint32_t pixel_data = 0;
-
-			switch (color_info) {
-			case 0x0000:
-				pixel_data = 0;
-				break;
-			case 0x0080:
-				pixel_data = palette[1];
-				break;
-			case 0x8000:
-				pixel_data = palette[2];
-				break;
-			case 0x8080:
-				pixel_data = palette[3];
-				break;
-			}
+			uint8_t entry = palette + colors[pixel_num];
+			// colors of object palettes that were never written are transparent
+			uint8_t pixel_data =
+				(colors[pixel_num] && gb->ppu.line_palette[entry]) ? entry : 0;
 
 			if (x_coord + pixel_num >= 0 &&
 			    (x_coord + pixel_num) < GAMEBOY_SCREEN_WIDTH) {
-				oam_line_slot[i].buf[buf_pos] = pixel_data;
+				gb->ppu.oam_line_slot[i].buf[buf_pos] = pixel_data;
 				buf_pos++;
 			}
 		}
-		oam_line_slot[i].obj_prio = obj_prio;
+		gb->ppu.oam_line_slot[i].obj_prio = obj_prio;
 	}
 }
 /**
- * @brief Finds specific line data of a tile using the tile_offset and
- * line_offset
- * @details Called by gb_ppu_draw_line() and returns color information of a
- * specific tile in the Gameboy's VRAM located by using the tile_offset and
- * line_offset parameters.
- * @param tile_offset gives the address offset in the tile map in Gameboy's VRAM
- * @param line_offset gives the line offset in the tile
- * @return uint16_t data containing the color information of each pixel of a
- * particular line belonging to a tile in the Gameboy's VRAM
+ * @brief Decodes the tiles written since the last scanline into the tile cache
+ * @details Every line of a tile is stored as two bit planes, the low bits of the 8 color indices
+ * in the first byte and the high bits in the second one, leftmost pixel first.
+ * @return Nothing
  */
-static uint16_t gb_ppu_get_tile_line_data(uint16_t tile_offset, uint8_t line_offset,
-					  uint16_t display_addr)
+static void gb_ppu_decode_tiles(gb_t *gb)
 {
-	uint16_t address = tile_data_addr;
-	if (tile_data_addr == TILE_DATA_UNSIGNED_ADDR) {
-		address += (mem.map[display_addr + tile_offset] * 0x10);
-	} else {
-		int8_t signed_conv = (int8_t)(mem.map[display_addr + tile_offset]);
-		address += (signed_conv + 128) * 0x10;
+	for (uint16_t i = 0; i < gb->ppu.tile_dirty_count; i++) {
+		uint16_t tile = gb->ppu.tile_dirty_list[i];
+		const uint8_t *data =
+			&gb->mem.map[TILE_DATA_UNSIGNED_ADDR + (tile * PPU_TILE_BYTES)];
+		uint8_t *colors = gb->ppu.tile_cache[0][tile];
+		uint8_t *mirrored = gb->ppu.tile_cache[1][tile];
+
+		for (int line = 0; line < PPU_TILE_SIZE; line++) {
+			uint8_t low = data[line * 2];
+			uint8_t high = data[(line * 2) + 1];
+
+			for (int x = 0; x < PPU_TILE_SIZE; x++) {
+				uint8_t bit = (PPU_TILE_SIZE - 1) - x;
+				uint8_t color =
+					((low >> bit) & 0x01) | (((high >> bit) & 0x01) << 1);
+
+				colors[(line * PPU_TILE_SIZE) + x] = color;
+				mirrored[(line * PPU_TILE_SIZE) + bit] = color;
+			}
+		}
+		gb->ppu.tile_dirty[tile] = false;
 	}
-	address += line_offset;
-	return CAT_BYTES(mem.map[address], mem.map[address + 1]);
+	gb->ppu.tile_dirty_count = 0;
+}
+
+/**
+ * @brief Finds the color indices of a line of the tile a tile map entry points to
+ * @details The tile map entry is an unsigned tile number counted from 0x8000 or a signed one
+ * counted from 0x9000, depending on the tile data area selected in LCDC.
+ * @param map_addr address of the tile map entry
+ * @param line line of the tile
+ * @return 8 color indices, leftmost pixel first
+ */
+static const uint8_t *gb_ppu_get_tile_line(gb_t *gb, uint16_t map_addr, uint8_t line)
+{
+	uint16_t tile = gb->mem.map[map_addr];
+
+	if (gb->ppu.tile_data_addr != TILE_DATA_UNSIGNED_ADDR) {
+		tile = ((TILE_DATA_SIGNED_ADDR - TILE_DATA_UNSIGNED_ADDR) / PPU_TILE_BYTES) +
+		       (tile ^ 0x80);
+	}
+
+	return &gb->ppu.tile_cache[0][tile][line * PPU_TILE_SIZE];
 }
 
 /**
@@ -390,14 +749,14 @@ static uint16_t gb_ppu_get_tile_line_data(uint16_t tile_offset, uint8_t line_off
  * @param ly value of the LY Register
  * @return Nothing
  */
-static inline void gb_ppu_check_lyc(void)
+static inline void gb_ppu_check_lyc(gb_t *gb)
 {
-	if (mem.map[LYC_ADDR] == ly) {
-		SET_BIT(mem.map[LYC_ADDR], 2);
-		if (lyc_int_sel)
-			SET_BIT(mem.map[IF_ADDR], 1);
+	if (gb->mem.map[LYC_ADDR] == gb->ppu.ly) {
+		SET_BIT(gb->mem.map[LYC_ADDR], 2);
+		if (gb->ppu.lyc_int_sel)
+			gb_memory_set_bit(gb, IF_ADDR, 1);
 	} else {
-		RST_BIT(mem.map[STAT_ADDR], 2);
+		RST_BIT(gb->mem.map[STAT_ADDR], 2);
 	}
 }
 
@@ -406,100 +765,53 @@ static inline void gb_ppu_check_lyc(void)
  * @param mode current status of the LCD controller
  * @return Nothing
  */
-static void gb_ppu_set_stat_mode(uint8_t mode)
+static void gb_ppu_set_stat_mode(gb_t *gb, uint8_t mode)
 {
-	stat_mode = mode;
+	gb->ppu.stat_mode = mode;
 	switch (mode) {
 	case STAT_MODE_0:
-		RST_BIT(mem.map[STAT_ADDR], 1);
-		RST_BIT(mem.map[STAT_ADDR], 0);
+		RST_BIT(gb->mem.map[STAT_ADDR], 1);
+		RST_BIT(gb->mem.map[STAT_ADDR], 0);
 		break; // 00
 	case STAT_MODE_1:
-		RST_BIT(mem.map[STAT_ADDR], 1);
-		SET_BIT(mem.map[STAT_ADDR], 0);
+		RST_BIT(gb->mem.map[STAT_ADDR], 1);
+		SET_BIT(gb->mem.map[STAT_ADDR], 0);
 		break; // 01
 	case STAT_MODE_2:
-		SET_BIT(mem.map[STAT_ADDR], 1);
-		RST_BIT(mem.map[STAT_ADDR], 0);
+		SET_BIT(gb->mem.map[STAT_ADDR], 1);
+		RST_BIT(gb->mem.map[STAT_ADDR], 0);
 		break; // 10
 	case STAT_MODE_3:
-		SET_BIT(mem.map[STAT_ADDR], 1);
-		SET_BIT(mem.map[STAT_ADDR], 0);
+		SET_BIT(gb->mem.map[STAT_ADDR], 1);
+		SET_BIT(gb->mem.map[STAT_ADDR], 0);
 		break; // 11
 	default:
 		break;
 	}
 }
 
-/**
- * @brief Updates the line buffer with pixel information for 1 specified pixel
- * @details Updates and applies a pixel perfect image scaling algorithm on 1
- * pixel of the line buffer when called.
- * @param data Color information for the current pixel
- * @param pixel_pos X position for the current pixel
- * @returns Nothing
- */
-static void gb_ppu_update_frame_buffer(uint32_t data, int pixel_pos)
-{
-	frame_buffer[(ly * GAMEBOY_SCREEN_WIDTH) + pixel_pos] = data;
-}
-
 /**
  * @brief Update line buffer with background information
  * @details Populates the line buffer with Background information on the line ly
  * displayed on Screen
  * @returns Nothing
  */
-static void gb_ppu_draw_line_background(void)
+static void gb_ppu_draw_line_background(gb_t *gb)
 {
-	uint16_t tile_offset = (((uint8_t)(scy + ly) / 8) * 32) +
-			       (scx / 8); // gives the address offset in the tile map
-	uint8_t line_offset = (((scy % 8) + ly) % 8) * 2; // gives the line offset in the tile
-	uint8_t pixl_offset = scx % 8;			  // gives current pixel offset
-
-	uint16_t first_tile = tile_offset % 32;
-	uint16_t tile_data =
-		gb_ppu_get_tile_line_data(tile_offset, line_offset,
-					  bg_display_addr); // tile data holds tile line information
-
-	for (int j = 0; j < GAMEBOY_SCREEN_WIDTH; j++) {
-
-		uint32_t pixel_data = 0;
-
-		switch (((tile_data << pixl_offset) & 0x8080)) {
-		case 0x0000:
-			pixel_data = bgp_color_to_palette[0];
-			bg_wn_buffer[j] = 0;
-			break;
-		case 0x0080:
-			pixel_data = bgp_color_to_palette[1];
-			bg_wn_buffer[j] = 1;
-			break;
-		case 0x8000:
-			pixel_data = bgp_color_to_palette[2];
-			bg_wn_buffer[j] = 2;
-			break;
-		case 0x8080:
-			pixel_data = bgp_color_to_palette[3];
-			bg_wn_buffer[j] = 3;
-			break;
-		}
-
-		gb_ppu_update_frame_buffer(pixel_data, j);
-		pixl_offset++;
-
-		if (pixl_offset == 8) {
-			tile_offset++;
-			pixl_offset = 0;
-			if (first_tile + (tile_offset % 32) >= 12 &&
-			    (tile_offset % 32) < first_tile)
-				tile_data = gb_ppu_get_tile_line_data(tile_offset - 32, line_offset,
-								      bg_display_addr);
-			else
-				tile_data = gb_ppu_get_tile_line_data(tile_offset, line_offset,
-								      bg_display_addr);
-		}
+	uint8_t y = gb->ppu.scy + gb->ppu.ly;
+	uint16_t map_addr = gb->ppu.bg_display_addr + ((y / PPU_TILE_SIZE) * 32);
+	uint8_t first_tile = gb->ppu.scx / PPU_TILE_SIZE;
+	uint8_t line[PPU_LINE_TILES * PPU_TILE_SIZE];
+
+	// the tile map wraps around horizontally
+	for (int i = 0; i < PPU_LINE_TILES; i++) {
+		memcpy(&line[i * PPU_TILE_SIZE],
+		       gb_ppu_get_tile_line(gb, map_addr + ((first_tile + i) % 32),
+					    y % PPU_TILE_SIZE),
+		       PPU_TILE_SIZE);
 	}
+
+	memcpy(gb->ppu.bg_wn_buffer, &line[gb->ppu.scx % PPU_TILE_SIZE], GAMEBOY_SCREEN_WIDTH);
 }
 
 /**
@@ -509,51 +821,39 @@ static void gb_ppu_draw_line_background(void)
  * displayed on Screen
  * @returns Nothing
  */
-static void gb_ppu_draw_line_window(void)
+static void gb_ppu_draw_line_window(gb_t *gb)
 {
-	if (wy > ly || wy > 143 || wx > 166)
+	if (!gb_ppu_window_shown(gb))
 		return;
 
-	uint16_t tile_offset = (((uint8_t)(wn_internal_line) / 8) * 32);
-	uint8_t line_offset = (((wn_internal_line) % 8)) * 2;
-	uint8_t pixl_offset = (wx - 7) % 8;
-
-	uint16_t tile_data = gb_ppu_get_tile_line_data(
-		tile_offset, line_offset, wn_display_addr); // tile data holds tile line information
-
-	for (int j = (wx - 7); j < GAMEBOY_SCREEN_WIDTH; j++) {
-		uint32_t pixel_data = 0;
-
-		switch (((tile_data << pixl_offset) & 0x8080)) {
-		case 0x0000:
-			pixel_data = bgp_color_to_palette[0];
-			bg_wn_buffer[j] = 0;
-			break;
-		case 0x0080:
-			pixel_data = bgp_color_to_palette[1];
-			bg_wn_buffer[j] = 1;
-			break;
-		case 0x8000:
-			pixel_data = bgp_color_to_palette[2];
-			bg_wn_buffer[j] = 2;
-			break;
-		case 0x8080:
-			pixel_data = bgp_color_to_palette[3];
-			bg_wn_buffer[j] = 3;
-			break;
-		}
+	uint16_t map_addr =
+		gb->ppu.wn_display_addr + ((gb->ppu.wn_internal_line / PPU_TILE_SIZE) * 32);
+	int start = gb->ppu.wx - 7;
+	// window tiles start on the tile boundary of the screen at or left of the window
+	int first_pixel = start & ~(PPU_TILE_SIZE - 1);
+	int first_shown = (start > 0) ? start : 0;
+	int tiles = ((GAMEBOY_SCREEN_WIDTH - 1 - first_pixel) / PPU_TILE_SIZE) + 1;
+	uint8_t line[PPU_LINE_TILES * PPU_TILE_SIZE];
+
+	for (int i = 0; i < tiles; i++) {
+		memcpy(&line[i * PPU_TILE_SIZE],
+		       gb_ppu_get_tile_line(gb, map_addr + i,
+					    gb->ppu.wn_internal_line % PPU_TILE_SIZE),
+		       PPU_TILE_SIZE);
+	}
 
-		gb_ppu_update_frame_buffer(pixel_data, j);
-		pixl_offset++;
+	memcpy(&gb->ppu.bg_wn_buffer[first_shown], &line[first_shown - first_pixel],
+	       GAMEBOY_SCREEN_WIDTH - first_shown);
+	gb->ppu.wn_internal_line++;
+}
 
-		if (pixl_offset == 8) {
-			tile_offset++;
-			pixl_offset = 0;
-			tile_data = gb_ppu_get_tile_line_data(tile_offset, line_offset,
-							      wn_display_addr);
-		}
-	}
-	wn_internal_line++;
+/**
+ * @brief Checks whether the window covers part of the line ly
+ * @returns true if the window is shown on the line
+ */
+static bool gb_ppu_window_shown(gb_t *gb)
+{
+	return gb->ppu.wy <= gb->ppu.ly && gb->ppu.wy <= 143 && gb->ppu.wx <= 166;
 }
 
 /**
@@ -561,17 +861,13 @@ static void gb_ppu_draw_line_window(void)
  * @details Populates the line buffer with object sprites on line ly
  * @returns Nothing
  */
-static void gb_ppu_draw_line_objects(void)
+static void gb_ppu_draw_line_objects(gb_t *gb)
 {
+	for (int i = 0; i < gb->ppu.oam_obj_count; i++) {
 
-	memset(oam_line_data_buffer, 0, GAMEBOY_SCREEN_WIDTH * sizeof(uint32_t));
-	memset(oam_line_prio_buffer, 0, GAMEBOY_SCREEN_WIDTH * sizeof(uint8_t));
-
-	for (int i = 0; i < oam_obj_count; i++) {
-
-		int16_t x_coord = oam_line_slot[i].x_coord;
-		uint8_t start = oam_line_slot[i].start;
-		uint8_t end = start + oam_line_slot[i].len;
+		int16_t x_coord = gb->ppu.oam_line_slot[i].x_coord;
+		uint8_t start = gb->ppu.oam_line_slot[i].start;
+		uint8_t end = start + gb->ppu.oam_line_slot[i].len;
 		uint8_t good = start;
 
 		if (start == end) {
@@ -580,37 +876,31 @@ static void gb_ppu_draw_line_objects(void)
 
 		// bounding box for overlaping objects, lower x coordinate prevails (dmg)
 		for (int j = 0; j < i; j++) {
-			int16_t x_coord_drawn = oam_line_slot[j].x_coord;
-			uint8_t start_drawn = oam_line_slot[j].start;
-			uint8_t end_drawn = start_drawn + oam_line_slot[j].len;
+			int16_t x_coord_drawn = gb->ppu.oam_line_slot[j].x_coord;
+			uint8_t start_drawn = gb->ppu.oam_line_slot[j].start;
+			uint8_t end_drawn = start_drawn + gb->ppu.oam_line_slot[j].len;
 
 			if (x_coord_drawn <= x_coord && start < end_drawn && start_drawn < end) {
 				good = end_drawn;
 			}
 		}
 
+		uint8_t behind = gb->ppu.oam_line_slot[i].obj_prio ? GB_PPU_LINE_BEHIND : 0;
+
 		// draw object pixels that have no conflicts
 		for (int pos = good; pos < end; pos++) {
-			if (oam_line_slot[i].buf[pos - start] != 0) {
-				oam_line_data_buffer[pos] = oam_line_slot[i].buf[pos - start];
-				oam_line_prio_buffer[pos] = oam_line_slot[i].obj_prio;
+			if (gb->ppu.oam_line_slot[i].buf[pos - start] != 0) {
+				gb->ppu.oam_line_data_buffer[pos] =
+					gb->ppu.oam_line_slot[i].buf[pos - start] | behind;
 			}
 		}
 
-		// draw over transparent object pixels anyways
+		// draw over transparent object pixels anyways, these are never behind the
+		// background
 		for (int pos = start; pos < good; pos++) {
-			if (oam_line_data_buffer[pos] == 0) {
-				oam_line_data_buffer[pos] = oam_line_slot[i].buf[pos - start];
-			}
-		}
-	}
-
-	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i++) {
-		if (oam_line_prio_buffer[i] && bg_wn_buffer[i]) {
-			continue;
-		} else {
-			if (oam_line_data_buffer[i] != 0) {
-				gb_ppu_update_frame_buffer(oam_line_data_buffer[i], i);
+			if (gb->ppu.oam_line_data_buffer[pos] == 0) {
+				gb->ppu.oam_line_data_buffer[pos] =
+					gb->ppu.oam_line_slot[i].buf[pos - start];
 			}
 		}
 	}
@@ -623,86 +913,185 @@ static void gb_ppu_draw_line_objects(void)
  * @param ly LY Register Value
  * @returns Nothing
  */
-static void gb_ppu_draw_line(void)
+static void gb_ppu_draw_line(gb_t *gb)
 {
-	if (bg_wn_enable) {
-		gb_ppu_draw_line_background();
-		if (wn_enable) {
-			gb_ppu_draw_line_window();
+	gb_ppu_decode_tiles(gb);
+
+	if (gb->ppu.bg_wn_enable) {
+		memcpy(gb->ppu.line_palette, gb->ppu.bgp_color_to_palette,
+		       sizeof(gb->ppu.bgp_color_to_palette));
+		gb_ppu_set_line_shades(gb, 0, gb->mem.map[BGP_ADDR]);
+		gb_ppu_draw_line_background(gb);
+		if (gb->ppu.wn_enable) {
+			gb_ppu_draw_line_window(gb);
 		}
 	} else {
-		for (int j = 0; j < GAMEBOY_SCREEN_WIDTH; j++) {
-			gb_ppu_update_frame_buffer(LIGHT_SHADE, j);
+		// the background is blank, nothing covers objects that go behind it
+		memset(gb->ppu.bg_wn_buffer, 0, sizeof(gb->ppu.bg_wn_buffer));
+		for (int j = 0; j < GB_PPU_LINE_OBP0; j++) {
+			gb->ppu.line_palette[j] = LIGHT_SHADE;
+			gb->ppu.line_shades[j] = 0;
+		}
+	}
+
+	memset(gb->ppu.oam_line_data_buffer, 0, GAMEBOY_SCREEN_WIDTH * sizeof(uint8_t));
+	if (gb->ppu.obj_enable) {
+		gb_ppu_draw_line_objects(gb);
+	}
+
+	// first pixel of the scanline
+	int pixel = gb->ppu.ly * GAMEBOY_SCREEN_WIDTH;
+
+	switch (gb->ppu.output) {
+	case GB_PPU_OUTPUT_INDEXED:
+		gb->ppu.compositor->indexed(&gb->ppu.indexed_frames[gb->ppu.back_buffer][pixel],
+					    gb->ppu.bg_wn_buffer, gb->ppu.oam_line_data_buffer,
+					    gb->ppu.line_shades);
+		break;
+	case GB_PPU_OUTPUT_INDEXED_PACKED:
+		gb->ppu.compositor->packed(
+			&gb->ppu.indexed_frames[gb->ppu.back_buffer][pixel / PPU_PACKED_PIXELS],
+			gb->ppu.bg_wn_buffer, gb->ppu.oam_line_data_buffer, gb->ppu.line_shades);
+		break;
+	default:
+		gb->ppu.compositor->argb(&gb->ppu.frame_buffers[gb->ppu.back_buffer][pixel],
+					 gb->ppu.bg_wn_buffer, gb->ppu.oam_line_data_buffer,
+					 gb->ppu.line_palette);
+		break;
+	}
+
+	if (gb->ppu.ly == 143) {
+		uint32_t *frame = NULL;
+
+		if (gb->ppu.output == GB_PPU_OUTPUT_ARGB8888) {
+			frame = gb->ppu.frame_buffers[gb->ppu.back_buffer];
+		}
+
+		// publish the completed frame and draw the next one into the other buffer
+		gb->ppu.front_output = gb->ppu.output;
+		PPU_STORE_RELEASE(gb->ppu.front_buffer, gb->ppu.back_buffer);
+		gb->ppu.back_buffer ^= 1;
+
+		if (gb->ppu.display_frame_buffer != NULL) {
+			gb->ppu.display_frame_buffer(gb->ppu.display_ctx, frame);
 		}
 	}
+}
 
-	if (obj_enable) {
-		gb_ppu_draw_line_objects();
+/**
+ * @brief Sets 4 shades of the current scanline from a palette register
+ * @param entry first palette entry to set
+ * @param palette value of BGP, OBP0 or OBP1
+ * @return Nothing
+ */
+static void gb_ppu_set_line_shades(gb_t *gb, uint8_t entry, uint8_t palette)
+{
+	for (int i = 0; i < 4; i++) {
+		gb->ppu.line_shades[entry + i] = (palette >> (i * 2)) & 0x03;
 	}
+}
+
+/**
+ * @brief Finds the shade of a pixel of the indexed frame
+ * @param frame indexed frame, see gb_ppu_get_indexed_frame()
+ * @param pixel index of the pixel, counted row by row
+ * @return shade
+ */
+static inline uint8_t gb_ppu_get_shade(const gb_t *gb, const uint8_t *frame, int pixel)
+{
+	if (gb->ppu.front_output == GB_PPU_OUTPUT_INDEXED_PACKED) {
+		uint8_t shift = ((PPU_PACKED_PIXELS - 1) - (pixel % PPU_PACKED_PIXELS)) * 2;
 
-	if (ly == 143) {
-		gb_ppu_display_frame_buffer(&frame_buffer[(0)]);
+		return (frame[pixel / PPU_PACKED_PIXELS] >> shift) & 0x03;
 	}
+
+	return frame[pixel];
 }
 
-uint8_t gb_ppu_memory_read(uint16_t address)
+uint8_t gb_ppu_memory_read(gb_t *gb, uint16_t address)
 {
-	return mem.map[address];
+	gb_ppu_sync(gb);
+	return gb->mem.map[address];
 }
 
-void gb_ppu_memory_write(uint16_t address, uint8_t data)
+void gb_ppu_memory_write(gb_t *gb, uint16_t address, uint8_t data)
 {
 	uint32_t *palette_sel = NULL;
 
+	gb_ppu_sync(gb);
+
+	if (address < IO_BASE) {
+		// VRAM and OAM, tiles are decoded again before the next scanline is drawn
+		if (address < TILE_MAP_LOCATION_LOW && gb->mem.map[address] != data) {
+			uint16_t tile = (address - TILE_DATA_UNSIGNED_ADDR) / PPU_TILE_BYTES;
+
+			if (!gb->ppu.tile_dirty[tile]) {
+				gb->ppu.tile_dirty[tile] = true;
+				gb->ppu.tile_dirty_list[gb->ppu.tile_dirty_count++] = tile;
+			}
+		}
+		gb->mem.map[address] = data;
+		return;
+	}
+
 	switch (address) {
 	case LCDC_ADDR:
-		ppu_enable = CHK_BIT(data, 7) ? true : false;
-		wn_display_addr = CHK_BIT(data, 6) ? TILE_MAP_LOCATION_HIGH : TILE_MAP_LOCATION_LOW;
-		wn_enable = CHK_BIT(data, 5) ? true : false;
-		tile_data_addr = CHK_BIT(data, 4) ? TILE_DATA_UNSIGNED_ADDR : TILE_DATA_SIGNED_ADDR;
-		bg_display_addr = CHK_BIT(data, 3) ? TILE_MAP_LOCATION_HIGH : TILE_MAP_LOCATION_LOW;
-		obj_size = CHK_BIT(data, 2) ? true : false;
-		obj_enable = CHK_BIT(data, 1) ? true : false;
-		bg_wn_enable = CHK_BIT(data, 0) ? true : false;
-		mem.map[address] = data;
+		gb_ppu_set_enable(gb, CHK_BIT(data, 7) ? true : false);
+		gb->ppu.wn_display_addr =
+			CHK_BIT(data, 6) ? TILE_MAP_LOCATION_HIGH : TILE_MAP_LOCATION_LOW;
+		gb->ppu.wn_enable = CHK_BIT(data, 5) ? true : false;
+		gb->ppu.tile_data_addr =
+			CHK_BIT(data, 4) ? TILE_DATA_UNSIGNED_ADDR : TILE_DATA_SIGNED_ADDR;
+		gb->ppu.bg_display_addr =
+			CHK_BIT(data, 3) ? TILE_MAP_LOCATION_HIGH : TILE_MAP_LOCATION_LOW;
+		gb->ppu.obj_size = CHK_BIT(data, 2) ? true : false;
+		gb->ppu.obj_enable = CHK_BIT(data, 1) ? true : false;
+		gb->ppu.bg_wn_enable = CHK_BIT(data, 0) ? true : false;
+		gb->mem.map[address] = data;
 		return;
 
 	case STAT_ADDR:
-		lyc_int_sel = CHK_BIT(data, 6) ? true : false;
-		mode_2_sel = CHK_BIT(data, 5) ? true : false;
-		mode_1_sel = CHK_BIT(data, 4) ? true : false;
-		mode_0_sel = CHK_BIT(data, 3) ? true : false;
-		mem.map[address] = (data & ~0x7) | mem.map[address] & 0x7;
+		gb->ppu.lyc_int_sel = CHK_BIT(data, 6) ? true : false;
+		gb->ppu.mode_2_sel = CHK_BIT(data, 5) ? true : false;
+		gb->ppu.mode_1_sel = CHK_BIT(data, 4) ? true : false;
+		gb->ppu.mode_0_sel = CHK_BIT(data, 3) ? true : false;
+		gb->mem.map[address] = (data & ~0x7) | gb->mem.map[address] & 0x7;
+		if (gb->ppu.ppu_enable) {
+			gb_ppu_schedule_irq(gb);
+		}
 		return;
 
 	case SCY_ADDR:
-		scy = data;
-		mem.map[address] = data;
+		gb->ppu.scy = data;
+		gb->mem.map[address] = data;
 		return;
 
 	case SCX_ADDR:
-		scx = data;
-		mem.map[address] = data;
+		gb->ppu.scx = data;
+		gb->mem.map[address] = data;
 		return;
 
 	case LY_ADDR:
 		return;
 
 	case LYC_ADDR:
-		mem.map[address] = data;
+		gb->mem.map[address] = data;
+		if (gb->ppu.ppu_enable) {
+			gb_ppu_schedule_irq(gb);
+		}
 		return;
 
 	case DMA_ADDR:
 		for (uint16_t i = 0; i < 40 * 4; i++)
-			mem.map[OAM_BASE + i] = gb_memory_read((data << 8) + i);
+			gb->mem.map[OAM_BASE + i] = gb_memory_read(gb, (data << 8) + i);
 		return;
 
 	case BGP_ADDR:
-		palette_sel = (palette_sel == NULL) ? bgp_color_to_palette : palette_sel;
+		palette_sel = (palette_sel == NULL) ? gb->ppu.bgp_color_to_palette : palette_sel;
 	case OBP0_ADDR:
-		palette_sel = (palette_sel == NULL) ? obp0_color_to_palette : palette_sel;
+		palette_sel = (palette_sel == NULL) ? gb->ppu.obp0_color_to_palette : palette_sel;
 	case OBP1_ADDR:
-		palette_sel = (palette_sel == NULL) ? obp1_color_to_palette : palette_sel;
+		palette_sel = (palette_sel == NULL) ? gb->ppu.obp1_color_to_palette : palette_sel;
 
 		for (int i = 0; i < 4; i++) {
 			switch ((data >> (i * 2)) & 0x03) {
@@ -722,21 +1111,21 @@ void gb_ppu_memory_write(uint16_t address, uint8_t data)
 				break;
 			}
 		}
-		mem.map[address] = data;
+		gb->mem.map[address] = data;
 		return;
 
 	case WY_ADDR:
-		wy = data;
-		mem.map[address] = data;
+		gb->ppu.wy = data;
+		gb->mem.map[address] = data;
 		return;
 
 	case WX_ADDR:
-		wx = data;
-		mem.map[address] = data;
+		gb->ppu.wx = data;
+		gb->mem.map[address] = data;
 		return;
 
 	default:
-		mem.map[address] = data;
+		gb->mem.map[address] = data;
 		return;
 	}
 }
@@ -0,0 +1,401 @@
+/**
+ * @file gb_ppu_line.c
+ * @brief Gameboy PPU scanline compositor.
+ *
+ * This file merges the background and window layer of a scanline with its object layer and maps
+ * the result to frame buffer colors. Both layers come as one byte per pixel: background and window
+ * pixels hold their color index, object pixels hold the palette entry of their color and
+ * GB_PPU_LINE_BEHIND, or 0 where no object pixel is shown. The palette has the background colors
+ * in its first 4 entries, followed by the colors of OBP0 and OBP1. The result is either a line of
+ * frame buffer colors, or a line of shades for the indexed frame formats, which use a palette of
+ * shades laid out the same way.
+ *
+ * On x86-64 hosts whose CPU supports SSSE3 or AVX2, the layers are merged with vector masks and
+ * the palette is applied with byte shuffles. Other hosts use the plain C version.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#include "gb_common.h"
+#include "gb_ppu_line.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define GB_PPU_LINE_X86_64
+#include <immintrin.h>
+#endif
+
+/*Function Prototypes*/
+static inline uint8_t gb_ppu_line_entry(uint8_t bg, uint8_t obj);
+static void gb_ppu_line_compose(uint32_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				const uint32_t *palette);
+static void gb_ppu_line_compose_indexed(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+					const uint8_t *shades);
+static void gb_ppu_line_compose_packed(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				       const uint8_t *shades);
+
+#ifdef GB_PPU_LINE_X86_64
+static inline __m128i gb_ppu_line_entries_ssse3(const uint8_t *bg, const uint8_t *obj);
+static void gb_ppu_line_tables(const uint32_t *palette, __m128i *tables);
+static void gb_ppu_line_compose_ssse3(uint32_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				      const uint32_t *palette);
+static void gb_ppu_line_compose_indexed_ssse3(uint8_t *pixels, const uint8_t *bg,
+					      const uint8_t *obj, const uint8_t *shades);
+static void gb_ppu_line_compose_packed_ssse3(uint8_t *pixels, const uint8_t *bg,
+					     const uint8_t *obj, const uint8_t *shades);
+static inline __m256i gb_ppu_line_entries_avx2(const uint8_t *bg, const uint8_t *obj);
+static void gb_ppu_line_compose_avx2(uint32_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				     const uint32_t *palette);
+static void gb_ppu_line_compose_indexed_avx2(uint8_t *pixels, const uint8_t *bg,
+					     const uint8_t *obj, const uint8_t *shades);
+static void gb_ppu_line_compose_packed_avx2(uint8_t *pixels, const uint8_t *bg,
+					    const uint8_t *obj, const uint8_t *shades);
+#endif
+
+static const gb_ppu_compositor_t gb_ppu_line_compositor = {
+	gb_ppu_line_compose,
+	gb_ppu_line_compose_indexed,
+	gb_ppu_line_compose_packed,
+};
+
+#ifdef GB_PPU_LINE_X86_64
+static const gb_ppu_compositor_t gb_ppu_line_compositor_ssse3 = {
+	gb_ppu_line_compose_ssse3,
+	gb_ppu_line_compose_indexed_ssse3,
+	gb_ppu_line_compose_packed_ssse3,
+};
+
+static const gb_ppu_compositor_t gb_ppu_line_compositor_avx2 = {
+	gb_ppu_line_compose_avx2,
+	gb_ppu_line_compose_indexed_avx2,
+	gb_ppu_line_compose_packed_avx2,
+};
+#endif
+
+/**
+ * @brief Picks the compositor for the host CPU
+ * @return compositor to draw scanlines with
+ */
+const gb_ppu_compositor_t *gb_ppu_line_select(void)
+{
+#ifdef GB_PPU_LINE_X86_64
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return &gb_ppu_line_compositor_avx2;
+	}
+	if (__builtin_cpu_supports("ssse3")) {
+		return &gb_ppu_line_compositor_ssse3;
+	}
+#endif
+
+	return &gb_ppu_line_compositor;
+}
+
+/**
+ * @brief Finds the palette entry of a pixel
+ * @details An object pixel is shown unless it is transparent or it is behind the background and
+ * the background color is not 0.
+ * @param bg color index of the background or window pixel
+ * @param obj palette entry of the object pixel
+ * @return palette entry
+ */
+static inline uint8_t gb_ppu_line_entry(uint8_t bg, uint8_t obj)
+{
+	bool shown = obj != 0 && !((obj & GB_PPU_LINE_BEHIND) && bg != 0);
+
+	return shown ? (obj & GB_PPU_LINE_ENTRY) : bg;
+}
+
+/**
+ * @brief Composites a scanline
+ * @param pixels frame buffer line
+ * @param bg color indices of the background and window pixels
+ * @param obj palette entries of the object pixels
+ * @param palette frame buffer colors of the palette entries
+ * @returns Nothing
+ */
+static void gb_ppu_line_compose(uint32_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				const uint32_t *palette)
+{
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i++) {
+		pixels[i] = palette[gb_ppu_line_entry(bg[i], obj[i])];
+	}
+}
+
+/**
+ * @brief Composites a scanline into shades
+ * @param pixels line of the indexed frame
+ * @param shades shades of the palette entries
+ * @returns Nothing
+ */
+static void gb_ppu_line_compose_indexed(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+					const uint8_t *shades)
+{
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i++) {
+		pixels[i] = shades[gb_ppu_line_entry(bg[i], obj[i])];
+	}
+}
+
+/**
+ * @brief Composites a scanline into packed shades
+ * @param pixels line of the packed indexed frame, GAMEBOY_SCREEN_WIDTH / 4 bytes
+ * @param shades shades of the palette entries
+ * @returns Nothing
+ */
+static void gb_ppu_line_compose_packed(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				       const uint8_t *shades)
+{
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i += 4) {
+		uint8_t packed = 0;
+
+		for (int j = i; j < i + 4; j++) {
+			packed = (packed << 2) | shades[gb_ppu_line_entry(bg[j], obj[j])];
+		}
+		pixels[i / 4] = packed;
+	}
+}
+
+#ifdef GB_PPU_LINE_X86_64
+
+/**
+ * @brief Finds the palette entries of 16 pixels with SSSE3
+ * @details Same as gb_ppu_line_entry(), the entries are picked with vector masks.
+ * @return palette entries
+ */
+__attribute__((target("ssse3"))) static inline __m128i
+gb_ppu_line_entries_ssse3(const uint8_t *bg, const uint8_t *obj)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i b = _mm_loadu_si128((const __m128i *)bg);
+	__m128i o = _mm_loadu_si128((const __m128i *)obj);
+	// GB_PPU_LINE_BEHIND is the sign bit
+	__m128i behind = _mm_andnot_si128(_mm_cmpeq_epi8(b, zero), _mm_cmplt_epi8(o, zero));
+	__m128i hidden = _mm_or_si128(_mm_cmpeq_epi8(o, zero), behind);
+
+	return _mm_or_si128(_mm_and_si128(hidden, b),
+			    _mm_andnot_si128(hidden,
+					     _mm_and_si128(o, _mm_set1_epi8(GB_PPU_LINE_ENTRY))));
+}
+
+/**
+ * @brief Splits the palette into one table per color byte
+ * @details Entry n of table b holds byte b of the color of palette entry n, so a byte shuffle of
+ * a table with palette entries looks up that byte of their colors.
+ * @param palette frame buffer colors of the palette entries
+ * @param tables filled with the 4 tables
+ * @returns Nothing
+ */
+__attribute__((target("ssse3"))) static inline void gb_ppu_line_tables(const uint32_t *palette,
+								       __m128i *tables)
+{
+	// gathers byte b of 4 colors into the b-th 32 bit lane
+	const __m128i bytes = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+	__m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&palette[0]), bytes);
+	__m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&palette[4]), bytes);
+	__m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&palette[8]), bytes);
+	__m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&palette[12]), bytes);
+	__m128i p01_lo = _mm_unpacklo_epi32(p0, p1);
+	__m128i p01_hi = _mm_unpackhi_epi32(p0, p1);
+	__m128i p23_lo = _mm_unpacklo_epi32(p2, p3);
+	__m128i p23_hi = _mm_unpackhi_epi32(p2, p3);
+
+	tables[0] = _mm_unpacklo_epi64(p01_lo, p23_lo);
+	tables[1] = _mm_unpackhi_epi64(p01_lo, p23_lo);
+	tables[2] = _mm_unpacklo_epi64(p01_hi, p23_hi);
+	tables[3] = _mm_unpackhi_epi64(p01_hi, p23_hi);
+}
+
+/**
+ * @brief Composites a scanline with SSSE3
+ * @details Same as gb_ppu_line_compose() for 16 pixels at once. Each byte of the colors of the
+ * palette entries is looked up with a byte shuffle and the 4 bytes are interleaved into the
+ * colors.
+ * @returns Nothing
+ */
+__attribute__((target("ssse3"))) static void gb_ppu_line_compose_ssse3(uint32_t *pixels,
+								       const uint8_t *bg,
+								       const uint8_t *obj,
+								       const uint32_t *palette)
+{
+	__m128i tables[4];
+
+	gb_ppu_line_tables(palette, tables);
+
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i += 16) {
+		__m128i entries = gb_ppu_line_entries_ssse3(&bg[i], &obj[i]);
+		__m128i c0 = _mm_shuffle_epi8(tables[0], entries);
+		__m128i c1 = _mm_shuffle_epi8(tables[1], entries);
+		__m128i c2 = _mm_shuffle_epi8(tables[2], entries);
+		__m128i c3 = _mm_shuffle_epi8(tables[3], entries);
+		__m128i c01_lo = _mm_unpacklo_epi8(c0, c1);
+		__m128i c01_hi = _mm_unpackhi_epi8(c0, c1);
+		__m128i c23_lo = _mm_unpacklo_epi8(c2, c3);
+		__m128i c23_hi = _mm_unpackhi_epi8(c2, c3);
+
+		_mm_storeu_si128((__m128i *)&pixels[i], _mm_unpacklo_epi16(c01_lo, c23_lo));
+		_mm_storeu_si128((__m128i *)&pixels[i + 4], _mm_unpackhi_epi16(c01_lo, c23_lo));
+		_mm_storeu_si128((__m128i *)&pixels[i + 8], _mm_unpacklo_epi16(c01_hi, c23_hi));
+		_mm_storeu_si128((__m128i *)&pixels[i + 12], _mm_unpackhi_epi16(c01_hi, c23_hi));
+	}
+}
+
+/**
+ * @brief Composites a scanline into shades with SSSE3
+ * @details Same as gb_ppu_line_compose_indexed() for 16 pixels at once.
+ * @returns Nothing
+ */
+__attribute__((target("ssse3"))) static void
+gb_ppu_line_compose_indexed_ssse3(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				  const uint8_t *shades)
+{
+	__m128i table = _mm_loadu_si128((const __m128i *)shades);
+
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i += 16) {
+		__m128i entries = gb_ppu_line_entries_ssse3(&bg[i], &obj[i]);
+
+		_mm_storeu_si128((__m128i *)&pixels[i], _mm_shuffle_epi8(table, entries));
+	}
+}
+
+/**
+ * @brief Composites a scanline into packed shades with SSSE3
+ * @details Same as gb_ppu_line_compose_packed() for 16 pixels at once. Neighbouring shades are
+ * joined by multiplying and adding pairs of bytes, first into 4 bit and then into 8 bit values.
+ * @returns Nothing
+ */
+__attribute__((target("ssse3"))) static void
+gb_ppu_line_compose_packed_ssse3(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				 const uint8_t *shades)
+{
+	__m128i table = _mm_loadu_si128((const __m128i *)shades);
+
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i += 16) {
+		__m128i s = _mm_shuffle_epi8(table, gb_ppu_line_entries_ssse3(&bg[i], &obj[i]));
+		__m128i nibbles = _mm_maddubs_epi16(s, _mm_set1_epi16(0x0104));
+
+		nibbles = _mm_packus_epi16(nibbles, nibbles);
+		__m128i packed = _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110));
+
+		packed = _mm_packus_epi16(packed, packed);
+		uint32_t bytes = (uint32_t)_mm_cvtsi128_si32(packed);
+
+		memcpy(&pixels[i / 4], &bytes, sizeof(bytes));
+	}
+}
+
+/**
+ * @brief Finds the palette entries of 32 pixels with AVX2
+ * @details Same as gb_ppu_line_entries_ssse3().
+ * @return palette entries
+ */
+__attribute__((target("avx2"))) static inline __m256i gb_ppu_line_entries_avx2(const uint8_t *bg,
+									      const uint8_t *obj)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i b = _mm256_loadu_si256((const __m256i *)bg);
+	__m256i o = _mm256_loadu_si256((const __m256i *)obj);
+	__m256i behind = _mm256_andnot_si256(_mm256_cmpeq_epi8(b, zero),
+					     _mm256_cmpgt_epi8(zero, o));
+	__m256i hidden = _mm256_or_si256(_mm256_cmpeq_epi8(o, zero), behind);
+
+	return _mm256_or_si256(
+		_mm256_and_si256(hidden, b),
+		_mm256_andnot_si256(hidden,
+				    _mm256_and_si256(o, _mm256_set1_epi8(GB_PPU_LINE_ENTRY))));
+}
+
+/**
+ * @brief Composites a scanline with AVX2
+ * @details Same as gb_ppu_line_compose_ssse3() for 32 pixels at once.
+ * @returns Nothing
+ */
+__attribute__((target("avx2"))) static void gb_ppu_line_compose_avx2(uint32_t *pixels,
+								     const uint8_t *bg,
+								     const uint8_t *obj,
+								     const uint32_t *palette)
+{
+	__m128i tables[4];
+
+	gb_ppu_line_tables(palette, tables);
+
+	// shuffles stay within 128 bit lanes, so both lanes get the whole table
+	const __m256i table0 = _mm256_broadcastsi128_si256(tables[0]);
+	const __m256i table1 = _mm256_broadcastsi128_si256(tables[1]);
+	const __m256i table2 = _mm256_broadcastsi128_si256(tables[2]);
+	const __m256i table3 = _mm256_broadcastsi128_si256(tables[3]);
+
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i += 32) {
+		__m256i entries = gb_ppu_line_entries_avx2(&bg[i], &obj[i]);
+		__m256i c0 = _mm256_shuffle_epi8(table0, entries);
+		__m256i c1 = _mm256_shuffle_epi8(table1, entries);
+		__m256i c2 = _mm256_shuffle_epi8(table2, entries);
+		__m256i c3 = _mm256_shuffle_epi8(table3, entries);
+		// unpacking stays within 128 bit lanes as well, c01_lo gets pixels 0-7 and 16-23
+		__m256i c01_lo = _mm256_unpacklo_epi8(c0, c1);
+		__m256i c01_hi = _mm256_unpackhi_epi8(c0, c1);
+		__m256i c23_lo = _mm256_unpacklo_epi8(c2, c3);
+		__m256i c23_hi = _mm256_unpackhi_epi8(c2, c3);
+		__m256i px0 = _mm256_unpacklo_epi16(c01_lo, c23_lo);
+		__m256i px4 = _mm256_unpackhi_epi16(c01_lo, c23_lo);
+		__m256i px8 = _mm256_unpacklo_epi16(c01_hi, c23_hi);
+		__m256i px12 = _mm256_unpackhi_epi16(c01_hi, c23_hi);
+
+		_mm256_storeu_si256((__m256i *)&pixels[i],
+				    _mm256_permute2x128_si256(px0, px4, 0x20));
+		_mm256_storeu_si256((__m256i *)&pixels[i + 8],
+				    _mm256_permute2x128_si256(px8, px12, 0x20));
+		_mm256_storeu_si256((__m256i *)&pixels[i + 16],
+				    _mm256_permute2x128_si256(px0, px4, 0x31));
+		_mm256_storeu_si256((__m256i *)&pixels[i + 24],
+				    _mm256_permute2x128_si256(px8, px12, 0x31));
+	}
+}
+
+/**
+ * @brief Composites a scanline into shades with AVX2
+ * @details Same as gb_ppu_line_compose_indexed_ssse3() for 32 pixels at once.
+ * @returns Nothing
+ */
+__attribute__((target("avx2"))) static void
+gb_ppu_line_compose_indexed_avx2(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				 const uint8_t *shades)
+{
+	__m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)shades));
+
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i += 32) {
+		__m256i entries = gb_ppu_line_entries_avx2(&bg[i], &obj[i]);
+
+		_mm256_storeu_si256((__m256i *)&pixels[i], _mm256_shuffle_epi8(table, entries));
+	}
+}
+
+/**
+ * @brief Composites a scanline into packed shades with AVX2
+ * @details Same as gb_ppu_line_compose_packed_ssse3() for 32 pixels at once.
+ * @returns Nothing
+ */
+__attribute__((target("avx2"))) static void
+gb_ppu_line_compose_packed_avx2(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+				const uint8_t *shades)
+{
+	__m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)shades));
+	// packing stays within 128 bit lanes, each lane ends up with 4 bytes in its first 32 bits
+	const __m256i lanes = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+
+	for (int i = 0; i < GAMEBOY_SCREEN_WIDTH; i += 32) {
+		__m256i s = _mm256_shuffle_epi8(table, gb_ppu_line_entries_avx2(&bg[i], &obj[i]));
+		__m256i nibbles = _mm256_maddubs_epi16(s, _mm256_set1_epi16(0x0104));
+
+		nibbles = _mm256_packus_epi16(nibbles, nibbles);
+		__m256i packed = _mm256_maddubs_epi16(nibbles, _mm256_set1_epi16(0x0110));
+
+		packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(packed, packed), lanes);
+		_mm_storel_epi64((__m128i *)&pixels[i / 4], _mm256_castsi256_si128(packed));
+	}
+}
+
+#endif /* GB_PPU_LINE_X86_64 */
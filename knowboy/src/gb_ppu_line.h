@@ -0,0 +1,23 @@
+/**
+ * @file gb_ppu_line.h
+ * @brief Private API of the scanline compositor.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#ifndef SRC_GB_PPU_LINE_H_
+#define SRC_GB_PPU_LINE_H_
+
+#include "gb_priv.h"
+
+/* First palette entries of the colors of the objects using OBP0 and OBP1 */
+#define GB_PPU_LINE_OBP0 4
+#define GB_PPU_LINE_OBP1 8
+/* Set on object pixels that are hidden behind background and window colors 1 to 3 */
+#define GB_PPU_LINE_BEHIND 0x80
+#define GB_PPU_LINE_ENTRY  0x0F
+
+const gb_ppu_compositor_t *gb_ppu_line_select(void);
+
+#endif /* SRC_GB_PPU_LINE_H_ */
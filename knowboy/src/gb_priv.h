@@ -0,0 +1,503 @@
+/**
+ * @file gb_priv.h
+ * @brief Private definition of the gameboy emulator context.
+ *
+ * The gb_t context owns all state of one emulated gameboy. Each module keeps its part of the state
+ * in its own sub-structure.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#ifndef SRC_GB_PRIV_H_
+#define SRC_GB_PRIV_H_
+
+#include "gb.h"
+#include "gb_cpu.h"
+#include "gb_debug.h"
+#include "gb_memory.h"
+#include "gb_ppu.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PPU_MAX_OBJECTS_PER_SCANLINE 10
+#define PPU_TILE_COUNT		     384
+#define PPU_LINE_COLORS		     16
+#define MAX_BREAKPOINTS		     5
+
+/* The address space is split into 256 byte pages for memory dispatch */
+#define GB_MEMORY_PAGE_SHIFT 8
+#define GB_MEMORY_PAGE_COUNT (0x10000 >> GB_MEMORY_PAGE_SHIFT)
+#define GB_MEMORY_PAGE_SIZE  (1 << GB_MEMORY_PAGE_SHIFT)
+
+/* Number of blocks held by the block cache and most instructions decoded into one block */
+#define GB_CPU_CACHE_BLOCKS	  2048
+#define GB_CPU_BLOCK_INSTRUCTIONS 16
+
+/* Most runs of instructions of one block that are translated to native code */
+#define GB_JIT_BLOCK_SEGMENTS 4
+
+struct gb_instr_info;
+
+/* Scheduled events, events due on the same clock cycle run in this order */
+typedef enum {
+	// CPU side events, run right after the instruction work of the M-cycle they are due on
+	GB_EVENT_SERIAL,
+	GB_EVENT_TIMA,
+	// events that run after the CPU has finished the M-cycle
+	GB_EVENT_PPU,
+	GB_EVENT_COUNT
+} gb_event_id_t;
+
+typedef void (*gb_event_handler_t)(gb_t *gb, uint64_t cycle);
+
+typedef struct {
+	// due clock cycle and event id packed by GB_SCHED_KEY()
+	uint64_t key;
+	gb_event_handler_t handler;
+} gb_event_t;
+
+/* Scheduler state */
+typedef struct {
+	// master clock, clock cycle at which the current M-cycle started
+	uint64_t now;
+	// key of the first pending event, UINT64_MAX if none is pending
+	uint64_t next_key;
+	// pending events sorted by key
+	gb_event_t queue[GB_EVENT_COUNT];
+	uint8_t count;
+} gb_sched_t;
+
+typedef uint8_t (*gb_memory_read_handler_t)(gb_t *gb, uint16_t address);
+typedef void (*gb_memory_write_handler_t)(gb_t *gb, uint16_t address, uint8_t data);
+
+/* Memory page table, one entry per page of the address space */
+typedef struct {
+	// host memory backing the page, NULL if accesses to the page go through its handler
+	const uint8_t *read[GB_MEMORY_PAGE_COUNT];
+	uint8_t *write[GB_MEMORY_PAGE_COUNT];
+	// handlers of memory mapped registers and banked cartridge memory
+	gb_memory_read_handler_t read_handler[GB_MEMORY_PAGE_COUNT];
+	gb_memory_write_handler_t write_handler[GB_MEMORY_PAGE_COUNT];
+} gb_memory_pages_t;
+
+/* CPU state */
+typedef struct {
+	gb_cpu_mode_t mode;
+	uint8_t stopped;
+	uint8_t halted;
+	uint8_t interrupt_master_enable;
+	uint8_t one_cycle_interrupt_delay;
+	// IE & IF & 0x1F, updated by the memory on every change of IE or IF
+	uint8_t pending_interrupts;
+	uint8_t op_remaining;
+	int interupt_dur;
+	uint8_t opcode;
+	// M-cycle of the current instruction, starting at 1, handlers that do work on more than one
+	// M-cycle check it to tell which part is due
+	uint8_t current_cycle;
+	bool dont_update_pc;
+	uint8_t next_instruction;
+	const struct gb_instr_info *instr_info;
+	uint8_t temp_res;
+	// the instruction core leaves the flags of INC, DEC, ADD, ADC, SUB, SBC and CP to be worked
+	// out from these by gb_cpu_flags(), F is only up to date while flags_op is 0
+	uint8_t flags_op;
+	uint8_t flags_xor;
+	uint16_t flags_res;
+	// clock cycles of busy-wait loops that were skipped over
+	uint64_t idle_cycles;
+	// host memory of the page instruction bytes were last fetched from, see gb_cpu_fetch(),
+	// fetch_size is 0 while it is unknown or the page has no host memory
+	const uint8_t *fetch_ptr;
+	uint16_t fetch_base;
+	uint16_t fetch_size;
+} gb_cpu_t;
+
+/* Instruction decoded by the block cache */
+typedef struct {
+	uint8_t opcode;
+	// length in bytes, including the CB prefix
+	uint8_t length;
+	// M-cycles taken, 0 for conditional jumps, calls and returns
+	uint8_t cycles;
+	// immediate operand, or the opcode following the CB prefix
+	uint16_t operand;
+} gb_cpu_decoded_t;
+
+/* Native code of a segment, returns the number of instructions it ran */
+typedef uint8_t (*gb_jit_func_t)(registers_t *reg, const uint8_t *const *read,
+				 uint8_t *const *write);
+
+/* Run of instructions of a block that was translated to native code */
+typedef struct {
+	gb_jit_func_t code;
+	// index of the first instruction in the block, number of instructions and their M-cycles
+	uint8_t first;
+	uint8_t count;
+	uint8_t cycles;
+} gb_jit_segment_t;
+
+/* Kinds of memory copy and fill loops */
+typedef enum {
+	GB_CPU_BULK_NONE,
+	GB_CPU_BULK_FILL,
+	GB_CPU_BULK_COPY,
+} gb_cpu_bulk_kind_t;
+
+/* Memory copy or fill loop recognized in a block, see gb_cpu_bulk.c */
+typedef struct {
+	gb_cpu_bulk_kind_t kind;
+	// destination and source pointers, as 2 bit register pair operand, and their steps
+	uint8_t dst;
+	uint8_t src;
+	int8_t dst_step;
+	int8_t src_step;
+	// counter, a 3 bit register operand or a register pair operand if wide is set
+	uint8_t counter;
+	bool wide;
+	// fills store value if immediate is set and A otherwise
+	bool immediate;
+	uint8_t value;
+	// M-cycles of an iteration that jumps back
+	uint8_t cycles;
+} gb_cpu_bulk_t;
+
+/* Run of instructions that is only left by its last instruction, an interrupt or a code change */
+typedef struct {
+	// host memory the block was decoded from, NULL if the entry is unused
+	const uint8_t *code;
+	// write generation of the page the block lies in when it was decoded
+	uint32_t generation;
+	uint16_t pc;
+	uint8_t count;
+	// the block jumps back to its start and only reads memory, see gb_cpu_idle_loop()
+	bool idle;
+	gb_cpu_bulk_t bulk;
+	gb_cpu_decoded_t instr[GB_CPU_BLOCK_INSTRUCTIONS];
+
+	// number of runs while the block is not translated yet
+	uint8_t hits;
+	// the native code segments are only valid while this matches the epoch of the code buffer
+	uint32_t jit_epoch;
+	// sorted by their first instruction, unused entries and the last one start at 0xFF
+	gb_jit_segment_t jit[GB_JIT_BLOCK_SEGMENTS + 1];
+} gb_cpu_block_t;
+
+/* Block cache state */
+typedef struct {
+	// direct mapped on the host address of the first instruction
+	gb_cpu_block_t blocks[GB_CPU_CACHE_BLOCKS];
+	// bumped by the first write to a page after blocks have been decoded from it
+	uint32_t generation[GB_MEMORY_PAGE_COUNT];
+	// host memory of write protected pages, their writes go through the block cache first
+	uint8_t *protected_write[GB_MEMORY_PAGE_COUNT];
+} gb_cpu_cache_t;
+
+/* JIT state */
+typedef struct {
+	// code buffer, only writable while code is emitted, NULL until the first block is translated
+	uint8_t *buf;
+	uint32_t size;
+	uint32_t used;
+	// bumped whenever the code buffer is flushed
+	uint32_t epoch;
+	// set if the host can not run translated code
+	bool unavailable;
+	// memory snapshots of the JIT check mode, NULL until it first runs a segment
+	uint8_t *check_memory;
+	// segments whose native code and the instruction core did not agree in the JIT check mode
+	uint32_t mismatches;
+} gb_jit_t;
+
+/* Joypad, timer and serial state */
+typedef struct {
+	uint8_t joypad_sel_dir;
+	uint8_t joypad_sel_but;
+	gb_memory_controls_t controls;
+	void *controls_ctx;
+	uint8_t timer_stop_start;
+	uint8_t clock_mode;
+	// TIMA prescaler, it and the TIMA Register hold their values as of timer_tima_cycle
+	uint8_t timer_tima;
+	uint64_t timer_tima_cycle;
+	// the DIV Register holds its value as of this clock cycle
+	uint64_t timer_div_cycle;
+	uint8_t data_trans_flag;
+} gb_io_t;
+
+/* Object attributes of an object found on the current scanline */
+typedef struct {
+	// palette entries of the shown pixels, see gb_ppu_line.h
+	uint8_t buf[8];
+	uint8_t obj_index;
+	int16_t x_coord;
+	int16_t y_coord;
+	uint8_t start;
+	uint8_t len;
+	bool obj_prio;
+} oam_obj_t;
+
+/* Scanline compositor for the host CPU, see gb_ppu_line.c */
+typedef struct {
+	// merges the background and window layer with the object layer into frame buffer colors
+	void (*argb)(uint32_t *pixels, const uint8_t *bg, const uint8_t *obj,
+		     const uint32_t *palette);
+	// the same into shades, one per byte or packed 4 per byte
+	void (*indexed)(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+			const uint8_t *shades);
+	void (*packed)(uint8_t *pixels, const uint8_t *bg, const uint8_t *obj,
+		       const uint8_t *shades);
+} gb_ppu_compositor_t;
+
+/* PPU state */
+typedef struct {
+	oam_obj_t oam_line_slot[PPU_MAX_OBJECTS_PER_SCANLINE];
+	uint8_t oam_line_data_buffer[GAMEBOY_SCREEN_WIDTH];
+	uint8_t bg_wn_buffer[GAMEBOY_SCREEN_WIDTH];
+	// colors and shades of the current scanline, the objects take theirs as of the start of
+	// mode 3
+	uint32_t line_palette[PPU_LINE_COLORS];
+	uint8_t line_shades[PPU_LINE_COLORS];
+	const gb_ppu_compositor_t *compositor;
+
+	// dot of the next PPU event and clock cycle at which the current scanline started
+	uint32_t ppu_dot_counter;
+	uint64_t line_cycle;
+
+	// number of objects checked by the OAM scan of the current scanline
+	uint8_t oam_scan_count;
+
+	// oam object count
+	uint8_t oam_obj_count;
+
+	// internal window line counter
+	uint8_t wn_internal_line;
+
+	// Palettes
+	uint32_t bgp_color_to_palette[4];
+	uint32_t obp0_color_to_palette[4];
+	uint32_t obp1_color_to_palette[4];
+
+	// Frame Buffers, lines are drawn into frame_buffers[back_buffer] while
+	// frame_buffers[front_buffer] holds the last completed frame, the two are swapped at VBlank
+	uint32_t frame_buffers[2][GAMEBOY_SCREEN_WIDTH * GAMEBOY_SCREEN_HEIGHT];
+	uint8_t back_buffer;
+	uint8_t front_buffer;
+
+	// frame format, frames other than ARGB8888 are drawn into indexed_frames instead, which are
+	// double buffered with the same back_buffer and front_buffer
+	gb_ppu_output_t output;
+	// format asked for with gb_ppu_set_output(), taken over by output when a frame starts
+	gb_ppu_output_t next_output;
+	// format of the completed frame in front_buffer
+	gb_ppu_output_t front_output;
+	uint8_t indexed_frames[2][GAMEBOY_SCREEN_WIDTH * GAMEBOY_SCREEN_HEIGHT];
+
+	// color indices of the tiles in VRAM, row by row, as stored and mirrored horizontally
+	uint8_t tile_cache[2][PPU_TILE_COUNT][64];
+	// tiles written since they were last decoded into the tile cache
+	bool tile_dirty[PPU_TILE_COUNT];
+	uint16_t tile_dirty_list[PPU_TILE_COUNT];
+	uint16_t tile_dirty_count;
+
+	// Set when LY reaches the first VBlank line, cleared by gb_run_frame()
+	bool vblank;
+
+	// frames skipped after each rendered one, frames left to skip before the next one is
+	// rendered and whether the current frame is skipped, see gb_ppu_set_render_skip()
+	uint32_t render_skip;
+	uint32_t render_skip_count;
+	bool render_next;
+	bool skip_frame;
+
+	// Function Pointer to the frontend's display function
+	gb_ppu_display_frame_buffer_t display_frame_buffer;
+	void *display_ctx;
+
+	// LCDC register
+	bool ppu_enable;
+	uint16_t wn_display_addr;
+	bool wn_enable;
+	uint16_t tile_data_addr;
+	uint16_t bg_display_addr;
+	bool obj_size;
+	bool obj_enable;
+	bool bg_wn_enable;
+
+	// stat register
+	uint8_t stat_mode;
+	bool lyc_int_sel;
+	bool mode_2_sel;
+	bool mode_1_sel;
+	bool mode_0_sel;
+
+	uint8_t scy;
+	uint8_t scx;
+	uint8_t ly;
+	uint8_t wy;
+	uint8_t wx;
+} gb_ppu_t;
+
+/* APU state */
+typedef struct {
+	// Audio buffers
+	uint16_t *buf;
+	uint16_t *buf_pos;
+	// number of entries in buf, 2 per stereo sample
+	uint16_t buf_size;
+
+	// 4.194 MHZ --> 44100 HZ Conversion (4.194 / 0.0441 = 95)
+	uint8_t audio_freq_convert_factor;
+
+	// Frame Sequence Step 0 - 7 (Incremented every 8192 T States)
+	uint8_t frame_sequence_step;
+
+	// Clock cycle up to which the channels and the mixer have been stepped
+	uint64_t cycle;
+
+	// NR10
+	uint8_t ch1_sweep_pace;
+	uint8_t ch1_sweep_dir;
+	int16_t ch1_sweep_step;
+	uint8_t ch1_sweep_enable;
+	uint8_t ch1_sweep_timer;
+	uint32_t ch1_sweep_shadow;
+	int16_t ch1_sweep_negate;
+
+	// NR11
+	uint8_t ch1_wave_duty;
+	uint8_t ch1_length_counter;
+	uint8_t ch1_duty_pos;
+
+	// NR12
+	uint8_t ch1_init_vol;
+	uint8_t ch1_envelope_dir;
+	uint8_t ch1_envelope_pace;
+	bool ch1_dac_on;
+	uint16_t ch1_volume;
+	uint8_t ch1_envelope;
+
+	// NR13
+	uint16_t ch1_freq;
+	int32_t ch1_timer;
+
+	// NR14
+	uint8_t ch1_len_enable;
+
+	// NR21
+	uint8_t ch2_wave_duty;
+	uint8_t ch2_length_counter;
+	uint8_t ch2_duty_pos;
+
+	// NR22
+	uint8_t ch2_init_vol;
+	uint8_t ch2_envelope_dir;
+	uint8_t ch2_envelope_pace;
+	bool ch2_dac_on;
+	uint16_t ch2_volume;
+	uint8_t ch2_envelope;
+
+	// NR23
+	uint16_t ch2_freq;
+	int32_t ch2_timer;
+
+	// NR24
+	uint8_t ch2_len_enable;
+
+	// NR30
+	bool ch3_dac_on;
+
+	// NR31
+	uint16_t ch3_length_counter;
+	uint8_t ch3_wave_pos;
+
+	// NR32
+	uint8_t ch3_output_lvl;
+	uint16_t ch3_volume;
+	uint8_t ch3_envelope;
+
+	// NR33
+	uint16_t ch3_freq;
+	int32_t ch3_timer;
+	bool ch3_wave_avail;
+
+	// NR34
+	uint8_t ch3_len_enable;
+
+	// NR41
+	uint8_t ch4_length_counter;
+
+	// NR42
+	uint8_t ch4_init_vol;
+	uint8_t ch4_envelope_dir;
+	uint8_t ch4_envelope_pace;
+	bool ch4_dac_on;
+	uint16_t ch4_volume;
+	uint8_t ch4_envelope;
+
+	// NR43
+	uint8_t ch4_clock_shift;
+	uint8_t ch4_lfsr_width;
+	uint8_t ch4_clock_div;
+	int32_t ch4_timer;
+	uint16_t ch4_lfsr;
+
+	// NR44
+	uint8_t ch4_len_enable;
+} gb_apu_t;
+
+/* Memory bank controller state */
+typedef struct {
+	uint8_t controller_code;
+	uint8_t rom_bank_count;
+	uint8_t ram_bank_count;
+	uint8_t ram_enable;
+	uint8_t bank1;
+	uint8_t bank2;
+	uint8_t bank_mode;
+	uint8_t *bank_ram;
+
+	// ROM banks mapped at 0x0000 and 0x4000, and the RAM bank mapped at 0xA000 (NULL while
+	// cartridge RAM is disabled or absent), updated on every bank register write
+	const uint8_t *bank0_ptr;
+	const uint8_t *bankX_ptr;
+	uint8_t *sram_ptr;
+} gb_mbc_t;
+
+/* Debugger state */
+typedef struct {
+	uint16_t address[MAX_BREAKPOINTS];
+	bool activated[MAX_BREAKPOINTS];
+} breakpoints_t;
+
+typedef struct {
+	bool debugger_stopped;
+	breakpoints_t breakpoints;
+	gb_debug_check_msg_queue_t check_queue;
+	gb_debug_flush_t flush;
+	void *queue_ctx;
+	bool proceed;
+	uint16_t prev_PC;
+	// log every instruction the CPU runs
+	bool trace;
+} gb_debugger_t;
+
+/* Gameboy emulator context */
+struct gb {
+	gb_sched_t sched;
+	memory_t mem;
+	gb_memory_pages_t pages;
+	const uint8_t *rom;
+	gb_io_t io;
+	gb_cpu_t cpu;
+	gb_cpu_cache_t cpu_cache;
+	gb_jit_t jit;
+	gb_ppu_t ppu;
+	gb_apu_t apu;
+	gb_mbc_t mbc;
+	gb_debugger_t debug;
+};
+
+#endif /* SRC_GB_PRIV_H_ */
@@ -0,0 +1,94 @@
+/**
+ * @file gb_sched.c
+ * @brief Gameboy event scheduler.
+ *
+ * This file keeps the master clock of the emulator and a small queue of future events, such as
+ * PPU interrupts and timer overflows. Instead of stepping every
+ * component on every M-cycle, each component schedules the next cycle it has work to do on and
+ * the CPU runs freely until then.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#include "gb_sched.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Resets the master clock and drops all pending events.
+ * @return Nothing
+ */
+void gb_sched_init(gb_t *gb)
+{
+	gb->sched.now = 0;
+	gb->sched.next_key = UINT64_MAX;
+	gb->sched.count = 0;
+}
+
+/**
+ * @brief Removes a pending event from the queue.
+ * @param id event to remove, nothing happens if it is not pending
+ * @return Nothing
+ */
+void gb_sched_cancel(gb_t *gb, gb_event_id_t id)
+{
+	for (uint8_t i = 0; i < gb->sched.count; i++) {
+		if (GB_SCHED_KEY_ID(gb->sched.queue[i].key) == id) {
+			gb->sched.count--;
+			memmove(&gb->sched.queue[i], &gb->sched.queue[i + 1],
+				(gb->sched.count - i) * sizeof(gb_event_t));
+			break;
+		}
+	}
+
+	gb->sched.next_key = (gb->sched.count) ? gb->sched.queue[0].key : UINT64_MAX;
+}
+
+/**
+ * @brief Schedules an event, replacing the pending one with the same id.
+ * @details Events due on the M-cycle the CPU is currently executing still run on that M-cycle,
+ * CPU side events right after the instruction work and all others after it.
+ * @param id event to schedule
+ * @param cycle clock cycle the event is due on
+ * @param handler function called with the due cycle once the master clock reaches it
+ * @return Nothing
+ */
+void gb_sched_schedule(gb_t *gb, gb_event_id_t id, uint64_t cycle, gb_event_handler_t handler)
+{
+	uint64_t key = GB_SCHED_KEY(cycle, id);
+	uint8_t pos;
+
+	gb_sched_cancel(gb, id);
+
+	for (pos = gb->sched.count; pos > 0 && gb->sched.queue[pos - 1].key > key; pos--) {
+		gb->sched.queue[pos] = gb->sched.queue[pos - 1];
+	}
+
+	gb->sched.queue[pos].key = key;
+	gb->sched.queue[pos].handler = handler;
+	gb->sched.count++;
+	gb->sched.next_key = gb->sched.queue[0].key;
+}
+
+/**
+ * @brief Runs all pending events with a key lower than key in order.
+ * @details Handlers are allowed to schedule new events, an event that is scheduled below key
+ * runs in the same call.
+ * @param key exclusive upper bound, built with GB_SCHED_KEY()
+ * @return Nothing
+ */
+void gb_sched_dispatch(gb_t *gb, uint64_t key)
+{
+	while (gb->sched.next_key < key) {
+		gb_event_t event = gb->sched.queue[0];
+
+		gb->sched.count--;
+		memmove(&gb->sched.queue[0], &gb->sched.queue[1],
+			gb->sched.count * sizeof(gb_event_t));
+		gb->sched.next_key = (gb->sched.count) ? gb->sched.queue[0].key : UINT64_MAX;
+
+		event.handler(gb, GB_SCHED_KEY_CYCLE(event.key));
+	}
+}
@@ -0,0 +1,55 @@
+/**
+ * @file gb_sched.h
+ * @brief Private API of the event scheduler.
+ *
+ * @author Rami Saad
+ * @date 2026-10-16
+ */
+
+#ifndef SRC_GB_SCHED_H_
+#define SRC_GB_SCHED_H_
+
+#include "gb_priv.h"
+
+#include <stdint.h>
+
+/* Packs a clock cycle and an event id into a queue key, ordering events by cycle then by id */
+#define GB_SCHED_KEY(cycle, id) (((uint64_t)(cycle) << 4) | (id))
+
+/* Clock cycle and event id of a queue key */
+#define GB_SCHED_KEY_CYCLE(key) ((key) >> 4)
+#define GB_SCHED_KEY_ID(key)	((key) & 0xF)
+
+void gb_sched_init(gb_t *gb);
+void gb_sched_schedule(gb_t *gb, gb_event_id_t id, uint64_t cycle, gb_event_handler_t handler);
+void gb_sched_cancel(gb_t *gb, gb_event_id_t id);
+void gb_sched_dispatch(gb_t *gb, uint64_t key);
+
+/* Runs the CPU side events that are due on the current M-cycle */
+static inline void gb_sched_run_cpu_events(gb_t *gb)
+{
+	uint64_t key = GB_SCHED_KEY(gb->sched.now, GB_EVENT_PPU);
+
+	if (gb->sched.next_key < key) {
+		gb_sched_dispatch(gb, key);
+	}
+}
+
+/* Runs all events that are due before the current M-cycle */
+static inline void gb_sched_run_events(gb_t *gb)
+{
+	uint64_t key = GB_SCHED_KEY(gb->sched.now, 0);
+
+	if (gb->sched.next_key < key) {
+		gb_sched_dispatch(gb, key);
+	}
+}
+
+/* Moves the master clock forward and runs all events that became due on the way */
+static inline void gb_sched_advance(gb_t *gb, uint32_t cycles)
+{
+	gb->sched.now += cycles;
+	gb_sched_run_events(gb);
+}
+
+#endif /* SRC_GB_SCHED_H_ */
@@ -9,6 +9,7 @@
 #include <windows.h>
 #endif
 
+#include "gb.h"
 #include "gb_apu.h"
 #include "gb_cpu.h"
 #include "gb_mbc.h"
@@ -28,6 +29,7 @@
 #define SOUND_SAMPLE_RATE 44100
 
 static uint8_t *frame_buf;
+static gb_t *gb;
 static bool use_audio_cb;
 char retro_base_directory[4096];
 char retro_game_path[4096];
@@ -51,6 +53,8 @@ void retro_deinit(void)
 	LOG_INF_CB("retro de-init");
 	free(frame_buf);
 	frame_buf = NULL;
+	gb_destroy(gb);
+	gb = NULL;
 }
 
 unsigned retro_api_version(void)
@@ -192,8 +196,6 @@ static void audio_set_state(bool enable)
 	(void)enable;
 }
 
-uint32_t framebuffer[VIDEO_HEIGHT * VIDEO_PITCH] = {0};
-
 void retro_run(void)
 {
 	update_input();
@@ -203,14 +205,9 @@ void retro_run(void)
 		check_variables();
 	}
 
-	/* step 70224 */
-	for (int Tstates = 0; Tstates < 70224; Tstates += 4) {
-		gb_cpu_step();
-		gb_ppu_step();
-		gb_apu_step();
-	}
+	gb_run_frame(gb);
 
-	video_cb(framebuffer, VIDEO_WIDTH, VIDEO_HEIGHT, VIDEO_PITCH * sizeof(uint32_t));
+	video_cb(gb_ppu_get_frame(gb), VIDEO_WIDTH, VIDEO_HEIGHT, VIDEO_PITCH * sizeof(uint32_t));
 
 	size_t uploaded_frames = 0;
 	int16_t buf_pos = 0;
@@ -222,14 +219,10 @@ void retro_run(void)
 	audio_buf_pos = 0;
 }
 
-void prvDisplayLineBuffer(uint32_t *buffer)
-{
-	memcpy(framebuffer, buffer, VIDEO_HEIGHT * VIDEO_PITCH * 4);
-}
-
 uint8_t rom_data[32768 * 100];
-uint8_t prvControlsJoypad(uint8_t *ucJoypadSELdir, uint8_t *ucJoypadSELbut)
+uint8_t prvControlsJoypad(void *ctx, uint8_t *ucJoypadSELdir, uint8_t *ucJoypadSELbut)
 {
+	(void)ctx;
 	uint8_t mask = 0;
 	// poll keys then set mask
 
@@ -305,18 +298,27 @@ bool retro_load_game(const struct retro_game_info *info)
 	}
 
 	memcpy(rom_data, info->data, info->size);
-	gb_cpu_init();
-	gb_ppu_init();
-	gb_apu_init(audio_buf, &audio_buf_pos, AUDIO_BUF_SIZE);
-	gb_memory_init(boot_rom_data, rom_data, false);
-	gb_memory_set_control_function(prvControlsJoypad);
-	gb_ppu_set_display_frame_buffer(prvDisplayLineBuffer);
+	gb_destroy(gb);
+	gb = gb_create();
+	if (gb == NULL) {
+		LOG_ERR_CB("Failed to create the emulator context");
+		return false;
+	}
+	gb_apu_init(gb, audio_buf, &audio_buf_pos, AUDIO_BUF_SIZE);
+	gb_memory_init(gb, boot_rom_data, rom_data, false);
+	gb_memory_set_control_function(gb, prvControlsJoypad, NULL);
 	return true;
 }
 
 void retro_unload_game(void)
 {
 	LOG_INF_CB("retro unload game");
+	if (gb != NULL) {
+		LOG_INF_CB("Skipped %llu clock cycles of busy-wait loops",
+			   (unsigned long long)gb_cpu_get_idle_cycles(gb));
+	}
+	gb_destroy(gb);
+	gb = NULL;
 }
 
 unsigned retro_get_region(void)
@@ -2,6 +2,9 @@
 #ifndef MAIN_H_
 #define MAIN_H_
 
+#include "gb.h"
+#include "gb_cpu.h"
+
 #include <SDL.h>
 #include <SDL_ttf.h>
 
@@ -70,6 +73,8 @@ typedef struct {
 	gb_rom_t boot_rom;
 	gb_state_t state;
 	gb_debug_t debug;
+	gb_t *gb;
+	gb_cpu_mode_t cpu_mode;
 	bool menu_skip;
 	bool boot_skip;
 	const char *cache_file;
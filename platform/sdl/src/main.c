@@ -12,6 +12,7 @@
 #include <nfd.h>
 
 // gameboyLib
+#include "gb.h"
 #include "gb_apu.h"
 #include "gb_cpu.h"
 #include "gb_debug.h"
@@ -23,7 +24,6 @@
 
 static uint8_t dir_input = 0;
 static uint8_t but_input = 0;
-static uint32_t framebuffer[GAMEBOY_SCREEN_HEIGHT * GAMEBOY_SCREEN_WIDTH] = {0};
 
 int load_rom(gb_config_t *gb_config);
 
@@ -369,13 +369,9 @@ void display_fps(gb_av_t *gb_av)
 	}
 }
 
-void copy_frame_buffer(uint32_t *buffer)
-{
-	memcpy(framebuffer, buffer, GAMEBOY_SCREEN_HEIGHT * GAMEBOY_SCREEN_WIDTH * 4);
-}
-
-uint8_t controls_joypad(uint8_t *ucJoypadSELdir, uint8_t *ucJoypadSELbut)
+uint8_t controls_joypad(void *ctx, uint8_t *ucJoypadSELdir, uint8_t *ucJoypadSELbut)
 {
+	(void)ctx;
 	uint8_t mask = 0;
 
 	if (*ucJoypadSELdir == 0x10) {
@@ -578,14 +574,14 @@ void render_pause_menu(gb_config_t *gb_config)
 	render_menu(gb_config, &gb_config->pause_menu);
 }
 
-void render_frame_buffer(gb_av_t *gb_av)
+void render_frame_buffer(gb_av_t *gb_av, const uint32_t *frame)
 {
 	int new_width;
 	int new_height;
 	if (gb_av->enable) {
 		SDL_Rect src_rect = {0, 0, GAMEBOY_SCREEN_WIDTH, GAMEBOY_SCREEN_HEIGHT};
 
-		SDL_UpdateTexture(gb_av->texture, NULL, framebuffer,
+		SDL_UpdateTexture(gb_av->texture, NULL, frame,
 				  GAMEBOY_SCREEN_WIDTH * sizeof(uint32_t));
 
 		SDL_SetRenderDrawColor(gb_av->renderer, 0, 0, 0, 255); // Black color
@@ -614,6 +610,12 @@ int load_rom(gb_config_t *gb_config)
 	if (gb_config->av.enable) {
 		SDL_PauseAudio(0);
 	}
+	gb_destroy(gb_config->gb);
+	gb_config->gb = gb_create();
+	if (gb_config->gb == NULL) {
+		LOG_ERR("Failed to create the emulator context");
+		return -1;
+	}
 	if (gb_config->debug.enable) {
 		gb_config->debug.queue_mutex = SDL_CreateMutex();
 		gb_config->debug.queue.front = 0;
@@ -621,32 +623,32 @@ int load_rom(gb_config_t *gb_config)
 		gb_config->debug.queue.count = 0;
 		SDL_Thread *thread_id =
 			SDL_CreateThread(listen_to_stdin, "stdinListener", &gb_config->debug);
-		gb_debug_init(check_queue, flush_stdout, &gb_config->debug);
-	}
-	gb_cpu_init();
-	gb_ppu_init();
-	gb_apu_init(gb_config->av.audio_buf, &gb_config->av.audio_buf_pos, AUDIO_BUF_SIZE);
-	gb_memory_init(gb_config->boot_rom.data, gb_config->game_rom.data, gb_config->boot_skip);
-	gb_memory_set_control_function(controls_joypad);
-	gb_ppu_set_display_frame_buffer(copy_frame_buffer);
+		gb_debug_init(gb_config->gb, check_queue, flush_stdout, &gb_config->debug);
+	}
+	gb_apu_init(gb_config->gb, gb_config->av.audio_buf, &gb_config->av.audio_buf_pos,
+		    AUDIO_BUF_SIZE);
+	gb_memory_init(gb_config->gb, gb_config->boot_rom.data, gb_config->game_rom.data,
+		       gb_config->boot_skip);
+	gb_memory_set_control_function(gb_config->gb, controls_joypad, NULL);
+	gb_cpu_set_mode(gb_config->gb, gb_config->cpu_mode);
 	return 0;
 }
 
 int run_rom(gb_config_t *gb_config)
 {
-	gb_debug_check_msg_queue();
-	for (int Tstates = 0; Tstates < 70224; Tstates += 4) {
-		while (gb_debug_step()) {
+	gb_t *gb = gb_config->gb;
+
+	if (gb_config->debug.enable) {
+		gb_debug_check_msg_queue(gb);
+		while (gb_debug_step(gb)) {
 			if (gb_config->av.enable) {
 				update_input(gb_config);
-				render_frame_buffer(&gb_config->av);
+				render_frame_buffer(&gb_config->av, gb_ppu_get_frame(gb));
 				SDL_Delay(16);
 			}
 		}
-		gb_cpu_step();
-		gb_ppu_step();
-		gb_apu_step();
 	}
+	gb_run_frame(gb);
 
 	if (gb_config->av.enable) {
 		SDL_QueueAudio(1, gb_config->av.audio_buf, (gb_config->av.audio_buf_pos) * 2);
@@ -700,6 +702,27 @@ int parse_arguments(int argc, char *argv[], gb_config_t *gb_config)
 
 		} else if (strcmp(argv[i], "--noninteractive") == 0) {
 			gb_config->av.enable = false;
+
+		} else if (strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) {
+			char *cpu_mode = argv[++i];
+			// the debugger steps the CPU one M-cycle at a time, so it is only attached to
+			// the M-cycle core, the default. Picking a faster core turns the debugger off,
+			// gb_run_frame() would fall back to the M-cycle core while it is attached.
+			if (strcmp(cpu_mode, "m-cycle") == 0) {
+				gb_config->cpu_mode = GB_CPU_MODE_M_CYCLE;
+			} else if (strcmp(cpu_mode, "instruction") == 0) {
+				gb_config->cpu_mode = GB_CPU_MODE_INSTRUCTION;
+				gb_config->debug.enable = false;
+			} else if (strcmp(cpu_mode, "jit") == 0) {
+				gb_config->cpu_mode = GB_CPU_MODE_JIT;
+				gb_config->debug.enable = false;
+			} else if (strcmp(cpu_mode, "jit-check") == 0) {
+				gb_config->cpu_mode = GB_CPU_MODE_JIT_CHECK;
+				gb_config->debug.enable = false;
+			} else {
+				LOG_ERR("Invalid cpu argument");
+				exit(1);
+			}
 		} else {
 			LOG_ERR("Error: Unrecognized argument '%s'\n", argv[i]);
 			return -1;
@@ -760,6 +783,8 @@ int main(int argc, char *argv[])
 				.enable = true,
 			},
 		.state = MAIN_MENU,
+		// the debugger is attached by default and needs the M-cycle core, see --cpu
+		.cpu_mode = GB_CPU_MODE_M_CYCLE,
 		.menu_skip = false,
 		.boot_skip = false,
 		.cache_file = "cache.txt",
@@ -792,11 +817,12 @@ int main(int argc, char *argv[])
 			break;
 		case ROM_RUNNING:
 			run_rom(&gb_config);
-			render_frame_buffer(&gb_config.av);
+			render_frame_buffer(&gb_config.av, gb_ppu_get_frame(gb_config.gb));
 			break;
 		}
 	}
 
+	gb_destroy(gb_config.gb);
 	app_close(&gb_config.av);
 	return 0;
 }
@@ -0,0 +1,54 @@
+; Busy-wait loop that is left on a carry from before it started.
+;
+; The loop below is entered with A = 1 and the carry of ADD set. Its first run adds the carry and
+; stays in the loop, which ends up with the registers it started with, the second run leaves it.
+; An emulator that skips over busy-wait loops must not take the first run for one that only
+; waits. DIV is reset before the loop and still reads 0 after it, a skipped loop leaves it at the
+; next event. The result is printed over the serial port, "Passed" or "Failed".
+;
+; Build with RGBDS:
+;   rgbasm -o idle_loop_carry.o idle_loop_carry.asm
+;   rgblink -o idle_loop_carry.gb idle_loop_carry.o
+;   rgbfix -v -p 0 -t IDLELOOPCARRY idle_loop_carry.gb
+
+SECTION "Header", ROM0[$100]
+	nop
+	jp Start
+	ds $150 - @, 0
+
+SECTION "Main", ROM0[$150]
+Start:
+	di
+	ld sp, $FFFE
+	xor a
+	ldh [$FF40], a		; LCD off, no video events wake the loop up
+	ldh [$FF80], a
+	ldh [$FF04], a		; reset DIV
+	ld a, $81
+	add a, $80		; A = 1, carry set
+	jr .loop		; start a new block at the loop
+.loop:
+	ldh a, [$FF80]
+	adc a, 0
+	cp 1
+	jr z, .loop
+	ldh a, [$FF04]
+	and a
+	ld hl, Passed
+	jr z, .print
+	ld hl, Failed
+.print:
+	ld a, [hl+]
+	and a
+	jr z, .done
+	ldh [$FF01], a
+	ld a, $81
+	ldh [$FF02], a
+	jr .print
+.done:
+	jr .done
+
+Passed:
+	db "Passed", 0
+Failed:
+	db "Failed", 0
@@ -0,0 +1,108 @@
+; TIMA overflow and DIV reads in every timer clock.
+;
+; For every TAC clock select TIMA is set to $FF with TMA = $40, the timer is started and read back
+; after waiting between one and two TIMA periods. The overflow in between must have reloaded TIMA
+; from TMA and requested the timer interrupt, so TIMA reads $40 to $47 and IF has bit 2 set. DIV
+; is then cleared and read back after 60 and 76 M-cycles, it must have counted 0 or 1 and 1 or 2
+; increments, DIV writes clear the register without restarting the divider in this emulator. The
+; result is printed over the serial port, "Passed" or "Failed".
+;
+; Build with RGBDS:
+;   rgbasm -o tima_overflow.o tima_overflow.asm
+;   rgblink -o tima_overflow.gb tima_overflow.o
+;   rgbfix -v -p 0 -t TIMAOVERFLOW tima_overflow.gb
+
+SECTION "Header", ROM0[$100]
+	nop
+	jp Start
+	ds $150 - @, 0
+
+SECTION "Main", ROM0[$150]
+Start:
+	di
+	ld sp, $FFFE
+	xor a
+	ldh [$FFFF], a		; no interrupts are dispatched, only requested
+	ld hl, Tests
+.next_mode:
+	ld a, [hl+]
+	and a
+	jr z, .div
+	ld c, a			; TAC
+	ld a, [hl+]
+	ld b, a			; first wait, in runs of 4 M-cycles
+	ld a, [hl+]
+	ld e, a			; last wait + 1
+.test:
+	xor a
+	ldh [$FF07], a		; stop the timer
+	ldh [$FF0F], a
+	ld a, $40
+	ldh [$FF06], a
+	ld a, $FF
+	ldh [$FF05], a
+	ldh [$FF04], a
+	ld a, c
+	ldh [$FF07], a
+	ld d, b
+.wait:
+	dec d
+	jr nz, .wait
+	ldh a, [$FF05]
+	sub $40
+	cp 8
+	jp nc, Fail
+	ldh a, [$FF0F]
+	and $04
+	jp z, Fail
+	inc b
+	ld a, b
+	cp e
+	jr nz, .test
+	jr .next_mode
+.div:
+	ldh [$FF07], a
+	ldh [$FF04], a
+	ld d, 14
+.w1:
+	dec d
+	jr nz, .w1
+	ldh a, [$FF04]
+	cp 2
+	jp nc, Fail
+	ldh [$FF04], a
+	ld d, 18
+.w2:
+	dec d
+	jr nz, .w2
+	ldh a, [$FF04]
+	sub 1
+	cp 2
+	jp nc, Fail
+	ld hl, Passed
+	jr Print
+Fail:
+	ld hl, Failed
+Print:
+	ld a, [hl+]
+	and a
+	jr z, .done
+	ldh [$FF01], a
+	ld a, $81
+	ldh [$FF02], a
+	jr Print
+.done:
+	jr .done
+
+; TAC, first and last + 1 wait of each clock select, the waits span one to two TIMA periods
+Tests:
+	db $05, 2, 4
+	db $06, 5, 9
+	db $07, 17, 33
+	db $04, 65, 129
+	db 0
+
+Passed:
+	db "Passed", 0
+Failed:
+	db "Failed", 0